@@ -7,6 +7,9 @@
 #include "DockMenuAppManager.h"
 #include "ManualProcessDialog.h"
 #include "WindowButtonManager.h"
+#include "WindowTaskModel.h"
+#include "DockTelemetry.h"
+#include "DockTelemetryOverlay.h"
 
 #include <QApplication>
 #include <QDebug>
@@ -49,88 +52,19 @@ struct EnumWindowsData {
     QList<QPair<HWND, QString>> windows;
 };
 
-// Callback-функция для EnumWindows
+// Callback-функция для EnumWindows (используется, если модель окон не получает уведомлений)
 BOOL CALLBACK EnumWindowsProc2(HWND hwnd, LPARAM lParam) {
     EnumWindowsData* data = reinterpret_cast<EnumWindowsData*>(lParam);
 
-    // Проверяем, видимо ли окно
-    if (!IsWindowVisible(hwnd)) {
+    // Фильтрация окон общая с моделью окон
+    TaskWindowInfo info;
+    if (!ReadTaskWindowInfo(hwnd, info)) {
         return TRUE;
     }
 
-    // Получаем заголовок окна
-    wchar_t windowTitle[256];
-    int titleLength = GetWindowTextW(hwnd, windowTitle, 255);
-
-    // Получаем стили окна
-    LONG_PTR style = GetWindowLongPtr(hwnd, GWL_STYLE);
-    LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-
-    // Пропускаем определенные типы окон
-    if (exStyle & WS_EX_TOOLWINDOW) {
-        return TRUE; // Пропускаем тултипы и всплывающие окна
-    }
-
-    // Пропускаем окна без заголовка (кроме некоторых исключений)
-    if (titleLength == 0 && !(style & WS_CHILD)) {
-        // Для окон без заголовка проверяем, не являются ли они диалогами
-        if (!(style & WS_DLGFRAME)) {
-            return TRUE;
-        }
-    }
-
-    QString title = QString::fromWCharArray(windowTitle);
-
-    // Пропускаем системные окна
-    if (title.isEmpty() ||
-        title == "Program Manager" ||
-        title.startsWith("MSCTFIME UI") ||
-        title == "Default IME" ||
-        title.contains("OleMainThreadWndName") ||
-        title == "Windows Input Experience" ||
-        title == "Shell_TrayWnd" ||
-        title == "DDE Server Window" ||
-        title == "Start" ||
-        title == "Application Manager") {
-        return TRUE;
-    }
-
-    // Получаем ID процесса окна
-    DWORD processId;
-    GetWindowThreadProcessId(hwnd, &processId);
-
-    // Открываем процесс для получения его имени
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
-    if (hProcess) {
-        wchar_t exePath[MAX_PATH];
-        if (GetModuleFileNameExW(hProcess, NULL, exePath, MAX_PATH)) {
-            QString processExeName = QFileInfo(QString::fromWCharArray(exePath)).fileName();
-            QString fullExePath = QString::fromWCharArray(exePath);
-
-            // Специальная обработка для taskmgr.exe
-            if (processExeName.compare("taskmgr.exe", Qt::CaseInsensitive) == 0) {
-                // Для диспетчера задач проверяем определенные заголовки
-                if (!title.isEmpty() &&
-                    title != "Task Manager" &&
-                    !title.contains("Диспетчер задач", Qt::CaseInsensitive)) {
-                    // Возможно, это одно из скрытых окон диспетчера задач
-                    if (title.contains("Task Manager", Qt::CaseInsensitive) ||
-                        title.contains("Performance", Qt::CaseInsensitive) ||
-                        title.contains("Производительность", Qt::CaseInsensitive)) {
-                        // Это окно диспетчера задач
-                    } else {
-                        CloseHandle(hProcess);
-                        return TRUE;
-                    }
-                }
-            }
-
-            // Сравниваем имя процесса с искомым
-            if (processExeName.compare(data->processName, Qt::CaseInsensitive) == 0) {
-                data->windows.append(qMakePair(hwnd, title));
-            }
-        }
-        CloseHandle(hProcess);
+    // Сравниваем имя процесса с искомым
+    if (info.processName.compare(data->processName, Qt::CaseInsensitive) == 0) {
+        data->windows.append(qMakePair(hwnd, info.title));
     }
 
     return TRUE;
@@ -145,6 +79,18 @@ QPoint DockItem::getIconPosition() const
 // Функция для поиска всех окон по имени процесса
 QList<QPair<HWND, QString>> FindAllWindowsByProcess(const QString& processName)
 {
+    // Модель окон обновляется по событиям - читаем из нее без перечисления всех окон
+    WindowTaskModel& model = WindowTaskModel::instance();
+    if (model.isLive()) {
+        QList<QPair<HWND, QString>> windows;
+        const QList<TaskWindowInfo> infos = model.windowsForProcess(processName);
+        windows.reserve(infos.size());
+        for (const TaskWindowInfo& info : infos) {
+            windows.append(qMakePair(reinterpret_cast<HWND>(info.id), info.title));
+        }
+        return windows;
+    }
+
     EnumWindowsData data;
     data.processName = processName;
 
@@ -689,6 +635,7 @@ void DockItem::contextMenuEvent(QContextMenuEvent* event)
 void DockItem::paintEvent(QPaintEvent* event)
 {
     Q_UNUSED(event)
+    DockTelemetry::ScopedTimer telemetryTimer("DockItem::paintEvent");
 
     // Для кнопки Task View не рисуем ничего (полностью прозрачная)
     if (m_isTaskView) {
@@ -718,7 +665,9 @@ bool DockItem::isExplorer() const
 // Dock implementation
 Dock::Dock(QScreen* targetScreen, QWidget* parent)
     : QWidget(parent), m_targetScreen(targetScreen), m_isHidden(false), m_winTabItem(nullptr),
-      m_mouseInActivationZone(false), m_updatingRunningApps(false)
+      m_updatingRunningApps(false), m_layoutBatch(new DockLayoutBatch(this)),
+      m_positionUpdatePending(false), m_geometryUpdateCount(0),
+      m_animationManager(nullptr)
 {
     qDebug() << "Dock constructor started";
 
@@ -801,6 +750,8 @@ Dock::Dock(QScreen* targetScreen, QWidget* parent)
     // Убедитесь, что фон установлен
     m_dockWidget->setStyleSheet("background: transparent;");
 
+    m_layoutBatch->setContainer(m_dockWidget);
+
     // СОЗДАЕМ МЕНЕДЖЕР РАСШИРЕНИЙ
     m_extensionManager = new ExtensionLayoutManager(this);
     qDebug() << "ExtensionLayoutManager created:" << (m_extensionManager != nullptr);
@@ -861,24 +812,35 @@ Dock::Dock(QScreen* targetScreen, QWidget* parent)
 
     // Таймер для обновления позиции дока
     m_positionTimer = new QTimer(this);
-    connect(m_positionTimer, &QTimer::timeout, this, &Dock::updateDockPosition);
+    connect(m_positionTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("Dock::positionTimer");
+        updateDockPosition();
+    });
     m_positionTimer->start(1000);
 
     // Таймер для проверки запущенных приложений
     m_runningCheckTimer = new QTimer(this);
-    connect(m_runningCheckTimer, &QTimer::timeout, this, &Dock::checkRunningApplications);
+    connect(m_runningCheckTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("Dock::runningCheckTimer");
+        DockTelemetry::ScopedTimer telemetryTimer("Dock::checkRunningApplications");
+        checkRunningApplications();
+    });
     m_runningCheckTimer->start(2000);
 
-    // Таймер для проверки позиции мыши
-    m_mouseCheckTimer = new QTimer(this);
-    connect(m_mouseCheckTimer, &QTimer::timeout, this, &Dock::checkMousePosition);
-    m_mouseCheckTimer->start(100);
+    // Позицию мыши у нижнего края отслеживает зона активации в DockAnimationManager
 
     // Таймер для скрытия кнопок окон
     QTimer* buttonHideTimer = new QTimer(this);
-    connect(buttonHideTimer, &QTimer::timeout, this, &Dock::hideWindowButtons);
+    connect(buttonHideTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("Dock::buttonHideTimer");
+        hideWindowButtons();
+    });
     buttonHideTimer->start(100); // Проверяем каждые 100ms для лучшей реакции
 
+    // Телеметрия (по умолчанию выключена) и ее оверлей с горячими клавишами
+    DockTelemetry::instance();
+    DockTelemetryOverlay::instance();
+
     // Создаем менеджер анимаций
     m_animationManager = new DockAnimationManager(this);
     if (m_animationManager) {
@@ -939,11 +901,6 @@ Dock::~Dock()
         delete m_runningCheckTimer;
         m_runningCheckTimer = nullptr;
     }
-    if (m_mouseCheckTimer) {
-        m_mouseCheckTimer->stop();
-        delete m_mouseCheckTimer;
-        m_mouseCheckTimer = nullptr;
-    }
 
     // Безопасно очищаем списки
     for (DockItem* item : m_items) {
@@ -1101,6 +1058,8 @@ void Dock::setDockIconSize(int size)
 {
     m_currentIconSize = size;
 
+    beginLayoutUpdate();
+
     // Обновить размеры всех иконок
     for (DockItem* item : m_items) {
         if (item) {
@@ -1159,7 +1118,7 @@ void Dock::setDockIconSize(int size)
         }
     }
 
-    updateDockPosition();
+    commitLayoutUpdate();
     saveDockSettings();
 }
 
@@ -1193,7 +1152,7 @@ void Dock::addApplication(const QIcon& icon, const QString& name, const QString&
         m_winTabItem = item;
     }
 
-    m_layout->addWidget(item);
+    addItemToLayout(item);
     m_items.append(item);
 }
 
@@ -1408,15 +1367,18 @@ void Dock::addRunningApplication(const QIcon& icon, const QString& name, const Q
         hideRunningApplication(item);
     });
 
-    m_layout->addWidget(item);
+    addItemToLayout(item);
     m_runningItems.append(item);
 }
 
 void Dock::setupDock()
 {
+    // Пересборка дока целиком - одним пакетом
+    beginLayoutUpdate();
+
     // Очищаем текущие элементы
     for (DockItem* item : m_items) {
-        m_layout->removeWidget(item);
+        removeItemFromLayout(item);
         delete item;
     }
     m_items.clear();
@@ -1439,11 +1401,11 @@ void Dock::setupDock()
     // Добавляем кнопку Win+Tab в конец (справа)
     addApplication(QIcon(), "Task View", "");
 
-    // Обновляем позицию после добавления иконок
-    QTimer::singleShot(100, this, &Dock::updateDockPosition);
-
     // Обновляем список запущенных приложений
     updateRunningApps();
+
+    // Позиция обновится один раз при завершении пакета
+    commitLayoutUpdate();
 }
 
 void Dock::clearRunningApps()
@@ -1459,7 +1421,7 @@ void Dock::clearRunningApps()
             item->disconnect();
 
             // Удаляем из layout
-            m_layout->removeWidget(item);
+            removeItemFromLayout(item);
 
             // Удаляем объект
             delete item;
@@ -1473,6 +1435,55 @@ void Dock::clearRunningApps()
     qDebug() << "Running apps cleared";
 }
 
+void Dock::addItemToLayout(DockItem* item)
+{
+    if (!item) return;
+
+    m_layout->addWidget(item);
+    m_layoutBatch->addMutation();
+}
+
+void Dock::removeItemFromLayout(DockItem* item)
+{
+    if (!item) return;
+
+    m_layout->removeWidget(item);
+    m_layoutBatch->addMutation();
+}
+
+void Dock::beginLayoutUpdate()
+{
+    // Отключаем перерисовку и layout до завершения пакета
+    if (m_layoutBatch->begin() && m_dockWidget) {
+        m_dockWidget->setUpdatesEnabled(false);
+    }
+}
+
+void Dock::commitLayoutUpdate()
+{
+    const int mutations = m_layoutBatch->pendingMutations();
+    int geometryUpdatesBefore = m_geometryUpdateCount;
+
+    // Один проход layout для всех накопленных изменений
+    if (!m_layoutBatch->commit()) {
+        return;
+    }
+
+    if (m_positionUpdatePending || mutations > 0) {
+        m_positionUpdatePending = false;
+        updateDockPosition();
+    }
+
+    if (m_dockWidget) {
+        m_dockWidget->setUpdatesEnabled(true);
+    }
+
+    if (mutations > 0) {
+        qDebug() << "Dock layout batch:" << mutations << "item changes,"
+                 << (m_geometryUpdateCount - geometryUpdatesBefore) << "geometry updates";
+    }
+}
+
 QString Dock::getAppType(const QString& processName) const
 {
     QString lowerName = processName.toLower();
@@ -1520,6 +1531,8 @@ QString Dock::getAppDisplayName(const QString& processName) const
 
 void Dock::updateRunningApps()
 {
+    DockTelemetry::ScopedTimer telemetryTimer("Dock::updateRunningApps");
+
     if (m_updatingRunningApps) {
         qDebug() << "updateRunningApps already in progress, skipping";
         return;
@@ -1539,6 +1552,9 @@ void Dock::updateRunningApps()
         m_runningCheckTimer->stop();
     }
 
+    // Все вставки и удаления ниже применяются к layout одним пакетом
+    beginLayoutUpdate();
+
     // Создаем временный список для новых запущенных приложений
     QList<DockItem*> newRunningItems;
 
@@ -1547,6 +1563,7 @@ void Dock::updateRunningApps()
     HANDLE hProcessSnap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
     if (hProcessSnap == INVALID_HANDLE_VALUE) {
         qDebug() << "Failed to create process snapshot";
+        commitLayoutUpdate();
         if (m_runningCheckTimer) m_runningCheckTimer->start();
         m_updatingRunningApps = false;
         return;
@@ -1558,6 +1575,7 @@ void Dock::updateRunningApps()
     if (!Process32First(hProcessSnap, &pe32)) {
         qDebug() << "Failed to get first process";
         CloseHandle(hProcessSnap);
+        commitLayoutUpdate();
         if (m_runningCheckTimer) m_runningCheckTimer->start();
         m_updatingRunningApps = false;
         return;
@@ -1642,7 +1660,7 @@ void Dock::updateRunningApps()
                 });
 
                 newRunningItems.append(item);
-                m_layout->addWidget(item);
+                addItemToLayout(item);
 
                 qDebug() << "Added new running app to dock:" << appName << "(" << processName << ")";
             }
@@ -1715,7 +1733,7 @@ void Dock::updateRunningApps()
                 });
 
                 newRunningItems.append(item);
-                m_layout->addWidget(item);
+                addItemToLayout(item);
 
                 qDebug() << "Added manual process to dock:" << appName << "(" << manualProcess << ")";
             }
@@ -1830,7 +1848,7 @@ void Dock::updateRunningApps()
                             });
 
                             newRunningItems.append(item);
-                            m_layout->addWidget(item);
+                            addItemToLayout(item);
                             qDebug() << "Added system app to dock:" << systemApp << "(" << appName << ")";
                         }
                     }
@@ -1867,7 +1885,7 @@ void Dock::updateRunningApps()
             itemToRemove->disconnect();
 
             // Удаляем из layout
-            m_layout->removeWidget(itemToRemove);
+            removeItemFromLayout(itemToRemove);
 
             // Удаляем из текущего списка
             m_runningItems.removeAll(itemToRemove);
@@ -1885,8 +1903,8 @@ void Dock::updateRunningApps()
         m_runningCheckTimer->start();
     }
 
-    // Обновляем позицию дока
-    updateDockPosition();
+    // Один проход layout и одно обновление позиции дока
+    commitLayoutUpdate();
 
     m_updatingRunningApps = false;
     //qDebug() << "Finished updateRunningApps";
@@ -1991,6 +2009,7 @@ QIcon Dock::getAppIcon(const QString& executablePath)
 void Dock::paintEvent(QPaintEvent* event)
 {
     Q_UNUSED(event)
+    DockTelemetry::ScopedTimer telemetryTimer("Dock::paintEvent");
 
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
@@ -2020,12 +2039,20 @@ void Dock::paintEvent(QPaintEvent* event)
 
 void Dock::updateDockPosition()
 {
+    // Во время пакетного обновления геометрия пересчитывается один раз в commitLayoutUpdate()
+    if (m_layoutBatch->isActive()) {
+        m_positionUpdatePending = true;
+        return;
+    }
+
     if (!m_targetScreen) {
         m_targetScreen = QGuiApplication::primaryScreen();
     }
 
     if (!m_targetScreen) return;
 
+    ++m_geometryUpdateCount;
+
     QRect screenGeometry = m_targetScreen->geometry();
 
     int totalItems = m_items.size() + m_runningItems.size();
@@ -2051,6 +2078,11 @@ void Dock::updateDockPosition()
     setGeometry(x, y, actualWidth, actualHeight);
     m_dockWidget->setGeometry(0, 0, actualWidth, actualHeight);
 
+    // Зона активации зависит от геометрии дока
+    if (m_animationManager) {
+        m_animationManager->updateActivationZone();
+    }
+
     // Гарантируем, что док всегда на верхнем уровне, но без активации
     raise();
 
@@ -2104,48 +2136,6 @@ QRect Dock::activationZone() const
     return QRect(zoneX, zoneY, zoneWidth, zoneHeight);
 }
 
-void Dock::checkMousePosition()
-{
-    if (!m_targetScreen) {
-        m_targetScreen = QGuiApplication::primaryScreen();
-    }
-
-    if (!m_targetScreen) return;
-
-    QPoint globalPos = QCursor::pos();
-    QRect screenGeometry = m_targetScreen->geometry();
-
-    // Проверяем, находится ли мышь на том же экране, что и док
-    if (!screenGeometry.contains(globalPos)) {
-        // Если мышь не на этом экране, то выходим из зоны активации, если были в ней
-        if (m_mouseInActivationZone) {
-            m_mouseInActivationZone = false;
-            m_animationManager->startHideAnimation();
-        }
-        return;
-    }
-
-    // Получаем зону активации для текущего дока
-    QRect activationZoneRect = activationZone();
-
-    // Проверяем, находится ли мышь в зоне активации ИЛИ над самим доком
-    bool inActivationZone = activationZoneRect.contains(globalPos);
-    bool overDock = geometry().contains(mapFromGlobal(globalPos));
-
-    if ((inActivationZone || overDock) && !m_mouseInActivationZone) {
-        // Мышь вошла в зону активации или над доком
-        m_mouseInActivationZone = true;
-        if (m_animationManager->shouldShowDock()) {
-            m_animationManager->startShowAnimation();
-        }
-    }
-    else if (!inActivationZone && !overDock && m_mouseInActivationZone) {
-        // Мышь вышла из зоны активации и не над доком
-        m_mouseInActivationZone = false;
-        m_animationManager->startHideAnimation();
-    }
-}
-
 void Dock::addApplicationDialog()
 {
     // Диалог для ввода имени приложения
@@ -2211,10 +2201,12 @@ void Dock::removeRunningApplication(DockItem* item)
         }
 
         // Отключаем сигналы и удаляем элемент
+        beginLayoutUpdate();
         item->disconnect();
-        m_layout->removeWidget(item);
+        removeItemFromLayout(item);
         m_runningItems.removeAll(item);
         delete item;
+        commitLayoutUpdate();
 
         qDebug() << "Closed app and removed from dock:" << appName;
 
@@ -2243,11 +2235,13 @@ void Dock::hideRunningApplication(DockItem* item)
         // Добавляем в список скрытых приложений через DockMenuAppManager
         m_dockAppManager->addHiddenApp(executableName);
 
+        beginLayoutUpdate();
+
         // Отключаем все сигналы
         item->disconnect();
 
         // Удаляем из layout
-        m_layout->removeWidget(item);
+        removeItemFromLayout(item);
 
         // Удаляем из списка
         m_runningItems.removeAll(item);
@@ -2257,8 +2251,8 @@ void Dock::hideRunningApplication(DockItem* item)
 
         qDebug() << "Successfully hidden and removed:" << executableName;
 
-        // Обновляем позицию дока
-        updateDockPosition();
+        // Обновляем layout и позицию дока
+        commitLayoutUpdate();
 
         // НЕ вызываем updateRunningApps здесь - дождемся следующего цикла таймера
     }
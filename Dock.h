@@ -17,6 +17,7 @@
 #include <QPointer>
 #include <QMenu>
 #include "DockConstants.h"
+#include "DockLayoutBatch.h"
 #include "DockMenuAppManager.h"
 #include "HiddenAppsDialog.h"
 #include "PinnedAppsDialog.h"
@@ -127,6 +128,17 @@ public:
     // Новый метод для получения зоны активации
     QRect activationZone() const;
 
+    // Пакетное изменение элементов дока. Все вставки и удаления между
+    // beginLayoutUpdate() и commitLayoutUpdate() дают один проход layout
+    // и одно обновление геометрии. Вызовы могут быть вложенными.
+    void beginLayoutUpdate();
+    void commitLayoutUpdate();
+    bool isLayoutUpdateInProgress() const { return m_layoutBatch->isActive(); }
+
+    // Счетчики для оценки стоимости обновлений
+    int layoutPassCount() const { return m_layoutBatch->layoutPassCount(); }
+    int geometryUpdateCount() const { return m_geometryUpdateCount; }
+
 public slots:
     void setDockTransparency(int transparency);
     void setDockBackgroundColor(const QColor& color);
@@ -149,7 +161,6 @@ private slots:
     void onAppsChanged();
     void checkRunningApplications();
     void executeWinTab();
-    void checkMousePosition();
     void showHiddenAppsManager();
     void showContextMenu(const QPoint& pos);
     void showManualProcessDialog();
@@ -165,7 +176,6 @@ private:
     QGraphicsDropShadowEffect* m_shadowEffect;
     QTimer* m_positionTimer;
     QTimer* m_runningCheckTimer;
-    QTimer* m_mouseCheckTimer;
     DockMenuAppManager* m_dockAppManager;
     DockContextMenu* m_contextMenu;
     QAction* m_addAppAction;
@@ -176,9 +186,13 @@ private:
     bool m_isHidden;
     DockItem* m_winTabItem;
     QSet<QString> m_hiddenApps;
-    bool m_mouseInActivationZone;
     bool m_updatingRunningApps;
 
+    // Состояние пакетного обновления layout
+    DockLayoutBatch* m_layoutBatch;
+    bool m_positionUpdatePending;
+    int m_geometryUpdateCount;
+
 
     // Менеджер кнопок окон
     WindowButtonManager* m_buttonManager;
@@ -209,6 +223,8 @@ private:
     QString getAppType(const QString& processName) const;
     QString getAppDisplayName(const QString& processName) const;
     void clearRunningApps();
+    void addItemToLayout(DockItem* item);
+    void removeItemFromLayout(DockItem* item);
     QIcon getAppIcon(const QString& executablePath);
     bool hasWindows(const QString& executableName);
     void loadProcessMapping();
@@ -0,0 +1,284 @@
+#include "DockActivationZone.h"
+#include "Dock.h"
+#include "DockConstants.h"
+#include "DockTelemetry.h"
+#include "ForegroundWindowTracker.h"
+
+#include <QCursor>
+#include <QDebug>
+#include <QEvent>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QWidget>
+
+#include <climits>
+
+DockActivationZone::DockActivationZone(Dock* dock)
+    : QObject(dock)
+    , m_dock(dock)
+    , m_edgeWindow(nullptr)
+    , m_fullScreenCheckTimer(nullptr)
+    , m_mode(Mode::EdgeTrigger)
+    , m_running(false)
+    , m_inside(false)
+    , m_wakeups(0)
+{
+    m_pollTimer = new QTimer(this);
+    m_pollTimer->setSingleShot(true);
+    connect(m_pollTimer, &QTimer::timeout, this, &DockActivationZone::poll);
+
+    // На платформах без реального курсора события наведения не приходят
+    const QString platform = QGuiApplication::platformName();
+    if (platform == "offscreen" || platform == "minimal") {
+        m_mode = Mode::Polling;
+    } else {
+        createEdgeWindow();
+
+        // События активного окна приходят пачками - проверяем один раз после них
+        m_fullScreenCheckTimer = new QTimer(this);
+        m_fullScreenCheckTimer->setSingleShot(true);
+        m_fullScreenCheckTimer->setInterval(DockConstants::EDGE_TRIGGER_FULLSCREEN_CHECK_DELAY);
+        connect(m_fullScreenCheckTimer, &QTimer::timeout, this, &DockActivationZone::updateEdgeWindowVisibility);
+
+        ForegroundWindowTracker& tracker = ForegroundWindowTracker::instance();
+        connect(&tracker, &ForegroundWindowTracker::foregroundChanged,
+                m_fullScreenCheckTimer, qOverload<>(&QTimer::start));
+        connect(&tracker, &ForegroundWindowTracker::foregroundGeometryChanged,
+                m_fullScreenCheckTimer, qOverload<>(&QTimer::start));
+    }
+
+    qDebug() << "DockActivationZone mode:" << (m_mode == Mode::EdgeTrigger ? "edge trigger" : "polling");
+}
+
+DockActivationZone::~DockActivationZone()
+{
+    stop();
+
+    if (m_edgeWindow) {
+        delete m_edgeWindow;
+        m_edgeWindow = nullptr;
+    }
+}
+
+void DockActivationZone::createEdgeWindow()
+{
+    m_edgeWindow = new QWidget(nullptr, Qt::FramelessWindowHint | Qt::Tool |
+                                        Qt::WindowStaysOnTopHint | Qt::WindowDoesNotAcceptFocus);
+    m_edgeWindow->setAttribute(Qt::WA_ShowWithoutActivating);
+    m_edgeWindow->setFocusPolicy(Qt::NoFocus);
+
+    // Полностью прозрачное окно не получает события мыши,
+    // поэтому делаем его почти прозрачным
+    m_edgeWindow->setAutoFillBackground(true);
+    m_edgeWindow->setStyleSheet("background: black;");
+    m_edgeWindow->setWindowOpacity(0.01);
+
+    m_edgeWindow->installEventFilter(this);
+}
+
+void DockActivationZone::start()
+{
+    if (m_running) {
+        return;
+    }
+
+    m_running = true;
+    m_wakeups = 0;
+    m_statsTimer.start();
+
+    updateZone();
+    updateEdgeWindowVisibility();
+
+    // Сразу определяем начальное состояние, чтобы док скрылся, если курсор не в зоне
+    QPoint globalPos = QCursor::pos();
+    m_lastCursorPos = globalPos;
+    m_inside = cursorInZone(globalPos);
+    if (m_inside) {
+        emit entered();
+    } else {
+        emit left();
+    }
+
+    if (m_inside || m_mode == Mode::Polling) {
+        m_pollTimer->start(nextPollInterval(globalPos));
+    }
+}
+
+void DockActivationZone::stop()
+{
+    m_running = false;
+    m_pollTimer->stop();
+    if (m_fullScreenCheckTimer) {
+        m_fullScreenCheckTimer->stop();
+    }
+
+    if (m_edgeWindow) {
+        m_edgeWindow->hide();
+    }
+}
+
+void DockActivationZone::updateZone()
+{
+    if (!m_edgeWindow || !m_dock) {
+        return;
+    }
+
+    QScreen* screen = targetScreen();
+    if (!screen) {
+        return;
+    }
+
+    QRect screenGeometry = screen->geometry();
+    QRect zone = m_dock->activationZone();
+    if (zone.isEmpty()) {
+        return;
+    }
+
+    // Тонкая полоска у самого нижнего края в пределах горизонтальной зоны активации
+    QRect edgeRect(zone.left(),
+                   screenGeometry.bottom() - DockConstants::EDGE_TRIGGER_HEIGHT + 1,
+                   zone.width(),
+                   DockConstants::EDGE_TRIGGER_HEIGHT);
+
+    if (m_edgeWindow->geometry() != edgeRect) {
+        m_edgeWindow->setGeometry(edgeRect);
+    }
+}
+
+QScreen* DockActivationZone::targetScreen() const
+{
+    QScreen* screen = m_dock ? m_dock->getTargetScreen() : nullptr;
+    return screen ? screen : QGuiApplication::primaryScreen();
+}
+
+void DockActivationZone::updateEdgeWindowVisibility()
+{
+    if (!m_edgeWindow || !m_running) {
+        return;
+    }
+
+    // Полноэкранное приложение (игра, плеер) должно получать клики и наведение
+    // у нижнего края - док над ним все равно не показывается
+    QScreen* screen = targetScreen();
+    bool fullScreen = screen && ForegroundWindowTracker::instance().isFullScreenOn(screen->geometry());
+
+    if (fullScreen && m_edgeWindow->isVisible()) {
+        m_edgeWindow->hide();
+    } else if (!fullScreen && !m_edgeWindow->isVisible()) {
+        m_edgeWindow->show();
+    }
+}
+
+double DockActivationZone::wakeupsPerMinute() const
+{
+    if (!m_statsTimer.isValid()) {
+        return 0.0;
+    }
+
+    qint64 elapsed = m_statsTimer.elapsed();
+    if (elapsed <= 0) {
+        return 0.0;
+    }
+
+    return m_wakeups * 60000.0 / elapsed;
+}
+
+void DockActivationZone::resetWakeupStats()
+{
+    m_wakeups = 0;
+    m_statsTimer.restart();
+}
+
+bool DockActivationZone::eventFilter(QObject* obj, QEvent* event)
+{
+    if (obj == m_edgeWindow && event->type() == QEvent::Enter && m_running) {
+        // Курсор коснулся нижнего края - включаем быстрый опрос до выхода из зоны
+        m_lastCursorPos = QCursor::pos();
+        setInside(true);
+        m_pollTimer->start(DockConstants::AUTO_HIDE_CHECK_INTERVAL);
+    }
+
+    return QObject::eventFilter(obj, event);
+}
+
+void DockActivationZone::poll()
+{
+    if (!m_running) {
+        return;
+    }
+
+    ++m_wakeups;
+    DockTelemetry::countWakeup("DockActivationZone::poll");
+
+    QPoint globalPos = QCursor::pos();
+    setInside(cursorInZone(globalPos));
+
+    // В режиме краевого окна опрос нужен только пока курсор в зоне
+    if (m_mode == Mode::EdgeTrigger && !m_inside) {
+        m_lastCursorPos = globalPos;
+        return;
+    }
+
+    m_pollTimer->start(nextPollInterval(globalPos));
+    m_lastCursorPos = globalPos;
+}
+
+void DockActivationZone::setInside(bool inside)
+{
+    if (m_inside == inside) {
+        return;
+    }
+
+    m_inside = inside;
+    if (m_inside) {
+        emit entered();
+    } else {
+        emit left();
+    }
+}
+
+bool DockActivationZone::cursorInZone(const QPoint& globalPos) const
+{
+    if (!m_dock) {
+        return false;
+    }
+
+    // Док - окно верхнего уровня, его geometry() уже в глобальных координатах
+    return m_dock->activationZone().contains(globalPos) ||
+           m_dock->geometry().contains(globalPos);
+}
+
+int DockActivationZone::distanceToZone(const QPoint& globalPos) const
+{
+    QRect zone = m_dock ? m_dock->activationZone() : QRect();
+    if (zone.isEmpty()) {
+        return INT_MAX;
+    }
+
+    int dx = qMax(0, qMax(zone.left() - globalPos.x(), globalPos.x() - zone.right()));
+    int dy = qMax(0, qMax(zone.top() - globalPos.y(), globalPos.y() - zone.bottom()));
+    return qMax(dx, dy);
+}
+
+int DockActivationZone::nextPollInterval(const QPoint& globalPos) const
+{
+    const int fastInterval = DockConstants::AUTO_HIDE_CHECK_INTERVAL;
+    const int maxInterval = DockConstants::ACTIVATION_POLL_MAX_INTERVAL;
+
+    if (m_inside) {
+        return fastInterval;
+    }
+
+    int distance = distanceToZone(globalPos);
+    if (distance <= DockConstants::ACTIVATION_NEAR_DISTANCE) {
+        return fastInterval;
+    }
+
+    // Курсор неподвижен - удваиваем интервал до максимума
+    if (globalPos == m_lastCursorPos) {
+        return qMin(qMax(m_pollTimer->interval(), fastInterval) * 2, maxInterval);
+    }
+
+    // Курсор движется - чем дальше от зоны, тем реже проверяем
+    return qBound(fastInterval, distance / 2, maxInterval);
+}
@@ -0,0 +1,80 @@
+#ifndef DOCKACTIVATIONZONE_H
+#define DOCKACTIVATIONZONE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QPoint>
+#include <QRect>
+#include <QElapsedTimer>
+
+class Dock;
+class QScreen;
+class QWidget;
+
+// Сервис зоны активации дока.
+// Вместо постоянного опроса QCursor::pos() использует тонкое прозрачное окно
+// у нижнего края экрана (события Enter). Быстрый опрос включается только пока
+// курсор находится в зоне, чтобы поймать выход из нее. Если платформа не
+// доставляет события наведения (offscreen/minimal), используется адаптивный
+// опрос, который при неподвижном или далеком курсоре замедляется до секунд.
+// Пока активное окно развернуто на весь экран, краевое окно скрыто: оно
+// лежит поверх нижнего края приложения и перехватывало бы его клики.
+class DockActivationZone : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Mode {
+        EdgeTrigger,   // Краевое окно + опрос только внутри зоны
+        Polling        // Адаптивный опрос курсора
+    };
+
+    explicit DockActivationZone(Dock* dock);
+    ~DockActivationZone();
+
+    void start();
+    void stop();
+
+    // Пересчитывает геометрию краевого окна по текущей зоне активации дока
+    void updateZone();
+
+    Mode mode() const { return m_mode; }
+    bool isCursorInside() const { return m_inside; }
+
+    // Метрика пробуждений таймера (для оценки нагрузки в простое)
+    quint64 wakeupCount() const { return m_wakeups; }
+    double wakeupsPerMinute() const;
+    void resetWakeupStats();
+
+signals:
+    void entered();
+    void left();
+
+protected:
+    bool eventFilter(QObject* obj, QEvent* event) override;
+
+private slots:
+    void poll();
+    void updateEdgeWindowVisibility();
+
+private:
+    void createEdgeWindow();
+    QScreen* targetScreen() const;
+    void setInside(bool inside);
+    bool cursorInZone(const QPoint& globalPos) const;
+    int distanceToZone(const QPoint& globalPos) const;
+    int nextPollInterval(const QPoint& globalPos) const;
+
+    Dock* m_dock;
+    QWidget* m_edgeWindow;
+    QTimer* m_pollTimer;
+    QTimer* m_fullScreenCheckTimer;
+    Mode m_mode;
+    bool m_running;
+    bool m_inside;
+    QPoint m_lastCursorPos;
+    quint64 m_wakeups;
+    QElapsedTimer m_statsTimer;
+};
+
+#endif // DOCKACTIVATIONZONE_H
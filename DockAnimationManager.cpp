@@ -1,6 +1,11 @@
 #include "DockAnimationManager.h"
 #include "Dock.h"
 #include "DockConstants.h"
+#include "DockActivationZone.h"
+#include "ForegroundWindowTracker.h"
+#include "DockTelemetry.h"
+
+#include <QScreen>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -25,18 +30,39 @@ DockAnimationManager::DockAnimationManager(Dock* dock)
     connect(m_hideAnimation, &QPropertyAnimation::finished, this, &DockAnimationManager::onHideAnimationFinished);
     connect(m_showAnimation, &QPropertyAnimation::finished, this, &DockAnimationManager::onShowAnimationFinished);
 
-    m_autoHideTimer = new QTimer(this);
-    connect(m_autoHideTimer, &QTimer::timeout, this, &DockAnimationManager::checkAutoHide);
+    // Кадры анимаций - тоже пробуждения цикла событий
+    connect(m_hideAnimation, &QPropertyAnimation::valueChanged, this, []() {
+        DockTelemetry::countWakeup("DockAnimationManager::hideAnimation");
+    });
+    connect(m_showAnimation, &QPropertyAnimation::valueChanged, this, []() {
+        DockTelemetry::countWakeup("DockAnimationManager::showAnimation");
+    });
+
+    // Зона активации сообщает о входе/выходе курсора вместо постоянного опроса
+    m_activationZone = new DockActivationZone(m_dock);
+    connect(m_activationZone, &DockActivationZone::entered, this, &DockAnimationManager::onActivationZoneEntered);
+    connect(m_activationZone, &DockActivationZone::left, this, &DockAnimationManager::onActivationZoneLeft);
 }
 
 DockAnimationManager::~DockAnimationManager()
 {
     stopAnimations();
+
+    if (m_activationZone) {
+        m_activationZone->stop();
+    }
 }
 
 void DockAnimationManager::initialize()
 {
-    m_autoHideTimer->start(DockConstants::AUTO_HIDE_CHECK_INTERVAL);
+    m_activationZone->start();
+}
+
+void DockAnimationManager::updateActivationZone()
+{
+    if (m_activationZone) {
+        m_activationZone->updateZone();
+    }
 }
 
 void DockAnimationManager::startShowAnimation()
@@ -108,33 +134,27 @@ bool DockAnimationManager::shouldShowDock() const
     return !isFullScreenAppActive();
 }
 
-void DockAnimationManager::checkAutoHide()
+void DockAnimationManager::onActivationZoneEntered()
 {
     if (!m_dock) {
         return;
     }
 
-    QPoint globalPos = QCursor::pos();
-    QScreen* targetScreen = m_dock->getTargetScreen();
-
-    if (targetScreen && targetScreen->geometry().contains(globalPos)) {
-        // Используем метод activationZone() для проверки зоны активации
-        QRect activationZone = m_dock->activationZone();
-        bool inActivationZone = activationZone.contains(globalPos);
-        bool overDock = m_dock->geometry().contains(m_dock->mapFromGlobal(globalPos));
+    // Курсор в зоне активации или над доком
+    if (m_isHidden && shouldShowDock()) {
+        startShowAnimation();
+    }
+}
 
-        if ((inActivationZone || overDock) && m_isHidden && shouldShowDock()) {
-            startShowAnimation();
-        }
-        else if (!inActivationZone && !overDock && !m_isHidden) {
-            startHideAnimation();
-        }
+void DockAnimationManager::onActivationZoneLeft()
+{
+    if (!m_dock) {
+        return;
     }
-    else {
-        // Если курсор не на целевом экране, скрываем док
-        if (!m_isHidden) {
-            startHideAnimation();
-        }
+
+    // Курсор покинул зону активации и док (в том числе ушел на другой экран)
+    if (!m_isHidden) {
+        startHideAnimation();
     }
 }
 
@@ -154,95 +174,17 @@ void DockAnimationManager::onHideAnimationFinished()
 
 bool DockAnimationManager::isFullScreenAppActive() const
 {
-#ifdef Q_OS_WIN
-    HWND hwnd = GetForegroundWindow();
-    if (!hwnd) {
-        return false;
-    }
-
-    // Проверяем, является ли окно видимым и не свернутым
-    if (!IsWindowVisible(hwnd) || IsIconic(hwnd)) {
-        return false;
-    }
+    DockTelemetry::ScopedTimer telemetryTimer("DockAnimationManager::isFullScreenAppActive");
 
-    // Получаем стили окна
-    LONG style = GetWindowLong(hwnd, GWL_STYLE);
-    LONG exStyle = GetWindowLong(hwnd, GWL_EXSTYLE);
-
-    // Проверяем, является ли окно настоящим полноэкранным приложением
-    bool isRealFullScreen = (!(style & WS_CAPTION) && !(style & WS_THICKFRAME));
-
-    // Дополнительная проверка для полноэкранных приложений
-    if ((style & WS_POPUP) && !(exStyle & WS_EX_WINDOWEDGE)) {
-        isRealFullScreen = true;
-    }
-
-    // Если это не настоящее полноэкранное приложение, не скрываем док
-    if (!isRealFullScreen) {
-        return false;
+    // Состояние активного окна кэшируется и обновляется по событиям WinEvent,
+    // поэтому здесь только сравнение геометрии с экраном
+    QScreen* targetScreen = m_dock->getTargetScreen();
+    if (!targetScreen) {
+        targetScreen = QGuiApplication::primaryScreen();
     }
-
-    // Исключаем системные окна (включая рабочий стол) заранее
-    const int bufferSize = 256;
-    WCHAR className[bufferSize];
-    GetClassName(hwnd, className, bufferSize);
-    QString classStr = QString::fromWCharArray(className);
-
-    if (classStr == "Progman" || classStr == "WorkerW" ||
-        classStr == "Shell_TrayWnd" || classStr == "Button") {
+    if (!targetScreen) {
         return false;
     }
 
-    // Проверяем, покрывает ли окно весь экран
-    RECT windowRect;
-    GetWindowRect(hwnd, &windowRect);
-
-    QScreen* targetScreen = m_dock->getTargetScreen();
-    QRect screenGeometry = targetScreen ? targetScreen->geometry() : QGuiApplication::primaryScreen()->geometry();
-    QRect windowGeometry(windowRect.left, windowRect.top,
-                         windowRect.right - windowRect.left,
-                         windowRect.bottom - windowRect.top);
-
-    // Если окно покрывает весь экран или почти весь экран
-    int tolerance = 5;
-    bool coversScreen =
-        (windowGeometry.left() <= screenGeometry.left() + tolerance) &&
-        (windowGeometry.top() <= screenGeometry.top() + tolerance) &&
-        (windowGeometry.right() >= screenGeometry.right() - tolerance) &&
-        (windowGeometry.bottom() >= screenGeometry.bottom() - tolerance);
-
-    if (coversScreen) {
-        // Получаем ID процесса
-        DWORD processId;
-        GetWindowThreadProcessId(hwnd, &processId);
-
-        // Открываем процесс
-        HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
-        if (hProcess) {
-            WCHAR exePath[MAX_PATH];
-            if (GetModuleFileNameEx(hProcess, nullptr, exePath, MAX_PATH)) {
-                QString executableName = QFileInfo(QString::fromWCharArray(exePath)).fileName().toLower();
-                CloseHandle(hProcess);
-
-                // Проверяем список полноэкранных приложений
-                // Чтобы скрывать док для всех полноэкранных приложений, а не только из списка,
-                // возвращаем true независимо от списка. Если нужно использовать список как whitelist,
-                // раскомментируйте следующую строку и закомментируйте return true ниже.
-                // if (m_dock->getFullScreenApps().contains(executableName)) {
-                    return true;
-                // }
-                // return false; // Если не в списке, не скрываем
-            } else {
-                CloseHandle(hProcess);
-                // Если не удалось получить имя, не скрываем
-                return false;
-            }
-        } else {
-            // Если не удалось открыть процесс, не скрываем
-            return false;
-        }
-    }
-
-#endif
-    return false;
+    return ForegroundWindowTracker::instance().isFullScreenOn(targetScreen->geometry());
 }
\ No newline at end of file
@@ -13,6 +13,7 @@
 #endif
 
 class Dock;
+class DockActivationZone;
 
 class DockAnimationManager : public QObject
 {
@@ -28,8 +29,13 @@ public:
     void stopAnimations();
     bool shouldShowDock() const;
 
+    // Пересчитать зону активации после изменения геометрии дока
+    void updateActivationZone();
+    DockActivationZone* activationZoneService() const { return m_activationZone; }
+
 private slots:
-    void checkAutoHide();
+    void onActivationZoneEntered();
+    void onActivationZoneLeft();
     void onShowAnimationFinished();
     void onHideAnimationFinished();
 
@@ -37,7 +43,7 @@ private:
     Dock* m_dock;
     QPropertyAnimation* m_hideAnimation;
     QPropertyAnimation* m_showAnimation;
-    QTimer* m_autoHideTimer;
+    DockActivationZone* m_activationZone;
     bool m_isHidden;
 
     bool isFullScreenAppActive() const;
@@ -59,5 +59,12 @@ namespace DockConstants {
     const int AUTO_HIDE_CHECK_INTERVAL = 100; // Интервал проверки автоскрытия (мс)
     const int ACTIVATION_BOTTOM_FIX = 20;
     const int ACTIVATION_BOTTOM_SPACING = 100;
+    const int EDGE_TRIGGER_HEIGHT = 2; // Высота краевого окна-триггера у нижнего края (px)
+    const int ACTIVATION_NEAR_DISTANCE = 150; // Расстояние до зоны, при котором опрос идет с частотой AUTO_HIDE_CHECK_INTERVAL (px)
+    const int ACTIVATION_POLL_MAX_INTERVAL = 2000; // Максимальный интервал адаптивного опроса курсора (мс)
+    const int EDGE_TRIGGER_FULLSCREEN_CHECK_DELAY = 100; // Задержка проверки полноэкранного окна после событий активного окна (мс)
+
+    // Телеметрия
+    const int TELEMETRY_OVERLAY_REFRESH_INTERVAL = 1000; // Интервал обновления оверлея телеметрии (мс)
 }
 #endif // DOCKCONSTANTS_H
\ No newline at end of file
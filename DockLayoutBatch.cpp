@@ -0,0 +1,86 @@
+#include "DockLayoutBatch.h"
+
+#include <QDebug>
+#include <QEvent>
+#include <QLayout>
+#include <QWidget>
+
+DockLayoutBatch::DockLayoutBatch(QObject* parent)
+    : QObject(parent)
+    , m_depth(0)
+    , m_pendingMutations(0)
+    , m_layoutPassCount(0)
+    , m_layoutPassCounted(false)
+{
+}
+
+void DockLayoutBatch::setContainer(QWidget* container)
+{
+    if (m_container) {
+        m_container->removeEventFilter(this);
+    }
+    m_container = container;
+    if (m_container) {
+        m_container->installEventFilter(this);
+    }
+}
+
+bool DockLayoutBatch::begin()
+{
+    if (m_depth++ > 0) {
+        return false;
+    }
+
+    m_pendingMutations = 0;
+
+    if (m_container) {
+        if (QLayout* layout = m_container->layout()) {
+            layout->setEnabled(false);
+        }
+    }
+    return true;
+}
+
+bool DockLayoutBatch::commit()
+{
+    if (m_depth == 0) {
+        qDebug() << "DockLayoutBatch::commit called without begin";
+        return false;
+    }
+
+    if (--m_depth > 0) {
+        return false;
+    }
+
+    if (m_container) {
+        if (QLayout* layout = m_container->layout()) {
+            layout->setEnabled(true);
+            // Один проход layout для всех накопленных изменений
+            if (m_pendingMutations > 0) {
+                layout->activate();
+                ++m_layoutPassCount;
+                m_layoutPassCounted = true;
+                // Запрос layout, отправленный во время пакета, стоит в очереди перед
+                // этим вызовом; если его не было, отметка снимается здесь
+                QMetaObject::invokeMethod(this, [this]() {
+                    m_layoutPassCounted = false;
+                }, Qt::QueuedConnection);
+            }
+        }
+    }
+
+    m_pendingMutations = 0;
+    return true;
+}
+
+bool DockLayoutBatch::eventFilter(QObject* obj, QEvent* event)
+{
+    if (event->type() == QEvent::LayoutRequest && obj == m_container) {
+        if (m_layoutPassCounted) {
+            m_layoutPassCounted = false;
+        } else {
+            ++m_layoutPassCount;
+        }
+    }
+    return QObject::eventFilter(obj, event);
+}
@@ -0,0 +1,51 @@
+#ifndef DOCKLAYOUTBATCH_H
+#define DOCKLAYOUTBATCH_H
+
+#include <QObject>
+#include <QPointer>
+
+class QWidget;
+
+// Пакетное изменение layout контейнера иконок дока.
+// Между begin() и commit() layout контейнера выключен, вставки и удаления
+// только отмечаются (addMutation); внешний commit() выполняет один проход
+// layout на все изменения. Вызовы могут быть вложенными.
+// Проходы layout считаются по событиям LayoutRequest контейнера. Запрос,
+// отправленный во время пакета, приходит уже после прохода в commit(), -
+// он пропускается при подсчете, но не удаляется из очереди: вместе с ним
+// обрабатываются и другие запросы к контейнеру.
+class DockLayoutBatch : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DockLayoutBatch(QObject* parent = nullptr);
+
+    void setContainer(QWidget* container);
+    QWidget* container() const { return m_container; }
+
+    // true - начат внешний пакет
+    bool begin();
+    // true - завершен внешний пакет (layout уже пересчитан)
+    bool commit();
+    bool isActive() const { return m_depth > 0; }
+
+    void addMutation() { ++m_pendingMutations; }
+    int pendingMutations() const { return m_pendingMutations; }
+
+    // Счетчик для оценки стоимости обновлений
+    int layoutPassCount() const { return m_layoutPassCount; }
+
+protected:
+    bool eventFilter(QObject* obj, QEvent* event) override;
+
+private:
+    QPointer<QWidget> m_container;
+    int m_depth;
+    int m_pendingMutations;
+    int m_layoutPassCount;
+    // Проход уже посчитан в commit() - ближайший LayoutRequest его не повторяет
+    bool m_layoutPassCounted;
+};
+
+#endif // DOCKLAYOUTBATCH_H
@@ -0,0 +1,247 @@
+#include "DockTelemetry.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QTimer>
+#include <algorithm>
+
+bool DockTelemetry::s_enabled = false;
+
+void TelemetryHistogram::record(quint64 us)
+{
+    int bucket = 0;
+    quint64 value = us;
+    while (value > 1 && bucket < BUCKET_COUNT - 1) {
+        value >>= 1;
+        ++bucket;
+    }
+
+    ++buckets[bucket];
+    ++count;
+    totalUs += us;
+    maxUs = qMax(maxUs, us);
+}
+
+quint64 TelemetryHistogram::percentile(double p) const
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    quint64 target = quint64(p * count);
+    if (target >= count) {
+        target = count - 1;
+    }
+
+    quint64 seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i];
+        if (seen > target) {
+            return qMin(quint64(1) << (i + 1), maxUs);
+        }
+    }
+    return maxUs;
+}
+
+void TelemetryHistogram::merge(const TelemetryHistogram& other)
+{
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    totalUs += other.totalUs;
+    maxUs = qMax(maxUs, other.maxUs);
+}
+
+DockTelemetry& DockTelemetry::instance()
+{
+    static DockTelemetry telemetry;
+    return telemetry;
+}
+
+DockTelemetry::DockTelemetry()
+    : QObject(nullptr)
+    , m_dumpTimer(nullptr)
+    , m_dumpInterval(DEFAULT_DUMP_INTERVAL)
+{
+    QSettings settings("MyCompany", "DockApp");
+    m_dumpInterval = settings.value("Telemetry/DumpInterval", DEFAULT_DUMP_INTERVAL).toInt();
+
+    m_dumpTimer = new QTimer(this);
+    connect(m_dumpTimer, &QTimer::timeout, this, [this]() {
+        dumpToFile();
+    });
+
+    setEnabled(settings.value("Telemetry/Enabled", false).toBool(), false);
+}
+
+void DockTelemetry::setEnabled(bool enabled, bool persist)
+{
+    if (s_enabled == enabled) {
+        return;
+    }
+
+    s_enabled = enabled;
+
+    if (enabled) {
+        reset();
+        // Периодическая выгрузка включается только вместе с телеметрией
+        if (m_dumpInterval > 0) {
+            m_dumpTimer->start(m_dumpInterval);
+        }
+    } else {
+        m_dumpTimer->stop();
+    }
+
+    if (persist) {
+        QSettings settings("MyCompany", "DockApp");
+        settings.setValue("Telemetry/Enabled", enabled);
+    }
+
+    qDebug() << "Dock telemetry" << (enabled ? "enabled" : "disabled");
+    emit enabledChanged(enabled);
+}
+
+void DockTelemetry::reset()
+{
+    m_wakeups.clear();
+    m_histograms.clear();
+    m_sessionTimer.start();
+}
+
+void DockTelemetry::addWakeup(const char* source)
+{
+    ++m_wakeups[source];
+}
+
+void DockTelemetry::addDuration(const char* name, quint64 us)
+{
+    m_histograms[name].record(us);
+}
+
+QHash<QString, quint64> DockTelemetry::mergedWakeups() const
+{
+    QHash<QString, quint64> result;
+    for (auto it = m_wakeups.constBegin(); it != m_wakeups.constEnd(); ++it) {
+        result[QString::fromLatin1(it.key())] += it.value();
+    }
+    return result;
+}
+
+QHash<QString, TelemetryHistogram> DockTelemetry::mergedHistograms() const
+{
+    QHash<QString, TelemetryHistogram> result;
+    for (auto it = m_histograms.constBegin(); it != m_histograms.constEnd(); ++it) {
+        result[QString::fromLatin1(it.key())].merge(it.value());
+    }
+    return result;
+}
+
+QJsonObject DockTelemetry::toJson() const
+{
+    const double minutes = qMax<qint64>(m_sessionTimer.isValid() ? m_sessionTimer.elapsed() : 0, 1) / 60000.0;
+
+    QJsonObject wakeups;
+    const QHash<QString, quint64> mergedWakeupCounts = mergedWakeups();
+    for (auto it = mergedWakeupCounts.constBegin(); it != mergedWakeupCounts.constEnd(); ++it) {
+        QJsonObject entry;
+        entry["count"] = double(it.value());
+        entry["perMinute"] = it.value() / minutes;
+        wakeups[it.key()] = entry;
+    }
+
+    QJsonObject timings;
+    const QHash<QString, TelemetryHistogram> histograms = mergedHistograms();
+    for (auto it = histograms.constBegin(); it != histograms.constEnd(); ++it) {
+        const TelemetryHistogram& histogram = it.value();
+
+        QJsonArray buckets;
+        for (int i = 0; i < TelemetryHistogram::BUCKET_COUNT; ++i) {
+            buckets.append(double(histogram.buckets[i]));
+        }
+
+        QJsonObject entry;
+        entry["count"] = double(histogram.count);
+        entry["totalUs"] = double(histogram.totalUs);
+        entry["meanUs"] = histogram.count ? double(histogram.totalUs) / histogram.count : 0.0;
+        entry["p50Us"] = double(histogram.percentile(0.5));
+        entry["p95Us"] = double(histogram.percentile(0.95));
+        entry["maxUs"] = double(histogram.maxUs);
+        entry["log2Buckets"] = buckets;
+        timings[it.key()] = entry;
+    }
+
+    QJsonObject root;
+    root["sessionMs"] = double(m_sessionTimer.isValid() ? m_sessionTimer.elapsed() : 0);
+    root["wakeups"] = wakeups;
+    root["timings"] = timings;
+    return root;
+}
+
+QString DockTelemetry::summaryText() const
+{
+    const double minutes = qMax<qint64>(m_sessionTimer.isValid() ? m_sessionTimer.elapsed() : 0, 1) / 60000.0;
+
+    QStringList lines;
+    lines << QString("Телеметрия дока (%1 c)").arg(m_sessionTimer.isValid() ? m_sessionTimer.elapsed() / 1000 : 0);
+
+    // Источники пробуждений - по убыванию частоты
+    const QHash<QString, quint64> wakeups = mergedWakeups();
+    QList<QString> sources = wakeups.keys();
+    std::sort(sources.begin(), sources.end(), [&wakeups](const QString& a, const QString& b) {
+        return wakeups.value(a) > wakeups.value(b);
+    });
+
+    lines << QString() << "Пробуждения таймеров:";
+    for (const QString& source : sources) {
+        lines << QString("  %1: %2 (%3/мин)")
+                     .arg(source)
+                     .arg(wakeups.value(source))
+                     .arg(wakeups.value(source) / minutes, 0, 'f', 1);
+    }
+
+    const QHash<QString, TelemetryHistogram> histograms = mergedHistograms();
+    QList<QString> names = histograms.keys();
+    std::sort(names.begin(), names.end());
+
+    lines << QString() << "Время выполнения (мкс):";
+    for (const QString& name : names) {
+        const TelemetryHistogram& histogram = histograms[name];
+        lines << QString("  %1: n=%2 p50=%3 p95=%4 max=%5 всего=%6 мс")
+                     .arg(name)
+                     .arg(histogram.count)
+                     .arg(histogram.percentile(0.5))
+                     .arg(histogram.percentile(0.95))
+                     .arg(histogram.maxUs)
+                     .arg(histogram.totalUs / 1000);
+    }
+
+    return lines.join('\n');
+}
+
+QString DockTelemetry::defaultDumpPath() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/dock_telemetry.json";
+}
+
+bool DockTelemetry::dumpToFile(const QString& path) const
+{
+    QString filePath = path.isEmpty() ? defaultDumpPath() : path;
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Failed to write telemetry dump:" << filePath;
+        return false;
+    }
+
+    file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+    return true;
+}
@@ -0,0 +1,123 @@
+#ifndef DOCKTELEMETRY_H
+#define DOCKTELEMETRY_H
+
+#include <QObject>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QString>
+
+class QTimer;
+
+// Гистограмма длительностей с логарифмическими корзинами (по степеням двойки в мкс).
+// Запись - O(1) без выделения памяти
+struct TelemetryHistogram {
+    static const int BUCKET_COUNT = 24; // До ~8 секунд
+
+    quint64 buckets[BUCKET_COUNT] = {};
+    quint64 count = 0;
+    quint64 totalUs = 0;
+    quint64 maxUs = 0;
+
+    void record(quint64 us);
+    // Оценка перцентиля (верхняя граница корзины), мкс
+    quint64 percentile(double p) const;
+    void merge(const TelemetryHistogram& other);
+};
+
+// Сервис телеметрии дока: пробуждения таймеров по источникам и время
+// обновления списка приложений, отрисовки и поиска. По умолчанию выключен,
+// в выключенном состоянии каждая точка измерения - одна проверка флага.
+// Источники идентифицируются строковыми литералами.
+// Запись (countWakeup, recordDuration, ScopedTimer) - только из потока GUI:
+// счетчики не защищены блокировкой. Фоновые задачи возвращают длительность
+// в результате, и она записывается в обработчике завершения.
+class DockTelemetry : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Интервал выгрузки телеметрии в JSON (мс)
+    static inline const int DEFAULT_DUMP_INTERVAL = 60000;
+
+    static DockTelemetry& instance();
+
+    static bool isEnabled() { return s_enabled; }
+    // persist - сохранить состояние в настройках (включится при следующем запуске)
+    void setEnabled(bool enabled, bool persist = true);
+
+    // Пробуждение таймера (вызов слота по таймеру)
+    static void countWakeup(const char* source)
+    {
+        if (s_enabled) {
+            instance().addWakeup(source);
+        }
+    }
+
+    static void recordDuration(const char* name, quint64 us)
+    {
+        if (s_enabled) {
+            instance().addDuration(name, us);
+        }
+    }
+
+    // Замер времени выполнения блока
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(const char* name)
+            : m_name(name)
+            , m_active(s_enabled)
+        {
+            if (m_active) {
+                m_timer.start();
+            }
+        }
+
+        ~ScopedTimer()
+        {
+            if (m_active) {
+                DockTelemetry::recordDuration(m_name, quint64(m_timer.nsecsElapsed() / 1000));
+            }
+        }
+
+    private:
+        const char* m_name;
+        bool m_active;
+        QElapsedTimer m_timer;
+    };
+
+    void reset();
+
+    QJsonObject toJson() const;
+    QString summaryText() const;
+
+    // Запись снимка в JSON. Пустой путь - файл по умолчанию в AppDataLocation
+    bool dumpToFile(const QString& path = QString()) const;
+    QString defaultDumpPath() const;
+
+signals:
+    void enabledChanged(bool enabled);
+
+private:
+    DockTelemetry();
+    ~DockTelemetry() = default;
+
+    void addWakeup(const char* source);
+    void addDuration(const char* name, quint64 us);
+
+    // Одинаковые литералы из разных единиц трансляции могут иметь разные адреса -
+    // при выводе данные объединяются по имени
+    QHash<QString, quint64> mergedWakeups() const;
+    QHash<QString, TelemetryHistogram> mergedHistograms() const;
+
+    QHash<const char*, quint64> m_wakeups;
+    QHash<const char*, TelemetryHistogram> m_histograms;
+    QElapsedTimer m_sessionTimer;
+    QTimer* m_dumpTimer;
+    int m_dumpInterval;
+
+    static bool s_enabled;
+};
+
+#endif // DOCKTELEMETRY_H
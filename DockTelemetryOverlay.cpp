@@ -0,0 +1,150 @@
+#include "DockTelemetryOverlay.h"
+#include "DockTelemetry.h"
+#include "DockConstants.h"
+
+#include <QApplication>
+#include <QDebug>
+#include <QLabel>
+#include <QMouseEvent>
+#include <QScreen>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#ifdef Q_OS_WIN
+namespace {
+    const int TOGGLE_HOTKEY_ID = 0x7E01;
+    const int DUMP_HOTKEY_ID = 0x7E02;
+}
+#endif
+
+DockTelemetryOverlay* DockTelemetryOverlay::instance()
+{
+    static DockTelemetryOverlay* overlay = new DockTelemetryOverlay();
+    return overlay;
+}
+
+DockTelemetryOverlay::DockTelemetryOverlay(QWidget* parent)
+    : QWidget(parent)
+    , m_label(nullptr)
+    , m_refreshTimer(nullptr)
+    , m_enabledTelemetry(false)
+{
+    setWindowFlags(Qt::FramelessWindowHint | Qt::Tool | Qt::WindowStaysOnTopHint | Qt::WindowDoesNotAcceptFocus);
+    setAttribute(Qt::WA_ShowWithoutActivating);
+    setStyleSheet("background-color: rgba(20, 20, 20, 220);");
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(12, 12, 12, 12);
+
+    m_label = new QLabel(this);
+    m_label->setStyleSheet("color: white; font-family: Consolas, monospace; font-size: 11px; background: transparent;");
+    m_label->setTextFormat(Qt::PlainText);
+    layout->addWidget(m_label);
+
+    m_refreshTimer = new QTimer(this);
+    connect(m_refreshTimer, &QTimer::timeout, this, &DockTelemetryOverlay::refresh);
+
+    hide();
+
+#ifdef Q_OS_WIN
+    registerHotkeys();
+#endif
+}
+
+DockTelemetryOverlay::~DockTelemetryOverlay()
+{
+#ifdef Q_OS_WIN
+    unregisterHotkeys();
+#endif
+}
+
+void DockTelemetryOverlay::toggleVisibility()
+{
+    if (isVisible()) {
+        hide();
+        return;
+    }
+
+    // Телеметрия только на время показа оверлея. Включенная в настройках
+    // (Telemetry/Enabled) продолжает работать и после скрытия
+    if (!DockTelemetry::isEnabled()) {
+        DockTelemetry::instance().setEnabled(true, false);
+        m_enabledTelemetry = true;
+    }
+    show();
+}
+
+void DockTelemetryOverlay::refresh()
+{
+    m_label->setText(DockTelemetry::instance().summaryText());
+    adjustSize();
+
+    // Левый верхний угол основного экрана
+    if (QScreen* screen = QApplication::primaryScreen()) {
+        move(screen->availableGeometry().topLeft() + QPoint(20, 20));
+    }
+}
+
+void DockTelemetryOverlay::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_refreshTimer->start(DockConstants::TELEMETRY_OVERLAY_REFRESH_INTERVAL);
+}
+
+void DockTelemetryOverlay::hideEvent(QHideEvent* event)
+{
+    QWidget::hideEvent(event);
+    m_refreshTimer->stop();
+
+    if (m_enabledTelemetry) {
+        m_enabledTelemetry = false;
+        DockTelemetry::instance().setEnabled(false, false);
+    }
+}
+
+void DockTelemetryOverlay::mousePressEvent(QMouseEvent* event)
+{
+    Q_UNUSED(event)
+    hide();
+}
+
+#ifdef Q_OS_WIN
+void DockTelemetryOverlay::registerHotkeys()
+{
+    HWND hwnd = (HWND)winId();
+    if (!RegisterHotKey(hwnd, TOGGLE_HOTKEY_ID, MOD_CONTROL | MOD_ALT | MOD_SHIFT, 'T')) {
+        qDebug() << "Failed to register telemetry overlay hotkey. Error:" << GetLastError();
+    }
+    if (!RegisterHotKey(hwnd, DUMP_HOTKEY_ID, MOD_CONTROL | MOD_ALT | MOD_SHIFT, 'D')) {
+        qDebug() << "Failed to register telemetry dump hotkey. Error:" << GetLastError();
+    }
+}
+
+void DockTelemetryOverlay::unregisterHotkeys()
+{
+    UnregisterHotKey((HWND)winId(), TOGGLE_HOTKEY_ID);
+    UnregisterHotKey((HWND)winId(), DUMP_HOTKEY_ID);
+}
+
+bool DockTelemetryOverlay::nativeEvent(const QByteArray& eventType, void* message, qintptr* result)
+{
+    MSG* msg = static_cast<MSG*>(message);
+    if (msg->message == WM_HOTKEY) {
+        if (msg->wParam == TOGGLE_HOTKEY_ID) {
+            toggleVisibility();
+            *result = 1;
+            return true;
+        }
+        if (msg->wParam == DUMP_HOTKEY_ID) {
+            DockTelemetry& telemetry = DockTelemetry::instance();
+            if (telemetry.isEnabled() && telemetry.dumpToFile()) {
+                qDebug() << "Telemetry dumped to" << telemetry.defaultDumpPath();
+            }
+            *result = 1;
+            return true;
+        }
+    }
+    return QWidget::nativeEvent(eventType, message, result);
+}
+#endif
@@ -0,0 +1,53 @@
+#ifndef DOCKTELEMETRYOVERLAY_H
+#define DOCKTELEMETRYOVERLAY_H
+
+#include <QWidget>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+class QLabel;
+class QTimer;
+
+// Оверлей телеметрии дока. Показывается по горячей клавише Ctrl+Alt+Shift+T
+// (включает телеметрию, если она выключена), Ctrl+Alt+Shift+D - выгрузка снимка в JSON.
+// Включенная оверлеем телеметрия не сохраняется в настройках и выключается
+// при его скрытии.
+// Пока оверлей скрыт, его таймер обновления остановлен. Существует в одном экземпляре
+// на приложение, чтобы горячие клавиши регистрировались один раз для всех доков.
+class DockTelemetryOverlay : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static DockTelemetryOverlay* instance();
+    ~DockTelemetryOverlay();
+
+    void toggleVisibility();
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+#ifdef Q_OS_WIN
+    bool nativeEvent(const QByteArray& eventType, void* message, qintptr* result) override;
+#endif
+
+private slots:
+    void refresh();
+
+private:
+    explicit DockTelemetryOverlay(QWidget* parent = nullptr);
+
+#ifdef Q_OS_WIN
+    void registerHotkeys();
+    void unregisterHotkeys();
+#endif
+
+    QLabel* m_label;
+    QTimer* m_refreshTimer;
+    bool m_enabledTelemetry;
+};
+
+#endif // DOCKTELEMETRYOVERLAY_H
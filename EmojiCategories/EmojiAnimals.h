@@ -1,125 +0,0 @@
-#ifndef EMOJIANIMALS_H
-#define EMOJIANIMALS_H
-
-#include "../EmojiList.h"
-
-static const QList<EmojiData> emojiAnimals = {
-    {"🐵", {"обезьяна", "животное"}},
-    {"🐒", {"обезьяна", "животное"}},
-    {"🦍", {"горилла", "обезьяна", "животное"}},
-    {"🦧", {"орангутан", "обезьяна", "животное"}},
-    {"🐶", {"собака", "питомец", "щенок"}},
-    {"🐕", {"собака", "животное"}},
-    {"🦮", {"поводырь", "собака", "помощь"}},
-    {"🐕‍🦺", {"служебная", "собака", "помощь"}},
-    {"🐩", {"пудель", "собака", "порода"}},
-    {"🐺", {"волк", "дикое", "животное"}},
-    {"🦊", {"лиса", "хитрый", "животное"}},
-    {"🦝", {"енот", "животное"}},
-    {"🐱", {"кот", "кошка", "котенок"}},
-    {"🐈", {"кот", "кошка"}},
-    {"🐈‍⬛", {"черный", "кот", "кошка"}},
-    {"🦁", {"лев", "царь", "зверей"}},
-    {"🐯", {"тигр", "дикое", "животное"}},
-    {"🐅", {"тигр", "дикое", "животное"}},
-    {"🐆", {"леопард", "пантера", "животное"}},
-    {"🐴", {"лошадь", "животное"}},
-    {"🐎", {"лошадь", "скачка", "животное"}},
-    {"🦄", {"единорог", "волшебный", "мифический"}},
-    {"🦓", {"зебра", "полоски", "животное"}},
-    {"🦌", {"олень", "рога", "животное"}},
-    {"🦬", {"бизон", "буйвол", "животное"}},
-    {"🐃", {"буйвол", "животное"}},
-    {"🐂", {"вол", "бык", "животное"}},
-    {"🐄", {"корова", "животное", "молоко"}},
-    {"🐷", {"свинья", "животное"}},
-    {"🐖", {"свинья", "животное"}},
-    {"🐗", {"кабан", "дикий", "животное"}},
-    {"🐽", {"нос", "свинья"}},
-    {"🐏", {"баран", "овца", "животное"}},
-    {"🐑", {"овца", "животное"}},
-    {"🐐", {"коза", "животное"}},
-    {"🐪", {"верблюд", "пустыня", "животное"}},
-    {"🐫", {"верблюд", "горбы", "животное"}},
-    {"🦙", {"лама", "альпака", "животное"}},
-    {"🦒", {"жираф", "шея", "животное"}},
-    {"🐘", {"слон", "хобот", "животное"}},
-    {"🦣", {"мамонт", "древний", "животное"}},
-    {"🦏", {"носорог", "рог", "животное"}},
-    {"🦛", {"бегемот", "животное"}},
-    {"🐭", {"мышь", "грызун"}},
-    {"🐁", {"мышь", "грызун"}},
-    {"🐀", {"крыса", "грызун"}},
-    {"🐹", {"хомяк", "грызун"}},
-    {"🐰", {"кролик", "заяц"}},
-    {"🐇", {"кролик", "заяц"}},
-    {"🐿️", {"белка", "грызун"}},
-    {"🦫", {"бобр", "грызун"}},
-    {"🦦", {"выдра", "животное"}},
-    {"🦇", {"летучая", "мышь", "вампир"}},
-    {"🐻", {"медведь", "животное"}},
-    {"🐻‍❄️", {"полярный", "медведь", "животное"}},
-    {"🐨", {"коала", "животное", "австралия"}},
-    {"🐼", {"панда", "животное", "китай"}},
-    {"🦥", {"ленивец", "медленный", "животное"}},
-    {"🦨", {"скунс", "животное"}},
-    {"🦘", {"кенгуру", "австралия", "животное"}},
-    {"🦡", {"барсук", "животное"}},
-    {"🐾", {"следы", "лапы", "животные"}},
-    {"🦃", {"индейка", "птица"}},
-    {"🐔", {"курица", "птица"}},
-    {"🐓", {"петух", "птица"}},
-    {"🐣", {"цыпленок", "яйцо", "рождение"}},
-    {"🐤", {"цыпленок", "птица"}},
-    {"🐥", {"цыпленок", "перед", "птица"}},
-    {"🐦", {"птица", "животное"}},
-    {"🐧", {"пингвин", "птица", "антарктида"}},
-    {"🕊️", {"голубь", "мир", "птица"}},
-    {"🦅", {"орел", "птица", "хищник"}},
-    {"🦆", {"утка", "птица"}},
-    {"🦢", {"лебедь", "птица", "красота"}},
-    {"🦉", {"сова", "мудрость", "птица"}},
-    {"🦤", {"додо", "вымерший", "птица"}},
-    {"🪶", {"перо", "птица"}},
-    {"🦩", {"фламинго", "птица"}},
-    {"🦚", {"павлин", "птица", "красота"}},
-    {"🦜", {"попугай", "птица", "говорун"}},
-    {"🪽", {" крыло", "птица", "полет"}},
-    {"🪿", {"гусь", "птица"}},
-    {"🐸", {"лягушка", "животное"}},
-    {"🐊", {"крокодил", "аллигатор", "рептилия"}},
-    {"🐢", {"черепаха", "медленный", "рептилия"}},
-    {"🦎", {"ящерица", "рептилия"}},
-    {"🐍", {"змея", "рептилия", "опасность"}},
-    {"🐲", {"дракон", "мифический", "огонь"}},
-    {"🐉", {"дракон", "мифический"}},
-    {"🦕", {"динозавр", "древний", "животное"}},
-    {"🦖", {"тираннозавр", "динозавр"}},
-    {"🐳", {"кит", "океан", "животное"}},
-    {"🐋", {"кит", "океан", "животное"}},
-    {"🐬", {"дельфин", "океан", "животное"}},
-    {"🦭", {"тюлень", "океан", "животное"}},
-    {"🐟", {"рыба", "океан", "животное"}},
-    {"🐠", {"тропическая", "рыба", "океан"}},
-    {"🐡", {"рыба", "фугу", "океан"}},
-    {"🦈", {"акула", "океан", "опасность"}},
-    {"🐙", {"осьминог", "океан", "животное"}},
-    {"🐚", {"раковина", "море", "океан"}},
-    {"🪸", {"коралл", "риф", "океан"}},
-    {"🐌", {"улитка", "медленный", "животное"}},
-    {"🦋", {"бабочка", "насекомое", "красота"}},
-    {"🐛", {"гусеница", "насекомое"}},
-    {"🐜", {"муравей", "насекомое"}},
-    {"🪱", {"червь", "насекомое"}},
-    {"🐝", {"пчела", "мед", "насекомое"}},
-    {"🪲", {"жук", "насекомое"}},
-    {"🪳", {"таракан", "насекомое"}},
-    {"🦟", {"комар", "насекомое"}},
-    {"🦗", {"сверчок", "насекомое"}},
-    {"🪰", {"муха", "насекомое"}},
-    {"🕷️", {"паук", "насекомое"}},
-    {"🕸️", {"паутина", "паук"}},
-    {"🦂", {"скорпион", "опасность", "насекомое"}}
-};
-
-#endif // EMOJIANIMALS_H
\ No newline at end of file
@@ -1,109 +0,0 @@
-#ifndef EMOJIFOOD_H
-#define EMOJIFOOD_H
-
-#include "../EmojiList.h"
-
-static const QList<EmojiData> emojiFood = {
-    {"🍎", {"яблоко", "фрукт"}},
-    {"🍏", {"зеленое", "яблоко", "фрукт"}},
-    {"🍐", {"груша", "фрукт"}},
-    {"🍊", {"апельсин", "мандарин", "фрукт"}},
-    {"🍋", {"лимон", "фрукт", "кислый"}},
-    {"🍌", {"банан", "фрукт"}},
-    {"🍍", {"ананас", "фрукт"}},
-    {"🥭", {"манго", "фрукт"}},
-    {"🍓", {"клубника", "фрукт"}},
-    {"🫐", {"черника", "ягоды", "фрукт"}},
-    {"🥝", {"киви", "фрукт"}},
-    {"🍅", {"помидор", "овощ"}},
-    {"🫒", {"оливка", "овощ"}},
-    {"🍆", {"баклажан", "овощ"}},
-    {"🥑", {"авокадо", "фрукт"}},
-    {"🥦", {"брокколи", "овощ"}},
-    {"🥬", {"капуста", "овощ"}},
-    {"🥒", {"огурец", "овощ"}},
-    {"🌶️", {"перец", "острый", "овощ"}},
-    {"🫑", {"болгарский", "перец", "овощ"}},
-    {"🌽", {"кукуруза", "овощ"}},
-    {"🥕", {"морковь", "овощ"}},
-    {"🫚", {"имбирь", "овощ"}},
-    {"🫛", {"горох", "овощ"}},
-    {"🍄", {"гриб", "овощ"}},
-    {"🥜", {"арахис", "орех"}},
-    {"🌰", {"каштан", "орех"}},
-    {"🍞", {"хлеб", "еда"}},
-    {"🥐", {"круассан", "выпечка"}},
-    {"🥖", {"багет", "хлеб"}},
-    {"🫓", {"лепешка", "хлеб"}},
-    {"🥨", {"крендель", "выпечка"}},
-    {"🥯", {"бублик", "выпечка"}},
-    {"🥞", {"блины", "еда"}},
-    {"🧇", {"вафля", "еда"}},
-    {"🧀", {"сыр", "еда"}},
-    {"🍖", {"мясо", "еда"}},
-    {"🍗", {"ножка", "курица", "еда"}},
-    {"🥩", {"стейк", "мясо", "еда"}},
-    {"🥓", {"бекон", "мясо", "еда"}},
-    {"🍔", {"гамбургер", "еда", "фастфуд"}},
-    {"🍟", {"картофель", "фри", "еда"}},
-    {"🍕", {"пицца", "еда"}},
-    {"🌭", {"хотдог", "еда", "фастфуд"}},
-    {"🥪", {"сэндвич", "еда"}},
-    {"🌮", {"тако", "еда", "мексика"}},
-    {"🌯", {"буррито", "еда", "мексика"}},
-    {"🫔", {"тамале", "еда", "мексика"}},
-    {"🥗", {"салат", "еда", "здоровое"}},
-    {"🥘", {"сковорода", "еда"}},
-    {"🫕", {"фондю", "еда"}},
-    {"🥫", {"консервы", "еда"}},
-    {"🍝", {"спагетти", "паста", "еда"}},
-    {"🍜", {"лапша", "еда", "азия"}},
-    {"🍲", {"горшок", "еда", "суп"}},
-    {"🍛", {"карри", "еда", "азия"}},
-    {"🍣", {"суши", "еда", "япония"}},
-    {"🍱", {"бенто", "еда", "япония"}},
-    {"🍤", {"креветка", "еда", "морепродукты"}},
-    {"🍙", {"онигири", "еда", "япония"}},
-    {"🍚", {"рис", "еда"}},
-    {"🍘", {"рисовый", "крекер", "еда"}},
-    {"🍥", {"рыбный", "пирог", "еда"}},
-    {"🥮", {"лунный", "пирог", "еда"}},
-    {"🍡", {"данго", "еда", "япония"}},
-    {"🍢", {"оден", "еда", "япония"}},
-    {"🍧", {"мороженое", "десерт"}},
-    {"🍨", {"мороженое", "десерт"}},
-    {"🍦", {"мороженое", "рожок", "десерт"}},
-    {"🥧", {"пирог", "десерт"}},
-    {"🧁", {"капкейк", "десерт"}},
-    {"🎂", {"торт", "день", "рождения", "десерт"}},
-    {"🍰", {"торт", "десерт"}},
-    {"🍮", {"пудинг", "десерт"}},
-    {"🍭", {"леденец", "десерт"}},
-    {"🍬", {"конфета", "десерт"}},
-    {"🍫", {"шоколад", "десерт"}},
-    {"🍿", {"попкорн", "еда"}},
-    {"🍩", {"пончик", "десерт"}},
-    {"🍪", {"печенье", "десерт"}},
-    {"🍯", {"мед", "еда"}},
-    {"🥛", {"молоко", "напиток"}},
-    {"🫗", {"наливать", "напиток"}},
-    {"☕", {"кофе", "напиток"}},
-    {"🫖", {"чайник", "чай", "напиток"}},
-    {"🍵", {"чашка", "чай", "напиток"}},
-    {"🍶", {"саке", "напиток", "япония"}},
-    {"🍾", {"шампанское", "напиток", "алкоголь"}},
-    {"🍷", {"вино", "напиток", "алкоголь"}},
-    {"🍸", {"коктейль", "напиток", "алкоголь"}},
-    {"🍹", {"тропический", "коктейль", "напиток"}},
-    {"🍺", {"пиво", "напиток", "алкоголь"}},
-    {"🍻", {"бокалы", "пиво", "напиток"}},
-    {"🥂", {"бокалы", "тост", "напиток"}},
-    {"🥃", {"стакан", "виски", "напиток"}},
-    {"🥤", {"стакан", "сок", "напиток"}},
-    {"🧃", {"сок", "напиток"}},
-    {"🧋", {"бабл", "чай", "напиток"}},
-    {"🧉", {"мате", "напиток"}},
-    {"🧊", {"лед", "холодный"}}
-};
-
-#endif // EMOJIFOOD_H
\ No newline at end of file
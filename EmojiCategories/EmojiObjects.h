@@ -1,58 +0,0 @@
-#ifndef EMOJIOBJECTS_H
-#define EMOJIOBJECTS_H
-
-#include "../EmojiList.h"
-
-static const QList<EmojiData> emojiObjects = {
-    {"⌚", {"часы", "время", "наручные"}},
-    {"📱", {"телефон", "смартфон", "технологии"}},
-    {"💻", {"ноутбук", "компьютер", "работа"}},
-    {"🖥️", {"компьютер", "монитор", "работа"}},
-    {"🖨️", {"принтер", "печать", "офис"}},
-    {"🕹️", {"джойстик", "игра", "контроллер"}},
-    {"🎮", {"игра", "консоль", "развлечение"}},
-    {"📷", {"камера", "фото", "съемка"}},
-    {"🎥", {"видеокамера", "кино", "съемка"}},
-    {"📺", {"телевизор", "телевидение", "экран"}},
-    {"📻", {"радио", "музыка", "новости"}},
-    {"⏰", {"будильник", "время", "подъем"}},
-    {"⏱️", {"секундомер", "время", "спорт"}},
-    {"📡", {"антенна", "спутник", "сигнал"}},
-    {"💡", {"лампочка", "идея", "свет"}},
-    {"🔦", {"фонарик", "свет", "темнота"}},
-    {"🕯️", {"свеча", "свет", "романтика"}},
-    {"📔", {"тетрадь", "книга", "записи"}},
-    {"📕", {"книга", "учеба", "чтение"}},
-    {"📘", {"учебник", "знания", "синий"}},
-    {"📙", {"книга", "оранжевый", "чтение"}},
-    {"📚", {"книги", "библиотека", "учеба"}},
-    {"🔖", {"закладка", "чтение", "страница"}},
-    {"💰", {"деньги", "богатство", "монеты"}},
-    {"💎", {"бриллиант", "драгоценность", "блеск"}},
-    {"🎁", {"подарок", "сюрприз", "праздник"}},
-    {"✉️", {"письмо", "конверт", "сообщение"}},
-    {"📦", {"посылка", "коробка", "доставка"}},
-    {"🛍️", {"пакеты", "шопинг", "покупки"}},
-    {"📌", {"кнопка", "крепление", "объявление"}},
-    {"📍", {"метка", "локация", "карта"}},
-    {"🖼️", {"рамка", "картина", "фото"}},
-    {"🛏️", {"кровать", "спальня", "отдых"}},
-    {"🚪", {"дверь", "вход", "выход"}},
-    {"🚽", {"унитаз", "туалет", "санузел"}},
-    {"🚿", {"душ", "ванная", "вода"}},
-    {"🛁", {"ванна", "купание", "отдых"}},
-    {"💺", {"сиденье", "стул", "место"}},
-    {"🪑", {"стул", "мебель", "сиденье"}},
-    {"🔑", {"ключ", "замок", "безопасность"}},
-    {"🔨", {"молоток", "инструмент", "ремонт"}},
-    {"🪓", {"топор", "инструмент", "рубка"}},
-    {"⛏️", {"кирка", "инструмент", "шахта"}},
-    {"🔧", {"гаечный", "ключ", "инструмент"}},
-    {"🪛", {"отвертка", "инструмент", "ремонт"}},
-    {"🔩", {"болт", "гайка", "крепление"}},
-    {"⚙️", {"шестеренка", "механизм", "техника"}},
-    {"⛓️", {"цепи", "связь", "блокировка"}},
-    {"🧱", {"кирпич", "строительство", "стена"}}
-};
-
-#endif // EMOJIOBJECTS_H
\ No newline at end of file
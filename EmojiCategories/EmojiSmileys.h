@@ -1,119 +0,0 @@
-#ifndef EMOJISMILEYS_H
-#define EMOJISMILEYS_H
-
-#include "../EmojiList.h"
-
-static const QList<EmojiData> emojiSmileys = {
-    {"😃", {"радость", "счастье", "улыбка", "лицо", "смех"}},
-    {"😄", {"радость", "счастье", "улыбка", "лицо"}},
-    {"😁", {"радость", "счастье", "улыбка", "лицо"}},
-    {"😆", {"смех", "радость", "улыбка"}},
-    {"😅", {"нервный", "пот", "облегчение", "смех"}},
-    {"😂", {"слезы", "смех", "радость"}},
-    {"🤣", {"кататься", "смех", "ржать"}},
-    {"😊", {"счастливый", "довольный", "улыбка"}},
-    {"😇", {"ангел", "невинный", "ореол"}},
-    {"🙂", {"улыбка", "нейтральный", "лицо"}},
-    {"🙃", {"перевернутый", "шутка", "ирония"}},
-    {"😉", {"подмигивание", "флирт", "шутка"}},
-    {"😌", {"спокойный", "удовлетворенный", "облегчение"}},
-    {"😍", {"влюбленный", "сердце", "глаза"}},
-    {"🥰", {"любовь", "счастье", "сердца"}},
-    {"😘", {"воздушный", "поцелуй", "флирт"}},
-    {"😗", {"поцелуй", "губы"}},
-    {"😙", {"поцелуй", "улыбка", "губы"}},
-    {"😚", {"поцелуй", "закрытые", "глаза"}},
-    {"😋", {"вкусный", "еда", "язык"}},
-    {"😛", {"язык", "шутка", "глупость"}},
-    {"😝", {"язык", "прищур", "глупость"}},
-    {"😜", {"подмигивание", "язык", "шутка"}},
-    {"🤪", {"сумасшедший", "глупый", "безумный"}},
-    {"🤨", {"поднятая", "бровь", "скептический"}},
-    {"🧐", {"монокль", "исследование", "умный"}},
-    {"🤓", {"очки", "умный", "ботан"}},
-    {"😎", {"очки", "крутой", "уверенный"}},
-    {"🤩", {"звезды", "глаза", "восхищение"}},
-    {"🥳", {"вечеринка", "праздник", "конфетти"}},
-    {"😏", {"ухмылка", "хитрый", "самодовольный"}},
-    {"😒", {"недовольный", "скука", "равнодушие"}},
-    {"😞", {"разочарованный", "грустный"}},
-    {"😔", {"грустный", "задумчивый"}},
-    {"😟", {"обеспокоенный", "тревога"}},
-    {"😕", {"растерянный", "непонимание"}},
-    {"🙁", {"легкая", "грусть", "недовольство"}},
-    {"☹️", {"грусть", "недовольство", "лицо"}},
-    {"😣", {"страдание", "боль", "усталость"}},
-    {"😖", {"смятение", "расстройство"}},
-    {"😫", {"усталый", "изнуренный"}},
-    {"😩", {"усталый", "измученный"}},
-    {"🥺", {"умоляющий", "щенячьи", "глаза"}},
-    {"😢", {"плач", "слезы", "грусть"}},
-    {"😭", {"горький", "плач", "слезы"}},
-    {"😤", {"триумф", "гордость", "нос"}},
-    {"😠", {"сердитый", "злой"}},
-    {"😡", {"раздраженный", "злой", "красный"}},
-    {"🤬", {"ругательство", "злой", "символы"}},
-    {"🤯", {"взрыв", "головы", "потрясение"}},
-    {"😳", {"смущение", "красный", "румянец"}},
-    {"🥵", {"жарко", "пот", "температура"}},
-    {"🥶", {"холодно", "замерзший", "лед"}},
-    {"😱", {"крик", "страх", "ужас"}},
-    {"😨", {"испуганный", "страх", "пот"}},
-    {"😰", {"тревога", "пот", "нервы"}},
-    {"😥", {"облегчение", "грусть", "пот"}},
-    {"😓", {"напряжение", "пот", "стресс"}},
-    {"🤗", {"объятия", "поддержка", "любовь"}},
-    {"🤔", {"размышление", "мышление", "вопрос"}},
-    {"🤭", {"рука", "рот", "смущение"}},
-    {"🤫", {"тишина", "секрет", "шепот"}},
-    {"🤥", {"ложь", "нос", "пиноккио"}},
-    {"😶", {"без", "слов", "молчание"}},
-    {"😐", {"нейтральный", "без", "эмоций"}},
-    {"😑", {"безразличный", "равнодушный"}},
-    {"😬", {"гримаса", "боль", "напряжение"}},
-    {"🙄", {"закатывание", "глаз", "раздражение"}},
-    {"😯", {"удивление", "рот", "открытый"}},
-    {"😦", {"огорчение", "открытый", "рот"}},
-    {"😧", {"агония", "страдание"}},
-    {"😮", {"удивление", "о", "рот"}},
-    {"😲", {"изумление", "удивление", "рот"}},
-    {"🥱", {"зевота", "усталость", "сон"}},
-    {"😴", {"сон", "спящий", "сновидения"}},
-    {"🤤", {"слюни", "голод", "желание"}},
-    {"😪", {"сонный", "усталый"}},
-    {"😵", {"головокружение", "бред", "звезды"}},
-    {"🤐", {"молчание", "застежка", "рот"}},
-    {"🥴", {"пьяный", "головокружение", "больной"}},
-    {"🤢", {"тошнота", "больной"}},
-    {"🤮", {"рвота", "тошнота", "больной"}},
-    {"🤧", {"чихание", "простуда", "больной"}},
-    {"😷", {"маска", "больной", "доктор"}},
-    {"🤒", {"термометр", "температура", "больной"}},
-    {"🤕", {"перевязанная", "голова", "травма"}},
-    {"🤑", {"деньги", "рот", "жадность"}},
-    {"🤠", {"ковбой", "шляпа", "техас"}},
-    {"😈", {"рога", "улыбка", "дьявол"}},
-    {"👿", {"злой", "дьявол", "рога"}},
-    {"👹", {"огр", "японский", "монстр"}},
-    {"👺", {"гоблин", "японский", "монстр"}},
-    {"🤡", {"клоун", "цирк", "комик"}},
-    {"💩", {"говно", "какашка", "дерьмо", "экскременты"}},
-    {"👻", {"призрак", "хэллоуин", "страх"}},
-    {"💀", {"череп", "смерть", "опасность"}},
-    {"☠️", {"череп", "кости", "пираты"}},
-    {"👽", {"инопланетянин", "космос", "НЛО"}},
-    {"👾", {"космический", "монстр", "игра"}},
-    {"🤖", {"робот", "технологии", "искусственный"}},
-    {"🎃", {"тыква", "хэллоуин", "праздник"}},
-    {"😺", {"кот", "улыбка", "радость"}},
-    {"😸", {"кот", "смех", "радость"}},
-    {"😹", {"кот", "слезы", "радость"}},
-    {"😻", {"кот", "сердце", "любовь"}},
-    {"😼", {"кот", "ухмылка", "хитрость"}},
-    {"😽", {"кот", "поцелуй", "любовь"}},
-    {"🙀", {"кот", "шок", "удивление"}},
-    {"😿", {"кот", "слезы", "грусть"}},
-    {"😾", {"кот", "сердитый", "недовольный"}}
-};
-
-#endif // EMOJISMILEYS_H
\ No newline at end of file
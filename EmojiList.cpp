@@ -1,27 +1,97 @@
 #include "EmojiList.h"
 
-// Включаем все категории
-#include "EmojiCategories/EmojiSmileys.h"
-#include "EmojiCategories/EmojiHearts.h"
-#include "EmojiCategories/EmojiAnimals.h"
-#include "EmojiCategories/EmojiFish.h"
-#include "EmojiCategories/EmojiFood.h"
-#include "EmojiCategories/EmojiObjects.h"
-#include "EmojiCategories/EmojiSports.h"
-#include "EmojiCategories/EmojiTransport.h"
-
-const QList<EmojiData>& getEmojiList() {
-    static const QList<EmojiData> emojis = []() {
-        QList<EmojiData> all;
-        all.append(emojiSmileys);
-        all.append(emojiHearts);
-        all.append(emojiAnimals);
-        all.append(emojiFood);
-        all.append(emojiSports);
-        all.append(emojiFish);
-        all.append(emojiTransport);
-        all.append(emojiObjects);
-        return all;
-    }();
-    return emojis;
+// Таблица генерируется из emoji_data.json при сборке
+#include "EmojiTable.h"
+
+#include <iterator>
+#include <unordered_map>
+
+namespace {
+    QString fromUtf8(std::string_view text)
+    {
+        return QString::fromUtf8(text.data(), qsizetype(text.size()));
+    }
+}
+
+namespace EmojiCatalog {
+    int count()
+    {
+        return int(std::size(EmojiTable::emojis));
+    }
+
+    const EmojiRecord& record(int row)
+    {
+        return EmojiTable::emojis[row];
+    }
+
+    int baseRow(int row)
+    {
+        return row - EmojiTable::emojis[row].skinTone;
+    }
+
+    int variantRow(int row, int skinTone)
+    {
+        const int base = baseRow(row);
+        if (skinTone <= 0 || skinTone > SKIN_TONE_COUNT || !EmojiTable::emojis[base].hasSkinTones) {
+            return base;
+        }
+        return base + skinTone;
+    }
+
+    int findRow(std::string_view emoji)
+    {
+        // Индекс строится при первом поиске; ключи ссылаются на строки таблицы
+        static const std::unordered_map<std::string_view, int> rows = []() {
+            std::unordered_map<std::string_view, int> result;
+            result.reserve(size_t(count()));
+            for (int row = 0; row < count(); ++row) {
+                result.emplace(EmojiTable::emojis[row].emoji, row);
+            }
+            return result;
+        }();
+
+        const auto it = rows.find(emoji);
+        return it != rows.end() ? it->second : -1;
+    }
+
+    QString emoji(int row)
+    {
+        return fromUtf8(EmojiTable::emojis[row].emoji);
+    }
+
+    QStringList keywords(int row)
+    {
+        const EmojiRecord& emojiRecord = EmojiTable::emojis[row];
+        QStringList result;
+        result.reserve(emojiRecord.keywordCount);
+        for (int i = 0; i < emojiRecord.keywordCount; ++i) {
+            result.append(fromUtf8(EmojiTable::keywords[EmojiTable::keywordRefs[emojiRecord.firstKeyword + i]]));
+        }
+        return result;
+    }
+
+    int keywordCount()
+    {
+        return int(std::size(EmojiTable::keywords));
+    }
+
+    std::string_view keyword(int keywordId)
+    {
+        return EmojiTable::keywords[keywordId];
+    }
+
+    int keywordId(int row, int index)
+    {
+        return EmojiTable::keywordRefs[EmojiTable::emojis[row].firstKeyword + index];
+    }
+
+    int categoryCount()
+    {
+        return int(std::size(EmojiTable::categories));
+    }
+
+    QString categoryName(int category)
+    {
+        return fromUtf8(EmojiTable::categories[category]);
+    }
 }
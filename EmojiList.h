@@ -3,13 +3,44 @@
 
 #include <QString>
 #include <QStringList>
-#include <QList>
+#include <QtGlobal>
+#include <string_view>
 
-struct EmojiData {
-    QString emoji;
-    QStringList keywords;
+// Запись каталога эмодзи. Таблица генерируется при сборке из emoji_data.json
+// (cmake/GenerateEmojiTable.cmake) и целиком constexpr: при старте ничего
+// не конструируется и не выделяется, строки лежат в секции констант
+struct EmojiRecord {
+    std::string_view emoji;   // UTF-8
+    quint16 firstKeyword;     // Смещение в EmojiTable::keywordRefs
+    quint8 keywordCount;
+    quint8 category;          // Номер в EmojiTable::categories
+    quint8 skinTone;          // 0 - основная запись, 1..5 - вариант с модификатором оттенка кожи
+    bool hasSkinTones;        // За основной записью следуют пять вариантов
 };
 
-const QList<EmojiData>& getEmojiList();
+namespace EmojiCatalog {
+    static inline const int SKIN_TONE_COUNT = 5;
 
-#endif // DOCK_EMOJILIST_H
\ No newline at end of file
+    // Все записи, включая варианты с оттенком кожи
+    int count();
+    const EmojiRecord& record(int row);
+    // Основная запись варианта и вариант основной записи (0 - сама запись)
+    int baseRow(int row);
+    int variantRow(int row, int skinTone);
+    // Строка по тексту эмодзи, -1 - нет в каталоге. Первый вызов строит хеш по всем записям
+    int findRow(std::string_view emoji);
+
+    // QString создаются по запросу
+    QString emoji(int row);
+    QStringList keywords(int row);
+
+    // Уникальные ключевые слова каталога
+    int keywordCount();
+    std::string_view keyword(int keywordId);
+    int keywordId(int row, int index);
+
+    int categoryCount();
+    QString categoryName(int category);
+}
+
+#endif // DOCK_EMOJILIST_H
@@ -1,5 +1,7 @@
 // AltTabOverlay.cpp
 #include "AltTabOverlay.h"
+#include "../DockTelemetry.h"
+#include "../ImageResampler.h"
 #include <QApplication>
 #include <QScreen>
 #include <QDebug>
@@ -43,7 +45,8 @@ AltTabThumbnail::AltTabThumbnail(HWND hwnd, QWidget* parent)
     }
 
     if (hIcon) {
-        m_icon = QPixmap::fromImage(QImage::fromHICON(hIcon));
+        // Значок масштабируется один раз, а не при каждой отрисовке
+        m_icon = QPixmap::fromImage(ImageResampler::scaled(QImage::fromHICON(hIcon), QSize(32, 32)));
     }
 
 #ifdef Q_OS_WIN
@@ -123,8 +126,7 @@ void AltTabThumbnail::paintEvent(QPaintEvent* event)
 
     // Draw icon if available
     if (!m_icon.isNull()) {
-        QPixmap scaledIcon = m_icon.scaled(32, 32, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        painter.drawPixmap(width()/2 - scaledIcon.width()/2, 15, scaledIcon);
+        painter.drawPixmap(width()/2 - m_icon.width()/2, 15, m_icon);
     }
 
     // Draw window title
@@ -204,7 +206,10 @@ AltTabOverlay::AltTabOverlay(QWidget* parent)
     // Timer to check Alt state
     m_altCheckTimer = new QTimer(this);
     m_altCheckTimer->setInterval(50);
-    connect(m_altCheckTimer, &QTimer::timeout, this, &AltTabOverlay::checkAltState);
+    connect(m_altCheckTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("AltTabOverlay::checkAltState");
+        checkAltState();
+    });
 
     connect(m_fadeAnimation, &QPropertyAnimation::finished, this, &AltTabOverlay::onAnimationFinished);
 
@@ -1,5 +1,6 @@
 #include "AppVolumeWidget.h"
 #include "WinDockBarConstants.h"
+#include "../ImageResampler.h"
 #include <QPainter>
 #include <QPainterPath>
 #include <QFont>
@@ -129,7 +130,7 @@ void AppVolumeWidget::updateAppIcon()
             painter.setClipPath(path);
 
             // Scale and draw the icon
-            QPixmap scaledPixmap = pixmap.scaled(40, 40, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            QPixmap scaledPixmap = ImageResampler::scaled(pixmap, QSize(40, 40));
             painter.drawPixmap(0, 0, scaledPixmap);
 
             m_appIcon->setPixmap(circularPixmap);
@@ -0,0 +1,320 @@
+#include "ClipboardHistoryModel.h"
+#include "ClipboardHistoryStore.h"
+#include "ClipboardPreviewLoader.h"
+#include "ClipboardSearchIndex.h"
+
+#include <QFileInfo>
+#include <QPainter>
+#include <QPainterPath>
+#include <QUrl>
+
+ClipboardHistoryModel::ClipboardHistoryModel(ClipboardHistoryStore* store, ClipboardPreviewLoader* previewLoader, QObject* parent)
+    : QAbstractListModel(parent)
+    , m_store(store)
+    , m_previewLoader(previewLoader)
+    , m_rowKeyBase(0)
+    , m_rowHeightsChangePending(false)
+{
+    m_rows = m_store->hashes();
+    m_rowKeys.reserve(m_rows.size());
+    updateRowKeys(0, m_rows.size());
+
+    connect(m_store, &ClipboardHistoryStore::entryInserted, this, &ClipboardHistoryModel::onEntryInserted);
+    connect(m_store, &ClipboardHistoryStore::entryMovedToFront, this, &ClipboardHistoryModel::onEntryMovedToFront);
+    connect(m_store, &ClipboardHistoryStore::entryRemoved, this, &ClipboardHistoryModel::onEntryRemoved);
+    connect(m_previewLoader, &ClipboardPreviewLoader::previewReady, this, &ClipboardHistoryModel::onPreviewReady);
+}
+
+bool ClipboardHistoryModel::isImageFile(const QString& filePath)
+{
+    QString extension = QFileInfo(filePath).suffix().toLower();
+    static const QStringList imageExtensions = {
+        "png", "jpg", "jpeg", "bmp", "gif", "tiff", "tif",
+        "webp", "ico", "svg", "psd", "raw", "heic", "heif"
+    };
+    return imageExtensions.contains(extension);
+}
+
+QString ClipboardHistoryModel::imageFilePath(const QString& text)
+{
+    if (text.startsWith("file:///") && isImageFile(text)) {
+        return QUrl(text).toLocalFile();
+    }
+    return QString();
+}
+
+int ClipboardHistoryModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant ClipboardHistoryModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) {
+        return QVariant();
+    }
+
+    const QByteArray& hash = m_rows.at(index.row());
+    if (role == HashRole) {
+        return hash;
+    }
+
+    // Высота строки запрашивается для всех строк списка, поэтому журнал
+    // здесь не читается: вид незагруженного текста неизвестен
+    const ClipboardEntry* cached = m_store->cachedEntry(hash);
+    if (!cached) {
+        return QVariant();
+    }
+    if (role == ImageRowHintRole && !cached->loaded) {
+        return cached->type == ClipboardEntry::Image;
+    }
+    const bool wasLoaded = cached->loaded;
+
+    // Запись загружается из журнала только для видимых строк
+    const ClipboardEntry* entry = m_store->entry(hash);
+    if (!entry) {
+        return QVariant();
+    }
+
+    const bool isImage = entry->type == ClipboardEntry::Image;
+    const QString filePath = isImage ? QString() : imageFilePath(entry->text);
+
+    // Путь к изображению в тексте, для которого высота была оценена как для текста
+    if (!wasLoaded && !filePath.isEmpty()) {
+        scheduleRowHeightsChanged();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+        if (isImage) {
+            return QStringLiteral("Image");
+        }
+        if (!filePath.isEmpty() && !m_previewLoader->hasFailed(filePath)) {
+            return QStringLiteral("Image");
+        }
+        return entry->text;
+    case Qt::DecorationRole:
+        if (isImage) {
+            return entry->thumbnail;
+        }
+        if (!filePath.isEmpty()) {
+            // Пустое изображение - миниатюра еще декодируется
+            return m_previewLoader->preview(filePath);
+        }
+        return QVariant();
+    case Qt::ToolTipRole:
+        if (isImage) {
+            return QStringLiteral("Image");
+        }
+        return filePath.isEmpty() ? entry->text : filePath;
+    case FullTextRole:
+        return entry->text;
+    case ImageEntryRole:
+        return isImage;
+    case ImageFileRole:
+        return filePath;
+    case ImageRowRole:
+    case ImageRowHintRole:
+        return isImage || (!filePath.isEmpty() && !m_previewLoader->hasFailed(filePath));
+    default:
+        return QVariant();
+    }
+}
+
+void ClipboardHistoryModel::scheduleRowHeightsChanged() const
+{
+    // data() вызывается при отрисовке, поэтому раскладку меняем после нее
+    // и один раз на все строки, загруженные за этот проход
+    if (m_rowHeightsChangePending) {
+        return;
+    }
+    m_rowHeightsChangePending = true;
+
+    ClipboardHistoryModel* self = const_cast<ClipboardHistoryModel*>(this);
+    QMetaObject::invokeMethod(self, [self]() {
+        self->m_rowHeightsChangePending = false;
+        emit self->rowHeightsChanged();
+    }, Qt::QueuedConnection);
+}
+
+int ClipboardHistoryModel::rowOf(const QByteArray& hash) const
+{
+    auto it = m_rowKeys.constFind(hash);
+    return it != m_rowKeys.constEnd() ? it.value() - m_rowKeyBase : -1;
+}
+
+void ClipboardHistoryModel::updateRowKeys(int from, int to)
+{
+    for (int row = from; row < to; ++row) {
+        m_rowKeys.insert(m_rows.at(row), row + m_rowKeyBase);
+    }
+}
+
+void ClipboardHistoryModel::onEntryInserted(const QByteArray& hash)
+{
+    beginInsertRows(QModelIndex(), 0, 0);
+    m_rows.prepend(hash);
+    m_rowKeys.insert(hash, --m_rowKeyBase);
+    endInsertRows();
+}
+
+void ClipboardHistoryModel::onEntryMovedToFront(const QByteArray& hash)
+{
+    int row = rowOf(hash);
+    if (row <= 0) {
+        return;
+    }
+
+    beginMoveRows(QModelIndex(), row, row, QModelIndex(), 0);
+    m_rows.move(row, 0);
+    // Сдвинулись только строки выше перемещенной
+    updateRowKeys(0, row + 1);
+    endMoveRows();
+}
+
+void ClipboardHistoryModel::onEntryRemoved(const QByteArray& hash)
+{
+    int row = rowOf(hash);
+    if (row < 0) {
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_rows.removeAt(row);
+    m_rowKeys.remove(hash);
+    // Вытесняются обычно самые старые записи - сдвигать почти нечего
+    updateRowKeys(row, m_rows.size());
+    endRemoveRows();
+}
+
+void ClipboardHistoryModel::onPreviewReady(const QString& filePath, const QImage& preview)
+{
+    // Файл не декодировался - строка становится текстовой и ниже
+    if (preview.isNull()) {
+        scheduleRowHeightsChanged();
+    }
+
+    // Обновляем только строки с этим путем
+    for (int row = 0; row < m_rows.size(); ++row) {
+        const ClipboardEntry* entry = m_store->cachedEntry(m_rows.at(row));
+        if (entry && entry->loaded && entry->type == ClipboardEntry::Text &&
+            imageFilePath(entry->text) == filePath) {
+            QModelIndex changed = index(row);
+            emit dataChanged(changed, changed);
+        }
+    }
+}
+
+ClipboardHistoryFilterModel::ClipboardHistoryFilterModel(ClipboardSearchIndex* searchIndex, QObject* parent)
+    : QSortFilterProxyModel(parent)
+    , m_searchIndex(searchIndex)
+    , m_sequence(0)
+{
+}
+
+void ClipboardHistoryFilterModel::setQuery(const QString& query)
+{
+    if (query == m_query) {
+        return;
+    }
+
+    m_query = query;
+    m_matches = m_searchIndex->search(query);
+    m_sequence = m_searchIndex->sequence();
+    invalidateFilter();
+}
+
+bool ClipboardHistoryFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+{
+    if (m_query.isEmpty()) {
+        return true;
+    }
+
+    const QByteArray hash = sourceModel()->index(sourceRow, 0, sourceParent)
+                                .data(ClipboardHistoryModel::HashRole).toByteArray();
+    if (m_matches.contains(hash)) {
+        return true;
+    }
+
+    // Запись появилась после запроса - индекс уже обновлен по сигналу хранилища
+    return m_searchIndex->indexedAfter(hash, m_sequence) && m_searchIndex->matches(hash, m_query);
+}
+
+ClipboardHistoryDelegate::ClipboardHistoryDelegate(QObject* parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void ClipboardHistoryDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    // Подложка строки (цвета как у прежнего стиля QListWidget::item)
+    QRect rowRect = option.rect.adjusted(ROW_MARGIN, ROW_MARGIN, -ROW_MARGIN, -ROW_MARGIN);
+    QColor background(60, 60, 60, 180);
+    if (option.state & QStyle::State_Selected) {
+        background = QColor(0, 120, 215, 200);
+    } else if (option.state & QStyle::State_MouseOver) {
+        background = QColor(80, 80, 80, 200);
+    }
+
+    QPainterPath path;
+    path.addRoundedRect(rowRect, ROW_RADIUS, ROW_RADIUS);
+    painter->fillPath(path, background);
+
+    QRect contentRect = rowRect.adjusted(ROW_PADDING, ROW_PADDING, -ROW_PADDING, -ROW_PADDING);
+
+    // Миниатюра
+    if (index.data(ClipboardHistoryModel::ImageRowRole).toBool()) {
+        QRect thumbRect(contentRect.left(), contentRect.center().y() - THUMBNAIL_SIZE / 2,
+                        THUMBNAIL_SIZE, THUMBNAIL_SIZE);
+        QImage thumbnail = index.data(Qt::DecorationRole).value<QImage>();
+        if (!thumbnail.isNull()) {
+            QSize size = thumbnail.size().scaled(THUMBNAIL_SIZE, THUMBNAIL_SIZE, Qt::KeepAspectRatio);
+            QRect target(QPoint(0, 0), size);
+            target.moveCenter(thumbRect.center());
+            painter->drawImage(target, thumbnail);
+        }
+        contentRect.setLeft(thumbRect.right() + ROW_PADDING);
+    }
+
+    // Текст - одна строка, обрезанная по ширине
+    QString text = index.data(Qt::DisplayRole).toString();
+    if (text.length() > MAX_TEXT_LENGTH) {
+        text = text.left(MAX_TEXT_LENGTH) + "...";
+    }
+    text.replace('\n', ' ').replace('\r', ' ').replace('\t', ' ');
+
+    painter->setFont(option.font);
+    QString elided = option.fontMetrics.elidedText(text, Qt::ElideRight, contentRect.width());
+
+    // Подсветка найденных вхождений
+    if (!m_highlight.isEmpty()) {
+        const int textTop = contentRect.center().y() - option.fontMetrics.height() / 2;
+        qsizetype from = 0;
+        qsizetype pos;
+        while ((pos = elided.indexOf(m_highlight, from, Qt::CaseInsensitive)) >= 0) {
+            QRect matchRect(contentRect.left() + option.fontMetrics.horizontalAdvance(elided.left(pos)), textTop,
+                            option.fontMetrics.horizontalAdvance(elided.mid(pos, m_highlight.size())),
+                            option.fontMetrics.height());
+            painter->fillRect(matchRect, QColor(255, 190, 0, 120));
+            from = pos + m_highlight.size();
+        }
+    }
+
+    painter->setPen(Qt::white);
+    painter->drawText(contentRect, Qt::AlignLeft | Qt::AlignVCenter, elided);
+
+    painter->restore();
+}
+
+QSize ClipboardHistoryDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    // Вызывается для каждой строки при раскладке - без загрузки записей
+    int contentHeight = option.fontMetrics.height();
+    if (index.data(ClipboardHistoryModel::ImageRowHintRole).toBool()) {
+        contentHeight = qMax(contentHeight, THUMBNAIL_SIZE);
+    }
+    return QSize(option.rect.width(), contentHeight + 2 * (ROW_PADDING + ROW_MARGIN));
+}
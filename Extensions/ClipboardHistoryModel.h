@@ -0,0 +1,116 @@
+#ifndef CLIPBOARDHISTORYMODEL_H
+#define CLIPBOARDHISTORYMODEL_H
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QSet>
+#include <QSortFilterProxyModel>
+#include <QStyledItemDelegate>
+
+class ClipboardHistoryStore;
+class ClipboardPreviewLoader;
+class ClipboardSearchIndex;
+
+// Модель истории буфера обмена поверх ClipboardHistoryStore.
+// Добавление, перемещение в начало и удаление записей приходят из хранилища
+// сигналами и превращаются в точечные операции со строками, поэтому список
+// не перестраивается целиком при каждом копировании.
+class ClipboardHistoryModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        HashRole = Qt::UserRole,   // Хеш записи в хранилище
+        FullTextRole,              // Полный текст записи
+        ImageEntryRole,            // true - изображение из истории (оригинал в хранилище)
+        ImageFileRole,             // Путь к файлу изображения, если текст - такой путь
+        ImageRowRole,              // true - строка отображается с миниатюрой
+        ImageRowHintRole           // То же без чтения журнала: незагруженный текст считается текстом
+    };
+
+    ClipboardHistoryModel(ClipboardHistoryStore* store, ClipboardPreviewLoader* previewLoader, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    static bool isImageFile(const QString& filePath);
+    // Локальный путь, если текст - ссылка на файл изображения
+    static QString imageFilePath(const QString& text);
+
+signals:
+    // Строка, высота которой была оценена по ImageRowHintRole, оказалась другого вида
+    void rowHeightsChanged();
+
+private slots:
+    void onEntryInserted(const QByteArray& hash);
+    void onEntryMovedToFront(const QByteArray& hash);
+    void onEntryRemoved(const QByteArray& hash);
+    void onPreviewReady(const QString& filePath, const QImage& preview);
+
+private:
+    void scheduleRowHeightsChanged() const;
+    int rowOf(const QByteArray& hash) const;
+    void updateRowKeys(int from, int to);
+
+    ClipboardHistoryStore* m_store;
+    ClipboardPreviewLoader* m_previewLoader;
+    QList<QByteArray> m_rows;   // Хеши записей от новых к старым
+    // Строка записи = ключ - m_rowKeyBase. Добавление в начало сдвигает все
+    // строки уменьшением базы; перемещение и удаление переписывают ключи
+    // только сдвинутых строк (обычно это новые или самые старые записи)
+    QHash<QByteArray, int> m_rowKeys;
+    int m_rowKeyBase;
+    mutable bool m_rowHeightsChangePending;
+};
+
+// Фильтр истории по строке поиска. Совпадения берутся из индекса один раз
+// на запрос; записи, добавленные после этого, проверяются по одной
+class ClipboardHistoryFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit ClipboardHistoryFilterModel(ClipboardSearchIndex* searchIndex, QObject* parent = nullptr);
+
+    void setQuery(const QString& query);
+    QString query() const { return m_query; }
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+private:
+    ClipboardSearchIndex* m_searchIndex;
+    QString m_query;
+    QSet<QByteArray> m_matches;
+    quint32 m_sequence;
+};
+
+// Отрисовка строк истории: миниатюра и/или текст на скругленной подложке
+class ClipboardHistoryDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    static inline const int THUMBNAIL_SIZE = 64;
+    static inline const int ROW_MARGIN = 2;
+    static inline const int ROW_PADDING = 10;
+    static inline const int ROW_RADIUS = 5;
+    static inline const int MAX_TEXT_LENGTH = 80;
+
+    explicit ClipboardHistoryDelegate(QObject* parent = nullptr);
+
+    // Строка, вхождения которой подсвечиваются в тексте
+    void setHighlight(const QString& text) { m_highlight = text; }
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+private:
+    QString m_highlight;
+};
+
+#endif // CLIPBOARDHISTORYMODEL_H
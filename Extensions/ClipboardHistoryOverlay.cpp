@@ -1,5 +1,14 @@
 #include "ClipboardHistoryOverlay.h"
-#include "..//EmojiList.h"
+#include "ClipboardHistoryStore.h"
+#include "ClipboardHistoryModel.h"
+#include "ClipboardPreviewLoader.h"
+#include "ClipboardSearchIndex.h"
+#include "EmojiListModel.h"
+#include "EmojiGridView.h"
+#include "EmojiGlyphAtlas.h"
+#include "EmojiUsageTracker.h"
+#include "../EmojiList.h"
+#include "../DockTelemetry.h"
 #include <QApplication>
 #include <QClipboard>
 #include <QGuiApplication>
@@ -16,19 +25,26 @@
 #include <QIcon>
 #include <QPixmap>
 #include <QLineEdit>
-#include <QFontDatabase>
+#include <QImageReader>
+#include <QPushButton>
+#include <QHBoxLayout>
+#include <QSettings>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
 #endif
 
 ClipboardHistoryOverlay::ClipboardHistoryOverlay(QWidget* parent)
-    : QWidget(parent), m_visible(false), m_ignoreNextClipboardChange(false), 
-      m_positionInitialized(false), m_closeButtonHovered(false)
+    : QWidget(parent), m_emojiTab(nullptr), m_emojiList(nullptr), m_emojiModel(nullptr), m_emojiFilter(nullptr),
+      m_emojiSearchEdit(nullptr), m_skinToneButton(nullptr), m_visible(false), m_historyStore(nullptr),
+      m_historyModel(nullptr), m_historyFilter(nullptr), m_searchIndex(nullptr), m_previewLoader(nullptr),
+      m_ignoreNextClipboardChange(false), m_positionInitialized(false), m_closeButtonHovered(false)
 #ifdef Q_OS_WIN
     , m_previousWindow(nullptr)
 #endif
 {
+    DockTelemetry::ScopedTimer telemetryTimer("ClipboardHistoryOverlay::create");
+
     setWindowFlags(Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint | Qt::Tool | Qt::Popup);
     setAttribute(Qt::WA_TranslucentBackground);
     setAttribute(Qt::WA_ShowWithoutActivating);
@@ -65,10 +81,10 @@ ClipboardHistoryOverlay::ClipboardHistoryOverlay(QWidget* parent)
         "}"
     );
 
-    // History list widget
-    m_historyList = new QListWidget(this);
+    // History list view - строки рисует делегат
+    m_historyList = new QListView(this);
     m_historyList->setStyleSheet(
-        "QListWidget {"
+        "QListView {"
         "   background-color: rgba(45, 45, 45, 250);"
         "   border: 2px solid rgba(80, 80, 80, 200);"
         "   border-radius: 10px;"
@@ -77,18 +93,6 @@ ClipboardHistoryOverlay::ClipboardHistoryOverlay(QWidget* parent)
         "   font-size: 14px;"
         "   outline: none;"
         "}"
-        "QListWidget::item {"
-        "   background-color: rgba(60, 60, 60, 180);"
-        "   border-radius: 5px;"
-        "   margin: 2px;"
-        "   padding: 10px;"
-        "}"
-        "QListWidget::item:selected {"
-        "   background-color: rgba(0, 120, 215, 200);"
-        "}"
-        "QListWidget::item:hover {"
-        "   background-color: rgba(80, 80, 80, 200);"
-        "}"
         "QScrollBar:vertical {"
         "   background: rgba(50, 50, 50, 150);"
         "   width: 12px;"
@@ -112,15 +116,19 @@ ClipboardHistoryOverlay::ClipboardHistoryOverlay(QWidget* parent)
     // Убираем горизонтальный скроллбар
     m_historyList->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     m_historyList->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-    m_historyList->setSelectionMode(QListWidget::SingleSelection);
-    m_historyList->setIconSize(QSize(64, 64));
-
-    connect(m_historyList, &QListWidget::itemClicked, this, &ClipboardHistoryOverlay::onItemClicked);
-
-    // Emoji search edit
-    m_emojiSearchEdit = new QLineEdit(this);
-    m_emojiSearchEdit->setPlaceholderText("Поиск эмодзи...");
-    m_emojiSearchEdit->setStyleSheet(
+    m_historyList->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_historyList->setMouseTracking(true);
+    // Раскладка порциями - длинная история не блокирует первое отображение
+    m_historyList->setLayoutMode(QListView::Batched);
+    m_historyDelegate = new ClipboardHistoryDelegate(m_historyList);
+    m_historyList->setItemDelegate(m_historyDelegate);
+
+    connect(m_historyList, &QListView::clicked, this, &ClipboardHistoryOverlay::onItemClicked);
+
+    // History search edit
+    m_historySearchEdit = new QLineEdit(this);
+    m_historySearchEdit->setPlaceholderText("Поиск в истории...");
+    m_historySearchEdit->setStyleSheet(
         "QLineEdit {"
         "   background-color: rgba(60, 60, 60, 180);"
         "   border: 2px solid rgba(80, 80, 80, 200);"
@@ -135,77 +143,29 @@ ClipboardHistoryOverlay::ClipboardHistoryOverlay(QWidget* parent)
         "}"
     );
 
-    // Emoji list widget
-    m_emojiList = new QListWidget(this);
-    m_emojiList->setStyleSheet(
-        "QListWidget {"
-        "   background-color: rgba(45, 45, 45, 250);"
-        "   border: 2px solid rgba(80, 80, 80, 200);"
-        "   border-radius: 10px;"
-        "   padding: 5px;"
-        "   color: white;"
-        "   font-size: 20px;"
-        "   outline: none;"
-        "}"
-        "QListWidget::item {"
-        "   background-color: rgba(60, 60, 60, 180);"
-        "   border-radius: 8px;"
-        "   margin: 2px;"
-        "   padding: 0px;"
-        "   text-align: center;"
-        "}"
-        "QListWidget::item:selected {"
-        "   background-color: rgba(0, 120, 215, 200);"
-        "   border: 2px solid rgba(100, 180, 255, 255);"
-        "}"
-        "QListWidget::item:hover {"
-        "   background-color: rgba(80, 80, 80, 200);"
-        "}"
-        "QScrollBar:vertical {"
-        "   background: rgba(50, 50, 50, 150);"
-        "   width: 12px;"
-        "   margin: 0px;"
-        "   border-radius: 6px;"
-        "}"
-        "QScrollBar::handle:vertical {"
-        "   background: rgba(100, 100, 100, 200);"
-        "   border-radius: 6px;"
-        "   min-height: 20px;"
-        "}"
-        "QScrollBar::handle:vertical:hover {"
-        "   background: rgba(120, 120, 120, 200);"
-        "}"
-        "QScrollBar::add-line:vertical, QScrollBar::sub-line:vertical {"
-        "   border: none;"
-        "   background: none;"
-        "}"
-    );
-
-    m_emojiList->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    m_emojiList->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-    m_emojiList->setSelectionMode(QListWidget::SingleSelection);
-    m_emojiList->setViewMode(QListWidget::IconMode);
-    m_emojiList->setGridSize(QSize(50, 50));
-    m_emojiList->setMovement(QListWidget::Static);
-
-    connect(m_emojiList, &QListWidget::itemClicked, this, &ClipboardHistoryOverlay::onEmojiItemClicked);
-
-    // Создаем layout для вкладки эмодзи
-    QWidget* emojiTabWidget = new QWidget();
-    QVBoxLayout* emojiLayout = new QVBoxLayout(emojiTabWidget);
+    // Создаем layout для вкладки истории
+    QWidget* historyTabWidget = new QWidget();
+    QVBoxLayout* historyLayout = new QVBoxLayout(historyTabWidget);
+    historyLayout->setContentsMargins(0, 0, 0, 0);
+    historyLayout->setSpacing(5);
+    historyLayout->addWidget(m_historySearchEdit);
+    historyLayout->addWidget(m_historyList);
+
+    // Вкладка эмодзи строится при первом переключении на нее или в простое после запуска -
+    // большинство вызовов только вставляют недавний текст
+    m_emojiTab = new QWidget();
+    QVBoxLayout* emojiLayout = new QVBoxLayout(m_emojiTab);
     emojiLayout->setContentsMargins(0, 0, 0, 0);
     emojiLayout->setSpacing(5);
-    emojiLayout->addWidget(m_emojiSearchEdit);
-    emojiLayout->addWidget(m_emojiList);
 
     // Add tabs
-    m_tabWidget->addTab(m_historyList, "History");
-    m_tabWidget->addTab(emojiTabWidget, "Emoji");
+    m_tabWidget->addTab(historyTabWidget, "History");
+    m_tabWidget->addTab(m_emojiTab, "Emoji");
 
     // Подключаем сигнал изменения вкладки
     connect(m_tabWidget, &QTabWidget::currentChanged, this, &ClipboardHistoryOverlay::onTabChanged);
-    // Подключаем сигнал поиска
-    connect(m_emojiSearchEdit, &QLineEdit::textChanged, this, &ClipboardHistoryOverlay::filterEmojis);
+    // Подключаем сигнал поиска по истории
+    connect(m_historySearchEdit, &QLineEdit::textChanged, this, &ClipboardHistoryOverlay::filterHistory);
 
     mainLayout->addWidget(m_tabWidget);
 
@@ -222,14 +182,46 @@ ClipboardHistoryOverlay::ClipboardHistoryOverlay(QWidget* parent)
     m_clipboard = QApplication::clipboard();
     connect(m_clipboard, &QClipboard::dataChanged, this, &ClipboardHistoryOverlay::onClipboardDataChanged);
 
+    // История хранится на диске и переживает перезапуск
+    m_historyStore = new ClipboardHistoryStore(QString(), this);
+    m_historyStore->load();
+
+    // Миниатюры файлов изображений декодируются в фоне
+    m_previewLoader = new ClipboardPreviewLoader(this);
+
+    // Индекс создается раньше модели - новые записи попадают в него первыми
+    m_searchIndex = new ClipboardSearchIndex(m_historyStore, this);
+
+    // Модель получает изменения хранилища построчно
+    m_historyModel = new ClipboardHistoryModel(m_historyStore, m_previewLoader, this);
+    m_historyFilter = new ClipboardHistoryFilterModel(m_searchIndex, this);
+    m_historyFilter->setSourceModel(m_historyModel);
+    m_historyList->setModel(m_historyFilter);
+
+    // Высота строк оценивается без чтения журнала; если видимая строка
+    // оказалась изображением, раскладка пересчитывается
+    connect(m_historyModel, &ClipboardHistoryModel::rowHeightsChanged, m_historyList, &QListView::doItemsLayout);
+
+    // Высота окна зависит только от первых строк
+    connect(m_historyFilter, &QAbstractItemModel::rowsInserted, this, [this]() {
+        if (m_visible) {
+            adjustHistoryHeight();
+        }
+    });
+    connect(m_historyFilter, &QAbstractItemModel::rowsRemoved, this, [this]() {
+        if (m_visible) {
+            adjustHistoryHeight();
+        }
+    });
+
     // Инициализируем историю текущим содержимым буфера
     QString initialText = m_clipboard->text();
-    if (!initialText.isEmpty()) {
-        m_clipboardHistory.append(initialText);
+    if (!initialText.isEmpty() && !ClipboardHistoryStore::isExcludedFromHistory(m_clipboard->mimeData())) {
+        m_historyStore->addText(initialText);
     }
 
-    // Заполняем список эмодзи
-    refreshEmojiList();
+    // Прогрев вкладки эмодзи, когда приложение уже запущено
+    QTimer::singleShot(EMOJI_PREWARM_DELAY, this, &ClipboardHistoryOverlay::prewarmEmojiTab);
 
     hide();
 }
@@ -301,7 +293,7 @@ void ClipboardHistoryOverlay::showEvent(QShowEvent* event)
     qApp->installEventFilter(this);
 
     // ОБНОВЛЯЕМ ТОЛЬКО ИСТОРИЮ, так как это первая вкладка
-    refreshList();
+    adjustHistoryHeight();
 }
 
 void ClipboardHistoryOverlay::hideEvent(QHideEvent* event)
@@ -309,6 +301,13 @@ void ClipboardHistoryOverlay::hideEvent(QHideEvent* event)
     Q_UNUSED(event)
     // Убираем фильтр событий при скрытии окна
     qApp->removeEventFilter(this);
+
+    // Миниатюры для скрытого списка больше не нужны
+    m_previewLoader->cancelPending();
+    // Глифы эмодзи растеризуются заново при следующем показе
+    if (m_emojiList) {
+        m_emojiList->releaseGlyphs();
+    }
 }
 
 void ClipboardHistoryOverlay::focusOutEvent(QFocusEvent* event)
@@ -323,6 +322,7 @@ void ClipboardHistoryOverlay::focusOutEvent(QFocusEvent* event)
         (focusedWidget == this ||
          focusedWidget == m_tabWidget ||
          focusedWidget == m_historyList ||
+         focusedWidget == m_historySearchEdit ||
          focusedWidget == m_emojiList ||
          focusedWidget == m_emojiSearchEdit ||
          isAncestorOf(focusedWidget))) {
@@ -411,28 +411,27 @@ void ClipboardHistoryOverlay::keyPressEvent(QKeyEvent* event)
         return;
     } else if (event->key() == Qt::Key_Up || event->key() == Qt::Key_Down) {
         // Передаем навигационные клавиши текущему списку
-        QWidget* currentWidget = m_tabWidget->currentWidget();
+        QWidget* currentWidget = m_tabWidget->currentIndex() == 0 ? static_cast<QWidget*>(m_historyList) : m_emojiList;
         if (currentWidget) {
             QApplication::sendEvent(currentWidget, event);
         }
     } else if (event->key() == Qt::Key_Enter || event->key() == Qt::Key_Return) {
         // Если фокус в поле поиска - не обрабатываем Enter
-        if (m_emojiSearchEdit->hasFocus()) {
+        if (m_emojiSearchEdit && m_emojiSearchEdit->hasFocus()) {
             event->ignore();
             return;
         }
 
-        // Enter для выбора элемента
-        QWidget* currentWidget = m_tabWidget->currentWidget();
-        if (currentWidget == m_historyList) {
-            QListWidgetItem* currentItem = m_historyList->currentItem();
-            if (currentItem) {
-                onItemClicked(currentItem);
+        // Enter для выбора элемента (в том числе из поля поиска по истории)
+        if (m_tabWidget->currentIndex() == 0) {
+            QModelIndex currentIndex = m_historyList->currentIndex();
+            if (currentIndex.isValid()) {
+                onItemClicked(currentIndex);
             }
         } else if (m_tabWidget->currentIndex() == 1) { // Вкладка Emoji
-            QListWidgetItem* currentItem = m_emojiList->currentItem();
-            if (currentItem) {
-                onEmojiItemClicked(currentItem);
+            QModelIndex currentIndex = m_emojiList->currentIndex();
+            if (currentIndex.isValid()) {
+                onEmojiItemClicked(currentIndex);
             }
         }
     } else if (event->key() == Qt::Key_Tab) {
@@ -548,6 +547,9 @@ void ClipboardHistoryOverlay::toggleVisibility()
         m_visible = false;
         m_positionInitialized = false; // Сбрасываем флаг при скрытии
     } else {
+        // Время от горячей клавиши до показа окна
+        DockTelemetry::ScopedTimer telemetryTimer("ClipboardHistoryOverlay::show");
+
         // Сохраняем предыдущее активное окно перед показом
 #ifdef Q_OS_WIN
         m_previousWindow = GetForegroundWindow();
@@ -555,9 +557,10 @@ void ClipboardHistoryOverlay::toggleVisibility()
         
         // ВСЕГДА устанавливаем первую вкладку (History) при открытии
         m_tabWidget->setCurrentIndex(0);
+        m_historySearchEdit->clear();
 
-        // Обновляем список истории перед показом
-        refreshList();
+        // Подбираем высоту под историю перед показом
+        adjustHistoryHeight();
 
         // Обновляем позицию только если это первое открытие ИЛИ если позиция не инициализирована
         if (!m_positionInitialized) {
@@ -574,8 +577,8 @@ void ClipboardHistoryOverlay::toggleVisibility()
 
             // Устанавливаем фокус на историю (первая вкладка)
             m_historyList->setFocus();
-            if (m_historyList->count() > 0) {
-                m_historyList->setCurrentRow(0);
+            if (m_historyFilter->rowCount() > 0) {
+                m_historyList->setCurrentIndex(m_historyFilter->index(0, 0));
             }
         });
 
@@ -605,8 +608,16 @@ void ClipboardHistoryOverlay::onClipboardDataChanged()
 
 void ClipboardHistoryOverlay::updateClipboardHistory()
 {
-    // Проверяем наличие изображения в буфере обмена
     const QMimeData* mimeData = m_clipboard->mimeData();
+
+    // Пароли и другое содержимое, помеченное источником как конфиденциальное,
+    // не попадает в историю и на диск
+    if (ClipboardHistoryStore::isExcludedFromHistory(mimeData)) {
+        qDebug() << "Clipboard content excluded from history by its source";
+        return;
+    }
+
+    // Проверяем наличие изображения в буфере обмена
     if (mimeData && mimeData->hasImage()) {
         QImage image = qvariant_cast<QImage>(mimeData->imageData());
         if (!image.isNull()) {
@@ -621,13 +632,11 @@ void ClipboardHistoryOverlay::updateClipboardHistory()
         for (const QUrl& url : urls) {
             if (url.isLocalFile()) {
                 QString filePath = url.toLocalFile();
-                // Проверяем, является ли файл изображением
-                if (isImageFile(filePath)) {
-                    QImage image(filePath);
-                    if (!image.isNull()) {
-                        addImageToHistory(image);
-                        return; // Добавляем только первое изображение
-                    }
+                // Проверяем, является ли файл изображением. Читается только заголовок,
+                // сам файл декодируется в фоне
+                if (isImageFile(filePath) && QImageReader(filePath).canRead()) {
+                    m_historyStore->addImageFile(filePath);
+                    return; // Добавляем только первое изображение
                 }
             }
         }
@@ -642,108 +651,38 @@ void ClipboardHistoryOverlay::updateClipboardHistory()
 
 bool ClipboardHistoryOverlay::isImageFile(const QString& filePath)
 {
-    QString extension = QFileInfo(filePath).suffix().toLower();
-    static const QStringList imageExtensions = {
-        "png", "jpg", "jpeg", "bmp", "gif", "tiff", "tif",
-        "webp", "ico", "svg", "psd", "raw", "heic", "heif"
-    };
-    return imageExtensions.contains(extension);
+    return ClipboardHistoryModel::isImageFile(filePath);
 }
 
 void ClipboardHistoryOverlay::addToHistory(const QString& text)
 {
-    // Проверяем, нет ли уже этого текста в истории
-    int existingIndex = -1;
-    for (int i = 0; i < m_clipboardHistory.size(); ++i) {
-        if (m_clipboardHistory[i] == text) {
-            existingIndex = i;
-            break;
-        }
-    }
-
-    // Если текст уже есть, перемещаем его в начало
-    if (existingIndex != -1) {
-        m_clipboardHistory.move(existingIndex, 0);
-    } else {
-        // Добавляем новый текст в начало
-        m_clipboardHistory.prepend(text);
-
-        // Оставляем только последние 15 элементов
-        if (m_clipboardHistory.size() > 15) {
-            m_clipboardHistory.removeLast();
-        }
-    }
-
-    // Обновляем отображение, если окно видимо
-    if (m_visible) {
-        refreshList();
-    }
+    // Дубликат определяется по хешу и перемещается в начало,
+    // модель получает это как вставку или перемещение одной строки
+    m_historyStore->addText(text);
 }
 
 void ClipboardHistoryOverlay::addImageToHistory(const QImage& image)
 {
-    // Добавляем изображение в историю
-    m_imageHistory.prepend(image);
-
-    // Оставляем только последние 15 элементов
-    if (m_imageHistory.size() > 15) {
-        m_imageHistory.removeLast();
-    }
-
-    // Обновляем отображение, если окно видимо
-    if (m_visible) {
-        refreshList();
-    }
+    // Оригинал сжимается в файл в фоне, в памяти остается только миниатюра.
+    // Строка появится в модели после обработки
+    m_historyStore->addImage(image);
 }
 
-void ClipboardHistoryOverlay::refreshList()
+void ClipboardHistoryOverlay::adjustHistoryHeight()
 {
-    m_historyList->clear();
-
-    // Добавляем изображения в список
-    for (const QImage& image : m_imageHistory) {
-        QPixmap pixmap = QPixmap::fromImage(image.scaled(64, 64, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        QListWidgetItem* item = new QListWidgetItem(QIcon(pixmap), "Image");
-        item->setData(Qt::UserRole, QVariant::fromValue(image));
-        item->setToolTip("Image");
-        m_historyList->addItem(item);
-    }
-
-    // Добавляем текстовые элементы в список
-    for (const QString& item : m_clipboardHistory) {
-        QString displayText = item;
-
-        // Проверяем, является ли текст путем к файлу изображения
-        if (item.startsWith("file:///") && isImageFile(item)) {
-            QString filePath = QUrl(item).toLocalFile();
-            QImage image(filePath);
-            if (!image.isNull()) {
-                QPixmap pixmap = QPixmap::fromImage(image.scaled(64, 64, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-                QListWidgetItem* listItem = new QListWidgetItem(QIcon(pixmap), "Image");
-                listItem->setData(Qt::UserRole, QVariant::fromValue(image));
-                listItem->setToolTip(filePath);
-                m_historyList->addItem(listItem);
-                continue; // Пропускаем добавление как текста
-            }
-        }
-
-        if (displayText.length() > 80) {
-            displayText = displayText.left(80) + "...";
-        }
-
-        QListWidgetItem* listItem = new QListWidgetItem(displayText);
-        listItem->setData(Qt::UserRole, item); // Сохраняем полный текст
-        listItem->setToolTip(item);
-        m_historyList->addItem(listItem);
+    // Автоматически подбираем высоту окна под содержимое (только для вкладки History)
+    if (m_tabWidget->currentIndex() != 0) {
+        return;
     }
 
-    // Автоматически подбираем высоту окна под содержимое (только для вкладки History)
-    if (m_historyList->count() > 0) {
+    const int rowCount = m_historyFilter->rowCount();
+    if (rowCount > 0) {
         int contentHeight = 0;
-        for (int i = 0; i < qMin(8, m_historyList->count()); ++i) {
+        for (int i = 0; i < qMin(8, rowCount); ++i) {
             contentHeight += m_historyList->sizeHintForRow(i);
         }
         contentHeight += 80; // Отступы, рамки и заголовок вкладки
+        contentHeight += m_historySearchEdit->sizeHint().height() + 5;
 
         // Ограничиваем максимальную высоту
         int newHeight = qMin(HISTORY_MAX_HEIGHT, contentHeight);
@@ -764,110 +703,171 @@ void ClipboardHistoryOverlay::refreshList()
     }
 }
 
-void ClipboardHistoryOverlay::refreshEmojiList()
+void ClipboardHistoryOverlay::filterHistory(const QString& searchText)
 {
-    m_emojiList->clear();
+    // Поиск по индексу, список меняется только фильтром
+    m_historyFilter->setQuery(searchText);
+    m_historyDelegate->setHighlight(searchText);
+    m_historyList->viewport()->update();
 
-    // Устанавливаем шрифт, который поддерживает эмодзи
-    QFont emojiFont = m_emojiList->font();
-    emojiFont.setPointSize(16);
+    if (m_historyFilter->rowCount() > 0) {
+        m_historyList->setCurrentIndex(m_historyFilter->index(0, 0));
+        m_historyList->scrollToTop();
+    }
+    adjustHistoryHeight();
+}
 
-    // Пробуем разные шрифты, поддерживающие эмодзи
-    QStringList emojiFonts = {
-        "Segoe UI Emoji",
-        "Segoe UI Symbol",
-        "Apple Color Emoji",
-        "Noto Color Emoji",
-        "Android Emoji",
-        "Twemoji Mozilla",
-        "EmojiOne",
-        "Arial"
-    };
-
-    // Проверяем доступные шрифты
-    QFontDatabase fontDatabase;
-    for (const QString& fontName : emojiFonts) {
-        if (fontDatabase.hasFamily(fontName)) {
-            emojiFont.setFamily(fontName);
-            qDebug() << "Using emoji font:" << fontName;
-            break;
-        }
+void ClipboardHistoryOverlay::prewarmEmojiTab()
+{
+    if (m_emojiList) {
+        return;
     }
 
-    // Если не нашли специальный шрифт, используем системный
-    if (emojiFont.family() == m_emojiList->font().family()) {
-        qDebug() << "No emoji font found, using system font";
+    // Виджеты и модели вкладки дешевы; из глифов в фоне готовится только
+    // первый экран, остальные растеризуются при прокрутке
+    ensureEmojiTab();
+    const int columns = TAB_WIDTH / EmojiGridView::CELL_SIZE.width();
+    const int rows = EMOJI_TAB_HEIGHT / EmojiGridView::CELL_SIZE.height() + 1;
+    m_emojiList->prefetchGlyphs(columns * rows);
+}
+
+void ClipboardHistoryOverlay::ensureEmojiTab()
+{
+    if (m_emojiList) {
+        return;
     }
 
-    m_emojiList->setFont(emojiFont);
+    DockTelemetry::ScopedTimer telemetryTimer("ClipboardHistoryOverlay::buildEmojiTab");
 
-    // Добавляем популярные эмодзи
-    const QList<EmojiData>& emojis = getEmojiList();
+    // Emoji search edit
+    m_emojiSearchEdit = new QLineEdit(m_emojiTab);
+    m_emojiSearchEdit->setPlaceholderText("Поиск эмодзи...");
+    m_emojiSearchEdit->setStyleSheet(
+        "QLineEdit {"
+        "   background-color: rgba(60, 60, 60, 180);"
+        "   border: 2px solid rgba(80, 80, 80, 200);"
+        "   border-radius: 10px;"
+        "   padding: 8px;"
+        "   color: white;"
+        "   font-size: 14px;"
+        "   margin-bottom: 5px;"
+        "}"
+        "QLineEdit:focus {"
+        "   border: 2px solid rgba(0, 120, 215, 200);"
+        "}"
+    );
 
-    for (const EmojiData& emojiData : emojis) {
-        QListWidgetItem* item = new QListWidgetItem(emojiData.emoji);
-        item->setTextAlignment(Qt::AlignCenter);
-        item->setFlags(item->flags() | Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+    // Emoji grid - строки берутся из каталога через фильтр, глифы из атласа
+    m_emojiList = new EmojiGridView(m_emojiTab);
+    m_emojiList->setStyleSheet(
+        "EmojiGridView {"
+        "   background-color: rgba(45, 45, 45, 250);"
+        "   border: 2px solid rgba(80, 80, 80, 200);"
+        "   border-radius: 10px;"
+        "   padding: 5px;"
+        "   outline: none;"
+        "}"
+        "QScrollBar:vertical {"
+        "   background: rgba(50, 50, 50, 150);"
+        "   width: 12px;"
+        "   margin: 0px;"
+        "   border-radius: 6px;"
+        "}"
+        "QScrollBar::handle:vertical {"
+        "   background: rgba(100, 100, 100, 200);"
+        "   border-radius: 6px;"
+        "   min-height: 20px;"
+        "}"
+        "QScrollBar::handle:vertical:hover {"
+        "   background: rgba(120, 120, 120, 200);"
+        "}"
+        "QScrollBar::add-line:vertical, QScrollBar::sub-line:vertical {"
+        "   border: none;"
+        "   background: none;"
+        "}"
+    );
 
-        // Устанавливаем размер элемента
-        item->setSizeHint(QSize(60, 60));
+    m_emojiModel = new EmojiListModel(this);
+    m_emojiFilter = new EmojiFilterModel(this);
+    m_emojiFilter->setSourceModel(m_emojiModel);
+    m_emojiList->setModel(m_emojiFilter);
 
-        m_emojiList->addItem(item);
-    }
+    connect(m_emojiList, &EmojiGridView::clicked, this, &ClipboardHistoryOverlay::onEmojiItemClicked);
+
+    // Оттенок кожи переключается по кругу и подставляется во все эмодзи, у которых он есть.
+    // Кнопка, а не выпадающий список - всплывающее окно списка закрывало бы оверлей
+    m_skinToneButton = new QPushButton(m_emojiTab);
+    m_skinToneButton->setToolTip("Оттенок кожи");
+    m_skinToneButton->setFocusPolicy(Qt::NoFocus);
+    m_skinToneButton->setStyleSheet(
+        "QPushButton {"
+        "   background-color: rgba(60, 60, 60, 180);"
+        "   border: 2px solid rgba(80, 80, 80, 200);"
+        "   border-radius: 10px;"
+        "   padding: 6px 10px;"
+        "   font-size: 16px;"
+        "   margin-bottom: 5px;"
+        "}"
+        "QPushButton:hover {"
+        "   background-color: rgba(80, 80, 80, 200);"
+        "}"
+    );
+    QSettings settings("MyCompany", "DockApp");
+    m_emojiModel->setSkinTone(settings.value("Emoji/SkinTone", 0).toInt());
+    updateSkinToneButton();
+    connect(m_skinToneButton, &QPushButton::clicked, this, &ClipboardHistoryOverlay::onSkinToneClicked);
+
+    // Заполняем вкладку эмодзи
+    QVBoxLayout* emojiLayout = static_cast<QVBoxLayout*>(m_emojiTab->layout());
+    QHBoxLayout* emojiSearchLayout = new QHBoxLayout();
+    emojiSearchLayout->setSpacing(5);
+    emojiSearchLayout->addWidget(m_emojiSearchEdit, 1);
+    emojiSearchLayout->addWidget(m_skinToneButton);
+    emojiLayout->addLayout(emojiSearchLayout);
+    emojiLayout->addWidget(m_emojiList);
 
-    // Устанавливаем режим отображения и размеры элементов
-    m_emojiList->setViewMode(QListWidget::IconMode);
-    m_emojiList->setGridSize(QSize(65, 65)); // Увеличиваем размер сетки
-    m_emojiList->setIconSize(QSize(45, 45)); // Увеличиваем размер иконки
-    m_emojiList->setSpacing(8); // Увеличиваем расстояние между элементами
+    connect(m_emojiSearchEdit, &QLineEdit::textChanged, this, &ClipboardHistoryOverlay::filterEmojis);
 
-    // Отключаем обрезку текста
-    m_emojiList->setWordWrap(true);
-    m_emojiList->setTextElideMode(Qt::ElideNone);
+    // Подбираем шрифт эмодзи
+    refreshEmojiList();
+}
 
-    // Устанавливаем политику размера
-    m_emojiList->setResizeMode(QListWidget::Adjust);
+void ClipboardHistoryOverlay::refreshEmojiList()
+{
+    // Шрифт с эмодзи подбирается один раз, глифы растеризуются в атлас в фоне
+    QFont emojiFont = EmojiGlyphAtlas::emojiFont(m_emojiList->font());
+    emojiFont.setPointSize(16);
+    m_emojiList->setGlyphFont(emojiFont);
+    m_skinToneButton->setFont(EmojiGlyphAtlas::emojiFont(m_skinToneButton->font()));
 
-    qDebug() << "Emoji list refreshed, count:" << m_emojiList->count();
-    if (m_emojiList->count() > 0) {
-        QListWidgetItem* firstItem = m_emojiList->item(0);
-        if (firstItem) {
-            qDebug() << "First emoji text:" << firstItem->text();
-            qDebug() << "First emoji font:" << m_emojiList->font().toString();
-        }
-    }
+    qDebug() << "Emoji list refreshed, count:" << m_emojiFilter->rowCount();
 }
 
 void ClipboardHistoryOverlay::filterEmojis(const QString& searchText)
 {
-    m_emojiList->clear();
-
-    QString searchLower = searchText.toLower();
-    const QList<EmojiData>& allEmojis = getEmojiList();
+    // Совпадения берутся из индекса ключевых слов, строки только скрываются
+    m_emojiFilter->setQuery(searchText);
 
-    for (const EmojiData& emojiData : allEmojis) {
-        bool matches = false;
+    if (m_emojiFilter->rowCount() > 0) {
+        m_emojiList->setCurrentIndex(m_emojiFilter->index(0, 0));
+        m_emojiList->scrollToTop();
+    }
+}
 
-        // Поиск по ключевым словам
-        for (const QString& keyword : emojiData.keywords) {
-            if (keyword.contains(searchLower)) {
-                matches = true;
-                break;
-            }
-        }
+void ClipboardHistoryOverlay::onSkinToneClicked()
+{
+    m_emojiModel->setSkinTone((m_emojiModel->skinTone() + 1) % (EmojiCatalog::SKIN_TONE_COUNT + 1));
+    updateSkinToneButton();
 
-        // Также ищем по самому эмодзи (если пользователь ввел эмодзи)
-        if (!matches && emojiData.emoji.contains(searchText)) {
-            matches = true;
-        }
+    QSettings settings("MyCompany", "DockApp");
+    settings.setValue("Emoji/SkinTone", m_emojiModel->skinTone());
+}
 
-        if (searchText.isEmpty() || matches) {
-            QListWidgetItem* item = new QListWidgetItem(emojiData.emoji);
-            item->setTextAlignment(Qt::AlignCenter);
-            item->setFlags(item->flags() | Qt::ItemIsEnabled | Qt::ItemIsSelectable);
-            m_emojiList->addItem(item);
-        }
-    }
+void ClipboardHistoryOverlay::updateSkinToneButton()
+{
+    // Образец - поднятая ладонь с текущим оттенком
+    static const char* const samples[] = {"✋", "✋🏻", "✋🏼", "✋🏽", "✋🏾", "✋🏿"};
+    m_skinToneButton->setText(QString::fromUtf8(samples[m_emojiModel->skinTone()]));
 }
 
 void ClipboardHistoryOverlay::onTabChanged(int index)
@@ -875,14 +875,17 @@ void ClipboardHistoryOverlay::onTabChanged(int index)
     if (index == 0) { // Вкладка History
         // Для истории используем фиксированную ширину и адаптивную высоту
         setFixedWidth(TAB_WIDTH);
-        refreshList(); // Обновляем список, который установит высоту
+        adjustHistoryHeight();
 
         // Устанавливаем фокус на историю
         m_historyList->setFocus();
-        if (m_historyList->count() > 0) {
-            m_historyList->setCurrentRow(0);
+        if (m_historyFilter->rowCount() > 0) {
+            m_historyList->setCurrentIndex(m_historyFilter->index(0, 0));
         }
     } else if (index == 1) { // Вкладка Emoji
+        // Вкладка могла еще не прогреться
+        ensureEmojiTab();
+
         // Для эмодзи фиксированный размер с той же шириной, но увеличенной высотой для поля поиска
         setFixedSize(TAB_WIDTH, EMOJI_TAB_HEIGHT + 40);
 
@@ -891,8 +894,8 @@ void ClipboardHistoryOverlay::onTabChanged(int index)
         m_emojiSearchEdit->selectAll(); // Выделяем весь текст для удобства
 
         // Убедимся, что есть выделенный элемент в списке эмодзи
-        if (m_emojiList->count() > 0) {
-            m_emojiList->setCurrentRow(0);
+        if (m_emojiFilter->rowCount() > 0) {
+            m_emojiList->setCurrentIndex(m_emojiFilter->index(0, 0));
         }
     }
 
@@ -902,12 +905,22 @@ void ClipboardHistoryOverlay::onTabChanged(int index)
     }
 }
 
-void ClipboardHistoryOverlay::onItemClicked(QListWidgetItem* item)
+void ClipboardHistoryOverlay::onItemClicked(const QModelIndex& index)
 {
-    if (item) {
+    if (index.isValid()) {
         // Проверяем, является ли элемент изображением
-        if (item->data(Qt::UserRole).canConvert<QImage>()) {
-            QImage image = item->data(Qt::UserRole).value<QImage>();
+        const bool historyImage = index.data(ClipboardHistoryModel::ImageEntryRole).toBool();
+        const QString imageFile = index.data(ClipboardHistoryModel::ImageRowRole).toBool()
+            ? index.data(ClipboardHistoryModel::ImageFileRole).toString()
+            : QString();
+        if (historyImage || !imageFile.isEmpty()) {
+            // Полное изображение декодируется только при вставке
+            QImage image = historyImage
+                ? m_historyStore->loadImage(index.data(ClipboardHistoryModel::HashRole).toByteArray())
+                : QImageReader(imageFile).read();
+            if (image.isNull()) {
+                return;
+            }
             m_ignoreNextClipboardChange = true;
 
             // Создаем QMimeData для передачи изображения
@@ -917,7 +930,7 @@ void ClipboardHistoryOverlay::onItemClicked(QListWidgetItem* item)
             // Устанавливаем в буфер обмена
             m_clipboard->setMimeData(mimeData);
         } else {
-            QString selectedText = item->data(Qt::UserRole).toString();
+            QString selectedText = index.data(ClipboardHistoryModel::FullTextRole).toString();
             m_ignoreNextClipboardChange = true;
             m_clipboard->setText(selectedText);
         }
@@ -931,10 +944,15 @@ void ClipboardHistoryOverlay::onItemClicked(QListWidgetItem* item)
     }
 }
 
-void ClipboardHistoryOverlay::onEmojiItemClicked(QListWidgetItem* item)
+void ClipboardHistoryOverlay::onEmojiItemClicked(const QModelIndex& index)
 {
-    if (item) {
-        QString emoji = item->text();
+    if (index.isValid()) {
+        QString emoji = index.data(Qt::DisplayRole).toString();
+
+        // Частота считается по основной записи, независимо от оттенка
+        EmojiUsageTracker::instance().recordUse(
+            EmojiCatalog::emoji(index.data(EmojiListModel::BaseRowRole).toInt()));
+
         m_ignoreNextClipboardChange = true;
         m_clipboard->setText(emoji);
         
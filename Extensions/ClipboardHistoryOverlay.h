@@ -3,7 +3,7 @@
 
 #include <QWidget>
 #include <QVBoxLayout>
-#include <QListWidget>
+#include <QListView>
 #include <QPropertyAnimation>
 #include <QGraphicsOpacityEffect>
 #include <QVector>
@@ -11,12 +11,23 @@
 #include <QClipboard>
 #include <QTabWidget>
 #include <QLineEdit>
+#include <QPushButton>
 #include <QImage>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
 #endif
 
+class ClipboardHistoryStore;
+class ClipboardHistoryModel;
+class ClipboardHistoryFilterModel;
+class ClipboardHistoryDelegate;
+class ClipboardPreviewLoader;
+class ClipboardSearchIndex;
+class EmojiListModel;
+class EmojiFilterModel;
+class EmojiGridView;
+
 class ClipboardHistoryOverlay : public QWidget
 {
     Q_OBJECT
@@ -27,6 +38,8 @@ public:
     static inline const int EMOJI_TAB_HEIGHT = 600;
     static inline const int HISTORY_INITIAL_HEIGHT = 600;
     static inline const int HISTORY_MAX_HEIGHT = 800;
+    // Задержка прогрева вкладки эмодзи после запуска (мс)
+    static inline const int EMOJI_PREWARM_DELAY = 5000;
 
     explicit ClipboardHistoryOverlay(QWidget* parent = nullptr);
     ~ClipboardHistoryOverlay();
@@ -46,17 +59,23 @@ protected:
     void resizeEvent(QResizeEvent* event) override;
 
 private slots:
-    void onItemClicked(QListWidgetItem* item);
+    void onItemClicked(const QModelIndex& index);
     void onClipboardDataChanged();
-    void onEmojiItemClicked(QListWidgetItem* item);
+    void onEmojiItemClicked(const QModelIndex& index);
     void onTabChanged(int index);
     void filterEmojis(const QString& searchText);
+    void filterHistory(const QString& searchText);
+    void onSkinToneClicked();
 
 private:
     void updatePosition();
     void adjustPositionToScreen();
-    void refreshList();
+    void adjustHistoryHeight();
+    // Строит вкладку эмодзи при первом обращении
+    void ensureEmojiTab();
+    void prewarmEmojiTab();
     void refreshEmojiList();
+    void updateSkinToneButton();
     void addToHistory(const QString& text);
     void addImageToHistory(const QImage& image);
     bool isImageFile(const QString& filePath);
@@ -65,24 +84,35 @@ private:
     
 #ifdef Q_OS_WIN
     void pasteToActiveWindow();
-    HWND m_previousWindow;
 #endif
 
     QTabWidget* m_tabWidget;
-    QListWidget* m_historyList;
-    QListWidget* m_emojiList;
+    QListView* m_historyList;
+    QLineEdit* m_historySearchEdit;
+    ClipboardHistoryDelegate* m_historyDelegate;
+    QWidget* m_emojiTab;
+    EmojiGridView* m_emojiList;
+    EmojiListModel* m_emojiModel;
+    EmojiFilterModel* m_emojiFilter;
     QLineEdit* m_emojiSearchEdit;
+    QPushButton* m_skinToneButton;
     QPropertyAnimation* m_fadeAnimation;
     QGraphicsOpacityEffect* m_opacityEffect;
     bool m_visible;
-    QVector<QString> m_clipboardHistory;
-    QVector<QImage> m_imageHistory;
+    ClipboardHistoryStore* m_historyStore;
+    ClipboardHistoryModel* m_historyModel;
+    ClipboardHistoryFilterModel* m_historyFilter;
+    ClipboardSearchIndex* m_searchIndex;
+    ClipboardPreviewLoader* m_previewLoader;
     QClipboard* m_clipboard;
     bool m_ignoreNextClipboardChange;
     QPoint m_initialPosition; // Сохраняем начальную позицию
     bool m_positionInitialized; // Флаг инициализации позиции
     bool m_closeButtonHovered;
     QRect m_closeButtonRect;
+#ifdef Q_OS_WIN
+    HWND m_previousWindow;
+#endif
 };
 
 #endif // CLIPBOARDHISTORYOVERLAY_H
\ No newline at end of file
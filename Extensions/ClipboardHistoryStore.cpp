@@ -0,0 +1,831 @@
+#include "ClipboardHistoryStore.h"
+#include "../ImageResampler.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QMimeData>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <QtEndian>
+#include <iterator>
+
+namespace {
+    // Заголовок файла журнала: сигнатура и версия формата
+    const char LOG_MAGIC[4] = {'D', 'C', 'L', 'H'};
+    const quint32 LOG_VERSION = 2;
+    const qint64 LOG_HEADER_SIZE = 8;
+
+    // Запись журнала: [quint32 размер][quint8 операция][quint8 тип][20 байт хеш][qint64 время][данные]
+    // Данные - текст UTF-8 или миниатюра PNG. В версии 1 не было байта типа (только текст)
+    const int HASH_SIZE = 20;
+    const qint64 FRAME_FIXED_SIZE = 1 + 1 + HASH_SIZE + 8;
+    const qint64 RECORD_HEADER_SIZE = 4 + FRAME_FIXED_SIZE;
+    const qint64 FRAME_FIXED_SIZE_V1 = 1 + HASH_SIZE + 8;
+
+    QByteArray logHeader(quint32 version = LOG_VERSION)
+    {
+        QByteArray header(LOG_MAGIC, sizeof(LOG_MAGIC));
+        quint32 bigEndianVersion = qToBigEndian(version);
+        header.append(reinterpret_cast<const char*>(&bigEndianVersion), sizeof(bigEndianVersion));
+        return header;
+    }
+
+    QByteArray buildRecord(quint8 op, quint8 type, const QByteArray& hash, qint64 timestamp, const QByteArray& payload)
+    {
+        QByteArray record;
+        record.reserve(RECORD_HEADER_SIZE + payload.size());
+
+        QDataStream stream(&record, QIODevice::WriteOnly);
+        stream << quint32(FRAME_FIXED_SIZE + payload.size());
+        stream << op << type;
+        stream.writeRawData(hash.constData(), HASH_SIZE);
+        stream << timestamp;
+        stream.writeRawData(payload.constData(), payload.size());
+        return record;
+    }
+}
+
+ClipboardHistoryStore::ClipboardHistoryStore(const QString& logPath, QObject* parent)
+    : QObject(parent)
+    , m_logPath(logPath)
+    , m_logVersion(LOG_VERSION)
+    , m_persistent(true)
+    , m_logSize(0)
+    , m_liveLogBytes(0)
+    , m_totalBytes(0)
+    , m_imageCount(0)
+    , m_maxCount(DEFAULT_MAX_COUNT)
+    , m_maxBytes(DEFAULT_MAX_BYTES)
+    , m_maxAgeDays(DEFAULT_MAX_AGE_DAYS)
+    , m_maxImageCount(DEFAULT_MAX_IMAGE_COUNT)
+{
+    if (m_logPath.isEmpty()) {
+        m_logPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/clipboard_history.log";
+    }
+    m_imageDir = QFileInfo(m_logPath).absolutePath() + "/clipboard_images";
+
+    // Один поток - изображения добавляются в историю в порядке копирования
+    m_imagePool.setMaxThreadCount(1);
+
+    loadSettings();
+}
+
+ClipboardHistoryStore::~ClipboardHistoryStore()
+{
+    m_imagePool.waitForDone();
+
+    if (m_log.isOpen()) {
+        m_log.close();
+    }
+}
+
+void ClipboardHistoryStore::loadSettings()
+{
+    QSettings settings("MyCompany", "DockApp");
+    m_persistent = settings.value("Clipboard/PersistHistory", true).toBool();
+    m_maxCount = settings.value("Clipboard/HistoryMaxCount", DEFAULT_MAX_COUNT).toInt();
+    m_maxBytes = settings.value("Clipboard/HistoryMaxBytes", DEFAULT_MAX_BYTES).toLongLong();
+    m_maxAgeDays = settings.value("Clipboard/HistoryMaxAgeDays", DEFAULT_MAX_AGE_DAYS).toInt();
+    m_maxImageCount = settings.value("Clipboard/ImageHistoryMaxCount", DEFAULT_MAX_IMAGE_COUNT).toInt();
+}
+
+QByteArray ClipboardHistoryStore::hashText(const QString& text)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray(1, char(ClipboardEntry::Text)));
+    hash.addData(text.toUtf8());
+    return hash.result();
+}
+
+QByteArray ClipboardHistoryStore::hashImage(const QImage& image)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray(1, char(ClipboardEntry::Image)));
+
+    qint32 meta[3] = {image.width(), image.height(), qint32(image.format())};
+    hash.addData(QByteArrayView(reinterpret_cast<const char*>(meta), sizeof(meta)));
+    hash.addData(QByteArrayView(reinterpret_cast<const char*>(image.constBits()), image.sizeInBytes()));
+    return hash.result();
+}
+
+bool ClipboardHistoryStore::isExcludedFromHistory(const QMimeData* mimeData)
+{
+    if (!mimeData) {
+        return false;
+    }
+
+    // Нестандартные форматы Windows Qt показывает как
+    // application/x-qt-windows-mime;value="<имя формата>"
+    const QStringList formats = mimeData->formats();
+    for (const QString& format : formats) {
+        // Наличие формата само по себе означает запрет
+        if (format.contains("ExcludeClipboardContentFromMonitorProcessing") ||
+            format.contains("Clipboard Viewer Ignore")) {
+            return true;
+        }
+
+        // DWORD 0 - содержимое не должно попадать в историю буфера
+        if (format.contains("CanIncludeInClipboardHistory")) {
+            const QByteArray value = mimeData->data(format);
+            if (value.size() >= int(sizeof(quint32)) && qFromLittleEndian<quint32>(value.constData()) == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool ClipboardHistoryStore::openLog()
+{
+    if (m_log.isOpen()) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(m_logPath).absolutePath());
+    m_log.setFileName(m_logPath);
+    if (!m_log.open(QIODevice::ReadWrite)) {
+        qDebug() << "ClipboardHistoryStore: failed to open log" << m_logPath << m_log.errorString();
+        m_persistent = false;
+        return false;
+    }
+    return true;
+}
+
+void ClipboardHistoryStore::load()
+{
+    if (!m_persistent || !openLog()) {
+        return;
+    }
+
+    const qint64 fileSize = m_log.size();
+
+    // Новый или поврежденный файл - начинаем журнал заново
+    m_log.seek(0);
+    QByteArray header = m_log.read(LOG_HEADER_SIZE);
+    if (header == logHeader(1)) {
+        // Журнал старой версии читается и затем переписывается в текущем формате
+        m_logVersion = 1;
+    } else if (header == logHeader()) {
+        m_logVersion = LOG_VERSION;
+    } else {
+        if (fileSize > 0) {
+            qDebug() << "ClipboardHistoryStore: unknown log format, starting a new log";
+        }
+        m_log.resize(0);
+        m_log.seek(0);
+        m_log.write(logHeader());
+        m_log.flush();
+        m_logSize = LOG_HEADER_SIZE;
+        removeOrphanImages();
+        return;
+    }
+
+    const qint64 frameFixedSize = m_logVersion == 1 ? FRAME_FIXED_SIZE_V1 : FRAME_FIXED_SIZE;
+    const qint64 recordHeaderSize = 4 + frameFixedSize;
+
+    // Воспроизводим журнал. Тексты не читаются - запоминаются только смещения
+    qint64 pos = LOG_HEADER_SIZE;
+    while (pos + recordHeaderSize <= fileSize) {
+        m_log.seek(pos);
+        QByteArray recordHeader = m_log.read(recordHeaderSize);
+        if (recordHeader.size() != recordHeaderSize) {
+            break;
+        }
+
+        QDataStream stream(recordHeader);
+        quint32 frameSize = 0;
+        quint8 op = 0;
+        quint8 type = ClipboardEntry::Text;
+        qint64 timestamp = 0;
+        stream >> frameSize >> op;
+        if (m_logVersion != 1) {
+            stream >> type;
+        }
+        QByteArray hash(HASH_SIZE, Qt::Uninitialized);
+        stream.readRawData(hash.data(), HASH_SIZE);
+        stream >> timestamp;
+
+        // Оборванная запись в конце файла (например, после сбоя) - отбрасываем
+        if (frameSize < frameFixedSize || pos + 4 + qint64(frameSize) > fileSize) {
+            break;
+        }
+
+        const qint64 payloadOffset = pos + recordHeaderSize;
+        const qint64 payloadSize = qint64(frameSize) - frameFixedSize;
+        auto indexIt = m_index.find(hash);
+
+        if (op == OpAdd) {
+            if (indexIt != m_index.end()) {
+                removeIterator(indexIt.value(), false);
+            }
+
+            ClipboardEntry entry;
+            entry.hash = hash;
+            entry.type = type == ClipboardEntry::Image ? ClipboardEntry::Image : ClipboardEntry::Text;
+            entry.timestamp = timestamp;
+            entry.byteSize = payloadSize;
+            entry.logOffset = payloadOffset;
+            entry.loaded = false;
+
+            m_entries.push_front(entry);
+            m_index.insert(hash, m_entries.begin());
+            if (entry.type == ClipboardEntry::Image) {
+                ++m_imageCount;
+            } else {
+                m_totalBytes += payloadSize;
+            }
+            m_liveLogBytes += recordHeaderSize + payloadSize;
+        } else if (op == OpTouch) {
+            if (indexIt != m_index.end()) {
+                EntryList::iterator it = indexIt.value();
+                it->timestamp = timestamp;
+                m_entries.splice(m_entries.begin(), m_entries, it);
+            }
+        } else if (op == OpRemove) {
+            if (indexIt != m_index.end()) {
+                removeIterator(indexIt.value(), false);
+            }
+        }
+
+        pos += 4 + qint64(frameSize);
+    }
+
+    if (pos < fileSize) {
+        qDebug() << "ClipboardHistoryStore: truncating damaged log tail at" << pos;
+        m_log.resize(pos);
+    }
+    m_logSize = pos;
+
+    enforceRetention();
+
+    // Сразу читаем только последние записи, остальные - по требованию
+    int preloaded = 0;
+    for (ClipboardEntry& entry : m_entries) {
+        if (preloaded++ >= PRELOAD_COUNT) {
+            break;
+        }
+        ensureLoaded(entry);
+    }
+
+    qDebug() << "ClipboardHistoryStore loaded" << m_index.size() << "entries, log size:" << m_logSize;
+
+    removeOrphanImages();
+
+    if (m_logVersion != LOG_VERSION) {
+        compact();
+    } else {
+        maybeCompact();
+    }
+}
+
+void ClipboardHistoryStore::removeOrphanImages()
+{
+    // Файлы, на которые нет записей (удалены при недоступном журнале или после сбоя)
+    QDir imageDir(m_imageDir);
+    const QFileInfoList files = imageDir.entryInfoList({"*.png"}, QDir::Files);
+    for (const QFileInfo& file : files) {
+        QByteArray hash = QByteArray::fromHex(file.completeBaseName().toLatin1());
+        auto indexIt = m_index.constFind(hash);
+        if (indexIt == m_index.constEnd() || indexIt.value()->type != ClipboardEntry::Image) {
+            QFile::remove(file.absoluteFilePath());
+        }
+    }
+}
+
+bool ClipboardHistoryStore::ensureLoaded(ClipboardEntry& entry)
+{
+    if (entry.loaded) {
+        return true;
+    }
+
+    QByteArray payload;
+    if (!readPayload(entry, &payload)) {
+        return false;
+    }
+
+    if (entry.type == ClipboardEntry::Image) {
+        entry.thumbnail.loadFromData(payload, "PNG");
+    } else {
+        entry.text = QString::fromUtf8(payload);
+    }
+    entry.loaded = true;
+    return true;
+}
+
+bool ClipboardHistoryStore::readPayload(const ClipboardEntry& entry, QByteArray* payload)
+{
+    if (!m_log.isOpen() || entry.logOffset < 0) {
+        return false;
+    }
+
+    m_log.seek(entry.logOffset);
+    *payload = m_log.read(entry.byteSize);
+    return payload->size() == entry.byteSize;
+}
+
+bool ClipboardHistoryStore::appendRecord(LogOp op, const ClipboardEntry& entry, qint64* payloadOffset,
+                                         const QByteArray& thumbnailData)
+{
+    // В журнал старой версии не дописываем - он будет переписан при компактировании
+    if (!m_persistent || !m_log.isOpen() || m_logVersion != LOG_VERSION) {
+        return false;
+    }
+
+    QByteArray payload;
+    if (op == OpAdd) {
+        if (entry.type == ClipboardEntry::Text) {
+            payload = entry.text.toUtf8();
+        } else {
+            payload = thumbnailData.isEmpty() ? thumbnailPng(entry.thumbnail) : thumbnailData;
+        }
+    }
+    QByteArray record = buildRecord(op, entry.type, entry.hash, entry.timestamp, payload);
+
+    m_log.seek(m_logSize);
+    if (m_log.write(record) != record.size()) {
+        qDebug() << "ClipboardHistoryStore: failed to append to log" << m_log.errorString();
+        return false;
+    }
+    m_log.flush();
+
+    if (payloadOffset) {
+        *payloadOffset = m_logSize + RECORD_HEADER_SIZE;
+    }
+    m_logSize += record.size();
+    return true;
+}
+
+QByteArray ClipboardHistoryStore::addText(const QString& text)
+{
+    if (text.isEmpty()) {
+        return QByteArray();
+    }
+
+    ClipboardEntry entry;
+    entry.hash = hashText(text);
+    entry.type = ClipboardEntry::Text;
+    entry.text = text;
+    return insert(entry);
+}
+
+void ClipboardHistoryStore::addImage(const QImage& image)
+{
+    if (image.isNull()) {
+        return;
+    }
+
+    // Хеш, миниатюра и сжатие оригинала - в фоновом потоке
+    startImageIngest(QtConcurrent::run(&m_imagePool, &ClipboardHistoryStore::ingestImage, image, m_imageDir,
+                                       QByteArray()));
+}
+
+void ClipboardHistoryStore::addImageFile(const QString& filePath)
+{
+    // Файл читается и декодируется в фоновом потоке, а не в GUI
+    startImageIngest(QtConcurrent::run(&m_imagePool, &ClipboardHistoryStore::ingestImageFile, filePath, m_imageDir));
+}
+
+void ClipboardHistoryStore::startImageIngest(const QFuture<ImageIngestResult>& future)
+{
+    QFutureWatcher<ImageIngestResult>* watcher = new QFutureWatcher<ImageIngestResult>(this);
+    connect(watcher, &QFutureWatcher<ImageIngestResult>::finished, this, [this, watcher]() {
+        finishImageIngest(watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(future);
+}
+
+ClipboardHistoryStore::ImageIngestResult ClipboardHistoryStore::ingestImageFile(const QString& filePath, const QString& imageDir)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "ClipboardHistoryStore: failed to open image file" << filePath << file.errorString();
+        return ImageIngestResult();
+    }
+    QByteArray data = file.readAll();
+    file.close();
+
+    QBuffer buffer(&data);
+    QImageReader reader(&buffer);
+    reader.setAutoTransform(true);
+    const QByteArray format = reader.format();
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qDebug() << "ClipboardHistoryStore: failed to read image file" << filePath << reader.errorString();
+        return ImageIngestResult();
+    }
+
+    // PNG и JPEG уже сжаты - сохраняем исходные байты файла без повторного сжатия
+    if (format == "png" || format == "jpeg") {
+        return ingestImage(image, imageDir, data);
+    }
+    return ingestImage(image, imageDir);
+}
+
+ClipboardHistoryStore::ImageIngestResult ClipboardHistoryStore::ingestImage(const QImage& image, const QString& imageDir,
+                                                                            const QByteArray& encoded)
+{
+    ImageIngestResult result;
+    result.hash = hashImage(image);
+    result.thumbnail = ImageResampler::scaled(image, QSize(THUMBNAIL_SIZE, THUMBNAIL_SIZE), Qt::KeepAspectRatio,
+                                               ImageResampler::Area);
+    result.thumbnailPng = thumbnailPng(result.thumbnail);
+
+    // Одинаковое содержимое - один и тот же файл, повторно не сжимаем
+    QString path = imageDir + "/" + QString::fromLatin1(result.hash.toHex()) + ".png";
+    if (QFileInfo::exists(path)) {
+        result.image = image;
+        result.stored = true;
+        return result;
+    }
+
+    QDir().mkpath(imageDir);
+    QSaveFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        if (!encoded.isEmpty()) {
+            result.stored = file.write(encoded) == encoded.size() && file.commit();
+        } else {
+            QImageWriter writer(&file, "PNG");
+            writer.setCompression(9);
+            result.stored = writer.write(image) && file.commit();
+        }
+    }
+    if (!result.stored) {
+        qDebug() << "ClipboardHistoryStore: failed to store image" << path;
+    }
+    return result;
+}
+
+void ClipboardHistoryStore::finishImageIngest(const ImageIngestResult& result)
+{
+    if (!result.stored) {
+        return;
+    }
+
+    // Пока шла обработка, запись с тем же содержимым могла быть удалена
+    // вместе с файлом - сжимаем оригинал заново
+    if (!result.image.isNull() && !m_index.contains(result.hash) && !QFileInfo::exists(imagePath(result.hash))) {
+        addImage(result.image);
+        return;
+    }
+
+    ClipboardEntry entry;
+    entry.hash = result.hash;
+    entry.type = ClipboardEntry::Image;
+    entry.thumbnail = result.thumbnail;
+    entry.byteSize = result.thumbnailPng.size();
+    insert(entry, result.thumbnailPng);
+
+    emit imageAdded(result.hash);
+}
+
+QByteArray ClipboardHistoryStore::thumbnailPng(const QImage& thumbnail)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    thumbnail.save(&buffer, "PNG");
+    return data;
+}
+
+QString ClipboardHistoryStore::imagePath(const QByteArray& hash) const
+{
+    // Файлы изображений, скопированных как файлы, хранят исходные байты JPEG
+    // под тем же расширением - при чтении формат определяется по содержимому
+    return m_imageDir + "/" + QString::fromLatin1(hash.toHex()) + ".png";
+}
+
+QImage ClipboardHistoryStore::loadImage(const QByteArray& hash) const
+{
+    QImageReader reader(imagePath(hash));
+    reader.setDecideFormatFromContent(true);
+    reader.setAutoTransform(true);
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qDebug() << "ClipboardHistoryStore: failed to decode image" << reader.fileName() << reader.errorString();
+    }
+    return image;
+}
+
+qint64 ClipboardHistoryStore::thumbnailMemoryBytes() const
+{
+    qint64 bytes = 0;
+    for (const ClipboardEntry& entry : m_entries) {
+        bytes += entry.thumbnail.sizeInBytes();
+    }
+    return bytes;
+}
+
+QByteArray ClipboardHistoryStore::insert(ClipboardEntry entry, const QByteArray& thumbnailData)
+{
+    entry.timestamp = QDateTime::currentMSecsSinceEpoch();
+
+    // Уже есть в истории - только перемещаем в начало
+    auto indexIt = m_index.find(entry.hash);
+    if (indexIt != m_index.end()) {
+        EntryList::iterator it = indexIt.value();
+        it->timestamp = entry.timestamp;
+        appendRecord(OpTouch, *it);
+        m_entries.splice(m_entries.begin(), m_entries, it);
+        emit entryMovedToFront(entry.hash);
+        maybeCompact();
+        return entry.hash;
+    }
+
+    if (entry.type == ClipboardEntry::Text) {
+        entry.byteSize = entry.text.toUtf8().size();
+        m_totalBytes += entry.byteSize;
+    } else {
+        ++m_imageCount;
+    }
+    if (appendRecord(OpAdd, entry, &entry.logOffset, thumbnailData)) {
+        m_liveLogBytes += RECORD_HEADER_SIZE + entry.byteSize;
+    }
+
+    m_entries.push_front(entry);
+    m_index.insert(entry.hash, m_entries.begin());
+    emit entryInserted(entry.hash);
+
+    enforceRetention();
+    maybeCompact();
+    return entry.hash;
+}
+
+bool ClipboardHistoryStore::moveToFront(const QByteArray& hash)
+{
+    auto indexIt = m_index.find(hash);
+    if (indexIt == m_index.end()) {
+        return false;
+    }
+
+    EntryList::iterator it = indexIt.value();
+    it->timestamp = QDateTime::currentMSecsSinceEpoch();
+    appendRecord(OpTouch, *it);
+    m_entries.splice(m_entries.begin(), m_entries, it);
+    emit entryMovedToFront(hash);
+    return true;
+}
+
+void ClipboardHistoryStore::remove(const QByteArray& hash)
+{
+    auto indexIt = m_index.find(hash);
+    if (indexIt != m_index.end()) {
+        removeIterator(indexIt.value(), true);
+        maybeCompact();
+    }
+}
+
+ClipboardHistoryStore::EntryList::iterator ClipboardHistoryStore::removeIterator(EntryList::iterator it, bool writeLog)
+{
+    if (writeLog) {
+        appendRecord(OpRemove, *it);
+    }
+    if (it->logOffset >= 0) {
+        m_liveLogBytes -= RECORD_HEADER_SIZE + it->byteSize;
+    }
+
+    if (it->type == ClipboardEntry::Text) {
+        m_totalBytes -= it->byteSize;
+    } else {
+        --m_imageCount;
+        // При воспроизведении журнала файл еще может понадобиться (запись добавят снова)
+        if (writeLog) {
+            QFile::remove(imagePath(it->hash));
+        }
+    }
+
+    QByteArray hash = it->hash;
+    m_index.remove(hash);
+    EntryList::iterator next = m_entries.erase(it);
+    emit entryRemoved(hash);
+    return next;
+}
+
+void ClipboardHistoryStore::clear()
+{
+    while (!m_entries.empty()) {
+        removeIterator(m_entries.begin(), false);
+    }
+    removeOrphanImages();
+
+    if (m_persistent && m_log.isOpen()) {
+        m_log.resize(0);
+        m_log.seek(0);
+        m_log.write(logHeader());
+        m_log.flush();
+        m_logSize = LOG_HEADER_SIZE;
+    }
+    m_liveLogBytes = 0;
+}
+
+void ClipboardHistoryStore::setRetention(int maxCount, qint64 maxBytes, int maxAgeDays)
+{
+    m_maxCount = maxCount;
+    m_maxBytes = maxBytes;
+    m_maxAgeDays = maxAgeDays;
+
+    QSettings settings("MyCompany", "DockApp");
+    settings.setValue("Clipboard/HistoryMaxCount", m_maxCount);
+    settings.setValue("Clipboard/HistoryMaxBytes", m_maxBytes);
+    settings.setValue("Clipboard/HistoryMaxAgeDays", m_maxAgeDays);
+
+    enforceRetention();
+    maybeCompact();
+}
+
+void ClipboardHistoryStore::setMaxImageCount(int maxImageCount)
+{
+    m_maxImageCount = maxImageCount;
+
+    QSettings settings("MyCompany", "DockApp");
+    settings.setValue("Clipboard/ImageHistoryMaxCount", m_maxImageCount);
+
+    enforceRetention();
+    maybeCompact();
+}
+
+void ClipboardHistoryStore::enforceRetention()
+{
+    const qint64 ageCutoff = m_maxAgeDays > 0
+        ? QDateTime::currentMSecsSinceEpoch() - qint64(m_maxAgeDays) * 24 * 60 * 60 * 1000
+        : 0;
+
+    // Записи упорядочены по времени использования, поэтому идем с конца
+    // и останавливаемся на первой записи, которая проходит все ограничения
+    EntryList::iterator it = m_entries.end();
+    while (it != m_entries.begin()) {
+        --it;
+
+        const int textCount = m_index.size() - m_imageCount;
+        const bool textOver = (m_maxCount > 0 && textCount > m_maxCount) ||
+                              (m_maxBytes > 0 && m_totalBytes > m_maxBytes);
+        const bool imageOver = m_maxImageCount >= 0 && m_imageCount > m_maxImageCount;
+        const bool expired = m_maxAgeDays > 0 && it->timestamp < ageCutoff;
+
+        if (!textOver && !imageOver && !expired) {
+            break;
+        }
+
+        const bool isImage = it->type == ClipboardEntry::Image;
+        if (expired || (isImage && imageOver) || (!isImage && textOver)) {
+            it = removeIterator(it, true);
+        }
+    }
+}
+
+void ClipboardHistoryStore::maybeCompact()
+{
+    if (m_persistent && m_logSize > COMPACT_MIN_LOG_SIZE && m_logSize > 2 * m_liveLogBytes) {
+        compact();
+    }
+}
+
+bool ClipboardHistoryStore::compact()
+{
+    if (!m_persistent || !m_log.isOpen()) {
+        return false;
+    }
+
+    QSaveFile file(m_logPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "ClipboardHistoryStore: failed to compact log" << file.errorString();
+        return false;
+    }
+
+    file.write(logHeader());
+    qint64 pos = LOG_HEADER_SIZE;
+
+    // Записываем от старых к новым, чтобы при воспроизведении сохранился порядок.
+    // Тексты и миниатюры читаются из старого журнала без загрузки в память и повторного сжатия
+    QHash<QByteArray, qint64> newOffsets;
+    for (auto it = m_entries.rbegin(); it != m_entries.rend(); ++it) {
+        QByteArray payload;
+        if (!it->loaded || (it->type == ClipboardEntry::Image && it->logOffset >= 0)) {
+            m_log.seek(it->logOffset);
+            payload = m_log.read(it->byteSize);
+        } else if (it->type == ClipboardEntry::Image) {
+            payload = thumbnailPng(it->thumbnail);
+        } else {
+            payload = it->text.toUtf8();
+        }
+        it->byteSize = payload.size();
+
+        QByteArray record = buildRecord(OpAdd, it->type, it->hash, it->timestamp, payload);
+        file.write(record);
+        newOffsets.insert(it->hash, pos + RECORD_HEADER_SIZE);
+        pos += record.size();
+    }
+
+    // Открытый файл журнала не дает заменить его на Windows
+    m_log.close();
+    const bool committed = file.commit();
+    openLog();
+
+    if (!committed) {
+        qDebug() << "ClipboardHistoryStore: failed to replace log" << file.errorString();
+        return false;
+    }
+
+    for (ClipboardEntry& entry : m_entries) {
+        auto offsetIt = newOffsets.constFind(entry.hash);
+        if (offsetIt != newOffsets.constEnd()) {
+            entry.logOffset = offsetIt.value();
+        }
+    }
+
+    qDebug() << "ClipboardHistoryStore compacted log from" << m_logSize << "to" << pos << "bytes";
+    m_logSize = pos;
+    m_liveLogBytes = pos - LOG_HEADER_SIZE;
+    m_logVersion = LOG_VERSION;
+    return true;
+}
+
+QList<ClipboardEntry> ClipboardHistoryStore::entries(ClipboardEntry::Type type, int offset, int limit)
+{
+    QList<ClipboardEntry> result;
+
+    int skipped = 0;
+    for (ClipboardEntry& entry : m_entries) {
+        if (entry.type != type) {
+            continue;
+        }
+        if (skipped < offset) {
+            ++skipped;
+            continue;
+        }
+        if (limit >= 0 && result.size() >= limit) {
+            break;
+        }
+
+        ensureLoaded(entry);
+        result.append(entry);
+    }
+
+    return result;
+}
+
+QList<QByteArray> ClipboardHistoryStore::hashes() const
+{
+    QList<QByteArray> result;
+    result.reserve(m_index.size());
+    for (const ClipboardEntry& entry : m_entries) {
+        result.append(entry.hash);
+    }
+    return result;
+}
+
+const ClipboardEntry* ClipboardHistoryStore::entry(const QByteArray& hash)
+{
+    auto indexIt = m_index.find(hash);
+    if (indexIt == m_index.end()) {
+        return nullptr;
+    }
+
+    ClipboardEntry& entry = *indexIt.value();
+    ensureLoaded(entry);
+    return &entry;
+}
+
+const ClipboardEntry* ClipboardHistoryStore::cachedEntry(const QByteArray& hash) const
+{
+    auto indexIt = m_index.constFind(hash);
+    return indexIt != m_index.constEnd() ? &*indexIt.value() : nullptr;
+}
+
+QString ClipboardHistoryStore::text(const QByteArray& hash)
+{
+    auto indexIt = m_index.find(hash);
+    if (indexIt == m_index.end()) {
+        return QString();
+    }
+
+    ClipboardEntry& entry = *indexIt.value();
+    ensureLoaded(entry);
+    return entry.text;
+}
+
+QString ClipboardHistoryStore::peekText(const QByteArray& hash)
+{
+    auto indexIt = m_index.constFind(hash);
+    if (indexIt == m_index.constEnd() || indexIt.value()->type != ClipboardEntry::Text) {
+        return QString();
+    }
+
+    const ClipboardEntry& entry = *indexIt.value();
+    if (entry.loaded) {
+        return entry.text;
+    }
+
+    QByteArray payload;
+    return readPayload(entry, &payload) ? QString::fromUtf8(payload) : QString();
+}
@@ -0,0 +1,186 @@
+#ifndef CLIPBOARDHISTORYSTORE_H
+#define CLIPBOARDHISTORYSTORE_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QFile>
+#include <QFuture>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QString>
+#include <QThreadPool>
+#include <list>
+
+class QMimeData;
+
+// Запись истории буфера обмена
+struct ClipboardEntry {
+    enum Type : quint8 {
+        Text = 1,
+        Image = 2
+    };
+
+    QByteArray hash;          // SHA-1 содержимого - ключ для дедупликации
+    Type type = Text;
+    qint64 timestamp = 0;     // Время последнего копирования (мс с начала эпохи)
+    QString text;             // Текст (для старых записей загружается по требованию)
+    QImage thumbnail;         // Миниатюра изображения; оригинал хранится в файле
+    qint64 byteSize = 0;      // Размер текста или сжатой миниатюры в байтах
+    qint64 logOffset = -1;    // Смещение данных в журнале, -1 - записи нет на диске
+    bool loaded = true;       // false - данные еще не прочитаны из журнала
+};
+
+// Хранилище истории буфера обмена.
+// Записи упорядочены от новых к старым, индекс по хешу содержимого дает
+// дедупликацию и перемещение в начало за O(1). Текстовые записи сохраняются
+// в журнал, в который только дописываются записи добавления, использования
+// и удаления; при накоплении мусора журнал переписывается (компактируется).
+// При загрузке в память читаются только последние записи, тексты более
+// старых читаются из журнала при первом обращении.
+// Изображения сжимаются в файлы в фоновом потоке, в памяти и журнале
+// остается только миниатюра; оригинал декодируется при вставке.
+class ClipboardHistoryStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Ограничения по умолчанию
+    static inline const int DEFAULT_MAX_COUNT = 1000;
+    static inline const qint64 DEFAULT_MAX_BYTES = 16 * 1024 * 1024;
+    static inline const int DEFAULT_MAX_AGE_DAYS = 30;
+    static inline const int DEFAULT_MAX_IMAGE_COUNT = 100;
+    static inline const int THUMBNAIL_SIZE = 64;
+    // Сколько последних записей загружается сразу при старте
+    static inline const int PRELOAD_COUNT = 100;
+    // Компактирование, когда журнал больше этого размера и вдвое больше живых данных
+    static inline const qint64 COMPACT_MIN_LOG_SIZE = 256 * 1024;
+
+    // Пустой путь - файл по умолчанию в AppDataLocation
+    explicit ClipboardHistoryStore(const QString& logPath = QString(), QObject* parent = nullptr);
+    ~ClipboardHistoryStore();
+
+    // Читает журнал. Без вызова хранилище работает только в памяти
+    void load();
+
+    // Добавляет запись или перемещает существующую в начало. Возвращает хеш записи
+    QByteArray addText(const QString& text);
+    // Изображение обрабатывается в фоне, по готовности испускается imageAdded
+    void addImage(const QImage& image);
+    // То же для файла изображения - файл читается в фоне, PNG и JPEG сохраняются без пересжатия
+    void addImageFile(const QString& filePath);
+
+    // Декодирует оригинал изображения из файла
+    QImage loadImage(const QByteArray& hash) const;
+    QString imagePath(const QByteArray& hash) const;
+    // Память, занимаемая миниатюрами
+    qint64 thumbnailMemoryBytes() const;
+
+    bool contains(const QByteArray& hash) const { return m_index.contains(hash); }
+    bool moveToFront(const QByteArray& hash);
+    void remove(const QByteArray& hash);
+    void clear();
+
+    int count() const { return m_index.size(); }
+    qint64 totalBytes() const { return m_totalBytes; }
+    qint64 logSize() const { return m_logSize; }
+
+    // Записи от новых к старым (тексты загружаются при необходимости)
+    QList<ClipboardEntry> entries(ClipboardEntry::Type type, int offset = 0, int limit = -1);
+    QList<QByteArray> hashes() const;
+    // Запись с загруженными данными; nullptr - записи нет
+    const ClipboardEntry* entry(const QByteArray& hash);
+    // Запись без обращения к журналу (данные могут быть не загружены)
+    const ClipboardEntry* cachedEntry(const QByteArray& hash) const;
+    QString text(const QByteArray& hash);
+    // Текст без кэширования: незагруженная запись читается из журнала и остается незагруженной
+    QString peekText(const QByteArray& hash);
+
+    void setRetention(int maxCount, qint64 maxBytes, int maxAgeDays);
+    void setMaxImageCount(int maxImageCount);
+    int maxImageCount() const { return m_maxImageCount; }
+    int maxCount() const { return m_maxCount; }
+    qint64 maxBytes() const { return m_maxBytes; }
+    int maxAgeDays() const { return m_maxAgeDays; }
+
+    // Переписывает журнал, оставляя только живые записи
+    bool compact();
+
+    static QByteArray hashText(const QString& text);
+    static QByteArray hashImage(const QImage& image);
+    static QByteArray thumbnailPng(const QImage& thumbnail);
+
+    // Содержимое, которое источник просит не сохранять в истории
+    // (менеджеры паролей помечают так скопированные пароли)
+    static bool isExcludedFromHistory(const QMimeData* mimeData);
+
+signals:
+    void entryInserted(const QByteArray& hash);
+    void entryMovedToFront(const QByteArray& hash);
+    void entryRemoved(const QByteArray& hash);
+    void imageAdded(const QByteArray& hash);
+
+private:
+    // Операции журнала
+    enum LogOp : quint8 {
+        OpAdd = 'A',
+        OpTouch = 'T',
+        OpRemove = 'R'
+    };
+
+    // std::list - итераторы остаются валидными при перемещении узлов (splice)
+    using EntryList = std::list<ClipboardEntry>;
+
+    // Результат фоновой обработки изображения
+    struct ImageIngestResult {
+        QByteArray hash;
+        QImage thumbnail;
+        QByteArray thumbnailPng;
+        // Оригинал, если файл уже существовал и не записывался: к моменту
+        // обработки результата файл может быть удален вместе с записью
+        QImage image;
+        bool stored = false;
+    };
+    // encoded - готовые байты PNG или JPEG для файла; пусто - оригинал сжимается в PNG
+    static ImageIngestResult ingestImage(const QImage& image, const QString& imageDir,
+                                         const QByteArray& encoded = QByteArray());
+    static ImageIngestResult ingestImageFile(const QString& filePath, const QString& imageDir);
+    void startImageIngest(const QFuture<ImageIngestResult>& future);
+    void finishImageIngest(const ImageIngestResult& result);
+    void removeOrphanImages();
+
+    // thumbnailData - готовая сжатая миниатюра изображения, чтобы не сжимать ее повторно
+    QByteArray insert(ClipboardEntry entry, const QByteArray& thumbnailData = QByteArray());
+    // Возвращает итератор на следующую запись
+    EntryList::iterator removeIterator(EntryList::iterator it, bool writeLog);
+    void enforceRetention();
+    bool ensureLoaded(ClipboardEntry& entry);
+    bool readPayload(const ClipboardEntry& entry, QByteArray* payload);
+
+    bool openLog();
+    bool appendRecord(LogOp op, const ClipboardEntry& entry, qint64* payloadOffset = nullptr,
+                      const QByteArray& thumbnailData = QByteArray());
+    void maybeCompact();
+    void loadSettings();
+
+    QString m_logPath;
+    QString m_imageDir;
+    QFile m_log;
+    quint32 m_logVersion;
+    bool m_persistent;
+    qint64 m_logSize;
+    qint64 m_liveLogBytes;
+
+    EntryList m_entries;
+    QHash<QByteArray, EntryList::iterator> m_index;
+    qint64 m_totalBytes;
+    int m_imageCount;
+    QThreadPool m_imagePool;
+
+    int m_maxCount;
+    qint64 m_maxBytes;
+    int m_maxAgeDays;
+    int m_maxImageCount;
+};
+
+#endif // CLIPBOARDHISTORYSTORE_H
@@ -0,0 +1,108 @@
+#include "ClipboardPreviewLoader.h"
+#include "../ImageResampler.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QImageReader>
+#include <QtConcurrent>
+
+ClipboardPreviewLoader::ClipboardPreviewLoader(QObject* parent)
+    : QObject(parent)
+    , m_cache(CACHE_MAX_BYTES)
+{
+    m_pool.setMaxThreadCount(MAX_THREADS);
+}
+
+ClipboardPreviewLoader::~ClipboardPreviewLoader()
+{
+    cancelPending();
+    m_pool.waitForDone();
+}
+
+QString ClipboardPreviewLoader::cacheKey(const QString& filePath)
+{
+    // Измененный файл получает новый ключ, старая миниатюра вытесняется из кэша
+    QFileInfo info(filePath);
+    return info.absoluteFilePath() + '|' + QString::number(info.lastModified().toMSecsSinceEpoch());
+}
+
+QImage ClipboardPreviewLoader::preview(const QString& filePath)
+{
+    const QString key = cacheKey(filePath);
+
+    if (QImage* cached = m_cache.object(key)) {
+        return *cached;
+    }
+    if (m_failed.contains(key) || m_pending.contains(key)) {
+        return QImage();
+    }
+
+    QSharedPointer<QAtomicInt> cancelled(new QAtomicInt(0));
+    m_pending.insert(key, cancelled);
+
+    QFutureWatcher<QImage>* watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, key, filePath, cancelled]() {
+        watcher->deleteLater();
+
+        // Задача отменена - результат не нужен, ключ уже убран из очереди
+        if (cancelled->loadRelaxed()) {
+            return;
+        }
+        m_pending.remove(key);
+
+        QImage image = watcher->result();
+        if (image.isNull()) {
+            m_failed.insert(key);
+        } else {
+            m_cache.insert(key, new QImage(image), qMax<qsizetype>(1, image.sizeInBytes()));
+        }
+        emit previewReady(filePath, image);
+    });
+    watcher->setFuture(QtConcurrent::run(&m_pool, &ClipboardPreviewLoader::decodePreview, filePath, cancelled));
+
+    return QImage();
+}
+
+bool ClipboardPreviewLoader::hasFailed(const QString& filePath) const
+{
+    return m_failed.contains(cacheKey(filePath));
+}
+
+void ClipboardPreviewLoader::cancelPending()
+{
+    for (const QSharedPointer<QAtomicInt>& cancelled : std::as_const(m_pending)) {
+        cancelled->storeRelaxed(1);
+    }
+    m_pending.clear();
+}
+
+QImage ClipboardPreviewLoader::decodePreview(const QString& filePath, QSharedPointer<QAtomicInt> cancelled)
+{
+    if (cancelled->loadRelaxed()) {
+        return QImage();
+    }
+
+    QImageReader reader(filePath);
+    reader.setAutoTransform(true);
+
+    // Декодируем сразу в размере миниатюры - для JPEG и других форматов
+    // с поддержкой масштабирования полный кадр не распаковывается
+    QSize size = reader.size();
+    if (size.isValid()) {
+        reader.setScaledSize(size.scaled(PREVIEW_SIZE, PREVIEW_SIZE, Qt::KeepAspectRatio));
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qDebug() << "ClipboardPreviewLoader: failed to decode" << filePath << reader.errorString();
+        return image;
+    }
+
+    // Формат без поддержки размера в заголовке - уменьшаем после декодирования
+    if (image.width() > PREVIEW_SIZE || image.height() > PREVIEW_SIZE) {
+        image = ImageResampler::scaled(image, QSize(PREVIEW_SIZE, PREVIEW_SIZE), Qt::KeepAspectRatio, ImageResampler::Area);
+    }
+    return image;
+}
@@ -0,0 +1,58 @@
+#ifndef CLIPBOARDPREVIEWLOADER_H
+#define CLIPBOARDPREVIEWLOADER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QThreadPool>
+
+// Асинхронная загрузка миниатюр файлов изображений для истории буфера обмена.
+// Файл декодируется в фоновом потоке сразу в размере миниатюры
+// (QImageReader::setScaledSize), результаты кэшируются по пути и времени
+// изменения файла. Незавершенные задачи можно отменить.
+class ClipboardPreviewLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    static inline const int PREVIEW_SIZE = 64;
+    // Ограничение кэша миниатюр (байт)
+    static inline const int CACHE_MAX_BYTES = 16 * 1024 * 1024;
+    static inline const int MAX_THREADS = 2;
+
+    explicit ClipboardPreviewLoader(QObject* parent = nullptr);
+    ~ClipboardPreviewLoader();
+
+    // Миниатюра из кэша. Если ее нет - ставит файл в очередь и возвращает пустое изображение,
+    // по готовности испускается previewReady
+    QImage preview(const QString& filePath);
+
+    // true - файл уже пробовали декодировать и это не удалось
+    bool hasFailed(const QString& filePath) const;
+
+    // Отменяет все задачи, которые еще не начали декодирование
+    void cancelPending();
+    int pendingCount() const { return m_pending.size(); }
+
+    // Пул потоков декодирования (тесты занимают его, чтобы задержать декодирование)
+    QThreadPool* threadPool() { return &m_pool; }
+
+signals:
+    void previewReady(const QString& filePath, const QImage& preview);
+
+private:
+    static QString cacheKey(const QString& filePath);
+    static QImage decodePreview(const QString& filePath, QSharedPointer<QAtomicInt> cancelled);
+
+    QCache<QString, QImage> m_cache;
+    QSet<QString> m_failed;
+    QHash<QString, QSharedPointer<QAtomicInt>> m_pending;
+    QThreadPool m_pool;
+};
+
+#endif // CLIPBOARDPREVIEWLOADER_H
@@ -0,0 +1,253 @@
+#include "ClipboardSearchIndex.h"
+#include "ClipboardHistoryStore.h"
+#include "../DockTelemetry.h"
+
+#include <QDebug>
+#include <algorithm>
+
+ClipboardSearchIndex::ClipboardSearchIndex(ClipboardHistoryStore* store, QObject* parent)
+    : QObject(parent)
+    , m_store(store)
+    , m_built(false)
+    , m_deadCount(0)
+{
+    // Подключаться нужно раньше моделей, чтобы новая запись попадала
+    // в индекс до того, как фильтр ее проверит
+    connect(m_store, &ClipboardHistoryStore::entryInserted, this, &ClipboardSearchIndex::onEntryInserted);
+    connect(m_store, &ClipboardHistoryStore::entryRemoved, this, &ClipboardSearchIndex::onEntryRemoved);
+}
+
+void ClipboardSearchIndex::ensureBuilt()
+{
+    if (m_built) {
+        return;
+    }
+
+    DockTelemetry::ScopedTimer timer("ClipboardSearchIndex::build");
+
+    // От старых к новым - идентификаторы растут вместе со временем добавления.
+    // Тексты старых записей читаются из журнала только на время индексации
+    const QList<QByteArray> hashes = m_store->hashes();
+    for (auto it = hashes.crbegin(); it != hashes.crend(); ++it) {
+        const ClipboardEntry* entry = m_store->cachedEntry(*it);
+        if (entry && entry->type == ClipboardEntry::Text) {
+            addEntry(*it, m_store->peekText(*it));
+        }
+    }
+
+    m_built = true;
+    qDebug() << "Clipboard search index built:" << m_ids.size() << "entries," << m_postings.size() << "trigrams";
+}
+
+QVector<ClipboardSearchIndex::Trigram> ClipboardSearchIndex::trigrams(const QString& foldedText)
+{
+    QVector<Trigram> result;
+    if (foldedText.size() < 3) {
+        return result;
+    }
+
+    result.reserve(foldedText.size() - 2);
+    const QChar* data = foldedText.constData();
+    for (qsizetype i = 0; i + 2 < foldedText.size(); ++i) {
+        result.append((Trigram(data[i].unicode()) << 32) |
+                      (Trigram(data[i + 1].unicode()) << 16) |
+                      Trigram(data[i + 2].unicode()));
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+void ClipboardSearchIndex::addEntry(const QByteArray& hash, const QString& text)
+{
+    if (m_ids.contains(hash)) {
+        return;
+    }
+
+    const quint32 id = quint32(m_hashes.size());
+    m_hashes.append(hash);
+    m_ids.insert(hash, id);
+
+    // Идентификатор больше всех существующих - списки остаются отсортированными
+    const QString folded = text.left(INDEX_TEXT_LIMIT).toCaseFolded();
+    const QVector<Trigram> entryTrigrams = trigrams(folded);
+    for (Trigram trigram : entryTrigrams) {
+        m_postings[trigram].append(id);
+    }
+
+    if (entryTrigrams.isEmpty() && !folded.isEmpty()) {
+        m_shortTexts.insert(id, folded);
+    }
+}
+
+void ClipboardSearchIndex::onEntryInserted(const QByteArray& hash)
+{
+    if (!m_built) {
+        return;
+    }
+
+    const ClipboardEntry* entry = m_store->cachedEntry(hash);
+    if (entry && entry->type == ClipboardEntry::Text) {
+        addEntry(hash, entry->text);
+    }
+}
+
+void ClipboardSearchIndex::onEntryRemoved(const QByteArray& hash)
+{
+    auto it = m_ids.find(hash);
+    if (it == m_ids.end()) {
+        return;
+    }
+
+    // Списки триграмм не трогаем - идентификатор только помечается удаленным
+    m_hashes[it.value()] = QByteArray();
+    m_shortTexts.remove(it.value());
+    m_ids.erase(it);
+    ++m_deadCount;
+
+    if (m_deadCount >= COMPACT_MIN_DEAD && m_deadCount > m_ids.size()) {
+        compact();
+    }
+}
+
+void ClipboardSearchIndex::compact()
+{
+    // Идентификаторы не перенумеровываются, чтобы sequence() оставался монотонным
+    for (auto it = m_postings.begin(); it != m_postings.end();) {
+        QVector<quint32>& ids = it.value();
+        ids.erase(std::remove_if(ids.begin(), ids.end(), [this](quint32 id) {
+            return m_hashes.at(id).isEmpty();
+        }), ids.end());
+
+        if (ids.isEmpty()) {
+            it = m_postings.erase(it);
+        } else {
+            ids.squeeze();
+            ++it;
+        }
+    }
+
+    m_deadCount = 0;
+}
+
+QSet<QByteArray> ClipboardSearchIndex::search(const QString& query)
+{
+    QSet<QByteArray> result;
+    if (query.isEmpty()) {
+        return result;
+    }
+
+    DockTelemetry::ScopedTimer timer("ClipboardSearchIndex::search");
+    ensureBuilt();
+
+    const QString folded = query.toCaseFolded();
+    const QVector<Trigram> queryTrigrams = trigrams(folded.left(INDEX_TEXT_LIMIT));
+
+    if (queryTrigrams.isEmpty()) {
+        return searchShort(folded);
+    }
+
+    QVector<const QVector<quint32>*> lists;
+    lists.reserve(queryTrigrams.size());
+    for (Trigram trigram : queryTrigrams) {
+        auto it = m_postings.constFind(trigram);
+        if (it == m_postings.constEnd()) {
+            return result;
+        }
+        lists.append(&it.value());
+    }
+
+    // Пересечение от самого короткого списка: каждый следующий список
+    // просматривается двоичным поиском с последней найденной позиции
+    std::sort(lists.begin(), lists.end(), [](const QVector<quint32>* a, const QVector<quint32>* b) {
+        return a->size() < b->size();
+    });
+
+    QVector<quint32> candidates = *lists.first();
+    for (int i = 1; i < lists.size() && !candidates.isEmpty(); ++i) {
+        const QVector<quint32>& other = *lists.at(i);
+        QVector<quint32> next;
+        auto from = other.constBegin();
+        for (quint32 id : std::as_const(candidates)) {
+            from = std::lower_bound(from, other.constEnd(), id);
+            if (from == other.constEnd()) {
+                break;
+            }
+            if (*from == id) {
+                next.append(id);
+            }
+        }
+        candidates.swap(next);
+    }
+
+    // Одна триграмма совпадает точно, для длинных запросов проверяем порядок символов
+    const bool verify = folded.size() > 3;
+    result.reserve(candidates.size());
+    for (quint32 id : std::as_const(candidates)) {
+        const QByteArray& hash = m_hashes.at(id);
+        if (hash.isEmpty()) {
+            continue;
+        }
+        if (!verify || m_store->peekText(hash).contains(query, Qt::CaseInsensitive)) {
+            result.insert(hash);
+        }
+    }
+
+    return result;
+}
+
+QSet<QByteArray> ClipboardSearchIndex::searchShort(const QString& foldedQuery) const
+{
+    // Текст из трех и более символов содержит запрос, только если его
+    // содержит одна из триграмм текста, - достаточно перебрать ключи
+    // триграмм (их число ограничено набором символов, а не размером истории)
+    const ushort first = foldedQuery.at(0).unicode();
+    const bool pair = foldedQuery.size() == 2;
+    const ushort second = pair ? foldedQuery.at(1).unicode() : 0;
+
+    QSet<quint32> ids;
+    for (auto it = m_postings.constBegin(); it != m_postings.constEnd(); ++it) {
+        const ushort c0 = ushort(it.key() >> 32);
+        const ushort c1 = ushort(it.key() >> 16);
+        const ushort c2 = ushort(it.key());
+        const bool found = pair
+            ? (c0 == first && c1 == second) || (c1 == first && c2 == second)
+            : c0 == first || c1 == first || c2 == first;
+        if (found) {
+            for (quint32 id : it.value()) {
+                ids.insert(id);
+            }
+        }
+    }
+
+    for (auto it = m_shortTexts.constBegin(); it != m_shortTexts.constEnd(); ++it) {
+        if (it.value().contains(foldedQuery)) {
+            ids.insert(it.key());
+        }
+    }
+
+    QSet<QByteArray> result;
+    result.reserve(ids.size());
+    for (quint32 id : std::as_const(ids)) {
+        const QByteArray& hash = m_hashes.at(id);
+        if (!hash.isEmpty()) {
+            result.insert(hash);
+        }
+    }
+    return result;
+}
+
+bool ClipboardSearchIndex::matches(const QByteArray& hash, const QString& query)
+{
+    if (!m_ids.contains(hash)) {
+        return false;
+    }
+    return m_store->peekText(hash).contains(query, Qt::CaseInsensitive);
+}
+
+bool ClipboardSearchIndex::indexedAfter(const QByteArray& hash, quint32 sequence) const
+{
+    auto it = m_ids.constFind(hash);
+    return it != m_ids.constEnd() && it.value() >= sequence;
+}
@@ -0,0 +1,81 @@
+#ifndef CLIPBOARDSEARCHINDEX_H
+#define CLIPBOARDSEARCHINDEX_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+class ClipboardHistoryStore;
+
+// Полнотекстовый индекс текстовых записей истории буфера обмена.
+// Для каждой триграммы (три символа текста в нижнем регистре) хранится
+// отсортированный список идентификаторов записей. Поиск пересекает списки
+// триграмм запроса начиная с самого короткого и проверяет кандидатов
+// по полному тексту, поэтому время поиска зависит от числа совпадений,
+// а не от размера истории.
+// Индекс строится при первом поиске и дальше обновляется по сигналам
+// хранилища: новая запись дописывается в конец списков (идентификаторы
+// растут), удаленная помечается и вычищается при компактировании.
+// Сами тексты индекс не хранит и не загружает в хранилище: для построения
+// и проверки кандидатов старые записи читаются из журнала без кэширования.
+// Запросы из одного-двух символов журнал не читают: подходящие записи
+// находятся по триграммам, содержащим запрос.
+class ClipboardSearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Trigram = quint64;
+
+    // Индексируется только начало длинных текстов
+    static inline const int INDEX_TEXT_LIMIT = 16 * 1024;
+    // Компактирование списков, когда удаленных записей больше живых
+    static inline const int COMPACT_MIN_DEAD = 256;
+
+    explicit ClipboardSearchIndex(ClipboardHistoryStore* store, QObject* parent = nullptr);
+
+    // Читает все текстовые записи хранилища (один раз), не оставляя их в памяти
+    void ensureBuilt();
+    bool isBuilt() const { return m_built; }
+
+    // Хеши записей, содержащих строку (без учета регистра)
+    QSet<QByteArray> search(const QString& query);
+    // Проверка одной записи
+    bool matches(const QByteArray& hash, const QString& query);
+
+    // Номер, который получит следующая проиндексированная запись
+    quint32 sequence() const { return quint32(m_hashes.size()); }
+    // true - запись проиндексирована после получения sequence
+    bool indexedAfter(const QByteArray& hash, quint32 sequence) const;
+
+    int entryCount() const { return m_ids.size(); }
+    int trigramCount() const { return m_postings.size(); }
+
+    // Уникальные триграммы текста (текст уже приведен к нижнему регистру), по возрастанию
+    static QVector<Trigram> trigrams(const QString& foldedText);
+
+private slots:
+    void onEntryInserted(const QByteArray& hash);
+    void onEntryRemoved(const QByteArray& hash);
+
+private:
+    void addEntry(const QByteArray& hash, const QString& text);
+    void compact();
+    // Запрос короче триграммы: совпадения ищутся по ключам триграмм и коротким текстам
+    QSet<QByteArray> searchShort(const QString& foldedQuery) const;
+
+    ClipboardHistoryStore* m_store;
+    bool m_built;
+
+    QHash<QByteArray, quint32> m_ids;
+    QVector<QByteArray> m_hashes;   // По идентификатору; пустой хеш - запись удалена
+    int m_deadCount;
+    QHash<Trigram, QVector<quint32>> m_postings;
+    // Тексты короче триграммы (в нижнем регистре) - у них нет триграмм
+    QHash<quint32, QString> m_shortTexts;
+};
+
+#endif // CLIPBOARDSEARCHINDEX_H
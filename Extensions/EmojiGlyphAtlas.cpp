@@ -0,0 +1,175 @@
+#include "EmojiGlyphAtlas.h"
+#include "../EmojiList.h"
+#include "../DockTelemetry.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFontDatabase>
+#include <QFontInfo>
+#include <QFutureWatcher>
+#include <QPainter>
+#include <QtConcurrent>
+#include <QtMath>
+
+QFont EmojiGlyphAtlas::emojiFont(const QFont& baseFont)
+{
+    // Пробуем разные шрифты, поддерживающие эмодзи
+    static const QString family = []() {
+        const QStringList emojiFonts = {
+            "Segoe UI Emoji",
+            "Segoe UI Symbol",
+            "Apple Color Emoji",
+            "Noto Color Emoji",
+            "Android Emoji",
+            "Twemoji Mozilla",
+            "EmojiOne",
+            "Arial"
+        };
+
+        for (const QString& fontName : emojiFonts) {
+            if (QFontDatabase::hasFamily(fontName)) {
+                qDebug() << "Using emoji font:" << fontName;
+                return fontName;
+            }
+        }
+
+        qDebug() << "No emoji font found, using system font";
+        return QString();
+    }();
+
+    QFont font = baseFont;
+    if (!family.isEmpty()) {
+        font.setFamily(family);
+    }
+    return font;
+}
+
+EmojiGlyphAtlas::EmojiGlyphAtlas(const QFont& font, int glyphSize, qreal devicePixelRatio, QObject* parent)
+    : QObject(parent)
+    , m_cellPixels(qCeil(glyphSize * devicePixelRatio))
+    , m_glyphBytes(qsizetype(m_cellPixels) * m_cellPixels * 4)
+    , m_devicePixelRatio(devicePixelRatio)
+    , m_glyphs(qMax<qsizetype>(CACHE_MAX_BYTES, MIN_CACHED_GLYPHS * m_glyphBytes))
+    , m_busy(false)
+    , m_batchScheduled(false)
+    , m_generation(0)
+{
+    // Размер шрифта переводится в пиксели экрана здесь, в потоке GUI
+    m_rasterFont = font;
+    m_rasterFont.setPixelSize(qMax(1, qRound(QFontInfo(font).pixelSize() * devicePixelRatio)));
+}
+
+const QPixmap* EmojiGlyphAtlas::glyph(int catalogRow)
+{
+    if (QPixmap* cached = m_glyphs.object(catalogRow)) {
+        return cached;
+    }
+    request(catalogRow);
+    return nullptr;
+}
+
+void EmojiGlyphAtlas::request(int catalogRow)
+{
+    if (catalogRow < 0 || catalogRow >= EmojiCatalog::count() ||
+        m_requested.contains(catalogRow) || m_glyphs.contains(catalogRow)) {
+        return;
+    }
+
+    m_requested.insert(catalogRow);
+    m_queue.append(catalogRow);
+    scheduleBatch();
+}
+
+void EmojiGlyphAtlas::cancelPending()
+{
+    for (int row : std::as_const(m_queue)) {
+        m_requested.remove(row);
+    }
+    m_queue.clear();
+}
+
+void EmojiGlyphAtlas::clear()
+{
+    cancelPending();
+    m_requested.clear();
+    m_glyphs.clear();
+    ++m_generation;
+}
+
+void EmojiGlyphAtlas::scheduleBatch()
+{
+    // Запросы одной отрисовки собираются в одно задание
+    if (m_batchScheduled || m_busy) {
+        return;
+    }
+    m_batchScheduled = true;
+    QMetaObject::invokeMethod(this, &EmojiGlyphAtlas::startBatch, Qt::QueuedConnection);
+}
+
+void EmojiGlyphAtlas::startBatch()
+{
+    m_batchScheduled = false;
+    if (m_busy || m_queue.isEmpty()) {
+        return;
+    }
+
+    const QVector<int> rows = m_queue.mid(0, BATCH_SIZE);
+    m_queue.remove(0, rows.size());
+    m_busy = true;
+
+    const quint32 generation = m_generation;
+    QFutureWatcher<RasterResult>* watcher = new QFutureWatcher<RasterResult>(this);
+    connect(watcher, &QFutureWatcher<RasterResult>::finished, this, [this, watcher, generation]() {
+        watcher->deleteLater();
+        m_busy = false;
+
+        RasterResult result = watcher->result();
+        DockTelemetry::recordDuration("EmojiGlyphAtlas::rasterize", quint64(result.elapsedUs));
+
+        if (generation == m_generation) {
+            // Преобразование в QPixmap - только в потоке GUI
+            for (int i = 0; i < result.rows.size(); ++i) {
+                const int row = result.rows.at(i);
+                m_requested.remove(row);
+                QPixmap* pixmap = new QPixmap(QPixmap::fromImage(std::move(result.images[i])));
+                m_glyphs.insert(row, pixmap, qMax<qsizetype>(1, m_glyphBytes));
+            }
+            emit glyphsReady();
+        }
+
+        startBatch();
+    });
+    watcher->setFuture(QtConcurrent::run(&EmojiGlyphAtlas::rasterize, m_rasterFont, m_cellPixels,
+                                         m_devicePixelRatio, rows));
+}
+
+EmojiGlyphAtlas::RasterResult EmojiGlyphAtlas::rasterize(QFont font, int cellPixels, qreal devicePixelRatio,
+                                                        QVector<int> rows)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    RasterResult result;
+    result.rows = rows;
+    result.images.reserve(rows.size());
+
+    const QRect cell(0, 0, cellPixels, cellPixels);
+    for (int row : std::as_const(rows)) {
+        QImage image(cellPixels, cellPixels, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::TextAntialiasing);
+        painter.setFont(font);
+        // Монохромные глифы (если цветного шрифта нет) рисуются светлыми, как текст списка
+        painter.setPen(Qt::white);
+        painter.drawText(cell, Qt::AlignCenter, EmojiCatalog::emoji(row));
+        painter.end();
+
+        image.setDevicePixelRatio(devicePixelRatio);
+        result.images.append(std::move(image));
+    }
+
+    result.elapsedUs = timer.nsecsElapsed() / 1000;
+    return result;
+}
@@ -0,0 +1,80 @@
+#ifndef EMOJIGLYPHATLAS_H
+#define EMOJIGLYPHATLAS_H
+
+#include <QObject>
+#include <QCache>
+#include <QFont>
+#include <QPixmap>
+#include <QSet>
+#include <QVector>
+
+// Кэш растеризованных глифов каталога эмодзи для одного шрифта, размера
+// ячейки и масштаба экрана. Глифы растеризуются по запросу, пачками
+// в фоновом потоке: сетка запрашивает только видимые ячейки и следующий
+// экран, поэтому в памяти нет изображения всего каталога. Кэш ограничен
+// по байтам и очищается, когда сетка скрыта.
+// Сетка рисует ячейки копированием готовых глифов, поэтому цветные глифы
+// не шейпятся и не растеризуются при каждой прокрутке.
+class EmojiGlyphAtlas : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Ограничение кэша глифов (байт)
+    static inline const int CACHE_MAX_BYTES = 8 * 1024 * 1024;
+    // При большом масштабе экрана кэш все равно вмещает столько глифов -
+    // видимые ячейки и следующий экран не должны вытеснять друг друга
+    static inline const int MIN_CACHED_GLYPHS = 256;
+    // Сколько глифов растеризуется за одно фоновое задание
+    static inline const int BATCH_SIZE = 64;
+
+    // Размер ячейки в логических пикселях
+    EmojiGlyphAtlas(const QFont& font, int glyphSize, qreal devicePixelRatio, QObject* parent = nullptr);
+
+    // Шрифт с цветными эмодзи на основе baseFont.
+    // Перебор QFontDatabase выполняется один раз за время работы
+    static QFont emojiFont(const QFont& baseFont);
+
+    qreal devicePixelRatio() const { return m_devicePixelRatio; }
+
+    // Глиф строки каталога; nullptr - глиф еще не готов и поставлен в очередь
+    const QPixmap* glyph(int catalogRow);
+    // Ставит глиф в очередь заранее (например, для следующего экрана)
+    void request(int catalogRow);
+    // Убирает из очереди глифы, растеризация которых еще не началась
+    void cancelPending();
+    // Освобождает все глифы
+    void clear();
+
+    int glyphCount() const { return m_glyphs.count(); }
+    qint64 memoryBytes() const { return m_glyphs.totalCost(); }
+    bool isBusy() const { return m_busy; }
+
+signals:
+    // Готова очередная пачка глифов
+    void glyphsReady();
+
+private:
+    struct RasterResult {
+        QVector<int> rows;
+        QVector<QImage> images;
+        qint64 elapsedUs = 0;
+    };
+    static RasterResult rasterize(QFont font, int cellPixels, qreal devicePixelRatio, QVector<int> rows);
+    void scheduleBatch();
+    void startBatch();
+
+    QFont m_rasterFont;
+    int m_cellPixels;
+    qsizetype m_glyphBytes;
+    qreal m_devicePixelRatio;
+    QCache<int, QPixmap> m_glyphs;
+    QVector<int> m_queue;      // Ожидают растеризации
+    QSet<int> m_requested;     // В очереди или растеризуются сейчас
+    bool m_busy;
+    bool m_batchScheduled;
+    // Результаты задания, начатого до clear(), не принимаются
+    quint32 m_generation;
+};
+
+#endif // EMOJIGLYPHATLAS_H
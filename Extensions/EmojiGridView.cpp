@@ -0,0 +1,334 @@
+#include "EmojiGridView.h"
+#include "EmojiGlyphAtlas.h"
+#include "EmojiListModel.h"
+#include "../DockTelemetry.h"
+
+#include <QAbstractItemModel>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPainterPath>
+#include <QScrollBar>
+
+EmojiGridView::EmojiGridView(QWidget* parent)
+    : QAbstractScrollArea(parent)
+    , m_model(nullptr)
+    , m_hoverRow(-1)
+    , m_pressedRow(-1)
+    , m_atlas(nullptr)
+{
+    setFocusPolicy(Qt::StrongFocus);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    viewport()->setMouseTracking(true);
+    viewport()->setAttribute(Qt::WA_Hover);
+}
+
+void EmojiGridView::setModel(QAbstractItemModel* model)
+{
+    if (m_model) {
+        disconnect(m_model, nullptr, this, nullptr);
+    }
+
+    m_model = model;
+    m_current = QPersistentModelIndex();
+
+    if (m_model) {
+        // Фильтр меняет набор строк сбросом раскладки или вставкой/удалением
+        connect(m_model, &QAbstractItemModel::modelReset, this, &EmojiGridView::onModelChanged);
+        connect(m_model, &QAbstractItemModel::layoutChanged, this, &EmojiGridView::onModelChanged);
+        connect(m_model, &QAbstractItemModel::rowsInserted, this, &EmojiGridView::onModelChanged);
+        connect(m_model, &QAbstractItemModel::rowsRemoved, this, &EmojiGridView::onModelChanged);
+        connect(m_model, &QAbstractItemModel::dataChanged, viewport(), qOverload<>(&QWidget::update));
+    }
+
+    onModelChanged();
+}
+
+void EmojiGridView::setGlyphFont(const QFont& font)
+{
+    m_glyphFont = font;
+    delete m_atlas;
+    m_atlas = nullptr;
+    updateAtlas();
+    viewport()->update();
+}
+
+void EmojiGridView::updateAtlas()
+{
+    // Глифы другого масштаба не подходят - старый атлас удаляется вместе с ними
+    const qreal ratio = devicePixelRatioF();
+    if (m_atlas && qFuzzyCompare(ratio, m_atlas->devicePixelRatio())) {
+        return;
+    }
+
+    delete m_atlas;
+    m_atlas = new EmojiGlyphAtlas(m_glyphFont, GLYPH_SIZE, ratio, this);
+    connect(m_atlas, &EmojiGlyphAtlas::glyphsReady, viewport(), qOverload<>(&QWidget::update));
+}
+
+void EmojiGridView::releaseGlyphs()
+{
+    if (m_atlas) {
+        m_atlas->clear();
+    }
+}
+
+void EmojiGridView::prefetchGlyphs(int rowCount)
+{
+    if (!m_model) {
+        return;
+    }
+
+    updateAtlas();
+    int firstRow = 0;
+    int lastRow = -1;
+    if (rowCount < 0) {
+        visibleRows(&firstRow, &lastRow);
+    } else {
+        lastRow = qMin(rowCount, m_model->rowCount()) - 1;
+    }
+    for (int row = firstRow; row <= lastRow; ++row) {
+        m_atlas->request(catalogRow(row));
+    }
+}
+
+void EmojiGridView::visibleRows(int* firstRow, int* lastRow) const
+{
+    const int count = m_model ? m_model->rowCount() : 0;
+    const int columns = columnCount();
+    const int scroll = verticalScrollBar()->value();
+    *firstRow = (scroll / CELL_SIZE.height()) * columns;
+    *lastRow = qMin(count - 1, ((scroll + viewport()->height()) / CELL_SIZE.height() + 1) * columns - 1);
+}
+
+int EmojiGridView::catalogRow(int row) const
+{
+    return m_model->index(row, 0).data(EmojiListModel::CatalogRowRole).toInt();
+}
+
+void EmojiGridView::onModelChanged()
+{
+    m_hoverRow = -1;
+    m_pressedRow = -1;
+    updateScrollBars();
+    viewport()->update();
+}
+
+int EmojiGridView::columnCount() const
+{
+    return qMax(1, viewport()->width() / CELL_SIZE.width());
+}
+
+QRect EmojiGridView::cellRect(int row) const
+{
+    const int columns = columnCount();
+    // Сетка выравнивается по центру
+    const int left = (viewport()->width() - columns * CELL_SIZE.width()) / 2;
+    return QRect(left + (row % columns) * CELL_SIZE.width(),
+                 (row / columns) * CELL_SIZE.height() - verticalScrollBar()->value(),
+                 CELL_SIZE.width(), CELL_SIZE.height());
+}
+
+int EmojiGridView::rowAt(const QPoint& pos) const
+{
+    if (!m_model) {
+        return -1;
+    }
+
+    const int columns = columnCount();
+    const int left = (viewport()->width() - columns * CELL_SIZE.width()) / 2;
+    const int x = pos.x() - left;
+    const int y = pos.y() + verticalScrollBar()->value();
+    if (x < 0 || y < 0 || x >= columns * CELL_SIZE.width()) {
+        return -1;
+    }
+
+    const int row = (y / CELL_SIZE.height()) * columns + x / CELL_SIZE.width();
+    return row < m_model->rowCount() ? row : -1;
+}
+
+QModelIndex EmojiGridView::indexAt(const QPoint& pos) const
+{
+    const int row = rowAt(pos);
+    return row >= 0 ? m_model->index(row, 0) : QModelIndex();
+}
+
+void EmojiGridView::updateScrollBars()
+{
+    const int count = m_model ? m_model->rowCount() : 0;
+    const int columns = columnCount();
+    const int contentHeight = ((count + columns - 1) / columns) * CELL_SIZE.height();
+
+    verticalScrollBar()->setRange(0, qMax(0, contentHeight - viewport()->height()));
+    verticalScrollBar()->setPageStep(viewport()->height());
+    verticalScrollBar()->setSingleStep(CELL_SIZE.height() / 2);
+}
+
+void EmojiGridView::setCurrentIndex(const QModelIndex& index)
+{
+    m_current = index;
+    if (index.isValid()) {
+        scrollTo(index);
+    }
+    viewport()->update();
+}
+
+void EmojiGridView::scrollTo(const QModelIndex& index)
+{
+    if (!index.isValid()) {
+        return;
+    }
+
+    const QRect rect = cellRect(index.row());
+    if (rect.top() < 0) {
+        verticalScrollBar()->setValue(verticalScrollBar()->value() + rect.top());
+    } else if (rect.bottom() > viewport()->height()) {
+        verticalScrollBar()->setValue(verticalScrollBar()->value() + rect.bottom() - viewport()->height());
+    }
+}
+
+void EmojiGridView::scrollToTop()
+{
+    verticalScrollBar()->setValue(0);
+}
+
+void EmojiGridView::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event)
+    DockTelemetry::ScopedTimer timer("EmojiGridView::paint");
+
+    if (!m_model) {
+        return;
+    }
+
+    // Экран мог смениться - атлас нужен под его масштаб
+    updateAtlas();
+
+    // Очередь атласа отражает только текущую прокрутку: глифы экранов,
+    // которые уже пролистаны, не растеризуются
+    m_atlas->cancelPending();
+
+    QPainter painter(viewport());
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    const int count = m_model->rowCount();
+    int firstRow = 0;
+    int lastRow = -1;
+    visibleRows(&firstRow, &lastRow);
+    const int currentRow = m_current.isValid() ? m_current.row() : -1;
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        const QRect cell = cellRect(row);
+        const QRect background = cell.adjusted(CELL_MARGIN, CELL_MARGIN, -CELL_MARGIN, -CELL_MARGIN);
+
+        // Подложка ячейки (цвета как у прежнего стиля QListWidget::item)
+        QPainterPath path;
+        path.addRoundedRect(background, CELL_RADIUS, CELL_RADIUS);
+        if (row == currentRow) {
+            painter.fillPath(path, QColor(0, 120, 215, 200));
+            painter.setPen(QPen(QColor(100, 180, 255, 255), 2));
+            painter.drawPath(path);
+        } else {
+            painter.fillPath(path, row == m_hoverRow ? QColor(80, 80, 80, 200) : QColor(60, 60, 60, 180));
+        }
+
+        QRect glyphRect(0, 0, GLYPH_SIZE, GLYPH_SIZE);
+        glyphRect.moveCenter(cell.center());
+
+        if (const QPixmap* glyph = m_atlas->glyph(catalogRow(row))) {
+            painter.drawPixmap(glyphRect, *glyph);
+        }
+    }
+
+    // Следующий экран - чтобы прокрутка вниз не ждала растеризации
+    const int nextLast = qMin(count - 1, lastRow + (lastRow - firstRow + 1));
+    for (int row = lastRow + 1; row <= nextLast; ++row) {
+        m_atlas->request(catalogRow(row));
+    }
+}
+
+void EmojiGridView::resizeEvent(QResizeEvent* event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+bool EmojiGridView::viewportEvent(QEvent* event)
+{
+    // Уход мыши с viewport не передается в обработчики QAbstractScrollArea
+    if (event->type() == QEvent::Leave && m_hoverRow >= 0) {
+        m_hoverRow = -1;
+        viewport()->update();
+    }
+    return QAbstractScrollArea::viewportEvent(event);
+}
+
+void EmojiGridView::mouseMoveEvent(QMouseEvent* event)
+{
+    const int row = rowAt(event->pos());
+    if (row != m_hoverRow) {
+        m_hoverRow = row;
+        viewport()->update();
+    }
+    QAbstractScrollArea::mouseMoveEvent(event);
+}
+
+void EmojiGridView::mousePressEvent(QMouseEvent* event)
+{
+    m_pressedRow = event->button() == Qt::LeftButton ? rowAt(event->pos()) : -1;
+    if (m_pressedRow >= 0) {
+        setCurrentIndex(m_model->index(m_pressedRow, 0));
+    }
+    QAbstractScrollArea::mousePressEvent(event);
+}
+
+void EmojiGridView::mouseReleaseEvent(QMouseEvent* event)
+{
+    const int row = rowAt(event->pos());
+    if (event->button() == Qt::LeftButton && row >= 0 && row == m_pressedRow) {
+        emit clicked(m_model->index(row, 0));
+    }
+    m_pressedRow = -1;
+    QAbstractScrollArea::mouseReleaseEvent(event);
+}
+
+void EmojiGridView::keyPressEvent(QKeyEvent* event)
+{
+    if (!m_model || m_model->rowCount() == 0) {
+        QAbstractScrollArea::keyPressEvent(event);
+        return;
+    }
+
+    const int count = m_model->rowCount();
+    const int columns = columnCount();
+    const int currentRow = m_current.isValid() ? m_current.row() : 0;
+    int row = currentRow;
+
+    switch (event->key()) {
+    case Qt::Key_Left:
+        row = qMax(0, currentRow - 1);
+        break;
+    case Qt::Key_Right:
+        row = qMin(count - 1, currentRow + 1);
+        break;
+    case Qt::Key_Up:
+        row = currentRow >= columns ? currentRow - columns : currentRow;
+        break;
+    case Qt::Key_Down:
+        row = currentRow + columns < count ? currentRow + columns : currentRow;
+        break;
+    case Qt::Key_Home:
+        row = 0;
+        break;
+    case Qt::Key_End:
+        row = count - 1;
+        break;
+    default:
+        QAbstractScrollArea::keyPressEvent(event);
+        return;
+    }
+
+    setCurrentIndex(m_model->index(row, 0));
+    event->accept();
+}
@@ -0,0 +1,83 @@
+#ifndef EMOJIGRIDVIEW_H
+#define EMOJIGRIDVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QPersistentModelIndex>
+#include <QFont>
+#include <QSize>
+
+class QAbstractItemModel;
+class EmojiGlyphAtlas;
+
+// Сетка эмодзи поверх модели каталога (обычно EmojiFilterModel).
+// Положение ячейки вычисляется по номеру строки, поэтому рисуются и
+// проверяются только видимые ячейки, без раскладки всего каталога.
+// Глифы копируются из EmojiGlyphAtlas. Атлас растеризует в фоне только
+// видимые ячейки и следующий экран; пока глиф не готов, ячейка рисуется
+// без него.
+class EmojiGridView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    static inline const QSize CELL_SIZE = QSize(65, 65);
+    static inline const int GLYPH_SIZE = 45;
+    static inline const int CELL_MARGIN = 4;
+    static inline const int CELL_RADIUS = 8;
+
+    explicit EmojiGridView(QWidget* parent = nullptr);
+
+    void setModel(QAbstractItemModel* model);
+    QAbstractItemModel* model() const { return m_model; }
+
+    // Шрифт глифов; атлас для него создается сразу
+    void setGlyphFont(const QFont& font);
+    // Освобождает растеризованные глифы (например, когда сетка скрыта)
+    void releaseGlyphs();
+    // Ставит в очередь глифы видимых ячеек, не дожидаясь отрисовки.
+    // rowCount - число первых строк, если сетка еще не разложена
+    void prefetchGlyphs(int rowCount = -1);
+    EmojiGlyphAtlas* glyphAtlas() const { return m_atlas; }
+
+    QModelIndex currentIndex() const { return m_current; }
+    void setCurrentIndex(const QModelIndex& index);
+    void scrollTo(const QModelIndex& index);
+    void scrollToTop();
+    // Ячейка под точкой (координаты viewport)
+    QModelIndex indexAt(const QPoint& pos) const;
+
+signals:
+    void clicked(const QModelIndex& index);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void keyPressEvent(QKeyEvent* event) override;
+    bool viewportEvent(QEvent* event) override;
+
+private slots:
+    void onModelChanged();
+
+private:
+    int columnCount() const;
+    int rowAt(const QPoint& pos) const;
+    // Ячейка строки модели в координатах viewport
+    QRect cellRect(int row) const;
+    void updateScrollBars();
+    void updateAtlas();
+    // Строки модели, видимые при текущей прокрутке
+    void visibleRows(int* firstRow, int* lastRow) const;
+    int catalogRow(int row) const;
+
+    QAbstractItemModel* m_model;
+    QPersistentModelIndex m_current;
+    int m_hoverRow;
+    int m_pressedRow;
+    QFont m_glyphFont;
+    EmojiGlyphAtlas* m_atlas;
+};
+
+#endif // EMOJIGRIDVIEW_H
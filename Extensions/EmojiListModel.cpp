@@ -0,0 +1,187 @@
+#include "EmojiListModel.h"
+#include "EmojiSearchIndex.h"
+#include "EmojiUsageTracker.h"
+#include "../EmojiList.h"
+
+EmojiListModel::EmojiListModel(QObject* parent)
+    : QAbstractListModel(parent)
+    , m_skinTone(0)
+{
+    for (int row = 0; row < EmojiCatalog::count(); ++row) {
+        if (EmojiCatalog::record(row).skinTone == 0) {
+            m_baseRows.append(row);
+        }
+    }
+
+    refreshFrequent();
+    connect(&EmojiUsageTracker::instance(), &EmojiUsageTracker::usageChanged,
+            this, &EmojiListModel::refreshFrequent);
+}
+
+int EmojiListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_frequentRows.size() + m_baseRows.size();
+}
+
+int EmojiListModel::baseRowAt(int row) const
+{
+    return row < m_frequentRows.size() ? m_frequentRows.at(row) : m_baseRows.at(row - m_frequentRows.size());
+}
+
+QVariant EmojiListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    const int baseRow = baseRowAt(index.row());
+    const int catalogRow = EmojiCatalog::variantRow(baseRow, m_skinTone);
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return EmojiCatalog::emoji(catalogRow);
+    case Qt::ToolTipRole:
+        return EmojiCatalog::keywords(baseRow).join(", ");
+    case Qt::TextAlignmentRole:
+        return int(Qt::AlignCenter);
+    case Qt::SizeHintRole:
+        return CELL_SIZE;
+    case CatalogRowRole:
+        return catalogRow;
+    case BaseRowRole:
+        return baseRow;
+    case FrequentRole:
+        return index.row() < m_frequentRows.size();
+    default:
+        return QVariant();
+    }
+}
+
+void EmojiListModel::setSkinTone(int skinTone)
+{
+    skinTone = qBound(0, skinTone, EmojiCatalog::SKIN_TONE_COUNT);
+    if (skinTone == m_skinTone) {
+        return;
+    }
+
+    m_skinTone = skinTone;
+    if (rowCount() > 0) {
+        emit dataChanged(index(0), index(rowCount() - 1), {Qt::DisplayRole, CatalogRowRole});
+    }
+}
+
+void EmojiListModel::refreshFrequent()
+{
+    QVector<int> frequentRows;
+    const QStringList frequent = EmojiUsageTracker::instance().frequent(FREQUENT_COUNT);
+    for (const QString& emoji : frequent) {
+        const QByteArray utf8 = emoji.toUtf8();
+        const int row = EmojiCatalog::findRow(std::string_view(utf8.constData(), size_t(utf8.size())));
+        if (row >= 0) {
+            frequentRows.append(EmojiCatalog::baseRow(row));
+        }
+    }
+
+    if (frequentRows == m_frequentRows) {
+        return;
+    }
+
+    // Раздел заменяется целиком; строки каталога за ним не меняются
+    if (!m_frequentRows.isEmpty()) {
+        beginRemoveRows(QModelIndex(), 0, m_frequentRows.size() - 1);
+        m_frequentRows.clear();
+        endRemoveRows();
+    }
+    if (!frequentRows.isEmpty()) {
+        beginInsertRows(QModelIndex(), 0, frequentRows.size() - 1);
+        m_frequentRows = frequentRows;
+        endInsertRows();
+    }
+}
+
+EmojiFilterModel::EmojiFilterModel(QObject* parent)
+    : QSortFilterProxyModel(parent)
+    , m_scoresDirty(true)
+{
+    connect(&EmojiUsageTracker::instance(), &EmojiUsageTracker::usageChanged,
+            this, &EmojiFilterModel::onUsageChanged);
+
+    // Без запроса lessThan сохраняет порядок модели
+    sort(0);
+}
+
+void EmojiFilterModel::setQuery(const QString& query)
+{
+    if (query == m_query) {
+        return;
+    }
+
+    const bool wasSearching = !m_query.isEmpty();
+    m_query = query;
+    m_visibleRows = query.isEmpty() ? QBitArray() : EmojiSearchIndex::instance().match(query);
+
+    const bool scoresChanged = !query.isEmpty() && updateScores();
+
+    // Порядок зависит только от счетов, поэтому при смене запроса
+    // достаточно перефильтровать строки. Пересортировка нужна, когда поиск
+    // начинается или заканчивается либо счета изменились
+    if (wasSearching == !query.isEmpty() && !scoresChanged) {
+        invalidateFilter();
+    } else {
+        invalidate();
+    }
+}
+
+void EmojiFilterModel::onUsageChanged()
+{
+    m_scoresDirty = true;
+}
+
+bool EmojiFilterModel::updateScores()
+{
+    if (!m_scoresDirty) {
+        return false;
+    }
+
+    // Затухание одинаково для всех эмодзи, поэтому порядок по счетам
+    // со временем не меняется и счета можно не пересчитывать до нового использования
+    m_scores.fill(0.0, EmojiCatalog::count());
+    const QHash<QString, double> scores = EmojiUsageTracker::instance().scores();
+    for (auto it = scores.constBegin(); it != scores.constEnd(); ++it) {
+        const QByteArray utf8 = it.key().toUtf8();
+        const int row = EmojiCatalog::findRow(std::string_view(utf8.constData(), size_t(utf8.size())));
+        if (row >= 0) {
+            m_scores[EmojiCatalog::baseRow(row)] = it.value();
+        }
+    }
+    m_scoresDirty = false;
+    return true;
+}
+
+bool EmojiFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+{
+    const QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
+
+    // Часто используемые показываются только без запроса - в результатах поиска они и так первые
+    if (index.data(EmojiListModel::FrequentRole).toBool()) {
+        return m_query.isEmpty();
+    }
+    if (m_query.isEmpty()) {
+        return true;
+    }
+
+    const int baseRow = index.data(EmojiListModel::BaseRowRole).toInt();
+    return baseRow < m_visibleRows.size() && m_visibleRows.testBit(baseRow);
+}
+
+bool EmojiFilterModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
+{
+    if (!m_query.isEmpty() && !m_scores.isEmpty()) {
+        const double leftScore = m_scores.value(left.data(EmojiListModel::BaseRowRole).toInt());
+        const double rightScore = m_scores.value(right.data(EmojiListModel::BaseRowRole).toInt());
+        if (leftScore != rightScore) {
+            return leftScore > rightScore;
+        }
+    }
+    return left.row() < right.row();
+}
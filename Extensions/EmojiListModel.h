@@ -0,0 +1,83 @@
+#ifndef EMOJILISTMODEL_H
+#define EMOJILISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QBitArray>
+#include <QSize>
+#include <QSortFilterProxyModel>
+#include <QVector>
+
+// Каталог эмодзи (EmojiCatalog) как модель: строки не создаются заранее,
+// данные берутся из constexpr-таблицы при отрисовке.
+// Первые строки - часто используемые эмодзи (EmojiUsageTracker), за ними
+// основные записи каталога. Варианты с оттенком кожи отдельными строками
+// не показываются: выбранный оттенок подставляется в каждую строку.
+class EmojiListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        CatalogRowRole = Qt::UserRole,  // Отображаемая запись EmojiCatalog (с учетом оттенка)
+        BaseRowRole,                    // Основная запись EmojiCatalog
+        FrequentRole                    // true - строка из раздела часто используемых
+    };
+
+    static inline const QSize CELL_SIZE = QSize(60, 60);
+    // Сколько часто используемых эмодзи показывается в начале
+    static inline const int FREQUENT_COUNT = 12;
+
+    explicit EmojiListModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    // 0 - без модификатора, 1..5 - оттенки кожи
+    void setSkinTone(int skinTone);
+    int skinTone() const { return m_skinTone; }
+
+    int frequentCount() const { return m_frequentRows.size(); }
+
+public slots:
+    void refreshFrequent();
+
+private:
+    int baseRowAt(int row) const;
+
+    QVector<int> m_baseRows;       // Основные записи каталога
+    QVector<int> m_frequentRows;   // Основные записи часто используемых эмодзи
+    int m_skinTone;
+};
+
+// Фильтр каталога по строке поиска. Маска видимых строк берется из
+// EmojiSearchIndex, смена запроса только скрывает и показывает строки.
+// Найденные эмодзи упорядочены по частоте использования; счета
+// пересчитываются только после нового использования эмодзи
+class EmojiFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit EmojiFilterModel(QObject* parent = nullptr);
+
+    void setQuery(const QString& query);
+    QString query() const { return m_query; }
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+
+private slots:
+    void onUsageChanged();
+
+private:
+    // false - счета не менялись с прошлого запроса
+    bool updateScores();
+
+    QString m_query;
+    QBitArray m_visibleRows;
+    QVector<double> m_scores;   // Счет использования по основной записи каталога
+    bool m_scoresDirty;         // Счета пересчитываются при следующем запросе
+};
+
+#endif // EMOJILISTMODEL_H
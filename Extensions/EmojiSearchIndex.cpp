@@ -0,0 +1,135 @@
+#include "EmojiSearchIndex.h"
+#include "ClipboardSearchIndex.h"
+#include "../EmojiList.h"
+#include "../DockTelemetry.h"
+
+#include <algorithm>
+#include <iterator>
+
+const EmojiSearchIndex& EmojiSearchIndex::instance()
+{
+    static const EmojiSearchIndex index;
+    return index;
+}
+
+EmojiSearchIndex::EmojiSearchIndex()
+    : m_emojiCount(EmojiCatalog::count())
+{
+    // Слова в таблице уже уникальны; после приведения к нижнему регистру
+    // совпавшие слова объединяются
+    QVector<Keyword> keywords(EmojiCatalog::keywordCount());
+    for (int keywordId = 0; keywordId < keywords.size(); ++keywordId) {
+        const std::string_view text = EmojiCatalog::keyword(keywordId);
+        keywords[keywordId].text = QString::fromUtf8(text.data(), qsizetype(text.size())).toLower();
+    }
+    // Варианты с оттенком кожи ищутся через основную запись
+    for (int row = 0; row < m_emojiCount; ++row) {
+        if (EmojiCatalog::record(row).skinTone != 0) {
+            continue;
+        }
+        for (int i = 0; i < EmojiCatalog::record(row).keywordCount; ++i) {
+            keywords[EmojiCatalog::keywordId(row, i)].emojis.append(quint16(row));
+        }
+    }
+
+    std::sort(keywords.begin(), keywords.end(), [](const Keyword& a, const Keyword& b) {
+        return a.text < b.text;
+    });
+
+    m_keywords.reserve(keywords.size());
+    for (const Keyword& keyword : std::as_const(keywords)) {
+        if (!m_keywords.isEmpty() && m_keywords.last().text == keyword.text) {
+            QVector<quint16>& emojis = m_keywords.last().emojis;
+            emojis += keyword.emojis;
+            std::sort(emojis.begin(), emojis.end());
+            emojis.erase(std::unique(emojis.begin(), emojis.end()), emojis.end());
+            continue;
+        }
+        m_keywords.append(keyword);
+    }
+
+    for (int keywordId = 0; keywordId < m_keywords.size(); ++keywordId) {
+        for (quint64 trigram : ClipboardSearchIndex::trigrams(m_keywords.at(keywordId).text)) {
+            m_trigrams[trigram].append(quint16(keywordId));
+        }
+    }
+}
+
+void EmojiSearchIndex::markKeyword(int keywordId, QBitArray& result) const
+{
+    for (quint16 row : m_keywords.at(keywordId).emojis) {
+        result.setBit(row);
+    }
+}
+
+QBitArray EmojiSearchIndex::match(const QString& query) const
+{
+    DockTelemetry::ScopedTimer timer("EmojiSearchIndex::match");
+
+    QBitArray result(m_emojiCount, query.isEmpty());
+    if (query.isEmpty()) {
+        return result;
+    }
+
+    const QString lower = query.toLower();
+    const QVector<quint64> queryTrigrams = ClipboardSearchIndex::trigrams(lower);
+
+    if (queryTrigrams.isEmpty()) {
+        // Короткий запрос - слова с таким началом идут подряд
+        auto it = std::lower_bound(m_keywords.constBegin(), m_keywords.constEnd(), lower,
+                                   [](const Keyword& keyword, const QString& prefix) {
+                                       return keyword.text < prefix;
+                                   });
+        for (; it != m_keywords.constEnd() && it->text.startsWith(lower); ++it) {
+            markKeyword(int(it - m_keywords.constBegin()), result);
+        }
+    } else {
+        // Пересечение списков слов по всем триграммам запроса
+        QVector<quint16> candidates;
+        bool first = true;
+        for (quint64 trigram : queryTrigrams) {
+            auto postings = m_trigrams.constFind(trigram);
+            if (postings == m_trigrams.constEnd()) {
+                candidates.clear();
+                break;
+            }
+
+            if (first) {
+                candidates = postings.value();
+                first = false;
+            } else {
+                QVector<quint16> next;
+                std::set_intersection(candidates.constBegin(), candidates.constEnd(),
+                                      postings->constBegin(), postings->constEnd(),
+                                      std::back_inserter(next));
+                candidates.swap(next);
+            }
+
+            if (candidates.isEmpty()) {
+                break;
+            }
+        }
+
+        for (quint16 keywordId : std::as_const(candidates)) {
+            if (m_keywords.at(keywordId).text.contains(lower)) {
+                markKeyword(keywordId, result);
+            }
+        }
+    }
+
+    // Пользователь ввел сам эмодзи или символ
+    const bool wordQuery = std::all_of(query.constBegin(), query.constEnd(), [](QChar ch) {
+        return ch.isLetterOrNumber() || ch.isSpace();
+    });
+    if (!wordQuery) {
+        const QByteArray queryUtf8 = query.toUtf8();
+        const std::string_view needle(queryUtf8.constData(), size_t(queryUtf8.size()));
+        for (int row = 0; row < m_emojiCount; ++row) {
+            if (EmojiCatalog::record(row).emoji.find(needle) != std::string_view::npos) {
+                result.setBit(EmojiCatalog::baseRow(row));
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,43 @@
+#ifndef EMOJISEARCHINDEX_H
+#define EMOJISEARCHINDEX_H
+
+#include <QBitArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// Индекс ключевых слов каталога эмодзи (EmojiCatalog).
+// Строится один раз: уникальные ключевые слова отсортированы для поиска
+// по префиксу, для поиска подстроки по каждой триграмме хранится список
+// слов. Запрос возвращает битовую маску строк каталога, поэтому фильтр
+// не перебирает все эмодзи и их ключевые слова на каждое нажатие клавиши.
+// Русские и английские ключевые слова индексируются вместе.
+class EmojiSearchIndex
+{
+public:
+    static const EmojiSearchIndex& instance();
+
+    // Основные записи каталога, подходящие под запрос. Запрос короче триграммы
+    // ищется по началу слов, длиннее - как подстрока; запрос с символами,
+    // не являющимися буквами и цифрами, дополнительно сравнивается с самими эмодзи
+    QBitArray match(const QString& query) const;
+
+    int emojiCount() const { return m_emojiCount; }
+    int keywordCount() const { return m_keywords.size(); }
+
+private:
+    EmojiSearchIndex();
+
+    struct Keyword {
+        QString text;               // В нижнем регистре
+        QVector<quint16> emojis;    // Строки каталога с этим словом
+    };
+
+    void markKeyword(int keywordId, QBitArray& result) const;
+
+    int m_emojiCount;
+    QVector<Keyword> m_keywords;                   // По возрастанию text
+    QHash<quint64, QVector<quint16>> m_trigrams;   // Триграмма -> слова по возрастанию
+};
+
+#endif // EMOJISEARCHINDEX_H
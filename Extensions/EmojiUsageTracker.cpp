@@ -0,0 +1,152 @@
+#include "EmojiUsageTracker.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QSettings>
+#include <QTimer>
+#include <QVariantList>
+#include <QVariantMap>
+#include <algorithm>
+#include <cmath>
+
+EmojiUsageTracker& EmojiUsageTracker::instance()
+{
+    static EmojiUsageTracker tracker;
+    return tracker;
+}
+
+EmojiUsageTracker::EmojiUsageTracker()
+    : QObject(nullptr)
+    , m_saveTimer(new QTimer(this))
+{
+    load();
+
+    // Серия кликов записывается в настройки один раз
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(SAVE_DELAY_MS);
+    connect(m_saveTimer, &QTimer::timeout, this, &EmojiUsageTracker::save);
+
+    if (QCoreApplication* app = QCoreApplication::instance()) {
+        connect(app, &QCoreApplication::aboutToQuit, this, &EmojiUsageTracker::flush);
+    }
+}
+
+double EmojiUsageTracker::decayed(const Usage& usage, qint64 nowMs)
+{
+    const qint64 elapsed = qMax<qint64>(0, nowMs - usage.updatedMs);
+    return usage.score * std::exp2(-double(elapsed) / HALF_LIFE_MS);
+}
+
+void EmojiUsageTracker::recordUse(const QString& emoji)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    Usage& usage = m_usage[emoji];
+    usage.score = decayed(usage, now) + 1.0;
+    usage.updatedMs = now;
+
+    // Вытесняем эмодзи с наименьшим счетом. Только что использованный не трогаем:
+    // у нового эмодзи счет 1 и он часто оказывается наименьшим
+    if (m_usage.size() > MAX_ENTRIES) {
+        auto weakest = m_usage.end();
+        double weakestScore = 0;
+        for (auto it = m_usage.begin(); it != m_usage.end(); ++it) {
+            if (it.key() == emoji) {
+                continue;
+            }
+            const double current = decayed(it.value(), now);
+            if (weakest == m_usage.end() || current < weakestScore) {
+                weakest = it;
+                weakestScore = current;
+            }
+        }
+        m_usage.erase(weakest);
+    }
+
+    scheduleSave();
+    emit usageChanged();
+}
+
+double EmojiUsageTracker::score(const QString& emoji) const
+{
+    auto it = m_usage.constFind(emoji);
+    return it != m_usage.constEnd() ? decayed(it.value(), QDateTime::currentMSecsSinceEpoch()) : 0.0;
+}
+
+QHash<QString, double> EmojiUsageTracker::scores() const
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QHash<QString, double> result;
+    result.reserve(m_usage.size());
+    for (auto it = m_usage.constBegin(); it != m_usage.constEnd(); ++it) {
+        result.insert(it.key(), decayed(it.value(), now));
+    }
+    return result;
+}
+
+QStringList EmojiUsageTracker::frequent(int count) const
+{
+    const QHash<QString, double> current = scores();
+
+    QStringList result = current.keys();
+    std::sort(result.begin(), result.end(), [&current](const QString& a, const QString& b) {
+        const double scoreA = current.value(a);
+        const double scoreB = current.value(b);
+        return scoreA != scoreB ? scoreA > scoreB : a < b;
+    });
+
+    if (result.size() > count) {
+        result.erase(result.begin() + count, result.end());
+    }
+    return result;
+}
+
+void EmojiUsageTracker::clear()
+{
+    m_usage.clear();
+    scheduleSave();
+    emit usageChanged();
+}
+
+void EmojiUsageTracker::flush()
+{
+    if (m_saveTimer->isActive()) {
+        m_saveTimer->stop();
+        save();
+    }
+}
+
+void EmojiUsageTracker::scheduleSave()
+{
+    m_saveTimer->start();
+}
+
+void EmojiUsageTracker::load()
+{
+    QSettings settings("MyCompany", "DockApp");
+    const QVariantMap stored = settings.value("Emoji/Usage").toMap();
+
+    for (auto it = stored.constBegin(); it != stored.constEnd(); ++it) {
+        const QVariantList values = it.value().toList();
+        if (values.size() != 2) {
+            continue;
+        }
+
+        Usage usage;
+        usage.score = values.at(0).toDouble();
+        usage.updatedMs = values.at(1).toLongLong();
+        m_usage.insert(it.key(), usage);
+    }
+}
+
+void EmojiUsageTracker::save() const
+{
+    QVariantMap stored;
+    for (auto it = m_usage.constBegin(); it != m_usage.constEnd(); ++it) {
+        stored.insert(it.key(), QVariantList{it.value().score, it.value().updatedMs});
+    }
+
+    QSettings settings("MyCompany", "DockApp");
+    settings.setValue("Emoji/Usage", stored);
+}
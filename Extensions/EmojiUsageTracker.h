@@ -0,0 +1,60 @@
+#ifndef EMOJIUSAGETRACKER_H
+#define EMOJIUSAGETRACKER_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+class QTimer;
+
+// Частота использования эмодзи с затуханием. При каждом использовании
+// счет уменьшается вдвое за каждый HALF_LIFE_MS с прошлого обновления
+// и увеличивается на 1, поэтому давно не используемые эмодзи постепенно
+// уступают место недавним. Счета хранятся в настройках между сеансами.
+// Ключ - текст основной записи (без оттенка кожи).
+// Изменения записываются в настройки не сразу, а через SAVE_DELAY_MS
+// после последнего использования и при выходе из приложения.
+class EmojiUsageTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    static inline const qint64 HALF_LIFE_MS = 7LL * 24 * 60 * 60 * 1000;
+    static inline const int MAX_ENTRIES = 200;
+    static inline const int SAVE_DELAY_MS = 2000;
+
+    static EmojiUsageTracker& instance();
+
+    void recordUse(const QString& emoji);
+    // Счет на текущий момент
+    double score(const QString& emoji) const;
+    // Эмодзи по убыванию счета
+    QStringList frequent(int count) const;
+    // Текущие счета всех эмодзи
+    QHash<QString, double> scores() const;
+    void clear();
+    // Немедленно записывает отложенные изменения
+    void flush();
+
+signals:
+    void usageChanged();
+
+private:
+    EmojiUsageTracker();
+
+    struct Usage {
+        double score = 0;
+        qint64 updatedMs = 0;
+    };
+
+    static double decayed(const Usage& usage, qint64 nowMs);
+    void load();
+    void save() const;
+    void scheduleSave();
+
+    QHash<QString, Usage> m_usage;
+    QTimer* m_saveTimer;
+};
+
+#endif // EMOJIUSAGETRACKER_H
@@ -1,5 +1,6 @@
 // ExplorerKillerExtension.cpp
 #include "ExplorerKiller.h"
+#include "../DockTelemetry.h"
 #include <QApplication>
 #include <QFontMetrics>
 
@@ -43,7 +44,11 @@ ExplorerKillerWidget::ExplorerKillerWidget(QWidget* parent)
 
     // Создаем и настраиваем таймер
     m_timer = new QTimer(this);
-    connect(m_timer, &QTimer::timeout, this, &ExplorerKillerWidget::updateExplorerCount);
+    connect(m_timer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("ExplorerKillerWidget::updateExplorerCount");
+        DockTelemetry::ScopedTimer telemetryTimer("ExplorerKillerWidget::updateExplorerCount");
+        updateExplorerCount();
+    });
     m_timer->start(UPDATE_INTERVAL_MS);
 
     // Подключаем сигнал
@@ -1,4 +1,5 @@
 #include "LangIndicatorExtension.h"
+#include "../DockTelemetry.h"
 #include <QApplication>
 #include <QScreen>
 #include <QDebug>
@@ -44,11 +45,18 @@ LangOverlayWidget::LangOverlayWidget(QWidget* parent)
     // Настройка таймеров
     m_checkTimer = new QTimer(this);
     m_checkTimer->setInterval(100); // Проверяем каждые 100мс
-    connect(m_checkTimer, &QTimer::timeout, this, &LangOverlayWidget::checkLanguageChange);
+    connect(m_checkTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("LangOverlayWidget::checkLanguageChange");
+        DockTelemetry::ScopedTimer telemetryTimer("LangOverlayWidget::checkLanguageChange");
+        checkLanguageChange();
+    });
 
     m_hideTimer = new QTimer(this);
     m_hideTimer->setSingleShot(true);
-    connect(m_hideTimer, &QTimer::timeout, this, &LangOverlayWidget::hideOverlay);
+    connect(m_hideTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("LangOverlayWidget::hideOverlay");
+        hideOverlay();
+    });
 
     // Настраиваем оверлей
     setupOverlay();
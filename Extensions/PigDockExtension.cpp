@@ -1,4 +1,5 @@
 #include "PigDockExtension.h"
+#include "../DockTelemetry.h"
 #include "../DockConstants.h"
 #include <QTimer>
 #include <QStorageInfo>
@@ -67,12 +68,20 @@ QWidget* PigDockExtension::createWidget(QWidget* parent)
             });
 
     m_trashCheckTimer = new QTimer(this);
-    connect(m_trashCheckTimer, &QTimer::timeout, this, &PigDockExtension::checkTrashStatus);
+    connect(m_trashCheckTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("PigDockExtension::checkTrashStatus");
+        DockTelemetry::ScopedTimer telemetryTimer("PigDockExtension::checkTrashStatus");
+        checkTrashStatus();
+    });
     m_trashCheckTimer->start(2000);
 
     m_refreshTimer = new QTimer(this);
     m_refreshTimer->setSingleShot(true);
-    connect(m_refreshTimer, &QTimer::timeout, this, &PigDockExtension::refreshTrashState);
+    connect(m_refreshTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("PigDockExtension::refreshTrashState");
+        DockTelemetry::ScopedTimer telemetryTimer("PigDockExtension::refreshTrashState");
+        refreshTrashState();
+    });
 
     QTimer::singleShot(100, this, &PigDockExtension::checkTrashStatus);
 
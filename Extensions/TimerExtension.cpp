@@ -1,4 +1,5 @@
 #include "TimerExtension.h"
+#include "../DockTelemetry.h"
 #include "../TimerNotification.h"
 #include <QApplication>
 #include "../TopPanelConstants.h"
@@ -40,8 +41,14 @@ TimerWidget::TimerWidget(QWidget* parent)
 
     setupMenu();
 
-    connect(m_countdownTimer, &QTimer::timeout, this, &TimerWidget::updateTimerDisplay);
-    connect(m_blinkTimer, &QTimer::timeout, this, &TimerWidget::updateBlinkEffect);
+    connect(m_countdownTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("TimerWidget::updateTimerDisplay");
+        updateTimerDisplay();
+    });
+    connect(m_blinkTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("TimerWidget::updateBlinkEffect");
+        updateBlinkEffect();
+    });
 }
 
 TimerWidget::~TimerWidget()
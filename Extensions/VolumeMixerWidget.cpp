@@ -1,4 +1,5 @@
 #include "VolumeMixerWidget.h"
+#include "../DockTelemetry.h"
 #include <QProcess>
 #include <QDebug>
 
@@ -206,7 +207,11 @@ VolumeMixerWidget::VolumeMixerWidget(QWidget* parent)
     updateVolumeIcon(m_currentVolume);
 
     m_sessionUpdateTimer = new QTimer(this);
-    connect(m_sessionUpdateTimer, &QTimer::timeout, this, &VolumeMixerWidget::updateAudioSessions);
+    connect(m_sessionUpdateTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("VolumeMixerWidget::updateAudioSessions");
+        DockTelemetry::ScopedTimer telemetryTimer("VolumeMixerWidget::updateAudioSessions");
+        updateAudioSessions();
+    });
     m_sessionUpdateTimer->start(2000); // Update every 2 seconds
 
     // Initial session setup
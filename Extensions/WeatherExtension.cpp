@@ -1,4 +1,5 @@
 #include "WeatherExtension.h"
+#include "../DockTelemetry.h"
 #include <QApplication>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -57,7 +58,10 @@ WeatherWidget::WeatherWidget(QWidget* parent)
 
     // Таймер для обновления погоды каждые 10 минут
     m_updateTimer = new QTimer(this);
-    connect(m_updateTimer, &QTimer::timeout, this, &WeatherWidget::updateWeather);
+    connect(m_updateTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("WeatherWidget::updateWeather");
+        updateWeather();
+    });
     m_updateTimer->start(600000); // 10 минут
 
     // Контекстное меню (правая кнопка)
@@ -1,4 +1,5 @@
 #include "WinDockBar.h"
+#include "../DockTelemetry.h"
 #include <QApplication>
 #include <QScreen>
 #include <QDebug>
@@ -91,7 +92,10 @@ ClockWidget::ClockWidget(QWidget* parent)
     setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Minimum);
 
     m_timer = new QTimer(this);
-    connect(m_timer, &QTimer::timeout, this, &ClockWidget::updateTime);
+    connect(m_timer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("ClockWidget::updateTime");
+        updateTime();
+    });
     m_timer->start(1000);
 
     updateTime();
@@ -1,4 +1,5 @@
 #include "WinTabOverlay.h"
+#include "../ImageResampler.h"
 #include <QApplication>
 #include <QScreen>
 #include <QDebug>
@@ -42,7 +43,8 @@ WindowThumbnail::WindowThumbnail(HWND hwnd, QWidget* parent)
     }
 
     if (hIcon) {
-        m_icon = QPixmap::fromImage(QImage::fromHICON(hIcon));
+        // Значок масштабируется один раз, а не при каждой отрисовке
+        m_icon = QPixmap::fromImage(ImageResampler::scaled(QImage::fromHICON(hIcon), QSize(48, 48)));
     }
 
 #ifdef Q_OS_WIN
@@ -122,8 +124,7 @@ void WindowThumbnail::paintEvent(QPaintEvent* event)
 
     // Draw icon if available
     if (!m_icon.isNull()) {
-        QPixmap scaledIcon = m_icon.scaled(48, 48, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        painter.drawPixmap(width()/2 - scaledIcon.width()/2, 20, scaledIcon);
+        painter.drawPixmap(width()/2 - m_icon.width()/2, 20, m_icon);
     }
 
     // Draw window title
@@ -0,0 +1,351 @@
+#include "ForegroundWindowTracker.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QSettings>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+#ifdef Q_OS_WIN
+// Источник данных на основе WinAPI и SetWinEventHook
+class WinForegroundWindowBackend : public ForegroundWindowBackend
+{
+public:
+    ~WinForegroundWindowBackend() override { removeHooks(); }
+
+    quintptr foregroundWindow() const override
+    {
+        return reinterpret_cast<quintptr>(GetForegroundWindow());
+    }
+
+    void queryIdentity(quintptr window, ForegroundWindowState& state) const override
+    {
+        HWND hwnd = reinterpret_cast<HWND>(window);
+
+        const int bufferSize = 256;
+        WCHAR className[bufferSize];
+        if (GetClassName(hwnd, className, bufferSize)) {
+            state.className = QString::fromWCharArray(className);
+        } else {
+            state.className.clear();
+        }
+
+        state.executableName.clear();
+
+        DWORD processId = 0;
+        GetWindowThreadProcessId(hwnd, &processId);
+
+        HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
+        if (hProcess) {
+            WCHAR exePath[MAX_PATH];
+            if (GetModuleFileNameEx(hProcess, nullptr, exePath, MAX_PATH)) {
+                state.executableName = QFileInfo(QString::fromWCharArray(exePath)).fileName().toLower();
+            }
+            CloseHandle(hProcess);
+        }
+    }
+
+    void queryGeometry(quintptr window, ForegroundWindowState& state) const override
+    {
+        HWND hwnd = reinterpret_cast<HWND>(window);
+
+        state.visible = IsWindowVisible(hwnd);
+        state.minimized = IsIconic(hwnd);
+
+        LONG style = GetWindowLong(hwnd, GWL_STYLE);
+        LONG exStyle = GetWindowLong(hwnd, GWL_EXSTYLE);
+
+        // Настоящее полноэкранное окно - без заголовка и рамки либо popup без края
+        state.borderless = (!(style & WS_CAPTION) && !(style & WS_THICKFRAME)) ||
+                           ((style & WS_POPUP) && !(exStyle & WS_EX_WINDOWEDGE));
+
+        RECT windowRect;
+        if (GetWindowRect(hwnd, &windowRect)) {
+            state.geometry = QRect(windowRect.left, windowRect.top,
+                                   windowRect.right - windowRect.left,
+                                   windowRect.bottom - windowRect.top);
+        } else {
+            state.geometry = QRect();
+        }
+    }
+
+    bool installHooks(ForegroundWindowTracker* tracker) override
+    {
+        s_tracker = tracker;
+        s_backend = this;
+
+        // Смена активного окна, сворачивание/разворачивание. Окна самого дока
+        // (настройки, оверлеи) тоже становятся активными - их события нужны
+        m_systemHook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_MINIMIZEEND,
+                                       nullptr, winEventProc, 0, 0,
+                                       WINEVENT_OUTOFCONTEXT);
+        // Уничтожение, показ и скрытие окна
+        m_objectHook = SetWinEventHook(EVENT_OBJECT_DESTROY, EVENT_OBJECT_HIDE,
+                                       nullptr, winEventProc, 0, 0,
+                                       WINEVENT_OUTOFCONTEXT);
+
+        if (!m_systemHook || !m_objectHook) {
+            qDebug() << "ForegroundWindowTracker: failed to install WinEvent hooks";
+            removeHooks();
+            return false;
+        }
+
+        watchLocation(GetForegroundWindow());
+        return true;
+    }
+
+    void removeHooks() override
+    {
+        if (m_systemHook) {
+            UnhookWinEvent(m_systemHook);
+            m_systemHook = nullptr;
+        }
+        if (m_objectHook) {
+            UnhookWinEvent(m_objectHook);
+            m_objectHook = nullptr;
+        }
+        if (m_locationHook) {
+            UnhookWinEvent(m_locationHook);
+            m_locationHook = nullptr;
+        }
+        m_locationThread = 0;
+        s_tracker = nullptr;
+        s_backend = nullptr;
+    }
+
+private:
+    // Перемещение и изменение размера отслеживаются только для потока активного
+    // окна: глобальная подписка получала бы каждое движение курсора и каретки
+    // во всей системе. Подписка переустанавливается при смене активного окна
+    void watchLocation(HWND hwnd)
+    {
+        DWORD processId = 0;
+        DWORD threadId = hwnd ? GetWindowThreadProcessId(hwnd, &processId) : 0;
+        if (m_locationHook && threadId == m_locationThread) {
+            return;
+        }
+
+        if (m_locationHook) {
+            UnhookWinEvent(m_locationHook);
+            m_locationHook = nullptr;
+        }
+        m_locationThread = 0;
+
+        if (!threadId) {
+            return;
+        }
+
+        m_locationHook = SetWinEventHook(EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE,
+                                         nullptr, winEventProc, processId, threadId,
+                                         WINEVENT_OUTOFCONTEXT);
+        if (m_locationHook) {
+            m_locationThread = threadId;
+        } else {
+            qDebug() << "ForegroundWindowTracker: failed to watch foreground window location";
+        }
+    }
+
+    static void CALLBACK winEventProc(HWINEVENTHOOK, DWORD event, HWND hwnd,
+                                      LONG idObject, LONG idChild, DWORD, DWORD)
+    {
+        if (!s_tracker) {
+            return;
+        }
+
+        if (event == EVENT_SYSTEM_FOREGROUND) {
+            if (s_backend) {
+                s_backend->watchLocation(hwnd);
+            }
+            s_tracker->notifyForegroundChanged();
+            return;
+        }
+
+        // Интересуют только события самого окна, а не его дочерних объектов (курсор, каретка и т.п.)
+        if (idObject != OBJID_WINDOW || idChild != CHILDID_SELF || !hwnd) {
+            return;
+        }
+
+        s_tracker->notifyWindowChanged(reinterpret_cast<quintptr>(hwnd));
+    }
+
+    HWINEVENTHOOK m_systemHook = nullptr;
+    HWINEVENTHOOK m_objectHook = nullptr;
+    HWINEVENTHOOK m_locationHook = nullptr;
+    DWORD m_locationThread = 0;
+
+    static ForegroundWindowTracker* s_tracker;
+    static WinForegroundWindowBackend* s_backend;
+};
+
+ForegroundWindowTracker* WinForegroundWindowBackend::s_tracker = nullptr;
+WinForegroundWindowBackend* WinForegroundWindowBackend::s_backend = nullptr;
+#endif
+
+ForegroundWindowTracker& ForegroundWindowTracker::instance()
+{
+    static ForegroundWindowTracker tracker;
+    return tracker;
+}
+
+ForegroundWindowTracker::ForegroundWindowTracker()
+    : QObject(nullptr)
+    , m_backend(nullptr)
+    , m_hooksInstalled(false)
+    , m_identityDirty(true)
+    , m_geometryDirty(true)
+    , m_identityQueries(0)
+    , m_geometryQueries(0)
+{
+    // Системные окна (включая рабочий стол), для которых док никогда не скрывается
+    m_excludedClasses = {"Progman", "WorkerW", "Shell_TrayWnd", "Button"};
+
+    loadExceptions();
+
+#ifdef Q_OS_WIN
+    setBackend(new WinForegroundWindowBackend());
+#endif
+}
+
+ForegroundWindowTracker::~ForegroundWindowTracker()
+{
+    if (m_backend) {
+        m_backend->removeHooks();
+        delete m_backend;
+        m_backend = nullptr;
+    }
+}
+
+void ForegroundWindowTracker::setBackend(ForegroundWindowBackend* backend)
+{
+    if (m_backend) {
+        m_backend->removeHooks();
+        delete m_backend;
+    }
+
+    m_backend = backend;
+    m_hooksInstalled = m_backend ? m_backend->installHooks(this) : false;
+    m_state = ForegroundWindowState();
+    m_identityDirty = true;
+    m_geometryDirty = true;
+}
+
+void ForegroundWindowTracker::loadExceptions()
+{
+    QSettings settings("MyCompany", "DockApp");
+    setExceptions(settings.value("Dock/FullScreenExceptions").toStringList());
+}
+
+void ForegroundWindowTracker::setExceptions(const QStringList& executableNames)
+{
+    m_exceptions.clear();
+    for (const QString& name : executableNames) {
+        QString normalized = name.trimmed().toLower();
+        if (!normalized.isEmpty()) {
+            m_exceptions.insert(normalized);
+        }
+    }
+
+    updateExcluded();
+}
+
+void ForegroundWindowTracker::updateExcluded()
+{
+    m_state.excluded = m_excludedClasses.contains(m_state.className) ||
+                       m_exceptions.contains(m_state.executableName);
+}
+
+void ForegroundWindowTracker::notifyForegroundChanged()
+{
+    m_identityDirty = true;
+    m_geometryDirty = true;
+    emit foregroundChanged();
+}
+
+void ForegroundWindowTracker::notifyWindowChanged(quintptr window)
+{
+    if (window != m_state.windowId) {
+        return;
+    }
+
+    m_geometryDirty = true;
+    emit foregroundGeometryChanged();
+}
+
+void ForegroundWindowTracker::refresh()
+{
+    if (!m_backend) {
+        return;
+    }
+
+    // Без уведомлений кэш нельзя считать актуальным - читаем данные каждый раз
+    if (!m_hooksInstalled) {
+        m_identityDirty = true;
+        m_geometryDirty = true;
+    }
+
+    if (m_identityDirty) {
+        quintptr window = m_backend->foregroundWindow();
+        if (window != m_state.windowId || !m_hooksInstalled) {
+            m_state = ForegroundWindowState();
+            m_state.windowId = window;
+            if (window) {
+                m_backend->queryIdentity(window, m_state);
+                ++m_identityQueries;
+            }
+            updateExcluded();
+            m_geometryDirty = true;
+        }
+        m_identityDirty = false;
+    }
+
+    if (m_geometryDirty) {
+        if (m_state.windowId) {
+            m_backend->queryGeometry(m_state.windowId, m_state);
+            ++m_geometryQueries;
+        }
+        m_geometryDirty = false;
+    }
+}
+
+const ForegroundWindowState& ForegroundWindowTracker::state()
+{
+    if (m_identityDirty || m_geometryDirty || !m_hooksInstalled) {
+        refresh();
+    }
+    return m_state;
+}
+
+bool ForegroundWindowTracker::isFullScreenOn(const QRect& screenGeometry)
+{
+    const ForegroundWindowState& current = state();
+
+    if (!current.windowId) {
+        return false;
+    }
+
+    // Окно должно быть видимым и не свернутым
+    if (!current.visible || current.minimized) {
+        return false;
+    }
+
+    // Если это не настоящее полноэкранное приложение, не скрываем док
+    if (!current.borderless || current.excluded) {
+        return false;
+    }
+
+    // Если не удалось получить имя процесса, не скрываем
+    if (current.executableName.isEmpty()) {
+        return false;
+    }
+
+    // Окно покрывает весь экран или почти весь экран
+    const int tolerance = 5;
+    const QRect& windowGeometry = current.geometry;
+    return (windowGeometry.left() <= screenGeometry.left() + tolerance) &&
+           (windowGeometry.top() <= screenGeometry.top() + tolerance) &&
+           (windowGeometry.right() >= screenGeometry.right() - tolerance) &&
+           (windowGeometry.bottom() >= screenGeometry.bottom() - tolerance);
+}
@@ -0,0 +1,95 @@
+#ifndef FOREGROUNDWINDOWTRACKER_H
+#define FOREGROUNDWINDOWTRACKER_H
+
+#include <QObject>
+#include <QRect>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class ForegroundWindowTracker;
+
+// Кэшированное состояние активного (foreground) окна
+struct ForegroundWindowState {
+    quintptr windowId = 0;
+    QString className;
+    QString executableName;   // Имя исполняемого файла в нижнем регистре
+    QRect geometry;
+    bool visible = false;
+    bool minimized = false;
+    bool borderless = false;  // Окно без заголовка и рамки (кандидат в полноэкранные)
+    bool excluded = false;    // Системное окно или приложение из списка исключений
+};
+
+// Источник данных об окнах. Позволяет подменить WinAPI (например, заглушкой)
+class ForegroundWindowBackend
+{
+public:
+    virtual ~ForegroundWindowBackend() = default;
+
+    virtual quintptr foregroundWindow() const = 0;
+
+    // Класс окна и имя процесса - дорогие запросы, выполняются только при смене окна
+    virtual void queryIdentity(quintptr window, ForegroundWindowState& state) const = 0;
+
+    // Геометрия, стили и видимость - при перемещении или изменении окна
+    virtual void queryGeometry(quintptr window, ForegroundWindowState& state) const = 0;
+
+    // Подписка на уведомления об изменениях. false - уведомлений не будет
+    virtual bool installHooks(ForegroundWindowTracker* tracker) = 0;
+    virtual void removeHooks() = 0;
+};
+
+// Сервис кэшированного состояния активного окна.
+// Данные обновляются только когда меняется активное окно или его геометрия,
+// поэтому проверка полноэкранного режима сводится к чтению кэша.
+class ForegroundWindowTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ForegroundWindowTracker& instance();
+
+    // Заменяет источник данных (трекер становится его владельцем)
+    void setBackend(ForegroundWindowBackend* backend);
+
+    const ForegroundWindowState& state();
+    bool isFullScreenOn(const QRect& screenGeometry);
+
+    // Приложения, для которых док не скрывается даже в полноэкранном режиме
+    void setExceptions(const QStringList& executableNames);
+    QStringList exceptions() const { return m_exceptions.values(); }
+
+    // Вызываются источником данных при изменениях
+    void notifyForegroundChanged();
+    void notifyWindowChanged(quintptr window);
+
+    // Количество обращений к источнику данных (для оценки стоимости проверок)
+    quint64 identityQueryCount() const { return m_identityQueries; }
+    quint64 geometryQueryCount() const { return m_geometryQueries; }
+
+signals:
+    void foregroundChanged();
+    // Активное окно переместилось или изменило размер (например, вошло в полноэкранный режим)
+    void foregroundGeometryChanged();
+
+private:
+    ForegroundWindowTracker();
+    ~ForegroundWindowTracker();
+
+    void refresh();
+    void updateExcluded();
+    void loadExceptions();
+
+    ForegroundWindowBackend* m_backend;
+    ForegroundWindowState m_state;
+    bool m_hooksInstalled;
+    bool m_identityDirty;
+    bool m_geometryDirty;
+    QSet<QString> m_excludedClasses;
+    QSet<QString> m_exceptions;
+    quint64 m_identityQueries;
+    quint64 m_geometryQueries;
+};
+
+#endif // FOREGROUNDWINDOWTRACKER_H
@@ -0,0 +1,533 @@
+#include "ImageResampler.h"
+
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+#include <QtMath>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGE_RESAMPLER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(IMAGE_RESAMPLER_SSE2) && (defined(__GNUC__) || defined(_MSC_VER))
+#define IMAGE_RESAMPLER_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define IMAGE_RESAMPLER_TARGET_AVX2
+#else
+#define IMAGE_RESAMPLER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+// Веса в фиксированной точке: 1.0 = 1 << PRECISION_BITS, помещаются в qint16
+const int PRECISION_BITS = 14;
+const int ROUNDING = 1 << (PRECISION_BITS - 1);
+// Минимум пикселей результата на одну параллельную полосу
+const int MIN_PIXELS_PER_BAND = 128 * 1024;
+
+std::atomic<int> s_implementation{ImageResampler::Auto};
+
+// Веса фильтра для одного измерения: для каждого пикселя результата
+// первый пиксель источника и taps весов (лишние веса нулевые)
+struct Coefficients {
+    int taps = 0;
+    std::vector<int> start;
+    std::vector<qint16> weights;
+
+    const qint16* weightsAt(int index) const { return weights.data() + size_t(index) * taps; }
+};
+
+double sinc(double x)
+{
+    if (x == 0.0) {
+        return 1.0;
+    }
+    x *= M_PI;
+    return std::sin(x) / x;
+}
+
+double lanczos3(double x)
+{
+    return (x > -3.0 && x < 3.0) ? sinc(x) * sinc(x / 3.0) : 0.0;
+}
+
+double box(double x)
+{
+    return (x > -0.5 && x <= 0.5) ? 1.0 : 0.0;
+}
+
+Coefficients computeCoefficients(int inSize, int outSize, ImageResampler::Filter filter)
+{
+    const double support = filter == ImageResampler::Lanczos3 ? 3.0 : 0.5;
+    double (*kernel)(double) = filter == ImageResampler::Lanczos3 ? lanczos3 : box;
+
+    // При уменьшении фильтр растягивается на масштаб, при увеличении остается единичным
+    const double scale = double(inSize) / outSize;
+    const double filterScale = qMax(scale, 1.0);
+    const double scaledSupport = support * filterScale;
+
+    Coefficients result;
+    result.taps = int(std::ceil(scaledSupport)) * 2 + 1;
+    result.start.resize(outSize);
+    result.weights.assign(size_t(outSize) * result.taps, 0);
+
+    std::vector<double> weights(result.taps);
+    for (int out = 0; out < outSize; ++out) {
+        const double center = (out + 0.5) * scale;
+        const int first = qMax(int(center - scaledSupport + 0.5), 0);
+        const int last = qMin(int(center + scaledSupport + 0.5), inSize);
+        const int count = qMin(last - first, result.taps);
+
+        double total = 0.0;
+        for (int i = 0; i < count; ++i) {
+            weights[i] = kernel((first + i - center + 0.5) / filterScale);
+            total += weights[i];
+        }
+
+        // Нормализация и округление; остаток округления отдается наибольшему весу,
+        // чтобы сумма была ровно единицей и яркость не смещалась
+        qint16* fixed = result.weights.data() + size_t(out) * result.taps;
+        int fixedTotal = 0;
+        int largest = 0;
+        for (int i = 0; i < count; ++i) {
+            const double normalized = total != 0.0 ? weights[i] / total : 0.0;
+            fixed[i] = qint16(std::lround(normalized * (1 << PRECISION_BITS)));
+            fixedTotal += fixed[i];
+            if (fixed[i] > fixed[largest]) {
+                largest = i;
+            }
+        }
+        if (count > 0) {
+            fixed[largest] = qint16(fixed[largest] + (1 << PRECISION_BITS) - fixedTotal);
+        }
+
+        // Окно не выходит за край источника
+        result.start[out] = qMin(first, qMax(0, inSize - result.taps));
+        if (result.start[out] != first) {
+            const int shift = first - result.start[out];
+            for (int i = count - 1; i >= 0; --i) {
+                fixed[i + shift] = fixed[i];
+            }
+            for (int i = 0; i < shift; ++i) {
+                fixed[i] = 0;
+            }
+        }
+    }
+
+    // Источник меньше окна - окно обрезается до размера источника
+    if (result.taps > inSize) {
+        Coefficients trimmed;
+        trimmed.taps = inSize;
+        trimmed.start.assign(outSize, 0);
+        trimmed.weights.resize(size_t(outSize) * inSize);
+        for (int out = 0; out < outSize; ++out) {
+            std::copy(result.weightsAt(out), result.weightsAt(out) + inSize,
+                      trimmed.weights.begin() + size_t(out) * inSize);
+        }
+        return trimmed;
+    }
+
+    return result;
+}
+
+// Округление, ограничение 0..255 и цвета не больше альфы (премультиплицированный формат)
+inline quint32 packPixel(int b, int g, int r, int a)
+{
+    a = qBound(0, (a + ROUNDING) >> PRECISION_BITS, 255);
+    b = qBound(0, (b + ROUNDING) >> PRECISION_BITS, a);
+    g = qBound(0, (g + ROUNDING) >> PRECISION_BITS, a);
+    r = qBound(0, (r + ROUNDING) >> PRECISION_BITS, a);
+    return quint32(b) | (quint32(g) << 8) | (quint32(r) << 16) | (quint32(a) << 24);
+}
+
+void horizontalRowScalar(const quint32* src, quint32* dst, int width, const Coefficients& coefficients)
+{
+    for (int x = 0; x < width; ++x) {
+        const quint32* pixels = src + coefficients.start[x];
+        const qint16* weights = coefficients.weightsAt(x);
+
+        int b = 0, g = 0, r = 0, a = 0;
+        for (int i = 0; i < coefficients.taps; ++i) {
+            const quint32 pixel = pixels[i];
+            b += int(pixel & 0xff) * weights[i];
+            g += int((pixel >> 8) & 0xff) * weights[i];
+            r += int((pixel >> 16) & 0xff) * weights[i];
+            a += int(pixel >> 24) * weights[i];
+        }
+        dst[x] = packPixel(b, g, r, a);
+    }
+}
+
+void verticalRowScalar(const uchar* src, qsizetype stride, quint32* dst, int width,
+                       const qint16* weights, int taps)
+{
+    for (int x = 0; x < width; ++x) {
+        int b = 0, g = 0, r = 0, a = 0;
+        const uchar* column = src + qsizetype(x) * 4;
+        for (int i = 0; i < taps; ++i) {
+            const quint32 pixel = *reinterpret_cast<const quint32*>(column + i * stride);
+            b += int(pixel & 0xff) * weights[i];
+            g += int((pixel >> 8) & 0xff) * weights[i];
+            r += int((pixel >> 16) & 0xff) * weights[i];
+            a += int(pixel >> 24) * weights[i];
+        }
+        dst[x] = packPixel(b, g, r, a);
+    }
+}
+
+#ifdef IMAGE_RESAMPLER_SSE2
+
+// Пара весов для _mm_madd_epi16: младшее слово - первый, старшее - второй
+inline __m128i weightPair(qint16 first, qint16 second)
+{
+    return _mm_set1_epi32(int(quint32(quint16(first)) | (quint32(quint16(second)) << 16)));
+}
+
+// Цвета не больше альфы того же пикселя
+inline __m128i clampToAlpha(__m128i pixels)
+{
+    __m128i alpha = _mm_srli_epi32(pixels, 24);
+    alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+    alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+    return _mm_min_epu8(pixels, alpha);
+}
+
+void horizontalRowSse2(const quint32* src, quint32* dst, int width, const Coefficients& coefficients)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi32(ROUNDING);
+
+    for (int x = 0; x < width; ++x) {
+        const quint32* pixels = src + coefficients.start[x];
+        const qint16* weights = coefficients.weightsAt(x);
+
+        __m128i sum = rounding;
+        int i = 0;
+        for (; i + 1 < coefficients.taps; i += 2) {
+            // Два пикселя, каналы чередуются: b0 b1 g0 g1 r0 r1 a0 a1
+            __m128i pair = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels + i)), zero);
+            pair = _mm_unpacklo_epi16(pair, _mm_srli_si128(pair, 8));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(pair, weightPair(weights[i], weights[i + 1])));
+        }
+        if (i < coefficients.taps) {
+            __m128i single = _mm_unpacklo_epi8(_mm_cvtsi32_si128(int(pixels[i])), zero);
+            single = _mm_unpacklo_epi16(single, zero);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(single, weightPair(weights[i], 0)));
+        }
+
+        sum = _mm_srai_epi32(sum, PRECISION_BITS);
+        sum = _mm_packs_epi32(sum, sum);
+        sum = _mm_packus_epi16(sum, sum);
+        dst[x] = quint32(_mm_cvtsi128_si32(clampToAlpha(sum)));
+    }
+}
+
+void verticalRowSse2(const uchar* src, qsizetype stride, quint32* dst, int width,
+                     const qint16* weights, int taps)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi32(ROUNDING);
+
+    // Четыре пикселя за итерацию, строки источника берутся парами
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        const uchar* column = src + qsizetype(x) * 4;
+        __m128i sum0 = rounding, sum1 = rounding, sum2 = rounding, sum3 = rounding;
+
+        int i = 0;
+        for (; i < taps; i += 2) {
+            const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i * stride));
+            const __m128i second = i + 1 < taps
+                ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + (i + 1) * stride))
+                : zero;
+            const __m128i weight = weightPair(weights[i], i + 1 < taps ? weights[i + 1] : 0);
+
+            const __m128i firstLow = _mm_unpacklo_epi8(first, zero);
+            const __m128i firstHigh = _mm_unpackhi_epi8(first, zero);
+            const __m128i secondLow = _mm_unpacklo_epi8(second, zero);
+            const __m128i secondHigh = _mm_unpackhi_epi8(second, zero);
+
+            sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(_mm_unpacklo_epi16(firstLow, secondLow), weight));
+            sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(_mm_unpackhi_epi16(firstLow, secondLow), weight));
+            sum2 = _mm_add_epi32(sum2, _mm_madd_epi16(_mm_unpacklo_epi16(firstHigh, secondHigh), weight));
+            sum3 = _mm_add_epi32(sum3, _mm_madd_epi16(_mm_unpackhi_epi16(firstHigh, secondHigh), weight));
+        }
+
+        const __m128i low = _mm_packs_epi32(_mm_srai_epi32(sum0, PRECISION_BITS), _mm_srai_epi32(sum1, PRECISION_BITS));
+        const __m128i high = _mm_packs_epi32(_mm_srai_epi32(sum2, PRECISION_BITS), _mm_srai_epi32(sum3, PRECISION_BITS));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), clampToAlpha(_mm_packus_epi16(low, high)));
+    }
+
+    if (x < width) {
+        verticalRowScalar(src + qsizetype(x) * 4, stride, dst + x, width - x, weights, taps);
+    }
+}
+
+#endif // IMAGE_RESAMPLER_SSE2
+
+#ifdef IMAGE_RESAMPLER_AVX2
+
+bool cpuHasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    // AVX и сохранение регистров YMM операционной системой
+    const bool osxsave = (info[2] & (1 << 27)) && (info[2] & (1 << 28));
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+IMAGE_RESAMPLER_TARGET_AVX2
+void verticalRowAvx2(const uchar* src, qsizetype stride, quint32* dst, int width,
+                     const qint16* weights, int taps)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i rounding = _mm256_set1_epi32(ROUNDING);
+
+    // Восемь пикселей за итерацию; распаковка и упаковка идут внутри 128-битных половин,
+    // поэтому порядок пикселей восстанавливается без перестановок
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        const uchar* column = src + qsizetype(x) * 4;
+        __m256i sum0 = rounding, sum1 = rounding, sum2 = rounding, sum3 = rounding;
+
+        for (int i = 0; i < taps; i += 2) {
+            const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i * stride));
+            const __m256i second = i + 1 < taps
+                ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + (i + 1) * stride))
+                : zero;
+            const __m256i weight = _mm256_set1_epi32(int(quint32(quint16(weights[i]))
+                                                         | (quint32(quint16(i + 1 < taps ? weights[i + 1] : 0)) << 16)));
+
+            const __m256i firstLow = _mm256_unpacklo_epi8(first, zero);
+            const __m256i firstHigh = _mm256_unpackhi_epi8(first, zero);
+            const __m256i secondLow = _mm256_unpacklo_epi8(second, zero);
+            const __m256i secondHigh = _mm256_unpackhi_epi8(second, zero);
+
+            sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(_mm256_unpacklo_epi16(firstLow, secondLow), weight));
+            sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(_mm256_unpackhi_epi16(firstLow, secondLow), weight));
+            sum2 = _mm256_add_epi32(sum2, _mm256_madd_epi16(_mm256_unpacklo_epi16(firstHigh, secondHigh), weight));
+            sum3 = _mm256_add_epi32(sum3, _mm256_madd_epi16(_mm256_unpackhi_epi16(firstHigh, secondHigh), weight));
+        }
+
+        const __m256i low = _mm256_packs_epi32(_mm256_srai_epi32(sum0, PRECISION_BITS), _mm256_srai_epi32(sum1, PRECISION_BITS));
+        const __m256i high = _mm256_packs_epi32(_mm256_srai_epi32(sum2, PRECISION_BITS), _mm256_srai_epi32(sum3, PRECISION_BITS));
+        __m256i pixels = _mm256_packus_epi16(low, high);
+
+        __m256i alpha = _mm256_srli_epi32(pixels, 24);
+        alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 8));
+        alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 16));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), _mm256_min_epu8(pixels, alpha));
+    }
+
+    if (x < width) {
+        verticalRowSse2(src + qsizetype(x) * 4, stride, dst + x, width - x, weights, taps);
+    }
+}
+
+#endif // IMAGE_RESAMPLER_AVX2
+
+using HorizontalRowFunction = void (*)(const quint32*, quint32*, int, const Coefficients&);
+using VerticalRowFunction = void (*)(const uchar*, qsizetype, quint32*, int, const qint16*, int);
+
+HorizontalRowFunction horizontalRow()
+{
+    // Для горизонтального прохода реализации AVX2 нет
+#ifdef IMAGE_RESAMPLER_SSE2
+    if (s_implementation.load(std::memory_order_relaxed) != ImageResampler::Scalar) {
+        return horizontalRowSse2;
+    }
+#endif
+    return horizontalRowScalar;
+}
+
+VerticalRowFunction verticalRow()
+{
+    switch (s_implementation.load(std::memory_order_relaxed)) {
+    case ImageResampler::Scalar:
+        return verticalRowScalar;
+#ifdef IMAGE_RESAMPLER_SSE2
+    case ImageResampler::Sse2:
+        return verticalRowSse2;
+#endif
+#ifdef IMAGE_RESAMPLER_AVX2
+    case ImageResampler::Avx2:
+        return verticalRowAvx2;
+#endif
+    default:
+        break;
+    }
+
+    // Возможности процессора проверяются один раз
+    static const VerticalRowFunction function = []() -> VerticalRowFunction {
+#ifdef IMAGE_RESAMPLER_AVX2
+        if (cpuHasAvx2()) {
+            return verticalRowAvx2;
+        }
+#endif
+#ifdef IMAGE_RESAMPLER_SSE2
+        return verticalRowSse2;
+#else
+        return verticalRowScalar;
+#endif
+    }();
+    return function;
+}
+
+// Полоса строк результата [firstRow, lastRow): горизонтальный проход только
+// по нужным ей строкам источника во временный буфер, затем вертикальный
+void resampleBand(const QImage& source, uchar* targetBits, qsizetype targetStride, const QSize& targetSize,
+                  const Coefficients& horizontal, const Coefficients& vertical, int firstRow, int lastRow)
+{
+    const int targetWidth = targetSize.width();
+    const bool scaleX = source.width() != targetWidth;
+    const bool scaleY = source.height() != targetSize.height();
+
+    const int sourceFirst = scaleY ? vertical.start[firstRow] : firstRow;
+    const int sourceLast = scaleY ? vertical.start[lastRow - 1] + vertical.taps : lastRow;
+
+    // Без масштаба по горизонтали вертикальный проход читает источник напрямую
+    std::vector<quint32> buffer;
+    const uchar* rows = source.constScanLine(sourceFirst);
+    qsizetype stride = source.bytesPerLine();
+    if (scaleX) {
+        buffer.resize(size_t(sourceLast - sourceFirst) * targetWidth);
+        const HorizontalRowFunction horizontalFunction = horizontalRow();
+        for (int y = sourceFirst; y < sourceLast; ++y) {
+            horizontalFunction(reinterpret_cast<const quint32*>(source.constScanLine(y)),
+                               buffer.data() + size_t(y - sourceFirst) * targetWidth, targetWidth, horizontal);
+        }
+        rows = reinterpret_cast<const uchar*>(buffer.data());
+        stride = qsizetype(targetWidth) * 4;
+    }
+
+    const VerticalRowFunction verticalFunction = verticalRow();
+    for (int y = firstRow; y < lastRow; ++y) {
+        quint32* dst = reinterpret_cast<quint32*>(targetBits + y * targetStride);
+        if (scaleY) {
+            verticalFunction(rows + (vertical.start[y] - sourceFirst) * stride, stride, dst, targetWidth,
+                             vertical.weightsAt(y), vertical.taps);
+        } else {
+            memcpy(dst, rows + (y - sourceFirst) * stride, size_t(targetWidth) * 4);
+        }
+    }
+}
+
+} // namespace
+
+QImage ImageResampler::resize(const QImage& image, const QSize& size, Filter filter)
+{
+    if (image.isNull() || size.isEmpty()) {
+        return QImage();
+    }
+
+    // Фильтр работает с 32-битными пикселями с премультиплицированной альфой
+    QImage source = image;
+    if (source.format() != QImage::Format_RGB32 && source.format() != QImage::Format_ARGB32_Premultiplied) {
+        source = source.convertToFormat(source.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                                 : QImage::Format_RGB32);
+    }
+    if (source.size() == size) {
+        return source;
+    }
+
+    QImage target(size, source.format());
+    if (target.isNull()) {
+        return QImage();
+    }
+    target.setDevicePixelRatio(image.devicePixelRatio());
+
+    const Coefficients horizontal = source.width() != size.width()
+        ? computeCoefficients(source.width(), size.width(), filter) : Coefficients();
+    const Coefficients vertical = source.height() != size.height()
+        ? computeCoefficients(source.height(), size.height(), filter) : Coefficients();
+
+    // Указатель берется до запуска потоков - scanLine() неконстантного QImage не потокобезопасен
+    uchar* targetBits = target.bits();
+    const qsizetype targetStride = target.bytesPerLine();
+
+    // Полосы строк результата обрабатываются параллельно
+    const qint64 pixels = qint64(size.width()) * size.height();
+    const int bandCount = int(qBound<qint64>(1, pixels / MIN_PIXELS_PER_BAND,
+                                             qMin(QThread::idealThreadCount(), size.height())));
+    if (bandCount == 1) {
+        resampleBand(source, targetBits, targetStride, size, horizontal, vertical, 0, size.height());
+        return target;
+    }
+
+    QVector<int> bands(bandCount);
+    for (int i = 0; i < bandCount; ++i) {
+        bands[i] = i;
+    }
+    QtConcurrent::blockingMap(bands, [&](int band) {
+        const int firstRow = int(qint64(size.height()) * band / bandCount);
+        const int lastRow = int(qint64(size.height()) * (band + 1) / bandCount);
+        resampleBand(source, targetBits, targetStride, size, horizontal, vertical, firstRow, lastRow);
+    });
+    return target;
+}
+
+QImage ImageResampler::scaled(const QImage& image, const QSize& size, Qt::AspectRatioMode mode, Filter filter)
+{
+    if (image.isNull()) {
+        return QImage();
+    }
+    return resize(image, image.size().scaled(size, mode).expandedTo(QSize(1, 1)), filter);
+}
+
+QPixmap ImageResampler::scaled(const QPixmap& pixmap, const QSize& size, Qt::AspectRatioMode mode, Filter filter)
+{
+    if (pixmap.isNull()) {
+        return QPixmap();
+    }
+    return QPixmap::fromImage(scaled(pixmap.toImage(), size, mode, filter));
+}
+
+bool ImageResampler::isSupported(Implementation implementation)
+{
+    switch (implementation) {
+    case Auto:
+    case Scalar:
+        return true;
+    case Sse2:
+#ifdef IMAGE_RESAMPLER_SSE2
+        return true;
+#else
+        return false;
+#endif
+    case Avx2:
+#ifdef IMAGE_RESAMPLER_AVX2
+        return cpuHasAvx2();
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+bool ImageResampler::setImplementation(Implementation implementation)
+{
+    if (!isSupported(implementation)) {
+        return false;
+    }
+    s_implementation.store(implementation, std::memory_order_relaxed);
+    return true;
+}
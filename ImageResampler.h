@@ -0,0 +1,49 @@
+#ifndef IMAGERESAMPLER_H
+#define IMAGERESAMPLER_H
+
+#include <QImage>
+#include <QPixmap>
+#include <QSize>
+
+// Раздельный (сначала по строкам, затем по столбцам) ресемплер изображений
+// с фильтрами Ланцоша и усреднения по площади. Веса считаются один раз
+// на размер в фиксированной точке, внутренние циклы векторизованы
+// (SSE2, вертикальный проход - AVX2 при поддержке процессором) с обычной
+// реализацией для остальных платформ. Большие изображения делятся на полосы
+// строк, которые обрабатываются параллельно.
+// Работает с Format_ARGB32_Premultiplied и Format_RGB32, остальные форматы
+// предварительно преобразуются. Можно вызывать из любого потока (кроме
+// перегрузки для QPixmap).
+namespace ImageResampler
+{
+    enum Filter {
+        // Среднее по площади пикселя - для сильного уменьшения (миниатюры, значки)
+        Area,
+        // Ланцош с окном 3 - для обоев и умеренного масштаба
+        Lanczos3
+    };
+
+    // Масштабирует изображение точно до size
+    QImage resize(const QImage& image, const QSize& size, Filter filter = Lanczos3);
+
+    // Аналог QImage::scaled(..., Qt::SmoothTransformation)
+    QImage scaled(const QImage& image, const QSize& size,
+                  Qt::AspectRatioMode mode = Qt::KeepAspectRatio, Filter filter = Lanczos3);
+    QPixmap scaled(const QPixmap& pixmap, const QSize& size,
+                   Qt::AspectRatioMode mode = Qt::KeepAspectRatio, Filter filter = Lanczos3);
+
+    // Реализация внутренних циклов. Auto - лучшая из поддерживаемых процессором,
+    // остальные нужны для сравнения реализаций в тестах и бенчмарках
+    enum Implementation {
+        Auto,
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    bool isSupported(Implementation implementation);
+    // Действует на последующие вызовы во всех потоках. false - реализация не поддерживается
+    bool setImplementation(Implementation implementation);
+}
+
+#endif // IMAGERESAMPLER_H
@@ -1,6 +1,7 @@
 #include "SearchWindow.h"
 #include "ApplicationSearcher.h"
 #include "SearchResult.h"
+#include "../DockTelemetry.h"
 
 #include <windows.h>
 #include <shobjidl.h>
@@ -87,7 +88,10 @@ SearchWindow::SearchWindow(QWidget *parent)
     m_searchTimer = new QTimer(this);
     m_searchTimer->setSingleShot(true);
     m_searchTimer->setInterval(200);
-    connect(m_searchTimer, &QTimer::timeout, this, &SearchWindow::updateResults);
+    connect(m_searchTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("SearchWindow::searchTimer");
+        updateResults();
+    });
 }
 
 SearchWindow::~SearchWindow()
@@ -835,6 +839,8 @@ void SearchWindow::onSearchTextChanged(const QString &text)
 
 void SearchWindow::updateResults()
 {
+    DockTelemetry::ScopedTimer telemetryTimer("SearchWindow::updateResults");
+
     QString query = m_searchEdit->text().trimmed();
     if (query.isEmpty()) {
         return;
@@ -906,7 +912,11 @@ void SearchWindow::updateResults()
     }
 
     if (m_appSearcher) {
-        QList<SearchResult> fileResults = m_appSearcher->searchAllFiles(query, 50);
+        QList<SearchResult> fileResults;
+        {
+            DockTelemetry::ScopedTimer searchTimer("ApplicationSearcher::searchAllFiles");
+            fileResults = m_appSearcher->searchAllFiles(query, 50);
+        }
         for (const SearchResult &file : fileResults) {
             addSearchResult(file);
         }
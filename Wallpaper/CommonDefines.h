@@ -25,6 +25,14 @@ namespace DesktopBackgroundSettings {
     const int VIDEO_DECODING_THREADS = 1;            // Количество потоков декодирования
     const int MAX_VIDEO_ERROR_COUNT = 3;             // Максимальное количество ошибок видео
     const int VIDEO_ERROR_RETRY_DELAY_MS = 1000;     // Задержка перед повторной попыткой при ошибке
+    // Настройки слайд-шоу
+    const int SLIDESHOW_DEFAULT_INTERVAL_S = 300;    // Интервал смены изображений по умолчанию
+    const int SLIDESHOW_MIN_INTERVAL_S = 5;          // Минимальный интервал смены
+    const int SLIDESHOW_CROSSFADE_MS = 800;          // Длительность плавного перехода
+    // Стоп-кадр видео обоев
+    const int VIDEO_POSTER_CROSSFADE_MS = 500;       // Переход от стоп-кадра к видео
+    const int VIDEO_POSTER_CAPTURE_DELAY_MS = 3000;  // Первый снимок кадра после старта видео
+    const int VIDEO_POSTER_REFRESH_MS = 600000;      // Обновление снимка во время воспроизведения
 }
 // Структура для хранения настроек каждого экрана
 struct ScreenSettings {
@@ -35,7 +43,11 @@ struct ScreenSettings {
     bool isVideo;       // флаг, указывающий что это видео
     bool loopVideo;     // зацикливать видео
     bool enableSound;   // включить звук
+    QString slideshowDirectory; // каталог слайд-шоу, пустой - слайд-шоу выключено
+    int slideshowInterval;      // интервал смены изображений, секунды
+    bool slideshowShuffle;      // случайный порядок
     ScreenSettings() : alignment("center"), scaling("fill"), scaleFactor(1.0),
-                      isVideo(false), loopVideo(true), enableSound(false) {}
+                      isVideo(false), loopVideo(true), enableSound(false),
+                      slideshowInterval(DesktopBackgroundSettings::SLIDESHOW_DEFAULT_INTERVAL_S), slideshowShuffle(false) {}
 };
 #endif // COMMONDEFINES_H
\ No newline at end of file
@@ -8,6 +8,8 @@
 
 #include "MultiDesktopManager.h"
 
+#include "../DockTelemetry.h"
+
 #include <QDebug>
 
 #include <QFileInfo>
@@ -110,7 +112,7 @@ DesktopBackground::DesktopBackground(QScreen* targetScreen, const ScreenSettings
 
     if (!m_settings.backgroundImage.isEmpty()) {
 
-        m_settings.isVideo = isVideoFile(m_settings.backgroundImage);
+        m_settings.isVideo = isVideoFile(m_settings.backgroundImage) && m_settings.slideshowDirectory.isEmpty();
 
         qDebug() << "DesktopBackground constructor: screen =" << (m_targetScreen ? m_targetScreen->name() : "unknown")
 
@@ -518,6 +520,10 @@ void DesktopBackground::paintEvent(QPaintEvent* event)
 
 
 
+    DockTelemetry::ScopedTimer telemetryTimer("DesktopBackground::paintEvent");
+
+
+
     if (m_renderer) {
 
         QPainter painter(this);
@@ -586,7 +592,9 @@ void DesktopBackground::setBackgroundImage(const QString& imagePath)
 
     m_settings.backgroundImage = imagePath;
 
-    m_settings.isVideo = isVideoFile(imagePath);
+    // Слайд-шоу показывается вместо видео
+
+    m_settings.isVideo = isVideoFile(imagePath) && m_settings.slideshowDirectory.isEmpty();
 
 
 
@@ -648,6 +656,52 @@ void DesktopBackground::setBackgroundImage(const QString& imagePath)
 
 
 
+void DesktopBackground::setSlideshow(const QString& directory, int intervalSeconds, bool shuffle)
+
+{
+
+    if (m_settings.slideshowDirectory == directory
+
+        && m_settings.slideshowInterval == intervalSeconds
+
+        && m_settings.slideshowShuffle == shuffle) {
+
+        return;
+
+    }
+
+
+
+    m_settings.slideshowDirectory = directory;
+
+    m_settings.slideshowInterval = intervalSeconds;
+
+    m_settings.slideshowShuffle = shuffle;
+
+
+
+    // Слайд-шоу ведет ImageRenderer; при смене видео на слайд-шоу и обратно рендерер пересоздается
+
+    ImageRenderer* imageRenderer = qobject_cast<ImageRenderer*>(m_renderer);
+
+    const bool wantsVideo = isVideoFile(m_settings.backgroundImage) && directory.isEmpty();
+
+    if (imageRenderer && !wantsVideo) {
+
+        imageRenderer->setSlideshow(directory, intervalSeconds, shuffle);
+
+        update();
+
+    } else {
+
+        setBackgroundImage(m_settings.backgroundImage);
+
+    }
+
+}
+
+
+
 void DesktopBackground::setBackgroundAlignment(const QString& alignment)
 
 {
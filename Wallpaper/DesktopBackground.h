@@ -34,6 +34,8 @@ public:
     void setBackgroundScaleFactor(qreal scaleFactor);
     void setVideoLoop(bool loop);
     void setVideoSound(bool enable);
+    // Слайд-шоу из каталога; пустой каталог - обычный фон
+    void setSlideshow(const QString& directory, int intervalSeconds, bool shuffle);
 
     // Геттеры
     QString getBackgroundImage() const { return m_settings.backgroundImage; }
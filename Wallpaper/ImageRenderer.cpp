@@ -1,12 +1,26 @@
 #include "ImageRenderer.h"
+#include "WallpaperPlaylist.h"
+#include "../DockTelemetry.h"
+#include "../ImageResampler.h"
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
 #include <QPainter>
+#include <QTimer>
 #include <QUrl>
+#include <QVariantAnimation>
 
 ImageRenderer::ImageRenderer(QWidget* parent)
     : MediaRenderer(parent)
+    , m_frameDirty(true)
+    , m_waitingForImage(false)
+    , m_playlist(nullptr)
+    , m_slideshowTimer(nullptr)
+    , m_nextReady(false)
+    , m_advancePending(false)
+    , m_failedCount(0)
+    , m_fadeAnimation(nullptr)
+    , m_fadeProgress(1.0)
     , m_initialized(false)
 {
     m_parentWidget = parent;
@@ -17,10 +31,43 @@ ImageRenderer::ImageRenderer(QWidget* parent)
     } else {
         m_currentSize = QSize(1920, 1080);
     }
+
+    connect(&WallpaperImageLoader::instance(), &WallpaperImageLoader::imageReady,
+            this, &ImageRenderer::onImageReady);
+
+    m_playlist = new WallpaperPlaylist(this);
+    connect(m_playlist, &WallpaperPlaylist::loaded, this, &ImageRenderer::onPlaylistLoaded);
+
+    m_slideshowTimer = new QTimer(this);
+    connect(m_slideshowTimer, &QTimer::timeout, this, &ImageRenderer::onSlideshowTimeout);
+
+    m_fadeAnimation = new QVariantAnimation(this);
+    m_fadeAnimation->setStartValue(0.0);
+    m_fadeAnimation->setEndValue(1.0);
+    m_fadeAnimation->setDuration(DesktopBackgroundSettings::SLIDESHOW_CROSSFADE_MS);
+    m_fadeAnimation->setEasingCurve(QEasingCurve::InOutQuad);
+    connect(m_fadeAnimation, &QVariantAnimation::valueChanged, this, [this](const QVariant& value) {
+        m_fadeProgress = value.toReal();
+        if (m_parentWidget) {
+            m_parentWidget->update();
+        }
+    });
+    connect(m_fadeAnimation, &QVariantAnimation::finished, this, [this]() {
+        stopTransition();
+        if (m_parentWidget) {
+            m_parentWidget->update();
+        }
+        // Следующее изображение готовится, пока показывается текущее
+        preloadNext();
+    });
 }
 
 ImageRenderer::~ImageRenderer()
 {
+    if (!m_imageKey.isEmpty()) {
+        WallpaperImageLoader::instance().release(m_imageKey);
+    }
+    releaseNextImage();
 }
 
 void ImageRenderer::initialize()
@@ -31,12 +78,15 @@ void ImageRenderer::initialize()
 
 void ImageRenderer::show()
 {
-    // Для изображений ничего не делаем при показе
+    // Слайд-шоу продолжается только на видимом экране
+    if (isSlideshow() && m_playlist->count() > 1 && !m_slideshowTimer->isActive()) {
+        m_slideshowTimer->start();
+    }
 }
 
 void ImageRenderer::hide()
 {
-    // Для изображений ничего не делаем при скрытии
+    m_slideshowTimer->stop();
 }
 
 void ImageRenderer::resize(const QSize& size)
@@ -48,6 +98,67 @@ void ImageRenderer::resize(const QSize& size)
 }
 
 void ImageRenderer::paint(QPainter* painter, const QRect& rect)
+{
+    if (m_frameDirty || (!m_frame.isNull() && m_frame.deviceIndependentSize().toSize() != rect.size())) {
+        composeFrame(rect.size());
+    }
+
+    if (!m_previousFrame.isNull()) {
+        // Смена слайда: оба кадра уже собраны, на кадр анимации - два копирования,
+        // второе с прозрачностью. Интервалы между кадрами показывают пропуски
+        if (m_fadeFrameTimer.isValid()) {
+            DockTelemetry::recordDuration("ImageRenderer::crossfadeFrameInterval",
+                                          quint64(m_fadeFrameTimer.nsecsElapsed() / 1000));
+        }
+        m_fadeFrameTimer.start();
+
+        painter->drawPixmap(rect.topLeft(), m_previousFrame);
+        painter->setOpacity(m_fadeProgress);
+        painter->drawPixmap(rect.topLeft(), m_frame);
+        painter->setOpacity(1.0);
+        return;
+    }
+
+    // Кадр уже в размере экрана - копирование без масштабирования,
+    // отсечение по открытой области выполняет сам QPainter виджета
+    if (!m_frame.isNull()) {
+        painter->drawPixmap(rect.topLeft(), m_frame);
+    }
+}
+
+void ImageRenderer::composeFrame(const QSize& size)
+{
+    DockTelemetry::ScopedTimer telemetryTimer("ImageRenderer::composeFrame");
+
+    m_frameDirty = false;
+    m_currentSize = size;
+
+    if (m_backgroundPixmap.isNull() || size.isEmpty()) {
+        m_frame = QPixmap();
+        return;
+    }
+
+    // Кадр в физических пикселях экрана, чтобы на HiDPI не было повторного масштабирования
+    const qreal dpr = devicePixelRatio();
+
+    // В fill и stretch загрузчик отдает изображение ровно в размере экрана -
+    // оно и есть кадр, второй буфер размером с экран не нужен
+    const bool scaledToScreen = m_settings.scaling == "fill" || m_settings.scaling == "stretch";
+    if (scaledToScreen && m_backgroundPixmap.size() == size * dpr
+        && qFuzzyCompare(m_backgroundPixmap.devicePixelRatio(), dpr)) {
+        m_frame = m_backgroundPixmap;
+        return;
+    }
+
+    m_frame = QPixmap(size * dpr);
+    m_frame.setDevicePixelRatio(dpr);
+    m_frame.fill(Qt::transparent);
+
+    QPainter framePainter(&m_frame);
+    paintContent(&framePainter, QRect(QPoint(0, 0), size));
+}
+
+void ImageRenderer::paintContent(QPainter* painter, const QRect& rect)
 {
     painter->setRenderHint(QPainter::SmoothPixmapTransform);
 
@@ -62,51 +173,55 @@ void ImageRenderer::paint(QPainter* painter, const QRect& rect)
         } else {
             if (m_settings.scaling == "fill") {
                 // Для fill масштабируем изображение с сохранением пропорций, заполняя всю область
-                // и обрезая края, если это необходимо
+                // и обрезая края, если это необходимо. Обрезка - в пикселях изображения
                 if (!m_backgroundPixmap.isNull()) {
-                    // Создаем временный QPixmap с правильным масштабированием
-                    QPixmap scaledPixmap = m_backgroundPixmap.scaled(
-                        rect.size(),
-                        Qt::KeepAspectRatioByExpanding,
-                        Qt::SmoothTransformation
-                    );
+                    const QSize targetPixels = rect.size() * m_backgroundPixmap.devicePixelRatio();
+
+                    // Изображение уже масштабировано при загрузке - повторно только при смене размера
+                    QPixmap scaledPixmap = m_backgroundPixmap;
+                    const QSize expandedSize = m_backgroundPixmap.size().scaled(targetPixels, Qt::KeepAspectRatioByExpanding);
+                    if (expandedSize != m_backgroundPixmap.size()) {
+                        scaledPixmap = ImageResampler::scaled(
+                            m_backgroundPixmap,
+                            targetPixels,
+                            Qt::KeepAspectRatioByExpanding
+                        );
+                    }
 
                     // Определяем область для обрезки с учетом выравнивания
                     int x = 0, y = 0;
 
-                    if (scaledPixmap.width() > rect.width()) {
+                    if (scaledPixmap.width() > targetPixels.width()) {
                         if (m_settings.alignment == "left") {
                             x = 0;
                         } else if (m_settings.alignment == "right") {
-                            x = scaledPixmap.width() - rect.width();
+                            x = scaledPixmap.width() - targetPixels.width();
                         } else { // center
-                            x = (scaledPixmap.width() - rect.width()) / 2;
+                            x = (scaledPixmap.width() - targetPixels.width()) / 2;
                         }
                     }
 
-                    if (scaledPixmap.height() > rect.height()) {
+                    if (scaledPixmap.height() > targetPixels.height()) {
                         if (m_settings.alignment == "top") {
                             y = 0;
                         } else if (m_settings.alignment == "bottom") {
-                            y = scaledPixmap.height() - rect.height();
+                            y = scaledPixmap.height() - targetPixels.height();
                         } else { // center
-                            y = (scaledPixmap.height() - rect.height()) / 2;
+                            y = (scaledPixmap.height() - targetPixels.height()) / 2;
                         }
                     }
 
-                    sourceRect = QRect(x, y, rect.width(), rect.height());
+                    sourceRect = QRect(x, y, targetPixels.width(), targetPixels.height());
                     painter->drawPixmap(targetRect, scaledPixmap, sourceRect);
                 }
             } else if (m_settings.scaling == "fit" || m_settings.scaling == "zoom") {
                 // Для fit и zoom центрируем изображение с учетом выравнивания
-                targetRect = QRect(0, 0, m_backgroundPixmap.width(), m_backgroundPixmap.height());
+                targetRect = QRect(QPoint(0, 0), m_backgroundPixmap.deviceIndependentSize().toSize());
                 targetRect = applyAlignmentToRect(targetRect);
                 painter->drawPixmap(targetRect, m_backgroundPixmap, sourceRect);
             } else if (m_settings.scaling == "center") {
                 // Для center позиционируем изображение с учетом выравнивания
-                targetRect = QRect(0, 0,
-                                 qMin(m_backgroundPixmap.width(), rect.width()),
-                                 qMin(m_backgroundPixmap.height(), rect.height()));
+                targetRect = QRect(QPoint(0, 0), m_backgroundPixmap.deviceIndependentSize().toSize().boundedTo(rect.size()));
                 targetRect = applyAlignmentToRect(targetRect);
                 painter->drawPixmap(targetRect, m_backgroundPixmap, sourceRect);
             }
@@ -123,9 +238,29 @@ void ImageRenderer::setSettings(const ScreenSettings& settings)
         m_currentSize = m_parentWidget->size();
     }
 
+    applySlideshowSettings();
     loadAndScaleImage();
 }
 
+void ImageRenderer::setSlideshow(const QString& directory, int intervalSeconds, bool shuffle)
+{
+    if (m_settings.slideshowDirectory == directory
+        && m_settings.slideshowInterval == intervalSeconds
+        && m_settings.slideshowShuffle == shuffle) {
+        return;
+    }
+
+    const bool directoryChanged = m_settings.slideshowDirectory != directory;
+    m_settings.slideshowDirectory = directory;
+    m_settings.slideshowInterval = intervalSeconds;
+    m_settings.slideshowShuffle = shuffle;
+
+    applySlideshowSettings();
+    if (directoryChanged) {
+        loadAndScaleImage();
+    }
+}
+
 void ImageRenderer::setAlignment(const QString& alignment)
 {
     if (m_settings.alignment != alignment) {
@@ -181,57 +316,302 @@ void ImageRenderer::reset()
     loadAndScaleImage();
 }
 
-void ImageRenderer::loadAndScaleImage()
+QString ImageRenderer::currentImagePath() const
 {
-    if (!m_settings.backgroundImage.isEmpty() && QFile::exists(m_settings.backgroundImage)) {
-        QPixmap originalPixmap;
-        if (originalPixmap.load(m_settings.backgroundImage)) {
-            // Используем актуальный размер
-            QSize targetSize = m_currentSize.isValid() ? m_currentSize : QSize(1920, 1080);
+    if (isSlideshow()) {
+        // До первого сканирования каталога показывается обычный фон, если это изображение
+        if (!m_slideshowPath.isEmpty()) {
+            return m_slideshowPath;
+        }
+        return WallpaperPlaylist::isImageFile(m_settings.backgroundImage) ? m_settings.backgroundImage : QString();
+    }
+    return m_settings.backgroundImage;
+}
 
-            qDebug() << "Loading image:" << m_settings.backgroundImage
-                     << "Original size:" << originalPixmap.size()
-                     << "Target size:" << targetSize
-                     << "Scaling mode:" << m_settings.scaling;
+WallpaperImageRequest ImageRenderer::imageRequest(const QString& path) const
+{
+    // Используем актуальный размер в физических пикселях экрана,
+    // иначе на HiDPI изображение растягивается при отрисовке
+    WallpaperImageRequest request;
+    request.path = path;
+    request.targetSize = (m_currentSize.isValid() ? m_currentSize : QSize(1920, 1080)) * devicePixelRatio();
+    request.scaling = m_settings.scaling;
+    request.alignment = m_settings.alignment;
+    request.scaleFactor = m_settings.scaleFactor;
+    return request;
+}
 
-            if (m_settings.scaling == "fill") {
-                // Для fill используем KeepAspectRatioByExpanding чтобы заполнить всю область
-                m_backgroundPixmap = originalPixmap.scaled(
-                    targetSize,
-                    Qt::KeepAspectRatioByExpanding,
-                    Qt::SmoothTransformation
-                );
-            } else if (m_settings.scaling == "fit") {
-                m_backgroundPixmap = originalPixmap.scaled(targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-            } else if (m_settings.scaling == "stretch") {
-                m_backgroundPixmap = originalPixmap.scaled(targetSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-            } else if (m_settings.scaling == "center" || m_settings.scaling == "tile") {
-                m_backgroundPixmap = originalPixmap;
-            } else if (m_settings.scaling == "zoom") {
-                applyScaling();
-            }
+qreal ImageRenderer::devicePixelRatio() const
+{
+    return m_parentWidget ? m_parentWidget->devicePixelRatioF() : 1.0;
+}
 
-            qDebug() << "Image loaded successfully, scaled size:" << m_backgroundPixmap.size();
-        } else {
-            qDebug() << "Failed to load image:" << m_settings.backgroundImage;
-            m_backgroundPixmap = QPixmap();
+qreal ImageRenderer::imagePixelRatio() const
+{
+    const bool scaledToScreen = m_settings.scaling == "fill" || m_settings.scaling == "fit" || m_settings.scaling == "stretch";
+    return scaledToScreen ? devicePixelRatio() : 1.0;
+}
+
+void ImageRenderer::applySlideshowSettings()
+{
+    const bool directoryChanged = m_playlist->directory() != m_settings.slideshowDirectory;
+
+    if (directoryChanged || !isSlideshow()) {
+        // Новый каталог - слайд-шоу начинается заново после его сканирования
+        m_slideshowTimer->stop();
+        stopTransition();
+        releaseNextImage();
+        m_nextPath.clear();
+        m_slideshowPath.clear();
+        m_advancePending = false;
+        m_failedCount = 0;
+    }
+
+    m_playlist->setDirectory(m_settings.slideshowDirectory, m_settings.slideshowShuffle);
+
+    if (isSlideshow()) {
+        const int interval = qMax(DesktopBackgroundSettings::SLIDESHOW_MIN_INTERVAL_S, m_settings.slideshowInterval);
+        m_slideshowTimer->setInterval(interval * 1000);
+    }
+}
+
+void ImageRenderer::loadAndScaleImage()
+{
+    m_frameDirty = true;
+    // Переход прерывается - кадры собраны для прежних размера и настроек
+    stopTransition();
+
+    const QString imagePath = currentImagePath();
+    if (!imagePath.isEmpty() && QFile::exists(imagePath)) {
+        const WallpaperImageRequest request = imageRequest(imagePath);
+
+        qDebug() << "Loading image:" << imagePath
+                 << "Target size:" << request.targetSize
+                 << "Scaling mode:" << m_settings.scaling;
+
+        // Декодирование в фоне; до готовности на экране остается предыдущий кадр.
+        // Старое изображение освобождается после захвата нового - при тех же
+        // параметрах оно не будет декодироваться заново
+        QImage readyImage;
+        m_loadTimer.start();
+        const QString previousKey = m_imageKey;
+        m_imageKey = WallpaperImageLoader::instance().acquire(request, &readyImage);
+        m_waitingForImage = true;
+        if (!previousKey.isEmpty()) {
+            WallpaperImageLoader::instance().release(previousKey);
+        }
+        if (!readyImage.isNull()) {
+            setSourceImage(std::move(readyImage));
         }
     } else {
+        if (!m_imageKey.isEmpty()) {
+            WallpaperImageLoader::instance().release(m_imageKey);
+            m_imageKey.clear();
+        }
+        m_waitingForImage = false;
         m_backgroundPixmap = QPixmap();
-        if (!m_settings.backgroundImage.isEmpty()) {
-            qDebug() << "Image file not found:" << m_settings.backgroundImage;
+        if (!imagePath.isEmpty()) {
+            qDebug() << "Image file not found:" << imagePath;
+        }
+    }
+
+    // Подготовленное следующее изображение тоже должно соответствовать новым параметрам
+    if (isSlideshow() && !m_slideshowPath.isEmpty()) {
+        if (m_nextPath.isEmpty()) {
+            preloadNext();
+        } else {
+            requestNextImage();
+        }
+    }
+}
+
+void ImageRenderer::onPlaylistLoaded()
+{
+    if (!isSlideshow() || m_playlist->isEmpty()) {
+        return;
+    }
+
+    m_slideshowPath = m_playlist->takeNext();
+    loadAndScaleImage();
+
+    if (m_playlist->count() > 1 && (!m_parentWidget || m_parentWidget->isVisible())) {
+        m_slideshowTimer->start();
+    }
+}
+
+void ImageRenderer::onSlideshowTimeout()
+{
+    DockTelemetry::countWakeup("ImageRenderer::slideshow");
+
+    if (!m_previousFrame.isNull()) {
+        return;
+    }
+
+    if (m_nextReady) {
+        startTransition();
+        return;
+    }
+
+    if (m_advancePending || m_nextPath.isEmpty()) {
+        // Изображение не подготовилось за целый интервал - берем следующее
+        preloadNext();
+    }
+    // Смена произойдет, как только изображение будет готово
+    m_advancePending = true;
+}
+
+void ImageRenderer::preloadNext()
+{
+    if (!isSlideshow() || m_playlist->count() < 2) {
+        return;
+    }
+
+    m_nextPath = m_playlist->takeNext();
+    requestNextImage();
+}
+
+void ImageRenderer::requestNextImage()
+{
+    if (m_nextPath.isEmpty()) {
+        return;
+    }
+
+    // Декодирование и масштабирование под экран - в потоках загрузчика
+    QImage readyImage;
+    const QString previousKey = m_nextKey;
+    m_nextImage = QImage();
+    m_nextReady = false;
+    m_nextKey = WallpaperImageLoader::instance().acquire(imageRequest(m_nextPath), &readyImage);
+    if (!previousKey.isEmpty()) {
+        WallpaperImageLoader::instance().release(previousKey);
+    }
+
+    if (!readyImage.isNull()) {
+        m_nextImage = readyImage;
+        m_nextReady = true;
+        if (m_advancePending) {
+            startTransition();
+        }
+    }
+}
+
+void ImageRenderer::releaseNextImage()
+{
+    if (!m_nextKey.isEmpty()) {
+        WallpaperImageLoader::instance().release(m_nextKey);
+        m_nextKey.clear();
+    }
+    m_nextImage = QImage();
+    m_nextReady = false;
+}
+
+void ImageRenderer::startTransition()
+{
+    m_advancePending = false;
+
+    if (m_nextImage.isNull()) {
+        // Файл не читается - пропускаем его, пока не перебран весь список
+        qDebug() << "Skipping unreadable slideshow image:" << m_nextPath;
+        releaseNextImage();
+        m_nextPath.clear();
+        if (++m_failedCount < m_playlist->count()) {
+            m_advancePending = true;
+            preloadNext();
         }
+        return;
+    }
+
+    DockTelemetry::ScopedTimer telemetryTimer("ImageRenderer::startTransition");
+    m_failedCount = 0;
+
+    if (m_frameDirty && !m_backgroundPixmap.isNull()) {
+        composeFrame(m_currentSize);
+    }
+    m_previousFrame = m_frame;
+
+    // Ссылка на подготовленное изображение переходит к текущему
+    if (!m_imageKey.isEmpty()) {
+        WallpaperImageLoader::instance().release(m_imageKey);
     }
+    m_imageKey = m_nextKey;
+    m_slideshowPath = m_nextPath;
+    m_nextKey.clear();
+    m_nextPath.clear();
+    m_waitingForImage = false;
+
+    // Изображение уже в размере экрана - только сборка кадра, без декодирования
+    m_backgroundPixmap = QPixmap::fromImage(std::move(m_nextImage));
+    m_backgroundPixmap.setDevicePixelRatio(imagePixelRatio());
+    m_nextImage = QImage();
+    m_nextReady = false;
+    composeFrame(m_currentSize);
+
+    if (m_parentWidget) {
+        m_parentWidget->update();
+    }
+
+    if (m_previousFrame.isNull()) {
+        preloadNext();
+        return;
+    }
+
+    m_fadeProgress = 0.0;
+    m_fadeFrameTimer.invalidate();
+    m_fadeAnimation->start();
 }
 
-void ImageRenderer::applyScaling()
+void ImageRenderer::stopTransition()
 {
-    if (!m_settings.backgroundImage.isEmpty() && QFile::exists(m_settings.backgroundImage)) {
-        QPixmap originalPixmap;
-        if (originalPixmap.load(m_settings.backgroundImage)) {
-            QSize scaledSize = originalPixmap.size() * m_settings.scaleFactor;
-            m_backgroundPixmap = originalPixmap.scaled(scaledSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    if (m_fadeAnimation->state() != QAbstractAnimation::Stopped) {
+        m_fadeAnimation->stop();
+    }
+    m_previousFrame = QPixmap();
+    m_fadeProgress = 1.0;
+}
+
+void ImageRenderer::onImageReady(const QString& key, const QImage& image)
+{
+    if (!m_nextReady && !m_nextKey.isEmpty() && key == m_nextKey) {
+        m_nextImage = image;
+        m_nextReady = true;
+        if (m_advancePending) {
+            startTransition();
         }
+        return;
+    }
+
+    if (!m_waitingForImage || key != m_imageKey) {
+        return;
+    }
+
+    if (image.isNull()) {
+        qDebug() << "Failed to load image:" << currentImagePath();
+        m_waitingForImage = false;
+        m_backgroundPixmap = QPixmap();
+        m_frameDirty = true;
+        if (m_parentWidget) {
+            m_parentWidget->update();
+        }
+        return;
+    }
+
+    setSourceImage(image);
+}
+
+void ImageRenderer::setSourceImage(QImage image)
+{
+    m_waitingForImage = false;
+    DockTelemetry::recordDuration("ImageRenderer::load", quint64(m_loadTimer.nsecsElapsed() / 1000));
+
+    // Изображение уже в нужном размере и формате - преобразование без копирования пикселей
+    m_backgroundPixmap = QPixmap::fromImage(std::move(image));
+    m_backgroundPixmap.setDevicePixelRatio(imagePixelRatio());
+    m_frameDirty = true;
+
+    qDebug() << "Image loaded successfully, scaled size:" << m_backgroundPixmap.size();
+
+    if (m_parentWidget) {
+        m_parentWidget->update();
     }
 }
 
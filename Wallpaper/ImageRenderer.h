@@ -2,8 +2,15 @@
 #define IMAGERENDERER_H
 
 #include "MediaRenderer.h"
+#include "WallpaperImageLoader.h"
+#include <QElapsedTimer>
+#include <QImage>
 #include <QPixmap>
 
+class QTimer;
+class QVariantAnimation;
+class WallpaperPlaylist;
+
 class ImageRenderer : public MediaRenderer
 {
     Q_OBJECT
@@ -27,13 +34,64 @@ public:
     bool isPlaying() const override { return true; }
     void reset() override;
 
+    // Слайд-шоу: пустой каталог - показывается backgroundImage
+    void setSlideshow(const QString& directory, int intervalSeconds, bool shuffle);
+    bool isSlideshow() const { return !m_settings.slideshowDirectory.isEmpty(); }
+
+private slots:
+    void onImageReady(const QString& key, const QImage& image);
+    void onPlaylistLoaded();
+    void onSlideshowTimeout();
+
 private:
+    // Текущее изображение: файл слайд-шоу или backgroundImage
+    QString currentImagePath() const;
+    WallpaperImageRequest imageRequest(const QString& path) const;
+    qreal devicePixelRatio() const;
+    // Масштаб изображения от загрузчика: fill, fit и stretch приходят в физических
+    // пикселях экрана, в остальных режимах пиксель оригинала - логический пиксель
+    qreal imagePixelRatio() const;
     void loadAndScaleImage();
-    void applyScaling();
+    void applySlideshowSettings();
+    // Следующее изображение слайд-шоу декодируется заранее в фоне
+    void preloadNext();
+    void requestNextImage();
+    void releaseNextImage();
+    // Переход на заранее подготовленное изображение без декодирования
+    void startTransition();
+    void stopTransition();
+    void setSourceImage(QImage image);
+    // Собирает готовый кадр размером с экран: масштаб, обрезка, выравнивание, плитка
+    void composeFrame(const QSize& size);
+    void paintContent(QPainter* painter, const QRect& rect);
     QRect applyAlignmentToRect(const QRect& contentRect);
 
     ScreenSettings m_settings;
     QPixmap m_backgroundPixmap;
+    // Кадр пересобирается только при смене настроек или размера,
+    // отрисовка - одно копирование открытой области
+    QPixmap m_frame;
+    bool m_frameDirty;
+    // Изображение, захваченное у общего загрузчика; пустой - ничего не захвачено
+    QString m_imageKey;
+    bool m_waitingForImage;
+    QElapsedTimer m_loadTimer;
+
+    // Слайд-шоу
+    WallpaperPlaylist* m_playlist;
+    QTimer* m_slideshowTimer;
+    QString m_slideshowPath;
+    QString m_nextPath;
+    QString m_nextKey;
+    QImage m_nextImage;
+    bool m_nextReady;
+    bool m_advancePending;
+    int m_failedCount;
+    // Плавная смена: предыдущий кадр под новым с растущей непрозрачностью
+    QVariantAnimation* m_fadeAnimation;
+    QPixmap m_previousFrame;
+    qreal m_fadeProgress;
+    QElapsedTimer m_fadeFrameTimer;
     bool m_initialized;
     QSize m_currentSize;
     QWidget* m_parentWidget;
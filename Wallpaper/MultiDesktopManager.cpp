@@ -233,6 +233,8 @@ void MultiDesktopManager::setBackgroundForScreen(QScreen* screen, const ScreenSe
     bool found = false;
     for (DesktopBackground* background : m_desktopBackgrounds) {
         if (background->getTargetScreen() == screen) {
+            background->setSlideshow(settings.slideshowDirectory, settings.slideshowInterval,
+                                     settings.slideshowShuffle);
             background->setBackgroundImage(settings.backgroundImage);
             background->setBackgroundAlignment(settings.alignment);
             background->setBackgroundScaling(settings.scaling);
@@ -311,6 +313,18 @@ void MultiDesktopManager::setVideoSound(QScreen* screen, bool enable)
     saveSettings();
 }
 
+void MultiDesktopManager::setSlideshow(QScreen* screen, const QString& directory, int intervalSeconds, bool shuffle)
+{
+    if (!screen) return;
+
+    ScreenSettings& settings = m_screenSettings[screen->name()];
+    settings.slideshowDirectory = directory;
+    settings.slideshowInterval = qMax(DesktopBackgroundSettings::SLIDESHOW_MIN_INTERVAL_S, intervalSeconds);
+    settings.slideshowShuffle = shuffle;
+    updateBackgroundForScreen(screen);
+    saveSettings();
+}
+
 void MultiDesktopManager::updateBackgroundForScreen(QScreen* screen)
 {
     if (!screen) return;
@@ -323,6 +337,8 @@ void MultiDesktopManager::updateBackgroundForScreen(QScreen* screen)
             background->setBackgroundScaleFactor(settings.scaleFactor);
             background->setVideoLoop(settings.loopVideo);
             background->setVideoSound(settings.enableSound);
+            background->setSlideshow(settings.slideshowDirectory, settings.slideshowInterval,
+                                     settings.slideshowShuffle);
             break;
         }
     }
@@ -497,6 +513,10 @@ void MultiDesktopManager::loadSettings()
         m_screenSettings[screenName].scaleFactor = settings.value("scaleFactor", 1.0).toDouble();
         m_screenSettings[screenName].loopVideo = settings.value("loopVideo", true).toBool();
         m_screenSettings[screenName].enableSound = settings.value("enableSound", false).toBool();
+        m_screenSettings[screenName].slideshowDirectory = settings.value("slideshowDirectory").toString();
+        m_screenSettings[screenName].slideshowInterval =
+            settings.value("slideshowInterval", DesktopBackgroundSettings::SLIDESHOW_DEFAULT_INTERVAL_S).toInt();
+        m_screenSettings[screenName].slideshowShuffle = settings.value("slideshowShuffle", false).toBool();
 
         // Убедимся, что isVideo синхронизирован с текущим файлом
         if (!m_screenSettings[screenName].backgroundImage.isEmpty()) {
@@ -543,6 +563,9 @@ void MultiDesktopManager::saveSettings()
         settings.setValue("scaleFactor", it.value().scaleFactor);
         settings.setValue("loopVideo", it.value().loopVideo);
         settings.setValue("enableSound", it.value().enableSound);
+        settings.setValue("slideshowDirectory", it.value().slideshowDirectory);
+        settings.setValue("slideshowInterval", it.value().slideshowInterval);
+        settings.setValue("slideshowShuffle", it.value().slideshowShuffle);
         settings.endGroup();
     }
     settings.endGroup();
@@ -42,6 +42,8 @@ public:
     void setBackgroundScaleFactor(QScreen* screen, qreal scaleFactor);
     void setVideoLoop(QScreen* screen, bool loop);
     void setVideoSound(QScreen* screen, bool enable);
+    // Пустой каталог выключает слайд-шоу
+    void setSlideshow(QScreen* screen, const QString& directory, int intervalSeconds, bool shuffle);
 
     // Методы для работы с диалогами
     void showBackgroundSettingsDialog(QScreen* screen = nullptr);
@@ -11,9 +11,13 @@ struct ScreenSettings {
     bool isVideo;       // флаг, указывающий что это видео
     bool loopVideo;     // зацикливать видео
     bool enableSound;   // включить звук
+    QString slideshowDirectory; // каталог слайд-шоу, пустой - слайд-шоу выключено
+    int slideshowInterval;      // интервал смены изображений, секунды
+    bool slideshowShuffle;      // случайный порядок
 
     ScreenSettings() : alignment("center"), scaling("fill"), scaleFactor(1.0),
-                      isVideo(false), loopVideo(true), enableSound(false) {}
+                      isVideo(false), loopVideo(true), enableSound(false),
+                      slideshowInterval(300), slideshowShuffle(false) {}
 };
 
 #endif // SCREENSETTINGS_H
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "SharedVideoPlayer.h"
+#include "CommonDefines.h"
+#include "../DockTelemetry.h"
+
+#include <QDebug>
+#include <QTimer>
+#include <QUrl>
+#include <QVideoFrame>
+#include <QVideoSink>
+
+QHash<QString, SharedVideoPlayer*> SharedVideoPlayer::s_players;
+
+SharedVideoPlayer* SharedVideoPlayer::acquire(const QString& path)
+{
+    SharedVideoPlayer*& player = s_players[path];
+    if (!player) {
+        player = new SharedVideoPlayer(path);
+    }
+    ++player->m_refs;
+
+    qDebug() << "Shared video player for" << path << "screens:" << player->m_refs;
+    return player;
+}
+
+void SharedVideoPlayer::release(SharedVideoPlayer* player)
+{
+    if (!player || --player->m_refs > 0) {
+        return;
+    }
+
+    s_players.remove(player->m_path);
+    player->deleteLater();
+}
+
+SharedVideoPlayer::SharedVideoPlayer(const QString& path)
+    : QObject(nullptr)
+    , m_path(path)
+    , m_refs(0)
+    , m_player(nullptr)
+    , m_sink(nullptr)
+    , m_errorCount(0)
+{
+    m_player = new QMediaPlayer(this);
+    m_sink = new QVideoSink(this);
+    m_player->setVideoOutput(m_sink);
+    // Общий плеер используется только без звука и с зацикливанием
+    m_player->setAudioOutput(nullptr);
+    m_player->setLoops(QMediaPlayer::Infinite);
+
+    connect(m_sink, &QVideoSink::videoFrameChanged, this, &SharedVideoPlayer::onVideoFrameChanged);
+    connect(m_player, &QMediaPlayer::mediaStatusChanged, this, &SharedVideoPlayer::onMediaStatusChanged);
+    connect(m_player, &QMediaPlayer::errorOccurred, this, &SharedVideoPlayer::onErrorOccurred);
+
+    m_player->setSource(QUrl::fromLocalFile(m_path));
+}
+
+SharedVideoPlayer::~SharedVideoPlayer()
+{
+    m_player->stop();
+}
+
+void SharedVideoPlayer::addSink(QObject* client, QVideoSink* sink)
+{
+    if (!client || !sink || m_clientSinks.value(client) == sink) {
+        return;
+    }
+
+    removeSink(client);
+    m_clientSinks.insert(client, sink);
+    if (m_playingClients.contains(client)) {
+        updateSink(client);
+        return;
+    }
+
+    // Новый экран сразу получает текущий кадр, не дожидаясь следующего
+    const QVideoFrame frame = m_sink->videoFrame();
+    if (frame.isValid()) {
+        sink->setVideoFrame(frame);
+    }
+}
+
+void SharedVideoPlayer::removeSink(QObject* client)
+{
+    const QPointer<QVideoSink> sink = m_clientSinks.take(client);
+    if (sink) {
+        m_sinks.removeAll(sink);
+    }
+}
+
+void SharedVideoPlayer::setPlaying(QObject* client, bool playing)
+{
+    if (playing) {
+        m_playingClients.insert(client);
+    } else {
+        m_playingClients.remove(client);
+    }
+    updateSink(client);
+    updatePlayback();
+}
+
+void SharedVideoPlayer::updateSink(QObject* client)
+{
+    QVideoSink* sink = m_clientSinks.value(client);
+    if (!sink) {
+        return;
+    }
+
+    const bool active = m_sinks.contains(sink);
+    if (m_playingClients.contains(client) == active) {
+        return;
+    }
+
+    if (active) {
+        // Закрытый или остановленный экран не получает кадры - виджет
+        // не перерисовывается и не масштабирует их впустую
+        m_sinks.removeAll(sink);
+        return;
+    }
+
+    // Возобновленный экран сразу переходит на текущий кадр
+    m_sinks.append(sink);
+    const QVideoFrame frame = m_sink->videoFrame();
+    if (frame.isValid()) {
+        sink->setVideoFrame(frame);
+    }
+}
+
+bool SharedVideoPlayer::isPlaying() const
+{
+    return m_player->playbackState() == QMediaPlayer::PlayingState;
+}
+
+void SharedVideoPlayer::reload()
+{
+    // Все экраны просыпаются одновременно - одной перезагрузки достаточно
+    if (m_reloadTimer.isValid() && m_reloadTimer.elapsed() < DesktopBackgroundSettings::WAKEUP_CHECK_INTERVAL_MS) {
+        return;
+    }
+    m_reloadTimer.start();
+
+    const qint64 position = m_player->position();
+    m_player->setSource(QUrl::fromLocalFile(m_path));
+    m_player->setPosition(position);
+    updatePlayback();
+    qDebug() << "Shared video player reloaded:" << m_path;
+}
+
+void SharedVideoPlayer::onVideoFrameChanged(const QVideoFrame& frame)
+{
+    DockTelemetry::countWakeup("SharedVideoPlayer::decodedFrame");
+    DockTelemetry::ScopedTimer telemetryTimer("SharedVideoPlayer::fanOut");
+
+    // Кадр разделяется между приемниками без копирования пикселей
+    for (int i = m_sinks.size() - 1; i >= 0; --i) {
+        QVideoSink* sink = m_sinks.at(i);
+        if (!sink) {
+            m_sinks.removeAt(i);
+            continue;
+        }
+        sink->setVideoFrame(frame);
+    }
+}
+
+void SharedVideoPlayer::onMediaStatusChanged(QMediaPlayer::MediaStatus status)
+{
+    switch (status) {
+    case QMediaPlayer::LoadedMedia:
+    case QMediaPlayer::BufferedMedia:
+        m_errorCount = 0;
+        updatePlayback();
+        break;
+    case QMediaPlayer::InvalidMedia:
+        qDebug() << "Invalid shared video:" << m_path;
+        break;
+    default:
+        break;
+    }
+}
+
+void SharedVideoPlayer::onErrorOccurred(QMediaPlayer::Error error, const QString& errorString)
+{
+    qDebug() << "Shared video player error:" << error << errorString;
+
+    if (++m_errorCount > DesktopBackgroundSettings::MAX_VIDEO_ERROR_COUNT) {
+        qDebug() << "Too many video errors, disabling shared video for:" << m_path;
+        emit failed(m_path);
+        return;
+    }
+
+    // Увеличиваем задержку при каждой следующей попытке
+    const int delay = DesktopBackgroundSettings::VIDEO_ERROR_RETRY_DELAY_MS * m_errorCount;
+    QTimer::singleShot(delay, this, [this]() {
+        m_player->stop();
+        m_player->setSource(QUrl::fromLocalFile(m_path));
+        updatePlayback();
+    });
+}
+
+void SharedVideoPlayer::updatePlayback()
+{
+    const QMediaPlayer::MediaStatus status = m_player->mediaStatus();
+    if (status == QMediaPlayer::NoMedia || status == QMediaPlayer::InvalidMedia) {
+        return;
+    }
+
+    if (!m_playingClients.isEmpty()) {
+        if (m_player->playbackState() != QMediaPlayer::PlayingState) {
+            m_player->play();
+        }
+    } else if (m_player->playbackState() == QMediaPlayer::PlayingState) {
+        // Ни один экран не показывает видео - декодирование останавливается,
+        // на экранах остается последний кадр
+        m_player->pause();
+    }
+}
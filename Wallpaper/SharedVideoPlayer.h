@@ -0,0 +1,77 @@
+#ifndef SHAREDVIDEOPLAYER_H
+#define SHAREDVIDEOPLAYER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMediaPlayer>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+
+class QVideoFrame;
+class QVideoSink;
+
+// Общий декодер видео обоев для нескольких экранов.
+// Один QMediaPlayer на файл декодирует поток один раз и раздает кадры
+// в приемники (QVideoSink) видео виджетов всех экранов с этим файлом;
+// каждый виджет масштабирует кадр под свой экран. Кадры общие (без
+// копирования), зацикливание синхронно по построению. Воспроизведение
+// идет, пока его хочет хотя бы один экран; кадры получают только экраны,
+// которые воспроизводят видео, - на остальных остается последний кадр.
+class SharedVideoPlayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Плеер для файла; создается при первом захвате, удаляется при последнем release
+    static SharedVideoPlayer* acquire(const QString& path);
+    static void release(SharedVideoPlayer* player);
+
+    QString path() const { return m_path; }
+    // Подключенные экраны и те из них, что сейчас получают кадры
+    int sinkCount() const { return m_clientSinks.size(); }
+    int activeSinkCount() const { return m_sinks.size(); }
+
+    // Приемник кадров экрана (client); кадры в него идут, пока экран воспроизводит видео
+    void addSink(QObject* client, QVideoSink* sink);
+    void removeSink(QObject* client);
+
+    // Желание экрана (client) воспроизводить видео
+    void setPlaying(QObject* client, bool playing);
+    bool isPlaying() const;
+
+    // Перезагрузка источника с той же позиции (после сна системы)
+    void reload();
+
+signals:
+    // Видео не удалось воспроизвести после повторных попыток
+    void failed(const QString& path);
+
+private:
+    explicit SharedVideoPlayer(const QString& path);
+    ~SharedVideoPlayer();
+
+    void onVideoFrameChanged(const QVideoFrame& frame);
+    void onMediaStatusChanged(QMediaPlayer::MediaStatus status);
+    void onErrorOccurred(QMediaPlayer::Error error, const QString& errorString);
+    void updatePlayback();
+    // Раздача кадров в приемник экрана включается, только пока он воспроизводит видео
+    void updateSink(QObject* client);
+
+    static QHash<QString, SharedVideoPlayer*> s_players;
+
+    QString m_path;
+    int m_refs;
+    QMediaPlayer* m_player;
+    QVideoSink* m_sink;
+    QHash<QObject*, QPointer<QVideoSink>> m_clientSinks;
+    // Приемники, в которые раздается каждый кадр
+    QList<QPointer<QVideoSink>> m_sinks;
+    QSet<QObject*> m_playingClients;
+    int m_errorCount;
+    QElapsedTimer m_reloadTimer;
+};
+
+#endif // SHAREDVIDEOPLAYER_H
@@ -0,0 +1,328 @@
+#include "VideoPlaybackPolicy.h"
+#include "../DockTelemetry.h"
+#include "../WindowTaskModel.h"
+
+#include <QDebug>
+#include <QSettings>
+#include <QTimer>
+#include <QWidget>
+
+#ifdef Q_OS_WIN
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <dwmapi.h>
+
+namespace {
+
+quint64 fileTimeValue(const FILETIME& time)
+{
+    return (quint64(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+}
+
+// Состояние системы через WinAPI
+class WinPlaybackEnvironment : public PlaybackEnvironment
+{
+public:
+    bool isWindowCovered(quintptr window) const override
+    {
+        HWND desktopWindow = reinterpret_cast<HWND>(window);
+        HMONITOR monitor = MonitorFromWindow(desktopWindow, MONITOR_DEFAULTTONULL);
+        if (!monitor) {
+            return false;
+        }
+
+        MONITORINFO monitorInfo = {};
+        monitorInfo.cbSize = sizeof(monitorInfo);
+        if (!GetMonitorInfoW(monitor, &monitorInfo)) {
+            return false;
+        }
+
+        CoverQuery query;
+        // Окно обоев может быть встроено в WorkerW - в z-order сравнивается окно верхнего уровня
+        query.window = GetAncestor(desktopWindow, GA_ROOT);
+        query.monitor = monitor;
+        query.workArea = monitorInfo.rcWork;
+        query.processId = GetCurrentProcessId();
+        // EnumWindows идет сверху вниз по z-order
+        EnumWindows(coverProc, reinterpret_cast<LPARAM>(&query));
+        return query.covered;
+    }
+
+    bool isOnBattery() const override
+    {
+        SYSTEM_POWER_STATUS status;
+        return GetSystemPowerStatus(&status) && status.ACLineStatus == 0;
+    }
+
+    int cpuLoad() override
+    {
+        FILETIME idleTime, kernelTime, userTime;
+        FILETIME creationTime, exitTime, processKernel, processUser;
+        if (!GetSystemTimes(&idleTime, &kernelTime, &userTime)
+            || !GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &processKernel, &processUser)) {
+            return -1;
+        }
+
+        const quint64 idle = fileTimeValue(idleTime);
+        // Время ядра включает простой
+        const quint64 total = fileTimeValue(kernelTime) + fileTimeValue(userTime);
+        const quint64 own = fileTimeValue(processKernel) + fileTimeValue(processUser);
+
+        int load = -1;
+        if (m_lastTotal > 0 && total > m_lastTotal) {
+            const quint64 totalDelta = total - m_lastTotal;
+            const quint64 busyDelta = totalDelta - qMin(totalDelta, idle - m_lastIdle);
+            // Собственное декодирование видео не должно вызывать паузу -
+            // иначе воспроизведение само себя останавливало бы
+            const quint64 otherDelta = busyDelta - qMin(busyDelta, own - m_lastOwn);
+            load = int(otherDelta * 100 / totalDelta);
+        }
+
+        m_lastIdle = idle;
+        m_lastTotal = total;
+        m_lastOwn = own;
+        return load;
+    }
+
+private:
+    struct CoverQuery {
+        HWND window = nullptr;
+        HMONITOR monitor = nullptr;
+        RECT workArea = {};
+        DWORD processId = 0;
+        bool covered = false;
+    };
+
+    static BOOL CALLBACK coverProc(HWND hwnd, LPARAM lParam)
+    {
+        CoverQuery* query = reinterpret_cast<CoverQuery*>(lParam);
+
+        // Дальше по z-order окна под обоями - они закрыть их не могут
+        if (hwnd == query->window) {
+            return FALSE;
+        }
+
+        if (!IsWindowVisible(hwnd) || IsIconic(hwnd)) {
+            return TRUE;
+        }
+
+        // Окна дока и обоев, а также служебные окна не считаются
+        DWORD processId = 0;
+        GetWindowThreadProcessId(hwnd, &processId);
+        if (processId == query->processId) {
+            return TRUE;
+        }
+        if (GetWindowLongW(hwnd, GWL_EXSTYLE) & (WS_EX_TOOLWINDOW | WS_EX_TRANSPARENT)) {
+            return TRUE;
+        }
+
+        // Окна рабочего стола проводника занимают весь монитор, но ничего не закрывают
+        wchar_t className[16] = {};
+        GetClassNameW(hwnd, className, int(sizeof(className) / sizeof(className[0])));
+        if (wcscmp(className, L"Progman") == 0 || wcscmp(className, L"WorkerW") == 0) {
+            return TRUE;
+        }
+
+        // Окна на других виртуальных рабочих столах скрыты через DWM
+        BOOL cloaked = FALSE;
+        DwmGetWindowAttribute(hwnd, DWMWA_CLOAKED, &cloaked, sizeof(cloaked));
+        if (cloaked) {
+            return TRUE;
+        }
+
+        if (MonitorFromWindow(hwnd, MONITOR_DEFAULTTONULL) != query->monitor) {
+            return TRUE;
+        }
+
+        RECT rect;
+        if (GetWindowRect(hwnd, &rect)
+            && rect.left <= query->workArea.left && rect.top <= query->workArea.top
+            && rect.right >= query->workArea.right && rect.bottom >= query->workArea.bottom) {
+            query->covered = true;
+            return FALSE;
+        }
+        return TRUE;
+    }
+
+    quint64 m_lastIdle = 0;
+    quint64 m_lastTotal = 0;
+    quint64 m_lastOwn = 0;
+};
+
+} // namespace
+#endif
+
+VideoPlaybackPolicy& VideoPlaybackPolicy::instance()
+{
+    static VideoPlaybackPolicy policy;
+    return policy;
+}
+
+VideoPlaybackPolicy::VideoPlaybackPolicy()
+    : QObject(nullptr)
+    , m_environment(nullptr)
+    , m_pollTimer(nullptr)
+    , m_evaluateTimer(nullptr)
+    , m_highLoad(false)
+    , m_highLoadSamples(0)
+    , m_posterOnBattery(true)
+    , m_posterOnHighLoad(true)
+{
+#ifdef Q_OS_WIN
+    m_environment = new WinPlaybackEnvironment();
+#else
+    m_environment = new ManualPlaybackEnvironment();
+#endif
+
+    QSettings settings("MyCompany", "DockApp");
+    m_posterOnBattery = settings.value("Video/PosterOnBattery", true).toBool();
+    m_posterOnHighLoad = settings.value("Video/PosterOnHighLoad", true).toBool();
+
+    m_pollTimer = new QTimer(this);
+    m_pollTimer->setInterval(POLL_INTERVAL_MS);
+    connect(m_pollTimer, &QTimer::timeout, this, [this]() {
+        DockTelemetry::countWakeup("VideoPlaybackPolicy::poll");
+        evaluate();
+    });
+
+    // События окон приходят пачками - пересчет один раз после них
+    m_evaluateTimer = new QTimer(this);
+    m_evaluateTimer->setSingleShot(true);
+    m_evaluateTimer->setInterval(EVALUATE_DELAY_MS);
+    connect(m_evaluateTimer, &QTimer::timeout, this, &VideoPlaybackPolicy::evaluate);
+
+    WindowTaskModel& windowModel = WindowTaskModel::instance();
+    connect(&windowModel, &WindowTaskModel::windowActivated, this, &VideoPlaybackPolicy::scheduleEvaluate);
+    connect(&windowModel, &WindowTaskModel::windowAdded, this, &VideoPlaybackPolicy::scheduleEvaluate);
+    connect(&windowModel, &WindowTaskModel::windowRemoved, this, &VideoPlaybackPolicy::scheduleEvaluate);
+}
+
+VideoPlaybackPolicy::~VideoPlaybackPolicy()
+{
+    delete m_environment;
+}
+
+void VideoPlaybackPolicy::setEnvironment(PlaybackEnvironment* environment)
+{
+    if (!environment || environment == m_environment) {
+        return;
+    }
+
+    delete m_environment;
+    m_environment = environment;
+    m_highLoad = false;
+    m_highLoadSamples = 0;
+    evaluate();
+}
+
+void VideoPlaybackPolicy::attach(QWidget* window)
+{
+    if (!window || m_windows.contains(window)) {
+        return;
+    }
+
+    m_windows.append(window);
+    m_modes.insert(window, Playing);
+
+    if (!m_pollTimer->isActive()) {
+        m_pollTimer->start();
+    }
+    scheduleEvaluate();
+}
+
+void VideoPlaybackPolicy::detach(QWidget* window)
+{
+    m_windows.removeAll(window);
+    m_modes.remove(window);
+
+    // Без видео обоев опрашивать нечего
+    if (m_windows.isEmpty()) {
+        m_pollTimer->stop();
+        m_evaluateTimer->stop();
+    }
+}
+
+VideoPlaybackPolicy::Mode VideoPlaybackPolicy::mode(QWidget* window) const
+{
+    return m_modes.value(window, Playing);
+}
+
+void VideoPlaybackPolicy::setPosterOnBattery(bool enabled)
+{
+    m_posterOnBattery = enabled;
+    QSettings settings("MyCompany", "DockApp");
+    settings.setValue("Video/PosterOnBattery", enabled);
+    evaluate();
+}
+
+void VideoPlaybackPolicy::setPosterOnHighLoad(bool enabled)
+{
+    m_posterOnHighLoad = enabled;
+    QSettings settings("MyCompany", "DockApp");
+    settings.setValue("Video/PosterOnHighLoad", enabled);
+    evaluate();
+}
+
+VideoPlaybackPolicy::Mode VideoPlaybackPolicy::decide(bool covered, bool onBattery, bool highLoad,
+                                                      bool posterOnBattery, bool posterOnHighLoad)
+{
+    if (covered) {
+        return Paused;
+    }
+    if ((onBattery && posterOnBattery) || (highLoad && posterOnHighLoad)) {
+        return Poster;
+    }
+    return Playing;
+}
+
+bool VideoPlaybackPolicy::updateHighLoad(bool highLoad, int load, int& highSamples)
+{
+    if (load < 0) {
+        return highLoad;
+    }
+
+    if (load >= HIGH_LOAD_PERCENT) {
+        // Кратковременные пики не останавливают видео
+        highSamples = qMin(highSamples + 1, HIGH_LOAD_SAMPLES);
+        return highLoad || highSamples >= HIGH_LOAD_SAMPLES;
+    }
+
+    highSamples = 0;
+    return highLoad && load >= NORMAL_LOAD_PERCENT;
+}
+
+void VideoPlaybackPolicy::scheduleEvaluate()
+{
+    if (!m_windows.isEmpty() && !m_evaluateTimer->isActive()) {
+        m_evaluateTimer->start();
+    }
+}
+
+void VideoPlaybackPolicy::evaluate()
+{
+    if (m_windows.isEmpty()) {
+        return;
+    }
+
+    DockTelemetry::ScopedTimer telemetryTimer("VideoPlaybackPolicy::evaluate");
+
+    const bool onBattery = m_environment->isOnBattery();
+    m_highLoad = updateHighLoad(m_highLoad, m_environment->cpuLoad(), m_highLoadSamples);
+
+    // Копия - обработчики сигнала могут отсоединять окна
+    const QList<QWidget*> windows = m_windows;
+    for (QWidget* window : windows) {
+        if (!m_modes.contains(window)) {
+            continue;
+        }
+
+        const bool covered = window->isVisible() && m_environment->isWindowCovered(quintptr(window->winId()));
+        const Mode newMode = decide(covered, onBattery, m_highLoad, m_posterOnBattery, m_posterOnHighLoad);
+        if (m_modes.value(window) != newMode) {
+            qDebug() << "Video wallpaper playback mode:" << newMode
+                     << "covered:" << covered << "battery:" << onBattery << "high load:" << m_highLoad;
+            m_modes[window] = newMode;
+            emit modeChanged(window, newMode);
+        }
+    }
+}
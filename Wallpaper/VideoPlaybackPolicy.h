@@ -0,0 +1,118 @@
+#ifndef VIDEOPLAYBACKPOLICY_H
+#define VIDEOPLAYBACKPOLICY_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QSet>
+
+class QTimer;
+class QWidget;
+
+// Источник состояния системы для политики воспроизведения.
+// Позволяет подменить WinAPI (например, заглушкой)
+class PlaybackEnvironment
+{
+public:
+    virtual ~PlaybackEnvironment() = default;
+
+    // Окно обоев (winId) полностью закрыто окнами приложений на своем мониторе
+    virtual bool isWindowCovered(quintptr window) const = 0;
+    virtual bool isOnBattery() const = 0;
+    // Загрузка процессора другими процессами с прошлого вызова, 0-100; -1 - неизвестно
+    virtual int cpuLoad() = 0;
+};
+
+// Заглушка: состояние задается вручную. Используется там, где нет
+// системной реализации, и для проверки политики
+class ManualPlaybackEnvironment : public PlaybackEnvironment
+{
+public:
+    bool isWindowCovered(quintptr window) const override { return m_coveredWindows.contains(window); }
+    bool isOnBattery() const override { return m_onBattery; }
+    int cpuLoad() override { return m_cpuLoad; }
+
+    void setWindowCovered(quintptr window, bool covered)
+    {
+        if (covered) {
+            m_coveredWindows.insert(window);
+        } else {
+            m_coveredWindows.remove(window);
+        }
+    }
+    void setOnBattery(bool onBattery) { m_onBattery = onBattery; }
+    void setCpuLoad(int load) { m_cpuLoad = load; }
+
+private:
+    QSet<quintptr> m_coveredWindows;
+    bool m_onBattery = false;
+    int m_cpuLoad = -1;
+};
+
+// Политика воспроизведения видео обоев: пауза, когда экран закрыт
+// полноэкранным или развернутым окном, и статичный кадр при работе от
+// батареи или высокой загрузке процессора другими программами.
+// Закрытие окон отслеживается по событиям активации окон (WindowTaskModel)
+// и редкому опросу; опрос работает, только пока есть видео обои.
+class VideoPlaybackPolicy : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Mode {
+        Playing,    // Обычное воспроизведение
+        Poster,     // Экран виден, но показывается последний кадр (экономия энергии)
+        Paused      // Экран закрыт - воспроизведение не нужно
+    };
+
+    static inline const int POLL_INTERVAL_MS = 2000;
+    static inline const int EVALUATE_DELAY_MS = 100;
+    // Гистерезис загрузки процессора
+    static inline const int HIGH_LOAD_PERCENT = 85;
+    static inline const int NORMAL_LOAD_PERCENT = 60;
+    static inline const int HIGH_LOAD_SAMPLES = 3;
+
+    static VideoPlaybackPolicy& instance();
+
+    // Заменяет источник состояния (политика становится его владельцем)
+    void setEnvironment(PlaybackEnvironment* environment);
+    PlaybackEnvironment* environment() const { return m_environment; }
+
+    // Окна видео обоев, для которых вычисляется режим
+    void attach(QWidget* window);
+    void detach(QWidget* window);
+    Mode mode(QWidget* window) const;
+
+    void setPosterOnBattery(bool enabled);
+    void setPosterOnHighLoad(bool enabled);
+
+    // Переходы состояний без обращения к системе
+    static Mode decide(bool covered, bool onBattery, bool highLoad,
+                       bool posterOnBattery, bool posterOnHighLoad);
+    // Учитывает очередной замер загрузки; true - загрузка высокая
+    static bool updateHighLoad(bool highLoad, int load, int& highSamples);
+
+public slots:
+    // Пересчет режимов; вызывается по таймеру и при смене активного окна
+    void evaluate();
+    void scheduleEvaluate();
+
+signals:
+    void modeChanged(QWidget* window, VideoPlaybackPolicy::Mode mode);
+
+private:
+    VideoPlaybackPolicy();
+    ~VideoPlaybackPolicy();
+
+    PlaybackEnvironment* m_environment;
+    QTimer* m_pollTimer;
+    QTimer* m_evaluateTimer;
+    QList<QWidget*> m_windows;
+    QHash<QWidget*, Mode> m_modes;
+    bool m_highLoad;
+    int m_highLoadSamples;
+    bool m_posterOnBattery;
+    bool m_posterOnHighLoad;
+};
+
+#endif // VIDEOPLAYBACKPOLICY_H
@@ -0,0 +1,174 @@
+#include "VideoPosterCache.h"
+#include "../DockTelemetry.h"
+#include "../ImageResampler.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QImageReader>
+#include <QPainter>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QtConcurrent>
+#include <algorithm>
+
+VideoPosterCache& VideoPosterCache::instance()
+{
+    static VideoPosterCache cache;
+    return cache;
+}
+
+VideoPosterCache::VideoPosterCache()
+    : QObject(nullptr)
+    , m_enabled(true)
+{
+    QSettings settings("MyCompany", "DockApp");
+    m_enabled = settings.value("Video/PosterCache", true).toBool();
+
+    m_dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/video_posters";
+    QDir().mkpath(m_dir);
+
+    m_pool.setMaxThreadCount(1);
+}
+
+VideoPosterCache::~VideoPosterCache()
+{
+    m_pool.waitForDone();
+}
+
+QString VideoPosterCache::posterKey(const QString& videoPath, const QSize& pixelSize, const QString& scaling,
+                                    const QString& alignment, qreal scaleFactor)
+{
+    const QFileInfo info(videoPath);
+    if (videoPath.isEmpty() || !info.exists() || pixelSize.isEmpty()) {
+        return QString();
+    }
+
+    // Замененный файл с тем же именем дает другой ключ
+    const QString source = info.absoluteFilePath() + '|' + QString::number(info.lastModified().toMSecsSinceEpoch())
+                           + '|' + QString::number(pixelSize.width()) + 'x' + QString::number(pixelSize.height())
+                           + '|' + scaling + '|' + alignment + '|' + QString::number(scaleFactor, 'f', 2);
+    return QString::fromLatin1(QCryptographicHash::hash(source.toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+QString VideoPosterCache::posterPath(const QString& key) const
+{
+    return m_dir + '/' + key + ".jpg";
+}
+
+void VideoPosterCache::load(const QString& key)
+{
+    if (!m_enabled || key.isEmpty()) {
+        emit posterLoaded(key, QImage());
+        return;
+    }
+
+    QFutureWatcher<JobResult>* watcher = new QFutureWatcher<JobResult>(this);
+    connect(watcher, &QFutureWatcher<JobResult>::finished, this, [this, watcher, key]() {
+        watcher->deleteLater();
+        const JobResult result = watcher->result();
+        if (result.elapsedUs > 0) {
+            DockTelemetry::recordDuration("VideoPosterCache::read", quint64(result.elapsedUs));
+        }
+        emit posterLoaded(key, result.image);
+    });
+    watcher->setFuture(QtConcurrent::run(&m_pool, &VideoPosterCache::readPoster, posterPath(key)));
+}
+
+void VideoPosterCache::store(const QString& key, const QImage& frame, const QSize& canvasSize, const QRect& targetRect)
+{
+    if (!m_enabled || key.isEmpty() || frame.isNull() || canvasSize.isEmpty() || m_storing.contains(key)) {
+        return;
+    }
+
+    m_storing.insert(key);
+
+    QFutureWatcher<JobResult>* watcher = new QFutureWatcher<JobResult>(this);
+    connect(watcher, &QFutureWatcher<JobResult>::finished, this, [this, watcher, key]() {
+        watcher->deleteLater();
+        m_storing.remove(key);
+        const JobResult result = watcher->result();
+        DockTelemetry::recordDuration("VideoPosterCache::write", quint64(result.elapsedUs));
+        if (result.written) {
+            removeOldPosters();
+        }
+    });
+    watcher->setFuture(QtConcurrent::run(&m_pool, &VideoPosterCache::writePoster,
+                                         posterPath(key), frame, canvasSize, targetRect));
+}
+
+void VideoPosterCache::removeOldPosters()
+{
+    QFileInfoList files = QDir(m_dir).entryInfoList({"*.jpg"}, QDir::Files);
+    if (files.size() <= MAX_POSTERS) {
+        return;
+    }
+
+    // Кадры показываемых видео обновляются при воспроизведении - удаляются самые старые
+    std::sort(files.begin(), files.end(), [](const QFileInfo& a, const QFileInfo& b) {
+        return a.lastModified() > b.lastModified();
+    });
+
+    for (int i = MAX_POSTERS; i < files.size(); ++i) {
+        QFile::remove(files[i].absoluteFilePath());
+    }
+}
+
+VideoPosterCache::JobResult VideoPosterCache::readPoster(const QString& path)
+{
+    JobResult result;
+    if (!QFileInfo::exists(path)) {
+        return result;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QImageReader reader(path);
+    result.image = reader.read();
+    if (result.image.isNull()) {
+        qDebug() << "VideoPosterCache: failed to read" << path << reader.errorString();
+    } else {
+        // Формат, который QPixmap принимает без преобразования в потоке GUI
+        result.image.convertTo(QImage::Format_RGB32);
+    }
+
+    result.elapsedUs = qMax<qint64>(1, timer.nsecsElapsed() / 1000);
+    return result;
+}
+
+VideoPosterCache::JobResult VideoPosterCache::writePoster(const QString& path, const QImage& frame,
+                                                          const QSize& canvasSize, const QRect& targetRect)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    JobResult result;
+
+    // Кадр раскладывается так же, как его показывает видео виджет, -
+    // при запуске стоп-кадр рисуется на весь экран без масштабирования
+    QImage canvas(canvasSize, QImage::Format_RGB32);
+    canvas.fill(Qt::black);
+    {
+        const QImage source = frame.convertToFormat(QImage::Format_RGB32);
+        QPainter painter(&canvas);
+        painter.drawImage(targetRect.topLeft(), source.size() == targetRect.size()
+                                                    ? source
+                                                    : ImageResampler::resize(source, targetRect.size()));
+    }
+
+    QSaveFile file(path);
+    result.written = file.open(QIODevice::WriteOnly) && canvas.save(&file, "JPG", JPEG_QUALITY) && file.commit();
+    if (!result.written) {
+        qDebug() << "VideoPosterCache: failed to write" << path;
+    }
+
+    result.elapsedUs = timer.nsecsElapsed() / 1000;
+    return result;
+}
@@ -0,0 +1,70 @@
+#ifndef VIDEOPOSTERCACHE_H
+#define VIDEOPOSTERCACHE_H
+
+#include <QObject>
+#include <QImage>
+#include <QRect>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+
+// Кеш стоп-кадров видео обоев.
+// Для каждого экрана сохраняется последний показанный кадр, уже
+// масштабированный под физическое разрешение экрана и его настройки
+// масштабирования, поэтому при следующем запуске он рисуется сразу, без
+// декодирования видео. Ключ - путь и время изменения видео плюс размер
+// экрана и параметры масштабирования. Кодирование и чтение JPEG идут в
+// фоновом потоке, файл записывается через QSaveFile (недописанных файлов
+// не бывает). Хранится ограниченное число кадров, старые удаляются.
+class VideoPosterCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static inline const int MAX_POSTERS = 24;
+    static inline const int JPEG_QUALITY = 90;
+
+    static VideoPosterCache& instance();
+
+    static QString posterKey(const QString& videoPath, const QSize& pixelSize, const QString& scaling,
+                             const QString& alignment, qreal scaleFactor);
+
+    bool isEnabled() const { return m_enabled; }
+
+    // Читает кадр в фоне, результат приходит через posterLoaded
+    void load(const QString& key);
+    // Кадр рисуется в targetRect на черном холсте размера canvasSize (физические пиксели)
+    void store(const QString& key, const QImage& frame, const QSize& canvasSize, const QRect& targetRect);
+
+    QString posterDirectory() const { return m_dir; }
+
+signals:
+    // Пустое изображение - кадра для ключа нет
+    void posterLoaded(const QString& key, const QImage& image);
+
+private:
+    VideoPosterCache();
+    ~VideoPosterCache();
+
+    // Результат фоновой задачи; длительность записывается в телеметрию в потоке GUI
+    struct JobResult {
+        QImage image;
+        bool written = false;
+        qint64 elapsedUs = 0;   // 0 - файла нет, чтение не выполнялось
+    };
+
+    QString posterPath(const QString& key) const;
+    void removeOldPosters();
+
+    static JobResult readPoster(const QString& path);
+    static JobResult writePoster(const QString& path, const QImage& frame, const QSize& canvasSize, const QRect& targetRect);
+
+    QString m_dir;
+    bool m_enabled;
+    QThreadPool m_pool;
+    // Ключи, для которых запись еще идет - повторный кадр не ставится в очередь
+    QSet<QString> m_storing;
+};
+
+#endif // VIDEOPOSTERCACHE_H
@@ -1,4 +1,8 @@
 #include "VideoRenderer.h"
+#include "VideoTranscodeCache.h"
+#include "SharedVideoPlayer.h"
+#include "VideoPosterCache.h"
+#include "../DockTelemetry.h"
 #include <QDebug>
 #include <QFileInfo>
 #include <QUrl>
@@ -9,14 +13,17 @@
 #include <QPainter>
 #include <QTime>
 #include <QMetaObject>
-#include <QProcess>
 #include <QDir>
 #include <QProgressBar>
-#include <QRegularExpression>
 #include <QElapsedTimer>
 #include <QThread>
 #include <QMessageBox>
 #include <QScreen>
+#include <QSettings>
+#include <QVideoSink>
+#include <QVideoFrame>
+#include <QVariantAnimation>
+#include <QRegion>
 
 VideoRenderer::VideoRenderer(QScreen* targetScreen, QWidget* parent)
     : MediaRenderer(parent)
@@ -29,7 +36,6 @@ VideoRenderer::VideoRenderer(QScreen* targetScreen, QWidget* parent)
     , m_optimizationTimer(nullptr)
     , m_geometryUpdateTimer(nullptr)
     , m_delayedInitTimer(nullptr)
-    , m_ffmpegProcess(nullptr)
     , m_progressBar(nullptr)
     , m_videoDuration(0)
     , m_wasSleeping(false)
@@ -37,6 +43,10 @@ VideoRenderer::VideoRenderer(QScreen* targetScreen, QWidget* parent)
     , m_videoInitialized(false)
     , m_videoErrorCount(0)
 {
+    // Рендерер создается вместе с обоями при запуске - от этого момента
+    // считается время до первого пикселя
+    m_startupTimer.start();
+
     // Устанавливаем начальный размер на основе экрана
     if (m_targetScreen) {
         m_currentSize = m_targetScreen->size();
@@ -60,10 +70,20 @@ VideoRenderer::VideoRenderer(QScreen* targetScreen, QWidget* parent)
         m_progressBar->setFixedSize(300, 30);
         m_progressBar->hide();
     }
+
+    connect(&VideoTranscodeCache::instance(), &VideoTranscodeCache::progress,
+            this, &VideoRenderer::onTranscodeProgress);
+    connect(&VideoTranscodeCache::instance(), &VideoTranscodeCache::finished,
+            this, &VideoRenderer::onTranscodeFinished);
+    connect(&VideoPosterCache::instance(), &VideoPosterCache::posterLoaded,
+            this, &VideoRenderer::onPosterLoaded);
 }
 
 VideoRenderer::~VideoRenderer()
 {
+    VideoPlaybackPolicy::instance().detach(m_parentWidget);
+    releaseSharedPlayer();
+
     // 1. Остановка таймеров
     if (m_statusCheckTimer) {
         m_statusCheckTimer->stop();
@@ -91,16 +111,8 @@ VideoRenderer::~VideoRenderer()
         m_delayedInitTimer = nullptr;
     }
 
-    // 2. Принудительная остановка FFmpeg
-    if (m_ffmpegProcess) {
-        if (m_ffmpegProcess->state() != QProcess::NotRunning) {
-            qDebug() << "Killing FFmpeg process before destruction...";
-            m_ffmpegProcess->kill();
-            m_ffmpegProcess->waitForFinished(1000);
-        }
-        delete m_ffmpegProcess;
-        m_ffmpegProcess = nullptr;
-    }
+    // 2. Освобождение конвертации - кеш остановит ее, если видео больше никому не нужно
+    releaseTranscode();
 
     // 3. Удаление UI
     if (m_progressBar) {
@@ -160,6 +172,12 @@ void VideoRenderer::initialize()
     m_geometryUpdateTimer->setSingleShot(true);
     m_geometryUpdateTimer->setInterval(16);
     connect(m_geometryUpdateTimer, &QTimer::timeout, this, &VideoRenderer::updateGeometry);
+
+    // Пауза, когда экран закрыт, и статичный кадр в режиме экономии
+    VideoPlaybackPolicy& policy = VideoPlaybackPolicy::instance();
+    connect(&policy, &VideoPlaybackPolicy::modeChanged, this, &VideoRenderer::onPlaybackModeChanged);
+    policy.attach(m_parentWidget);
+    m_playbackMode = policy.mode(m_parentWidget);
 }
 
 void VideoRenderer::show()
@@ -167,8 +185,11 @@ void VideoRenderer::show()
     qDebug() << "VideoRenderer::show() called";
 
     if (m_videoWidget) {
-        m_videoWidget->show();
-        m_videoWidget->raise();
+        // Пока показан стоп-кадр, виджет остается скрытым
+        if (!posterActive()) {
+            m_videoWidget->show();
+            m_videoWidget->raise();
+        }
 
         if (m_parentWidget) {
             m_parentWidget->show();
@@ -203,9 +224,15 @@ void VideoRenderer::hide()
         m_statusCheckTimer->stop();
     }
 
+    // Последний показанный кадр станет стоп-кадром при следующем запуске
+    captureCurrentPoster();
+
     if (m_mediaPlayer) {
         m_mediaPlayer->pause();
     }
+    if (m_sharedPlayer) {
+        m_sharedPlayer->setPlaying(this, false);
+    }
 
     if (m_videoWidget) {
         m_videoWidget->hide();
@@ -223,6 +250,7 @@ void VideoRenderer::hide()
 void VideoRenderer::resize(const QSize& size)
 {
     m_currentSize = size;
+    requestPoster();
     if (m_geometryUpdateTimer) {
         m_geometryUpdateTimer->start();
     }
@@ -236,7 +264,33 @@ void VideoRenderer::resize(const QSize& size)
 
 void VideoRenderer::paint(QPainter* painter, const QRect& rect)
 {
-    painter->fillRect(rect, Qt::black);
+    // Видео показывает виджет - здесь только фон под ним или стоп-кадр
+    if (m_poster.isNull()) {
+        painter->fillRect(rect, Qt::black);
+        return;
+    }
+
+    painter->drawPixmap(rect, m_poster);
+    recordFirstPixel();
+
+    // Переход: кадры видео поверх стоп-кадра с растущей непрозрачностью.
+    // Кадр переводится в RGB здесь, не чаще одного раза за шаг анимации
+    if (m_pendingLiveFrame.isValid()) {
+        DockTelemetry::countWakeup("VideoRenderer::fadeFrameConversion");
+        m_liveFrame = m_pendingLiveFrame.toImage();
+        m_pendingLiveFrame = QVideoFrame();
+    }
+    if (!m_liveFrame.isNull() && m_posterFadeProgress > 0.0) {
+        const QRect target = videoTargetRect(m_liveFrame.size());
+
+        painter->save();
+        painter->setOpacity(m_posterFadeProgress);
+        painter->setClipRegion(QRegion(rect).subtracted(QRegion(target)));
+        painter->fillRect(rect, Qt::black);
+        painter->setClipping(false);
+        painter->drawImage(target, m_liveFrame);
+        painter->restore();
+    }
 }
 
 void VideoRenderer::setSettings(const ScreenSettings& settings)
@@ -249,12 +303,8 @@ void VideoRenderer::setSettings(const ScreenSettings& settings)
     if (pathChanged) {
         qDebug() << "Video path changed from" << m_currentVideoPath << "to" << decodedPath;
 
-        // Если идет конвертация предыдущего файла — убиваем её
-        if (m_ffmpegProcess && m_ffmpegProcess->state() != QProcess::NotRunning) {
-            qDebug() << "Aborting active conversion for previous video.";
-            m_ffmpegProcess->kill();
-            m_ffmpegProcess->waitForFinished();
-        }
+        // Конвертация предыдущего файла прерывается, если он не нужен другим экранам
+        releaseTranscode();
 
         // Скрываем прогресс бар старого процесса
         if (m_progressBar) {
@@ -262,6 +312,12 @@ void VideoRenderer::setSettings(const ScreenSettings& settings)
             m_progressBar->setValue(0);
         }
 
+        // Стоп-кадр нового видео читается до создания плеера, чтобы
+        // виджет не показывал черный экран до его загрузки
+        resetPoster();
+        m_settings = settings;
+        requestPoster();
+
         // Сброс переменных
         m_currentVideoPath = decodedPath;
         m_convertedVideoPath.clear();
@@ -271,6 +327,7 @@ void VideoRenderer::setSettings(const ScreenSettings& settings)
         m_videoDuration = 0;
 
         // Очистка старого плеера
+        releaseSharedPlayer();
         if (m_mediaPlayer) {
             m_mediaPlayer->stop();
             m_mediaPlayer->setSource(QUrl());
@@ -286,6 +343,7 @@ void VideoRenderer::setSettings(const ScreenSettings& settings)
     // Применяем настройки масштабирования без перезагрузки видео
     if (!pathChanged) {
         updateGeometry();
+        requestPoster();
     }
 }
 
@@ -293,12 +351,14 @@ void VideoRenderer::setAlignment(const QString& alignment)
 {
     m_settings.alignment = alignment;
     updateGeometry();
+    requestPoster();
 }
 
 void VideoRenderer::setScaling(const QString& scaling)
 {
     m_settings.scaling = scaling;
     updateGeometry();
+    requestPoster();
 }
 
 void VideoRenderer::setScaleFactor(qreal scaleFactor)
@@ -307,12 +367,18 @@ void VideoRenderer::setScaleFactor(qreal scaleFactor)
     if (!qFuzzyCompare(m_settings.scaleFactor, scaleFactor)) {
         m_settings.scaleFactor = scaleFactor;
         updateGeometry();
+        requestPoster();
     }
 }
 
 void VideoRenderer::setLoop(bool loop)
 {
     m_settings.loopVideo = loop;
+    // Общий декодер только для зацикленного видео - переключаемся на свой плеер или обратно
+    if (m_videoWidget && (m_sharedPlayer != nullptr) != shouldSharePlayer()) {
+        recreatePlayer();
+        return;
+    }
     if (m_mediaPlayer) {
         m_mediaPlayer->setLoops(loop ? QMediaPlayer::Infinite : 1);
     }
@@ -321,6 +387,10 @@ void VideoRenderer::setLoop(bool loop)
 void VideoRenderer::setSound(bool enable)
 {
     m_settings.enableSound = enable;
+    if (m_videoWidget && (m_sharedPlayer != nullptr) != shouldSharePlayer()) {
+        recreatePlayer();
+        return;
+    }
     if (m_mediaPlayer) {
         if (enable) {
             QAudioOutput* audioOutput = new QAudioOutput(this);
@@ -334,6 +404,11 @@ void VideoRenderer::setSound(bool enable)
 
 void VideoRenderer::reset()
 {
+    if (m_sharedPlayer) {
+        m_sharedPlayer->reload();
+        return;
+    }
+
     if (m_mediaPlayer && m_videoWidget) {
         bool wasPlaying = isPlaying();
         qint64 currentPosition = m_mediaPlayer->position();
@@ -356,6 +431,9 @@ void VideoRenderer::reset()
 
 bool VideoRenderer::isPlaying() const
 {
+    if (m_sharedPlayer) {
+        return m_sharedPlayer->isPlaying();
+    }
     return m_mediaPlayer && m_mediaPlayer->playbackState() == QMediaPlayer::PlayingState;
 }
 
@@ -368,7 +446,12 @@ void VideoRenderer::startImmediately()
 
 void VideoRenderer::ensurePlaying()
 {
-    if (m_mediaPlayer && m_videoWidget && m_videoWidget->isVisible() && !isPlaying()) {
+    if (m_sharedPlayer) {
+        m_sharedPlayer->setPlaying(this, videoVisible() && playbackAllowed());
+        return;
+    }
+
+    if (m_mediaPlayer && videoVisible() && !isPlaying() && playbackAllowed()) {
         if (m_mediaPlayer->mediaStatus() == QMediaPlayer::NoMedia && !m_currentVideoPath.isEmpty()) {
             QUrl videoUrl = QUrl::fromLocalFile(m_currentVideoPath);
             m_mediaPlayer->setSource(videoUrl);
@@ -446,7 +529,7 @@ void VideoRenderer::updateGeometry()
 
 void VideoRenderer::setupVideoPlayer()
 {
-    if (m_mediaPlayer || m_currentVideoPath.isEmpty()) {
+    if (m_mediaPlayer || m_sharedPlayer || m_currentVideoPath.isEmpty()) {
         return;
     }
 
@@ -523,14 +606,8 @@ void VideoRenderer::setupVideoPlayer()
     createDirectVideoPlayer();
 }
 
-void VideoRenderer::createDirectVideoPlayer()
+bool VideoRenderer::createVideoWidget()
 {
-    // Создаем медиаплеер
-    m_mediaPlayer = new QMediaPlayer(this);
-
-    // Настраиваем аппаратное ускорение
-    setupHardwareAcceleration();
-
     // Создаем видео виджет с правильным родителем
     if (m_parentWidget) {
         m_videoWidget = new QVideoWidget(m_parentWidget);
@@ -540,18 +617,107 @@ void VideoRenderer::createDirectVideoPlayer()
         m_parentWidget->setWindowFlags(Qt::FramelessWindowHint | Qt::WindowStaysOnBottomHint | Qt::Tool);
     } else {
         qDebug() << "No parent widget for video";
-        return;
+        return false;
     }
 
-    // Подключаем видео выход
-    m_mediaPlayer->setVideoOutput(m_videoWidget);
+    // Виджет сам перерисовывается по приходу кадра - дополнительных таймеров
+    // обновления не нужно. Кадры и перерисовки только считаются
+    if (QVideoSink* sink = m_videoWidget->videoSink()) {
+        connect(sink, &QVideoSink::videoFrameChanged, this, &VideoRenderer::onVideoFrameChanged);
+    }
+    m_videoWidget->installEventFilter(this);
 
     // Конфигурируем видео виджет с оптимизациями для плавности
     configureVideoWidget();
 
     // Сразу устанавливаем правильный размер
     m_videoWidget->resize(m_currentSize);
-    m_videoWidget->show();
+    // Со стоп-кадром виджет показывается после перехода к первому кадру видео
+    if (!posterActive()) {
+        m_videoWidget->show();
+    }
+    return true;
+}
+
+bool VideoRenderer::shouldSharePlayer() const
+{
+    // Общий декодер раздает одни и те же кадры, поэтому только для
+    // зацикленного видео без звука (звук с каждого экрана дублировался бы)
+    QSettings settings("MyCompany", "DockApp");
+    return settings.value("Video/SharedDecoding", true).toBool()
+           && m_settings.loopVideo && !m_settings.enableSound;
+}
+
+void VideoRenderer::createSharedVideoPlayer()
+{
+    if (!createVideoWidget()) {
+        return;
+    }
+
+    // Декодирование общее для всех экранов с этим файлом, виджет получает
+    // кадры через свой приемник и масштабирует их под экран
+    m_sharedPlayer = SharedVideoPlayer::acquire(m_currentVideoPath);
+    m_sharedPlayer->addSink(this, m_videoWidget->videoSink());
+    connect(m_sharedPlayer, &SharedVideoPlayer::failed, this, &VideoRenderer::videoError);
+
+    m_videoInitialized = true;
+    ensurePlaying();
+    QTimer::singleShot(50, this, &VideoRenderer::updateGeometry);
+
+    qDebug() << "Shared video player attached, screens:" << m_sharedPlayer->sinkCount();
+}
+
+void VideoRenderer::releaseSharedPlayer()
+{
+    if (!m_sharedPlayer) {
+        return;
+    }
+
+    m_sharedPlayer->removeSink(this);
+    m_sharedPlayer->setPlaying(this, false);
+    disconnect(m_sharedPlayer, nullptr, this, nullptr);
+    SharedVideoPlayer::release(m_sharedPlayer);
+    m_sharedPlayer = nullptr;
+}
+
+void VideoRenderer::recreatePlayer()
+{
+    releaseSharedPlayer();
+
+    if (m_mediaPlayer) {
+        m_mediaPlayer->stop();
+        delete m_mediaPlayer;
+        m_mediaPlayer = nullptr;
+    }
+    if (m_videoWidget) {
+        m_videoWidget->hide();
+        delete m_videoWidget;
+        m_videoWidget = nullptr;
+    }
+
+    createDirectVideoPlayer();
+    show();
+}
+
+void VideoRenderer::createDirectVideoPlayer()
+{
+    if (shouldSharePlayer()) {
+        createSharedVideoPlayer();
+        return;
+    }
+
+    // Создаем медиаплеер
+    m_mediaPlayer = new QMediaPlayer(this);
+
+    // Настраиваем аппаратное ускорение
+    setupHardwareAcceleration();
+
+    if (!createVideoWidget()) {
+        return;
+    }
+
+    // Подключаем видео выход
+    m_mediaPlayer->setVideoOutput(m_videoWidget);
 
     // Подключаем сигналы
     connect(m_mediaPlayer, &QMediaPlayer::errorOccurred,
@@ -708,23 +874,11 @@ void VideoRenderer::optimizeFor4KVideo()
     m_videoWidget->setAttribute(Qt::WA_TranslucentBackground, false);
     m_videoWidget->setAttribute(Qt::WA_PaintOnScreen, true);
 
-    // Получаем частоту обновления экрана
+    // Получаем частоту обновления экрана. Перерисовка идет по кадрам
+    // декодера (QVideoSink::videoFrameChanged), а не по таймеру
     int refreshRate = m_targetScreen ? m_targetScreen->refreshRate() : 60;
     int targetFps = qMin(refreshRate, 60);
 
-    // Рассчитываем интервал обновления
-    int interval = 1000 / targetFps;
-    interval = qBound(16, interval, 33);
-
-    QTimer* updateTimer = new QTimer(this);
-    updateTimer->setInterval(interval);
-    connect(updateTimer, &QTimer::timeout, this, [this]() {
-        if (m_videoWidget && m_videoWidget->isVisible()) {
-            m_videoWidget->update();
-        }
-    });
-    updateTimer->start();
-
     // Увеличиваем буфер для 4K видео
     if (m_mediaPlayer) {
         m_mediaPlayer->setProperty("videoBufferSize", 1024 * 1024 * 100);
@@ -780,13 +934,13 @@ void VideoRenderer::handleSystemWake()
 
 void VideoRenderer::checkStatus()
 {
-    if (!m_mediaPlayer || !m_videoWidget) {
+    if (!m_mediaPlayer || !m_videoWidget || !playbackAllowed()) {
         return;
     }
 
     // Проверяем состояние воспроизведения
     if (m_mediaPlayer->playbackState() != QMediaPlayer::PlayingState &&
-        m_videoWidget->isVisible()) {
+        videoVisible()) {
         qDebug() << "Video not playing, attempting to restart";
 
         if (m_mediaPlayer->mediaStatus() == QMediaPlayer::LoadedMedia ||
@@ -812,7 +966,7 @@ void VideoRenderer::handleApplicationStateChange(Qt::ApplicationState state)
     if (state == Qt::ApplicationActive) {
         // Приложение стало активным
         qDebug() << "Application became active, checking video playback";
-        if (m_mediaPlayer && m_videoWidget && m_videoWidget->isVisible()) {
+        if (m_mediaPlayer && videoVisible() && playbackAllowed()) {
             if (m_mediaPlayer->playbackState() != QMediaPlayer::PlayingState) {
                 m_mediaPlayer->play();
                 updateGeometry();
@@ -833,46 +987,33 @@ void VideoRenderer::handleApplicationStateChange(Qt::ApplicationState state)
 
 void VideoRenderer::convertH264ToVP9(const QString& inputPath, const QSize& videoSize)
 {
-    // Если процесс уже идет - не запускаем новый, если это тот же файл
-    if (m_ffmpegProcess && m_ffmpegProcess->state() != QProcess::NotRunning) {
+    // Конвертация этого видео уже запрошена
+    if (!m_transcodeKey.isEmpty()) {
         return;
     }
 
-    // Формируем путь к кэшу
-    QString tempDir = QDir::tempPath() + "/VideoWallpaperCache";
-    QDir().mkpath(tempDir);
+    VideoTranscodeRequest request;
+    request.inputPath = inputPath;
+    request.videoSize = videoSize;
+    request.withAudio = m_settings.enableSound;
+    request.durationMs = m_videoDuration;
 
-    QString baseName = QFileInfo(inputPath).completeBaseName();
-    QString outputName = QString("optimized_%1_%2x%3.webm")
-        .arg(baseName)
-        .arg(videoSize.width())
-        .arg(videoSize.height());
-    QString outputPath = tempDir + "/" + outputName;
-
-    // Если файл уже есть в кэше и он валидный (размер > 0), используем его
-    QFileInfo outputInfo(outputPath);
-    if (outputInfo.exists() && outputInfo.size() > 0) {
-        qDebug() << "Found cached optimized video:" << outputPath;
-        handleConversionFinished(0, outputPath);
+    // Кеш общий для всех экранов: готовый файл возвращается сразу,
+    // иначе конвертация ставится в очередь
+    QString readyPath;
+    m_transcodeKey = VideoTranscodeCache::instance().acquire(request, &readyPath);
+    if (m_transcodeKey.isEmpty()) {
+        qDebug() << "Cannot read video for conversion, playing original:" << inputPath;
+        createDirectVideoPlayer();
+        show();
         return;
     }
 
-    qDebug() << "Starting H.264 -> VP9 conversion for:" << inputPath << "Size:" << videoSize;
-
-    // --- ИНИЦИАЛИЗАЦИЯ ПРОЦЕССА ---
-    if (!m_ffmpegProcess) {
-        m_ffmpegProcess = new QProcess(this);
+    if (!readyPath.isEmpty()) {
+        handleConversionFinished(0, readyPath);
+        return;
     }
 
-    // Подключаем сигналы
-    disconnect(m_ffmpegProcess, nullptr, this, nullptr);
-    connect(m_ffmpegProcess, &QProcess::readyReadStandardError,
-            this, &VideoRenderer::updateConversionProgress);
-    connect(m_ffmpegProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, [this, outputPath](int exitCode, QProcess::ExitStatus) {
-        handleConversionFinished(exitCode, outputPath);
-    });
-
     // --- НАСТРОЙКА UI (ПРОГРЕСС БАР) ---
     if (!m_progressBar) {
         m_progressBar = new QProgressBar(nullptr);
@@ -909,86 +1050,30 @@ void VideoRenderer::convertH264ToVP9(const QString& inputPath, const QSize& vide
     m_progressBar->setValue(0);
     m_progressBar->show();
     m_progressBar->raise();
+}
 
-    // --- ПАРАМЕТРЫ FFMPEG для максимальной плавности ---
-    QStringList args;
-    args << "-y" << "-i" << inputPath;
-
-    // Адаптивное масштабирование для производительности
-    if (videoSize.width() > 1920 || videoSize.height() > 1080) {
-        // Для 4K и выше масштабируем до 1440p для баланса качества/производительности
-        args << "-vf" << "scale=2560:-2";
-        args << "-b:v" << "8M";
-    } else if (videoSize.width() > 1280 || videoSize.height() > 720) {
-        // Для 1080p оставляем как есть
-        args << "-b:v" << "4M";
-    } else {
-        // Для HD и ниже
-        args << "-b:v" << "2M";
-    }
-
-    // VP9 кодек с оптимизациями для плавности
-    args << "-c:v" << "libvpx-vp9"
-         << "-crf" << "28"
-         << "-deadline" << "good"
-         << "-cpu-used" << "2"
-         << "-row-mt" << "1"
-         << "-tile-columns" << "2"
-         << "-tile-rows" << "2"
-         << "-frame-parallel" << "1"
-         << "-lag-in-frames" << "16"
-         << "-auto-alt-ref" << "1";
-
-    // Настройки аудио
-    if (!m_settings.enableSound) {
-        args << "-an";
-    } else {
-        args << "-c:a" << "libopus"
-             << "-b:a" << "128k"
-             << "-ac" << "2";
+void VideoRenderer::releaseTranscode()
+{
+    if (!m_transcodeKey.isEmpty()) {
+        VideoTranscodeCache::instance().release(m_transcodeKey);
+        m_transcodeKey.clear();
     }
-
-    // Дополнительные настройки для плавности
-    args << "-vsync" << "cfr"
-         << "-r" << "60"
-         << "-pix_fmt" << "yuv420p"
-         << "-g" << "120"
-         << "-keyint_min" << "60";
-
-    args << outputPath;
-
-    qDebug() << "FFmpeg command:" << "ffmpeg" << args;
-
-    m_ffmpegProcess->start("ffmpeg", args);
 }
 
-void VideoRenderer::updateConversionProgress()
+void VideoRenderer::onTranscodeProgress(const QString& key, int percent)
 {
-    if (!m_ffmpegProcess) return;
-
-    // FFmpeg пишет прогресс в StandardError
-    QByteArray output = m_ffmpegProcess->readAllStandardError();
-    QString outputStr = QString::fromUtf8(output);
-
-    // Ищем time=HH:MM:SS.ms
-    static QRegularExpression timeRegex("time=(\\d{2}):(\\d{2}):(\\d{2})\\.(\\d{2})");
-    QRegularExpressionMatch match = timeRegex.match(outputStr);
-
-    if (match.hasMatch() && m_videoDuration > 0) {
-        int hours = match.captured(1).toInt();
-        int mins = match.captured(2).toInt();
-        int secs = match.captured(3).toInt();
-        int ms = match.captured(4).toInt() * 10;
-
-        qint64 currentMs = ((hours * 3600) + (mins * 60) + secs) * 1000 + ms;
-
-        int progress = static_cast<int>((currentMs * 100.0) / m_videoDuration);
-        progress = qBound(0, progress, 99);
+    if (key == m_transcodeKey && m_progressBar) {
+        m_progressBar->setValue(percent);
+    }
+}
 
-        if (m_progressBar) {
-            m_progressBar->setValue(progress);
-        }
+void VideoRenderer::onTranscodeFinished(const QString& key, const QString& outputPath)
+{
+    if (key != m_transcodeKey) {
+        return;
     }
+
+    handleConversionFinished(outputPath.isEmpty() ? 1 : 0, outputPath);
 }
 
 void VideoRenderer::handleConversionFinished(int exitCode, const QString& outputPath)
@@ -1042,7 +1127,7 @@ void VideoRenderer::onMediaStatusChanged(QMediaPlayer::MediaStatus status)
 
         // Автоматический старт воспроизведения с задержкой для стабилизации
         QTimer::singleShot(100, this, [this]() {
-            if (m_mediaPlayer && m_mediaPlayer->playbackState() != QMediaPlayer::PlayingState) {
+            if (m_mediaPlayer && m_mediaPlayer->playbackState() != QMediaPlayer::PlayingState && playbackAllowed()) {
                 m_mediaPlayer->play();
                 qDebug() << "Auto-started video playback";
             }
@@ -1062,7 +1147,7 @@ void VideoRenderer::onMediaStatusChanged(QMediaPlayer::MediaStatus status)
         qDebug() << "Media buffered";
 
         // Обеспечиваем продолжение воспроизведения
-        if (m_mediaPlayer->playbackState() != QMediaPlayer::PlayingState) {
+        if (m_mediaPlayer->playbackState() != QMediaPlayer::PlayingState && playbackAllowed()) {
             m_mediaPlayer->play();
             qDebug() << "Playback started after buffering";
         }
@@ -1074,7 +1159,9 @@ void VideoRenderer::onMediaStatusChanged(QMediaPlayer::MediaStatus status)
 
         if (m_settings.loopVideo && m_mediaPlayer) {
             m_mediaPlayer->setPosition(0);
-            m_mediaPlayer->play();
+            if (playbackAllowed()) {
+                m_mediaPlayer->play();
+            }
             qDebug() << "Looping playback";
         }
         break;
@@ -1137,4 +1224,256 @@ void VideoRenderer::onErrorOccurred(QMediaPlayer::Error error, const QString &er
 void VideoRenderer::onPlaybackStateChanged(QMediaPlayer::PlaybackState state)
 {
     qDebug() << "Playback state changed to:" << state;
-}
\ No newline at end of file
+}
+
+void VideoRenderer::onVideoFrameChanged(const QVideoFrame& frame)
+{
+    DockTelemetry::countWakeup("VideoRenderer::decodedFrame");
+
+    // Кадры, показанные больше одной перерисовкой, - лишняя работа.
+    // Отношение widgetRepaint / decodedFrame в телеметрии должно быть около 1
+    if (m_repaintsSinceFrame > 1) {
+        DockTelemetry::countWakeup("VideoRenderer::extraRepaint");
+    }
+    m_repaintsSinceFrame = 0;
+
+    if (!frame.isValid()) {
+        return;
+    }
+
+    if (!m_liveFrameShown) {
+        m_liveFrameShown = true;
+        m_posterCaptureTimer.start();
+        DockTelemetry::recordDuration("VideoRenderer::timeToFirstFrame", quint64(m_startupTimer.nsecsElapsed() / 1000));
+
+        if (m_poster.isNull()) {
+            // Стоп-кадра нет (или он еще не прочитан) - сразу показываем видео
+            m_posterPending = false;
+            recordFirstPixel();
+            showVideoWidget();
+        } else {
+            startPosterFade();
+        }
+    }
+
+    // Во время перехода виджет скрыт, кадры рисует родитель поверх стоп-кадра.
+    // Запоминается только последний кадр: перерисовку запрашивает шаг анимации
+    if (m_posterFade && m_posterFade->state() == QAbstractAnimation::Running) {
+        m_pendingLiveFrame = frame;
+    }
+
+    if (m_posterCaptureTimer.isValid() && m_posterCaptureTimer.elapsed() >= m_posterCaptureInterval) {
+        capturePoster(frame);
+    }
+}
+
+void VideoRenderer::onPlaybackModeChanged(QWidget* window, VideoPlaybackPolicy::Mode mode)
+{
+    if (window != m_parentWidget || m_playbackMode == mode) {
+        return;
+    }
+
+    m_playbackMode = mode;
+    qDebug() << "Video wallpaper mode for screen" << (m_targetScreen ? m_targetScreen->name() : "unknown")
+             << "->" << mode;
+
+    if (mode == VideoPlaybackPolicy::Playing) {
+        // Плеер не пересоздается: виджет все это время показывает последний
+        // кадр, и воспроизведение продолжается с той же позиции
+        ensurePlaying();
+    } else {
+        captureCurrentPoster();
+        if (m_sharedPlayer) {
+            m_sharedPlayer->setPlaying(this, false);
+        } else if (m_mediaPlayer && isPlaying()) {
+            m_mediaPlayer->pause();
+        }
+    }
+}
+
+bool VideoRenderer::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == m_videoWidget && event->type() == QEvent::Paint) {
+        DockTelemetry::countWakeup("VideoRenderer::widgetRepaint");
+        ++m_repaintsSinceFrame;
+    }
+    return MediaRenderer::eventFilter(watched, event);
+}
+bool VideoRenderer::videoVisible() const
+{
+    if (!m_videoWidget) {
+        return false;
+    }
+    // Виджет скрыт ради стоп-кадра, но видео уже должно декодироваться
+    if (posterActive()) {
+        return m_parentWidget && m_parentWidget->isVisible();
+    }
+    return m_videoWidget->isVisible();
+}
+
+void VideoRenderer::requestPoster()
+{
+    const qreal dpr = m_targetScreen ? m_targetScreen->devicePixelRatio() : 1.0;
+    const QString key = VideoPosterCache::posterKey(QUrl::fromPercentEncoding(m_settings.backgroundImage.toUtf8()),
+                                                    m_currentSize * dpr, m_settings.scaling,
+                                                    m_settings.alignment, m_settings.scaleFactor);
+    if (key == m_posterKey) {
+        return;
+    }
+    m_posterKey = key;
+
+    // Видео уже идет - ключ нужен только для следующих снимков
+    if (m_liveFrameShown) {
+        return;
+    }
+
+    m_poster = QPixmap();
+    m_posterPending = !key.isEmpty() && VideoPosterCache::instance().isEnabled();
+    if (m_posterPending) {
+        if (m_videoWidget) {
+            m_videoWidget->hide();
+        }
+        VideoPosterCache::instance().load(key);
+    } else {
+        showVideoWidget();
+    }
+}
+
+void VideoRenderer::onPosterLoaded(const QString& key, const QImage& image)
+{
+    if (key != m_posterKey || !m_posterPending) {
+        return;
+    }
+    m_posterPending = false;
+
+    if (!image.isNull() && !m_liveFrameShown) {
+        m_poster = QPixmap::fromImage(image);
+        m_poster.setDevicePixelRatio(m_targetScreen ? m_targetScreen->devicePixelRatio() : 1.0);
+        qDebug() << "Video poster shown for screen" << (m_targetScreen ? m_targetScreen->name() : "unknown")
+                 << "after" << m_startupTimer.elapsed() << "ms";
+        if (m_parentWidget) {
+            m_parentWidget->update();
+        }
+    }
+
+    showVideoWidget();
+}
+
+void VideoRenderer::capturePoster(const QVideoFrame& frame)
+{
+    m_posterCaptureTimer.start();
+    m_posterCaptureInterval = DesktopBackgroundSettings::VIDEO_POSTER_REFRESH_MS;
+
+    if (m_posterKey.isEmpty() || !frame.isValid() || !VideoPosterCache::instance().isEnabled()) {
+        return;
+    }
+
+    QImage image;
+    {
+        DockTelemetry::ScopedTimer telemetryTimer("VideoRenderer::posterGrab");
+        image = frame.toImage();
+    }
+    if (image.isNull()) {
+        return;
+    }
+
+    // Кадр сохраняется так, как он лежит на экране, в физических пикселях
+    const qreal dpr = m_targetScreen ? m_targetScreen->devicePixelRatio() : 1.0;
+    const QRect target = videoTargetRect(image.size());
+    VideoPosterCache::instance().store(m_posterKey, image, m_currentSize * dpr,
+                                       QRect(target.topLeft() * dpr, target.size() * dpr));
+}
+
+void VideoRenderer::captureCurrentPoster()
+{
+    if (m_liveFrameShown && m_videoWidget && m_videoWidget->videoSink()) {
+        capturePoster(m_videoWidget->videoSink()->videoFrame());
+    }
+}
+
+void VideoRenderer::startPosterFade()
+{
+    if (!m_posterFade) {
+        m_posterFade = new QVariantAnimation(this);
+        m_posterFade->setStartValue(0.0);
+        m_posterFade->setEndValue(1.0);
+        m_posterFade->setDuration(DesktopBackgroundSettings::VIDEO_POSTER_CROSSFADE_MS);
+        m_posterFade->setEasingCurve(QEasingCurve::InOutQuad);
+        connect(m_posterFade, &QVariantAnimation::valueChanged, this, [this](const QVariant& value) {
+            m_posterFadeProgress = value.toReal();
+            if (m_parentWidget) {
+                m_parentWidget->update();
+            }
+        });
+        connect(m_posterFade, &QVariantAnimation::finished, this, &VideoRenderer::finishPosterFade);
+    }
+
+    m_posterFadeProgress = 0.0;
+    m_posterFade->start();
+}
+
+void VideoRenderer::finishPosterFade()
+{
+    m_poster = QPixmap();
+    m_liveFrame = QImage();
+    m_pendingLiveFrame = QVideoFrame();
+    m_posterFadeProgress = 0.0;
+    showVideoWidget();
+}
+
+void VideoRenderer::resetPoster()
+{
+    if (m_posterFade) {
+        m_posterFade->stop();
+    }
+
+    m_posterKey.clear();
+    m_posterPending = false;
+    m_poster = QPixmap();
+    m_liveFrame = QImage();
+    m_pendingLiveFrame = QVideoFrame();
+    m_posterFadeProgress = 0.0;
+    m_liveFrameShown = false;
+    m_posterCaptureTimer.invalidate();
+    m_posterCaptureInterval = DesktopBackgroundSettings::VIDEO_POSTER_CAPTURE_DELAY_MS;
+}
+
+void VideoRenderer::showVideoWidget()
+{
+    if (!m_videoWidget || posterActive() || !m_videoWidget->isHidden()) {
+        return;
+    }
+
+    m_videoWidget->show();
+    m_videoWidget->raise();
+    updateGeometry();
+}
+
+void VideoRenderer::recordFirstPixel()
+{
+    if (!m_firstPixelRecorded) {
+        m_firstPixelRecorded = true;
+        DockTelemetry::recordDuration("VideoRenderer::timeToFirstPixel", quint64(m_startupTimer.nsecsElapsed() / 1000));
+    }
+}
+
+QRect VideoRenderer::videoTargetRect(const QSize& frameSize)
+{
+    // Повторяет updateGeometry и режимы соотношения сторон QVideoWidget
+    const QRect screenRect(QPoint(0, 0), m_currentSize);
+    if (frameSize.isEmpty() || m_settings.scaling == "stretch") {
+        return screenRect;
+    }
+
+    if (m_settings.scaling == "fill") {
+        QRect rect(QPoint(0, 0), frameSize.scaled(m_currentSize, Qt::KeepAspectRatioByExpanding));
+        rect.moveCenter(screenRect.center());
+        return rect;
+    }
+
+    QSize box = m_currentSize;
+    if (m_settings.scaling == "zoom") {
+        box = (frameSize * m_settings.scaleFactor).boundedTo(m_currentSize * 2);
+    }
+    return applyAlignmentToRect(QRect(QPoint(0, 0), frameSize.scaled(box, Qt::KeepAspectRatio)));
+}
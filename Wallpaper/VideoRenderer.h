@@ -2,14 +2,21 @@
 #define VIDEORENDERER_H
 
 #include "MediaRenderer.h"
+#include "VideoPlaybackPolicy.h"
 #include <QMediaPlayer>
 #include <QVideoWidget>
+#include <QVideoFrame>
 #include <QTimer>
 #include <QScreen>
-#include <QProcess>
 #include <QProgressBar>
+#include <QPixmap>
+#include <QElapsedTimer>
 #include "CommonDefines.h"
 
+class SharedVideoPlayer;
+class QVariantAnimation;
+class QVideoFrame;
+
 class VideoRenderer : public MediaRenderer
 {
     Q_OBJECT
@@ -42,6 +49,10 @@ public:
     QVideoWidget* videoWidget() const { return m_videoWidget; }
     QMediaPlayer* mediaPlayer() const { return m_mediaPlayer; }
 
+protected:
+    // Счетчик перерисовок видео виджета для телеметрии
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
 public slots:
     void handleSystemWake();
     void checkStatus();
@@ -54,14 +65,24 @@ private slots:
     void onMediaStatusChanged(QMediaPlayer::MediaStatus status);
     void onErrorOccurred(QMediaPlayer::Error error, const QString &errorString);
     void onPlaybackStateChanged(QMediaPlayer::PlaybackState state);
+    void onVideoFrameChanged(const QVideoFrame& frame);
+    void onPosterLoaded(const QString& key, const QImage& image);
+    void onPlaybackModeChanged(QWidget* window, VideoPlaybackPolicy::Mode mode);
 
-    // Новые слоты для конвертации
-    void updateConversionProgress();
+    // Слоты для конвертации
+    void onTranscodeProgress(const QString& key, int percent);
+    void onTranscodeFinished(const QString& key, const QString& outputPath);
     void handleConversionFinished(int exitCode, const QString& outputPath);
 
 private:
     void setupVideoPlayer();
     void createDirectVideoPlayer();  // ДОБАВЛЕНО
+    bool createVideoWidget();
+    // Общий декодер для экранов с одним файлом
+    bool shouldSharePlayer() const;
+    void createSharedVideoPlayer();
+    void releaseSharedPlayer();
+    void recreatePlayer();
     void configureVideoWidget();     // ДОБАВЛЕНО
     void setupHardwareAcceleration();
     void optimizeVideoPlayback();
@@ -70,9 +91,27 @@ private:
     void checkVideoCodecFallback();
     QRect applyAlignmentToRect(const QRect& contentRect);
     bool isHighResolution(const QSize& size) const;
+    // Политика разрешает воспроизведение (экран виден, нет режима экономии)
+    bool playbackAllowed() const { return m_playbackMode == VideoPlaybackPolicy::Playing; }
+    // Видео должно идти: виджет виден или скрыт только на время стоп-кадра
+    bool videoVisible() const;
+
+    // Стоп-кадр (VideoPosterCache): показывается до первого кадра видео
+    bool posterActive() const { return m_posterPending || !m_poster.isNull(); }
+    void requestPoster();
+    void capturePoster(const QVideoFrame& frame);
+    void captureCurrentPoster();
+    void startPosterFade();
+    void finishPosterFade();
+    void resetPoster();
+    void showVideoWidget();
+    void recordFirstPixel();
+    // Где видео виджет показывает кадр этого размера (логические координаты)
+    QRect videoTargetRect(const QSize& frameSize);
 
     // Исправлен тип возвращаемого значения на void (согласно .cpp)
     void convertH264ToVP9(const QString& inputPath, const QSize& videoSize);
+    void releaseTranscode();
 
     int m_retryCount = 0;
 
@@ -82,6 +121,8 @@ private:
     QWidget* m_parentWidget;
 
     QMediaPlayer* m_mediaPlayer = nullptr;
+    // Вместо своего плеера - общий декодер (m_mediaPlayer тогда пуст)
+    SharedVideoPlayer* m_sharedPlayer = nullptr;
     QVideoWidget* m_videoWidget = nullptr;
 
     // Таймеры
@@ -91,19 +132,39 @@ private:
     QTimer* m_geometryUpdateTimer = nullptr;
     QTimer* m_delayedInitTimer = nullptr;
 
-    // Процессы и UI
-    QProcess* m_ffmpegProcess = nullptr;
+    // Конвертация (общий кеш VideoTranscodeCache) и UI
+    QString m_transcodeKey;
     QProgressBar* m_progressBar = nullptr;
 
     bool m_wasSleeping = false;
     bool m_videoOptimized = false;
     bool m_videoInitialized = false;
+    VideoPlaybackPolicy::Mode m_playbackMode = VideoPlaybackPolicy::Playing;
 
     int m_videoErrorCount = 0;
+    // Перерисовки виджета с момента последнего декодированного кадра
+    int m_repaintsSinceFrame = 0;
     qint64 m_videoDuration = 0;
 
     QString m_currentVideoPath;
     QString m_convertedVideoPath;
+
+    // Стоп-кадр и переход от него к видео
+    QString m_posterKey;
+    bool m_posterPending = false;
+    QPixmap m_poster;
+    QImage m_liveFrame;
+    // Последний кадр видео во время перехода, еще не переведенный в RGB
+    QVideoFrame m_pendingLiveFrame;
+    QVariantAnimation* m_posterFade = nullptr;
+    qreal m_posterFadeProgress = 0.0;
+    bool m_liveFrameShown = false;
+    QElapsedTimer m_posterCaptureTimer;
+    int m_posterCaptureInterval = DesktopBackgroundSettings::VIDEO_POSTER_CAPTURE_DELAY_MS;
+
+    // Время до первого пикселя обоев с момента создания рендерера
+    QElapsedTimer m_startupTimer;
+    bool m_firstPixelRecorded = false;
 };
 
 #endif // VIDEORENDERER_H
\ No newline at end of file
@@ -0,0 +1,405 @@
+#include "VideoTranscodeCache.h"
+#include "../DockTelemetry.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSettings>
+#include <algorithm>
+
+VideoTranscodeCache& VideoTranscodeCache::instance()
+{
+    static VideoTranscodeCache cache;
+    return cache;
+}
+
+VideoTranscodeCache::VideoTranscodeCache()
+    : QObject(nullptr)
+    , m_maxBytes(qint64(DEFAULT_MAX_MB) * 1024 * 1024)
+    , m_process(nullptr)
+    , m_aborted(false)
+{
+    QSettings settings("MyCompany", "DockApp");
+    m_maxBytes = qint64(settings.value("Video/TranscodeCacheMaxMB", DEFAULT_MAX_MB).toInt()) * 1024 * 1024;
+    // Путь к ffmpeg можно задать явно, если его нет в PATH
+    m_encoderProgram = settings.value("Video/EncoderPath", "ffmpeg").toString();
+
+    m_cacheDir = QDir::tempPath() + "/VideoWallpaperCache";
+    QDir().mkpath(m_cacheDir);
+
+    removePartialOutputs();
+    enforceBudget();
+}
+
+VideoTranscodeCache::~VideoTranscodeCache()
+{
+    m_queue.clear();
+    abortRunningJob();
+}
+
+QString VideoTranscodeCache::acquire(const VideoTranscodeRequest& request, QString* readyPath)
+{
+    const QString hash = cachedContentHash(request.inputPath);
+    if (hash.isEmpty()) {
+        return QString();
+    }
+
+    // Параметры кодирования тоже определяют результат
+    QString key = hash + '_' + QString::number(request.videoSize.width()) + 'x'
+                  + QString::number(request.videoSize.height());
+    if (request.withAudio) {
+        key += "_a";
+    }
+
+    ++m_refs[key];
+
+    const QString path = outputPath(key);
+    const QFileInfo info(path);
+    if (info.exists() && info.size() > 0 && !isPending(key)) {
+        qDebug() << "Found cached optimized video:" << path << "for" << request.inputPath;
+        touch(path);
+        if (readyPath) {
+            *readyPath = path;
+        }
+        return key;
+    }
+
+    if (!isPending(key)) {
+        m_queue.append({key, request});
+        qDebug() << "Queued video conversion:" << request.inputPath << "queue length:" << m_queue.size();
+        startNextJob();
+    }
+    return key;
+}
+
+void VideoTranscodeCache::release(const QString& key)
+{
+    auto it = m_refs.find(key);
+    if (it == m_refs.end()) {
+        return;
+    }
+
+    if (--it.value() > 0) {
+        return;
+    }
+    m_refs.erase(it);
+
+    // Результат больше никому не нужен - конвертация отменяется
+    for (int i = 0; i < m_queue.size(); ++i) {
+        if (m_queue.at(i).key == key) {
+            m_queue.removeAt(i);
+            break;
+        }
+    }
+    if (m_process && m_runningJob.key == key) {
+        abortRunningJob();
+    }
+
+    // Освобожденный файл мог держать кеш сверх лимита
+    enforceBudget();
+}
+
+void VideoTranscodeCache::setMaxBytes(qint64 maxBytes)
+{
+    m_maxBytes = maxBytes;
+
+    QSettings settings("MyCompany", "DockApp");
+    settings.setValue("Video/TranscodeCacheMaxMB", int(maxBytes / (1024 * 1024)));
+
+    enforceBudget();
+}
+
+QString VideoTranscodeCache::contentHash(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+
+    const QFileInfo info(filePath);
+    const qint64 size = file.size();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(size));
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+
+    // Блоки в начале, конце и равномерно между ними: достаточно, чтобы различать
+    // файлы, и не нужно читать гигабайты видео
+    if (size <= HASH_SAMPLE_COUNT * HASH_SAMPLE_SIZE) {
+        hash.addData(file.readAll());
+    } else {
+        for (int i = 0; i < HASH_SAMPLE_COUNT; ++i) {
+            const qint64 offset = (size - HASH_SAMPLE_SIZE) * i / (HASH_SAMPLE_COUNT - 1);
+            if (!file.seek(offset)) {
+                return QString();
+            }
+            hash.addData(file.read(HASH_SAMPLE_SIZE));
+        }
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString VideoTranscodeCache::cachedContentHash(const QString& filePath)
+{
+    const QFileInfo info(filePath);
+    if (!info.exists()) {
+        return QString();
+    }
+
+    const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+    HashEntry& entry = m_hashes[filePath];
+    if (entry.hash.isEmpty() || entry.size != info.size() || entry.modified != modified) {
+        DockTelemetry::ScopedTimer telemetryTimer("VideoTranscodeCache::contentHash");
+        entry.size = info.size();
+        entry.modified = modified;
+        entry.hash = contentHash(filePath);
+    }
+    return entry.hash;
+}
+
+QString VideoTranscodeCache::outputPath(const QString& key) const
+{
+    return m_cacheDir + "/" + key + ".webm";
+}
+
+bool VideoTranscodeCache::isPending(const QString& key) const
+{
+    if (m_process && m_runningJob.key == key) {
+        return true;
+    }
+    for (const Job& job : m_queue) {
+        if (job.key == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void VideoTranscodeCache::startNextJob()
+{
+    if (m_process || m_queue.isEmpty()) {
+        return;
+    }
+
+    m_runningJob = m_queue.takeFirst();
+    m_aborted = false;
+
+    const QString partPath = outputPath(m_runningJob.key) + ".part";
+    QFile::remove(partPath);
+
+    qDebug() << "Starting H.264 -> VP9 conversion for:" << m_runningJob.request.inputPath
+             << "Size:" << m_runningJob.request.videoSize;
+
+    m_process = new QProcess(this);
+    connect(m_process, &QProcess::readyReadStandardError, this, &VideoTranscodeCache::readProgress);
+    connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, [this](int exitCode, QProcess::ExitStatus exitStatus) {
+        finishJob(exitCode == 0 && exitStatus == QProcess::NormalExit);
+    });
+    // Без кодировщика finished не придет
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            qDebug() << "Failed to start encoder:" << m_encoderProgram;
+            finishJob(false);
+        }
+    });
+
+    const QStringList args = encoderArguments(m_runningJob.request, partPath);
+    qDebug() << "FFmpeg command:" << m_encoderProgram << args;
+    m_process->start(m_encoderProgram, args);
+}
+
+void VideoTranscodeCache::readProgress()
+{
+    if (!m_process) return;
+
+    // FFmpeg пишет прогресс в StandardError
+    const QString output = QString::fromUtf8(m_process->readAllStandardError());
+
+    // Ищем time=HH:MM:SS.ms
+    static QRegularExpression timeRegex("time=(\\d{2}):(\\d{2}):(\\d{2})\\.(\\d{2})");
+    QRegularExpressionMatch match = timeRegex.match(output);
+
+    const qint64 durationMs = m_runningJob.request.durationMs;
+    if (match.hasMatch() && durationMs > 0) {
+        int hours = match.captured(1).toInt();
+        int mins = match.captured(2).toInt();
+        int secs = match.captured(3).toInt();
+        int ms = match.captured(4).toInt() * 10;
+
+        qint64 currentMs = ((hours * 3600) + (mins * 60) + secs) * 1000 + ms;
+        int percent = static_cast<int>((currentMs * 100.0) / durationMs);
+        emit progress(m_runningJob.key, qBound(0, percent, 99));
+    }
+}
+
+void VideoTranscodeCache::finishJob(bool success)
+{
+    if (!m_process) {
+        return;
+    }
+
+    m_process->disconnect(this);
+    m_process->deleteLater();
+    m_process = nullptr;
+
+    const Job job = m_runningJob;
+    m_runningJob = Job();
+
+    const QString path = outputPath(job.key);
+    const QString partPath = path + ".part";
+
+    // Результат появляется под своим именем только целиком
+    bool stored = success && !m_aborted && QFileInfo(partPath).size() > 0;
+    if (stored) {
+        QFile::remove(path);
+        stored = QFile::rename(partPath, path);
+    }
+    if (!stored) {
+        QFile::remove(partPath);
+    }
+
+    if (stored) {
+        qDebug() << "Conversion finished successfully:" << path;
+        enforceBudget();
+    } else {
+        qDebug() << "Conversion failed or aborted:" << job.request.inputPath;
+    }
+
+    if (!m_aborted) {
+        emit finished(job.key, stored ? path : QString());
+    }
+    m_aborted = false;
+
+    startNextJob();
+}
+
+void VideoTranscodeCache::abortRunningJob()
+{
+    if (!m_process) {
+        return;
+    }
+
+    qDebug() << "Aborting video conversion:" << m_runningJob.request.inputPath;
+    m_aborted = true;
+    // waitForFinished испускает finished синхронно: обработчик завершил бы задачу
+    // и запустил следующую, а finishJob ниже остановил бы уже ее
+    m_process->disconnect(this);
+    if (m_process->state() != QProcess::NotRunning) {
+        m_process->kill();
+        m_process->waitForFinished(1000);
+    }
+    finishJob(false);
+}
+
+void VideoTranscodeCache::removePartialOutputs()
+{
+    // Остатки прерванных конвертаций и пустые файлы после сбоев
+    const QFileInfoList files = QDir(m_cacheDir).entryInfoList({"*.part", "*.webm"}, QDir::Files);
+    for (const QFileInfo& file : files) {
+        if (file.suffix() == "part" || file.size() == 0) {
+            qDebug() << "Removing partial video cache file:" << file.fileName();
+            QFile::remove(file.absoluteFilePath());
+        }
+    }
+}
+
+void VideoTranscodeCache::enforceBudget()
+{
+    QFileInfoList files = QDir(m_cacheDir).entryInfoList({"*.webm"}, QDir::Files);
+
+    qint64 total = 0;
+    for (const QFileInfo& file : files) {
+        total += file.size();
+    }
+    if (total <= m_maxBytes) {
+        return;
+    }
+
+    // Сначала давно не использованные
+    std::sort(files.begin(), files.end(), [](const QFileInfo& a, const QFileInfo& b) {
+        return a.lastModified() < b.lastModified();
+    });
+
+    for (const QFileInfo& file : files) {
+        if (total <= m_maxBytes) {
+            break;
+        }
+        // Видео, которые сейчас показываются, не трогаем
+        if (m_refs.contains(file.completeBaseName())) {
+            continue;
+        }
+        if (QFile::remove(file.absoluteFilePath())) {
+            qDebug() << "Evicted cached video:" << file.fileName() << "size:" << file.size();
+            total -= file.size();
+        }
+    }
+}
+
+void VideoTranscodeCache::touch(const QString& filePath)
+{
+    QFile file(filePath);
+    if (file.open(QIODevice::ReadWrite)) {
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+}
+
+QStringList VideoTranscodeCache::encoderArguments(const VideoTranscodeRequest& request, const QString& outputPath)
+{
+    // --- ПАРАМЕТРЫ FFMPEG для максимальной плавности ---
+    QStringList args;
+    args << "-y" << "-i" << request.inputPath;
+
+    const QSize& videoSize = request.videoSize;
+
+    // Адаптивное масштабирование для производительности
+    if (videoSize.width() > 1920 || videoSize.height() > 1080) {
+        // Для 4K и выше масштабируем до 1440p для баланса качества/производительности
+        args << "-vf" << "scale=2560:-2";
+        args << "-b:v" << "8M";
+    } else if (videoSize.width() > 1280 || videoSize.height() > 720) {
+        // Для 1080p оставляем как есть
+        args << "-b:v" << "4M";
+    } else {
+        // Для HD и ниже
+        args << "-b:v" << "2M";
+    }
+
+    // VP9 кодек с оптимизациями для плавности
+    args << "-c:v" << "libvpx-vp9"
+         << "-crf" << "28"
+         << "-deadline" << "good"
+         << "-cpu-used" << "2"
+         << "-row-mt" << "1"
+         << "-tile-columns" << "2"
+         << "-tile-rows" << "2"
+         << "-frame-parallel" << "1"
+         << "-lag-in-frames" << "16"
+         << "-auto-alt-ref" << "1";
+
+    // Настройки аудио
+    if (!request.withAudio) {
+        args << "-an";
+    } else {
+        args << "-c:a" << "libopus"
+             << "-b:a" << "128k"
+             << "-ac" << "2";
+    }
+
+    // Дополнительные настройки для плавности
+    args << "-vsync" << "cfr"
+         << "-r" << "60"
+         << "-pix_fmt" << "yuv420p"
+         << "-g" << "120"
+         << "-keyint_min" << "60";
+
+    // Временный файл без расширения .webm - формат указывается явно
+    args << "-f" << "webm" << outputPath;
+    return args;
+}
@@ -0,0 +1,103 @@
+#ifndef VIDEOTRANSCODECACHE_H
+#define VIDEOTRANSCODECACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+class QProcess;
+
+// Параметры перекодирования видео обоев
+struct VideoTranscodeRequest {
+    QString inputPath;
+    QSize videoSize;        // Разрешение исходного видео
+    bool withAudio = false;
+    qint64 durationMs = 0;  // Для расчета прогресса; 0 - прогресс неизвестен
+};
+
+// Кеш перекодированных (VP9) видео обоев.
+// Ключ - содержимое файла: размер, время изменения и SHA-1 выборочных блоков,
+// плюс параметры кодирования, поэтому разные файлы с одинаковым именем не
+// путаются. Кодировщик пишет во временный файл .part, готовый результат
+// переименовывается - в кеше не бывает недописанных файлов, а оставшиеся
+// после сбоя .part удаляются при запуске. Объем кеша ограничен: при
+// превышении удаляются давно не использованные файлы (время изменения
+// обновляется при каждом обращении), кроме захваченных экранами.
+// Конвертации выполняются по очереди; экраны с одним видео ждут одну задачу.
+class VideoTranscodeCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static inline const int DEFAULT_MAX_MB = 4096;
+    // Выборка для хеша содержимого: блоки, равномерно распределенные по файлу
+    static inline const int HASH_SAMPLE_COUNT = 8;
+    static inline const qint64 HASH_SAMPLE_SIZE = 64 * 1024;
+
+    static VideoTranscodeCache& instance();
+
+    // Захватывает результат для запроса и возвращает ключ. Если видео уже
+    // в кеше, путь возвращается через readyPath, иначе конвертация ставится
+    // в очередь и позже придет finished. Пустой ключ - файл не читается.
+    // Каждому acquire соответствует один release
+    QString acquire(const VideoTranscodeRequest& request, QString* readyPath);
+    // Последний release отменяет ожидающую или идущую конвертацию
+    void release(const QString& key);
+
+    QString cacheDirectory() const { return m_cacheDir; }
+    qint64 maxBytes() const { return m_maxBytes; }
+    void setMaxBytes(qint64 maxBytes);
+
+    static QString contentHash(const QString& filePath);
+
+signals:
+    void progress(const QString& key, int percent);
+    // Пустой путь - конвертация не удалась или отменена
+    void finished(const QString& key, const QString& outputPath);
+
+private:
+    VideoTranscodeCache();
+    ~VideoTranscodeCache();
+
+    struct Job {
+        QString key;
+        VideoTranscodeRequest request;
+    };
+
+    QString cachedContentHash(const QString& filePath);
+    QString outputPath(const QString& key) const;
+    bool isPending(const QString& key) const;
+
+    void startNextJob();
+    void readProgress();
+    void finishJob(bool success);
+    void abortRunningJob();
+
+    void removePartialOutputs();
+    void enforceBudget();
+    static void touch(const QString& filePath);
+    static QStringList encoderArguments(const VideoTranscodeRequest& request, const QString& outputPath);
+
+    QString m_cacheDir;
+    QString m_encoderProgram;
+    qint64 m_maxBytes;
+
+    // Хеши содержимого по пути; пересчитываются при смене размера или времени изменения
+    struct HashEntry {
+        qint64 size = 0;
+        qint64 modified = 0;
+        QString hash;
+    };
+    QHash<QString, HashEntry> m_hashes;
+
+    QHash<QString, int> m_refs;
+    QList<Job> m_queue;
+    Job m_runningJob;
+    QProcess* m_process;
+    bool m_aborted;
+};
+
+#endif // VIDEOTRANSCODECACHE_H
@@ -0,0 +1,472 @@
+#include "WallpaperImageLoader.h"
+#include "../DockTelemetry.h"
+#include "../ImageResampler.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QImageReader>
+#include <QSet>
+#include <QtConcurrent>
+
+namespace {
+
+// Смещение обрезки лишней части по выравниванию - как при отрисовке в режиме fill
+QPoint alignedOffset(const QSize& excess, const QString& alignment)
+{
+    int x = excess.width() / 2;
+    int y = excess.height() / 2;
+
+    if (alignment == "left") {
+        x = 0;
+    } else if (alignment == "right") {
+        x = excess.width();
+    }
+
+    if (alignment == "top") {
+        y = 0;
+    } else if (alignment == "bottom") {
+        y = excess.height();
+    }
+
+    return QPoint(qMax(0, x), qMax(0, y));
+}
+
+// Размер, который нужен экрану от исходника размера sourceSize
+QSize neededSize(const QSize& sourceSize, const WallpaperImageRequest& request)
+{
+    if (request.scaling == "fill") {
+        return sourceSize.scaled(request.targetSize, Qt::KeepAspectRatioByExpanding);
+    } else if (request.scaling == "fit") {
+        return sourceSize.scaled(request.targetSize, Qt::KeepAspectRatio);
+    } else if (request.scaling == "stretch") {
+        return request.targetSize;
+    } else if (request.scaling == "zoom") {
+        return sourceSize * qBound(0.1, request.scaleFactor, 3.0);
+    }
+    // center и tile используют оригинал
+    return sourceSize;
+}
+
+} // namespace
+
+WallpaperImageLoader& WallpaperImageLoader::instance()
+{
+    static WallpaperImageLoader loader;
+    return loader;
+}
+
+WallpaperImageLoader::WallpaperImageLoader()
+    : QObject(nullptr)
+{
+    m_pool.setMaxThreadCount(DECODE_THREADS);
+}
+
+WallpaperImageLoader::~WallpaperImageLoader()
+{
+    m_pool.waitForDone();
+}
+
+WallpaperImageLoader::SourceInfo WallpaperImageLoader::readInfo(const QString& path)
+{
+    // Читается только заголовок файла
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+
+    SourceInfo info;
+    info.modified = QFileInfo(path).lastModified().toMSecsSinceEpoch();
+    info.transposed = reader.transformation().testFlag(QImageIOHandler::TransformationRotate90);
+    info.size = reader.size();
+    if (info.transposed) {
+        info.size.transpose();
+    }
+    return info;
+}
+
+int WallpaperImageLoader::sizeClass(const SourceInfo& info, const WallpaperImageRequest& request)
+{
+    if (!info.size.isValid() || request.targetSize.isEmpty()) {
+        return 1;
+    }
+
+    // Наибольшее уменьшение, при котором исходник не меньше нужного размера
+    const QSize needed = neededSize(info.size, request);
+    for (int divisor = 8; divisor > 1; divisor /= 2) {
+        if (info.size.width() / divisor >= needed.width() && info.size.height() / divisor >= needed.height()) {
+            return divisor;
+        }
+    }
+    return 1;
+}
+
+QString WallpaperImageLoader::acquire(const WallpaperImageRequest& request, QImage* readyImage)
+{
+    // В потоке GUI - только время изменения файла, заголовок читается в фоне
+    const qint64 modified = QFileInfo(request.path).lastModified().toMSecsSinceEpoch();
+
+    QString key = request.path + '|' + QString::number(modified) + '|' + QString::number(request.targetSize.width())
+                  + 'x' + QString::number(request.targetSize.height()) + '|' + request.scaling;
+    // Выравнивание и масштаб влияют на результат только в своих режимах
+    if (request.scaling == "fill") {
+        key += '|' + request.alignment;
+    } else if (request.scaling == "zoom") {
+        key += '|' + QString::number(request.scaleFactor);
+    }
+
+    // Экран с теми же параметрами уже получил или ждет это изображение
+    auto resultIt = m_results.find(key);
+    if (resultIt != m_results.end()) {
+        ++resultIt->refs;
+        if (resultIt->ready && readyImage) {
+            *readyImage = resultIt->image;
+        }
+        return key;
+    }
+
+    Result& result = m_results[key];
+    result.request = request;
+    result.refs = 1;
+
+    auto infoIt = m_sourceInfo.constFind(request.path);
+    if (infoIt != m_sourceInfo.constEnd() && infoIt->modified == modified) {
+        startSource(key, *infoIt);
+    } else {
+        startInfo(request.path, key);
+    }
+
+    // Для center и tile результат готов сразу, если исходник уже в памяти
+    const Result& created = m_results[key];
+    if (created.ready && readyImage) {
+        *readyImage = created.image;
+    }
+    return key;
+}
+
+void WallpaperImageLoader::startInfo(const QString& path, const QString& key)
+{
+    // Экраны с тем же файлом ждут одно чтение заголовка
+    QList<QString>& waiters = m_infoWaiters[path];
+    waiters.append(key);
+    if (waiters.size() > 1) {
+        return;
+    }
+
+    QFutureWatcher<SourceInfo>* watcher = new QFutureWatcher<SourceInfo>(this);
+    connect(watcher, &QFutureWatcher<SourceInfo>::finished, this, [this, watcher, path]() {
+        watcher->deleteLater();
+        finishInfo(path, watcher->result());
+    });
+    watcher->setFuture(QtConcurrent::run(&m_pool, &WallpaperImageLoader::readInfo, path));
+}
+
+void WallpaperImageLoader::finishInfo(const QString& path, const SourceInfo& info)
+{
+    m_sourceInfo.insert(path, info);
+
+    const QList<QString> waiters = m_infoWaiters.take(path);
+    for (const QString& key : waiters) {
+        auto it = m_results.find(key);
+        if (it == m_results.end()) {
+            continue;
+        }
+        if (it->refs <= 0) {
+            // Экран отказался от изображения, пока читался заголовок
+            m_results.erase(it);
+            continue;
+        }
+        startSource(key, info);
+    }
+}
+
+void WallpaperImageLoader::startSource(const QString& key, const SourceInfo& info)
+{
+    Result& result = m_results[key];
+    const WallpaperImageRequest& request = result.request;
+    const QString fileKey = request.path + '|' + QString::number(info.modified);
+
+    // Размер и обрезка чтения задаются в ориентации файла, поворот применяется после чтения
+    const QSize fileSize = info.transposed ? info.size.transposed() : info.size;
+    QSize scaledSize;
+    QRect clipRect;
+
+    if (request.scaling == "fill" && info.size.isValid() && !request.targetSize.isEmpty()) {
+        // Читается только видимая часть, сразу в размере экрана. Такой исходник
+        // нужен только экранам с тем же размером и выравниванием
+        result.sourceKey = fileKey + "|fill|" + QString::number(request.targetSize.width()) + 'x'
+                           + QString::number(request.targetSize.height()) + '|' + request.alignment;
+
+        const QSize targetSize = info.transposed ? request.targetSize.transposed() : request.targetSize;
+        const QSize expandedSize = fileSize.scaled(targetSize, Qt::KeepAspectRatioByExpanding);
+        const QSize clipSize(qMin(fileSize.width(), qRound(qreal(targetSize.width()) * fileSize.width() / expandedSize.width())),
+                             qMin(fileSize.height(), qRound(qreal(targetSize.height()) * fileSize.height() / expandedSize.height())));
+        const QString alignment = info.transposed ? QString("center") : request.alignment;
+        clipRect = QRect(alignedOffset(fileSize - clipSize, alignment), clipSize);
+        scaledSize = targetSize;
+    } else {
+        const int divisor = sizeClass(info, request);
+        result.sourceKey = fileKey + '|' + QString::number(divisor);
+        if (info.size.isValid() && divisor > 1) {
+            scaledSize = QSize((fileSize.width() + divisor - 1) / divisor,
+                               (fileSize.height() + divisor - 1) / divisor);
+        }
+    }
+
+    Source& source = m_sources[result.sourceKey];
+    ++source.refs;
+
+    if (!source.image.isNull()) {
+        // Исходник еще в памяти для другого экрана - только масштабирование
+        startRescale(key);
+        return;
+    }
+
+    source.waiters.append(key);
+    if (!source.decoding) {
+        source.decoding = true;
+        startDecode(result.sourceKey, request.path, scaledSize, clipRect);
+    }
+}
+
+void WallpaperImageLoader::release(const QString& key)
+{
+    auto it = m_results.find(key);
+    if (it == m_results.end()) {
+        return;
+    }
+
+    if (--it->refs > 0 || it->scaling) {
+        // Масштабирование в фоне завершится и удалит результат само
+        return;
+    }
+    if (it->sourceKey.isEmpty()) {
+        // Заголовок еще читается - результат удалится после чтения
+        return;
+    }
+
+    const QString sourceKey = it->sourceKey;
+    m_results.erase(it);
+    releaseSource(sourceKey);
+    logMemory();
+}
+
+void WallpaperImageLoader::releaseSource(const QString& sourceKey)
+{
+    auto it = m_sources.find(sourceKey);
+    if (it == m_sources.end()) {
+        return;
+    }
+
+    if (--it->refs <= 0 && !it->decoding) {
+        m_sources.erase(it);
+    }
+}
+
+void WallpaperImageLoader::trimSource(const QString& sourceKey)
+{
+    auto it = m_sources.find(sourceKey);
+    if (it == m_sources.end() || it->decoding || it->rescaling > 0 || !it->waiters.isEmpty()) {
+        return;
+    }
+    for (const Result& result : std::as_const(m_results)) {
+        if (result.sourceKey == sourceKey && result.image.cacheKey() == it->image.cacheKey()) {
+            // Пиксели разделяет результат (center, tile, чтение в размере экрана) -
+            // освобождение ничего не даст, а новому экрану пришлось бы декодировать снова
+            return;
+        }
+    }
+
+    // Результаты экранов готовы; исходник в полном разрешении больше не нужен.
+    // Экран, которому он понадобится позже, декодирует его заново
+    it->image = QImage();
+}
+
+void WallpaperImageLoader::startDecode(const QString& sourceKey, const QString& path, const QSize& scaledSize,
+                                       const QRect& clipRect)
+{
+    QFutureWatcher<JobResult>* watcher = new QFutureWatcher<JobResult>(this);
+    connect(watcher, &QFutureWatcher<JobResult>::finished, this, [this, watcher, sourceKey]() {
+        watcher->deleteLater();
+        finishDecode(sourceKey, watcher->result());
+    });
+    watcher->setFuture(QtConcurrent::run(&m_pool, &WallpaperImageLoader::decode, path, scaledSize, clipRect));
+}
+
+void WallpaperImageLoader::finishDecode(const QString& sourceKey, const JobResult& result)
+{
+    DockTelemetry::recordDuration("WallpaperImageLoader::decode", quint64(result.elapsedUs));
+
+    auto it = m_sources.find(sourceKey);
+    if (it == m_sources.end()) {
+        return;
+    }
+
+    it->decoding = false;
+    const QList<QString> waiters = it->waiters;
+    it->waiters.clear();
+
+    if (it->refs <= 0) {
+        // Все экраны отказались от изображения, пока оно декодировалось
+        m_sources.erase(it);
+        return;
+    }
+
+    it->image = result.image;
+
+    for (const QString& key : waiters) {
+        if (!m_results.contains(key)) {
+            continue;
+        }
+        if (result.image.isNull()) {
+            finishResult(key, QImage());
+        } else {
+            startRescale(key);
+        }
+    }
+    trimSource(sourceKey);
+}
+
+void WallpaperImageLoader::startRescale(const QString& key)
+{
+    Result& result = m_results[key];
+    Source& sourceEntry = m_sources[result.sourceKey];
+    const QImage source = sourceEntry.image;
+
+    // Для center и tile исходник используется как есть, как и исходник,
+    // прочитанный уже в размере экрана
+    const bool readyAsIs = result.request.scaling == "center" || result.request.scaling == "tile"
+        || (result.request.scaling == "fill" ? source.size() == result.request.targetSize
+                                             : neededSize(source.size(), result.request) == source.size());
+    if (readyAsIs) {
+        finishResult(key, source);
+        return;
+    }
+
+    result.scaling = true;
+    ++sourceEntry.rescaling;
+    const QString sourceKey = result.sourceKey;
+
+    QFutureWatcher<JobResult>* watcher = new QFutureWatcher<JobResult>(this);
+    connect(watcher, &QFutureWatcher<JobResult>::finished, this, [this, watcher, key, sourceKey]() {
+        watcher->deleteLater();
+
+        const JobResult jobResult = watcher->result();
+        DockTelemetry::recordDuration("WallpaperImageLoader::rescale", quint64(jobResult.elapsedUs));
+
+        auto sourceIt = m_sources.find(sourceKey);
+        if (sourceIt != m_sources.end()) {
+            --sourceIt->rescaling;
+            trimSource(sourceKey);
+        }
+
+        auto it = m_results.find(key);
+        if (it == m_results.end()) {
+            return;
+        }
+        it->scaling = false;
+
+        if (it->refs <= 0) {
+            const QString sourceKey = it->sourceKey;
+            m_results.erase(it);
+            releaseSource(sourceKey);
+            return;
+        }
+        finishResult(key, jobResult.image);
+    });
+    watcher->setFuture(QtConcurrent::run(&m_pool, &WallpaperImageLoader::rescale, source, result.request));
+}
+
+void WallpaperImageLoader::finishResult(const QString& key, const QImage& image)
+{
+    Result& result = m_results[key];
+    result.image = image;
+    result.ready = true;
+
+    logMemory();
+    emit imageReady(key, image);
+}
+
+qint64 WallpaperImageLoader::memoryBytes() const
+{
+    // Результат может разделять данные с исходником (center, tile, совпавший размер)
+    QSet<qint64> counted;
+    qint64 bytes = 0;
+
+    for (const Source& source : m_sources) {
+        if (!source.image.isNull() && !counted.contains(source.image.cacheKey())) {
+            counted.insert(source.image.cacheKey());
+            bytes += source.image.sizeInBytes();
+        }
+    }
+    for (const Result& result : m_results) {
+        if (!result.image.isNull() && !counted.contains(result.image.cacheKey())) {
+            counted.insert(result.image.cacheKey());
+            bytes += result.image.sizeInBytes();
+        }
+    }
+    return bytes;
+}
+
+void WallpaperImageLoader::logMemory() const
+{
+    qDebug() << "WallpaperImageLoader:" << m_sources.size() << "sources," << m_results.size() << "screens images,"
+             << memoryBytes() / (1024 * 1024) << "MB";
+}
+
+WallpaperImageLoader::JobResult WallpaperImageLoader::decode(const QString& path, const QSize& scaledSize,
+                                                             const QRect& clipRect)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    JobResult result;
+
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+    // Только видимая часть (fill) - остальное не разжимается
+    if (clipRect.isValid()) {
+        reader.setClipRect(clipRect);
+    }
+    // Уменьшение при чтении - JPEG не разжимается в полном разрешении
+    if (scaledSize.isValid()) {
+        reader.setScaledSize(scaledSize);
+    }
+
+    result.image = reader.read();
+    if (result.image.isNull()) {
+        qDebug() << "WallpaperImageLoader: failed to read" << path << reader.errorString();
+    } else {
+        // Формат, который QPixmap принимает без преобразования в потоке GUI
+        result.image.convertTo(result.image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                              : QImage::Format_RGB32);
+    }
+
+    result.elapsedUs = timer.nsecsElapsed() / 1000;
+    return result;
+}
+
+WallpaperImageLoader::JobResult WallpaperImageLoader::rescale(const QImage& source, const WallpaperImageRequest& request)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    JobResult result;
+    const QSize needed = neededSize(source.size(), request);
+
+    if (request.scaling == "fill") {
+        // Масштаб с заполнением и обрезка видимой части по выравниванию
+        const QImage expanded = needed == source.size()
+            ? source
+            : ImageResampler::resize(source, needed);
+        const QSize visibleSize = expanded.size().boundedTo(request.targetSize);
+        result.image = expanded.copy(QRect(alignedOffset(expanded.size() - visibleSize, request.alignment), visibleSize));
+    } else if (needed == source.size()) {
+        result.image = source;
+    } else {
+        result.image = ImageResampler::resize(source, needed);
+    }
+
+    result.elapsedUs = timer.nsecsElapsed() / 1000;
+    return result;
+}
@@ -0,0 +1,114 @@
+#ifndef WALLPAPERIMAGELOADER_H
+#define WALLPAPERIMAGELOADER_H
+
+#include <QObject>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+
+// Параметры изображения обоев для одного экрана
+struct WallpaperImageRequest {
+    QString path;
+    QSize targetSize;   // Размер экрана в логических пикселях
+    QString scaling;    // fill, fit, stretch, center, tile, zoom
+    QString alignment;
+    qreal scaleFactor = 1.0;
+};
+
+// Загрузчик обоев с общим кешем декодированных изображений.
+// Заголовок файла и пиксели читаются в фоновом потоке через QImageReader.
+// В режиме fill читается только видимая часть, сразу в размере экрана.
+// В остальных режимах файл декодируется один раз на (путь, время изменения,
+// класс размера): класс - степень уменьшения 1/2/4/8, при которой изображение
+// еще покрывает нужный экрану размер (JPEG декодирует такие уменьшения без
+// чтения полного разрешения). Затем для каждого экрана исходник масштабируется
+// под его разрешение, а после последнего масштабирования освобождается.
+// Экраны с одинаковыми параметрами получают один результат. Результаты
+// считают ссылки и освобождаются, когда их больше не использует ни один экран.
+class WallpaperImageLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    static inline const int DECODE_THREADS = 2;
+
+    static WallpaperImageLoader& instance();
+
+    // Захватывает изображение для запроса и возвращает ключ. Если оно уже
+    // готово, возвращается через readyImage, иначе позже придет imageReady.
+    // Каждому acquire соответствует один release
+    QString acquire(const WallpaperImageRequest& request, QImage* readyImage);
+    void release(const QString& key);
+
+    // Память декодированных изображений (общие данные считаются один раз)
+    qint64 memoryBytes() const;
+
+signals:
+    // Пустое изображение - файл не удалось прочитать
+    void imageReady(const QString& key, const QImage& image);
+
+private:
+    WallpaperImageLoader();
+    ~WallpaperImageLoader();
+
+    // Заголовок файла - читается один раз на время изменения
+    struct SourceInfo {
+        qint64 modified = 0;
+        QSize size;           // В ориентации отображения (с учетом EXIF)
+        bool transposed = false;
+    };
+
+    struct Source {
+        QImage image;           // Пустой после масштабирования для всех ожидавших экранов
+        int refs = 0;
+        bool decoding = false;
+        int rescaling = 0;      // Масштабирования в фоне, читающие image
+        QList<QString> waiters; // Результаты, ожидающие декодирования
+    };
+
+    struct Result {
+        WallpaperImageRequest request;
+        QString sourceKey;      // Пустой, пока читается заголовок файла
+        QImage image;
+        int refs = 0;
+        bool ready = false;
+        bool scaling = false;
+    };
+
+    struct JobResult {
+        QImage image;
+        qint64 elapsedUs = 0;
+    };
+
+    // Делитель разрешения исходника: 1, 2, 4 или 8
+    static int sizeClass(const SourceInfo& info, const WallpaperImageRequest& request);
+
+    void startInfo(const QString& path, const QString& key);
+    void finishInfo(const QString& path, const SourceInfo& info);
+    // Выбирает исходник для результата и запускает его декодирование
+    void startSource(const QString& key, const SourceInfo& info);
+    void startDecode(const QString& sourceKey, const QString& path, const QSize& scaledSize, const QRect& clipRect);
+    void finishDecode(const QString& sourceKey, const JobResult& result);
+    void startRescale(const QString& key);
+    void finishResult(const QString& key, const QImage& image);
+    void releaseSource(const QString& sourceKey);
+    // Освобождает пиксели исходника, если их больше никто не ждет
+    void trimSource(const QString& sourceKey);
+    void logMemory() const;
+
+    static SourceInfo readInfo(const QString& path);
+    static JobResult decode(const QString& path, const QSize& scaledSize, const QRect& clipRect);
+    static JobResult rescale(const QImage& source, const WallpaperImageRequest& request);
+
+    QThreadPool m_pool;
+    QHash<QString, SourceInfo> m_sourceInfo;
+    QHash<QString, QList<QString>> m_infoWaiters; // Результаты, ожидающие заголовка, по пути
+    QHash<QString, Source> m_sources;
+    QHash<QString, Result> m_results;
+};
+
+#endif // WALLPAPERIMAGELOADER_H
@@ -0,0 +1,164 @@
+#include "WallpaperPlaylist.h"
+
+#include <QCollator>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QRandomGenerator>
+#include <QtConcurrent>
+#include <algorithm>
+
+WallpaperPlaylist::WallpaperPlaylist(QObject* parent)
+    : QObject(parent)
+    , m_shuffle(false)
+    , m_position(0)
+    , m_scanning(false)
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+void WallpaperPlaylist::setDirectory(const QString& directory, bool shuffle)
+{
+    if (m_directory == directory && m_shuffle == shuffle) {
+        return;
+    }
+
+    const bool directoryChanged = m_directory != directory;
+    m_directory = directory;
+    m_shuffle = shuffle;
+
+    if (directoryChanged) {
+        m_files.clear();
+        m_order.clear();
+        m_position = 0;
+        m_last.clear();
+        if (!m_directory.isEmpty()) {
+            startScan();
+        }
+    } else {
+        // Сменился только порядок - новый цикл с начала
+        buildOrder();
+    }
+}
+
+QString WallpaperPlaylist::takeNext()
+{
+    if (m_files.isEmpty()) {
+        // Каталог мог быть пуст при сканировании - пробуем снова
+        startScan();
+        return QString();
+    }
+
+    if (m_position >= m_order.size()) {
+        // Цикл пройден - перечитываем каталог, пока идет сканирование
+        // выдаем изображения в новом порядке из прежнего списка
+        buildOrder();
+        startScan();
+    }
+
+    m_last = m_order.at(m_position++);
+    return m_last;
+}
+
+bool WallpaperPlaylist::isImageFile(const QString& filePath)
+{
+    static const QStringList imageExtensions = {
+        "png", "jpg", "jpeg", "bmp", "gif", "tiff", "tif", "webp"
+    };
+    return imageExtensions.contains(QFileInfo(filePath).suffix().toLower());
+}
+
+void WallpaperPlaylist::startScan()
+{
+    if (m_scanning || m_directory.isEmpty()) {
+        return;
+    }
+
+    m_scanning = true;
+    const QString directory = m_directory;
+
+    QFutureWatcher<QStringList>* watcher = new QFutureWatcher<QStringList>(this);
+    connect(watcher, &QFutureWatcher<QStringList>::finished, this, [this, watcher, directory]() {
+        watcher->deleteLater();
+        finishScan(directory, watcher->result());
+    });
+    watcher->setFuture(QtConcurrent::run(&m_pool, &WallpaperPlaylist::scanDirectory, directory));
+}
+
+void WallpaperPlaylist::finishScan(const QString& directory, const QStringList& files)
+{
+    m_scanning = false;
+
+    // Каталог сменился, пока шло сканирование - результат устарел
+    if (directory != m_directory) {
+        startScan();
+        return;
+    }
+
+    const bool firstScan = m_files.isEmpty();
+    m_files = files;
+
+    qDebug() << "Slideshow playlist:" << directory << "images:" << m_files.size();
+
+    if (firstScan) {
+        buildOrder();
+        emit loaded();
+    } else {
+        // Текущий цикл продолжается по новому списку: удаленные файлы выпадают,
+        // новые попадут в следующий цикл
+        QStringList order;
+        for (int i = m_position; i < m_order.size(); ++i) {
+            if (m_files.contains(m_order.at(i))) {
+                order.append(m_order.at(i));
+            }
+        }
+        m_order = order;
+        m_position = 0;
+    }
+}
+
+void WallpaperPlaylist::buildOrder()
+{
+    m_order = m_files;
+    m_position = 0;
+
+    if (!m_shuffle) {
+        // По имени - продолжаем с файла, следующего за последним показанным
+        const int index = m_order.indexOf(m_last);
+        if (index >= 0) {
+            std::rotate(m_order.begin(), m_order.begin() + index + 1, m_order.end());
+        }
+        return;
+    }
+
+    QRandomGenerator* random = QRandomGenerator::global();
+    for (int i = m_order.size() - 1; i > 0; --i) {
+        m_order.swapItemsAt(i, int(random->bounded(i + 1)));
+    }
+
+    // Первое изображение цикла не должно совпадать с последним показанным
+    if (m_order.size() > 1 && m_order.first() == m_last) {
+        m_order.swapItemsAt(0, 1 + int(random->bounded(m_order.size() - 1)));
+    }
+}
+
+QStringList WallpaperPlaylist::scanDirectory(const QString& directory)
+{
+    QStringList files;
+    const QFileInfoList entries = QDir(directory).entryInfoList(QDir::Files | QDir::Readable);
+    for (const QFileInfo& entry : entries) {
+        if (isImageFile(entry.fileName())) {
+            files.append(entry.absoluteFilePath());
+        }
+    }
+
+    // Естественная сортировка: "2.jpg" раньше "10.jpg"
+    QCollator collator;
+    collator.setNumericMode(true);
+    collator.setCaseSensitivity(Qt::CaseInsensitive);
+    std::sort(files.begin(), files.end(), [&collator](const QString& a, const QString& b) {
+        return collator.compare(a, b) < 0;
+    });
+    return files;
+}
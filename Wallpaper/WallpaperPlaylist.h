@@ -0,0 +1,54 @@
+#ifndef WALLPAPERPLAYLIST_H
+#define WALLPAPERPLAYLIST_H
+
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+
+// Список изображений каталога для слайд-шоу обоев.
+// Каталог сканируется в фоновом потоке; файлы выдаются по кругу по имени
+// или в случайном порядке (перемешивание Фишера-Йетса на каждый цикл, первое
+// изображение нового цикла не повторяет последнее). В конце цикла каталог
+// пересканируется, до готовности нового списка используется прежний.
+class WallpaperPlaylist : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WallpaperPlaylist(QObject* parent = nullptr);
+
+    // Пустой каталог - список очищается
+    void setDirectory(const QString& directory, bool shuffle);
+    QString directory() const { return m_directory; }
+    bool shuffle() const { return m_shuffle; }
+
+    bool isEmpty() const { return m_files.isEmpty(); }
+    int count() const { return m_files.size(); }
+
+    // Следующее изображение; пустая строка - список пуст или еще сканируется
+    QString takeNext();
+
+    static bool isImageFile(const QString& filePath);
+
+signals:
+    // Первое сканирование каталога завершено
+    void loaded();
+
+private:
+    void startScan();
+    void finishScan(const QString& directory, const QStringList& files);
+    void buildOrder();
+
+    static QStringList scanDirectory(const QString& directory);
+
+    QString m_directory;
+    bool m_shuffle;
+    QStringList m_files;
+    QStringList m_order;
+    int m_position;
+    QString m_last;
+    bool m_scanning;
+    QThreadPool m_pool;
+};
+
+#endif // WALLPAPERPLAYLIST_H
@@ -0,0 +1,518 @@
+#include "WindowTaskModel.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <algorithm>
+
+#ifdef Q_OS_WIN
+#include <psapi.h>
+#endif
+
+#ifdef Q_OS_WIN
+bool ReadTaskWindowInfo(HWND hwnd, TaskWindowInfo& info)
+{
+    // Проверяем, видимо ли окно
+    if (!IsWindowVisible(hwnd)) {
+        return false;
+    }
+
+    // Получаем заголовок окна
+    wchar_t windowTitle[256];
+    int titleLength = GetWindowTextW(hwnd, windowTitle, 255);
+
+    // Получаем стили окна
+    LONG_PTR style = GetWindowLongPtr(hwnd, GWL_STYLE);
+    LONG_PTR exStyle = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
+
+    // Пропускаем тултипы и всплывающие окна
+    if (exStyle & WS_EX_TOOLWINDOW) {
+        return false;
+    }
+
+    // Пропускаем окна без заголовка (кроме диалогов)
+    if (titleLength == 0 && !(style & WS_CHILD)) {
+        if (!(style & WS_DLGFRAME)) {
+            return false;
+        }
+    }
+
+    QString title = QString::fromWCharArray(windowTitle, titleLength);
+
+    // Пропускаем системные окна
+    if (title.isEmpty() ||
+        title == "Program Manager" ||
+        title.startsWith("MSCTFIME UI") ||
+        title == "Default IME" ||
+        title.contains("OleMainThreadWndName") ||
+        title == "Windows Input Experience" ||
+        title == "Shell_TrayWnd" ||
+        title == "DDE Server Window" ||
+        title == "Start" ||
+        title == "Application Manager") {
+        return false;
+    }
+
+    // Получаем ID процесса окна
+    DWORD processId = 0;
+    GetWindowThreadProcessId(hwnd, &processId);
+
+    // Открываем процесс для получения его имени
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
+    if (!hProcess) {
+        return false;
+    }
+
+    wchar_t exePath[MAX_PATH];
+    bool ok = GetModuleFileNameExW(hProcess, NULL, exePath, MAX_PATH);
+    CloseHandle(hProcess);
+    if (!ok) {
+        return false;
+    }
+
+    QString processExeName = QFileInfo(QString::fromWCharArray(exePath)).fileName();
+
+    // Специальная обработка для taskmgr.exe - пропускаем его скрытые служебные окна
+    if (processExeName.compare("taskmgr.exe", Qt::CaseInsensitive) == 0) {
+        if (title != "Task Manager" &&
+            !title.contains("Диспетчер задач", Qt::CaseInsensitive) &&
+            !title.contains("Task Manager", Qt::CaseInsensitive) &&
+            !title.contains("Performance", Qt::CaseInsensitive) &&
+            !title.contains("Производительность", Qt::CaseInsensitive)) {
+            return false;
+        }
+    }
+
+    info.id = reinterpret_cast<quintptr>(hwnd);
+    info.title = title;
+    info.processName = processExeName.toLower();
+    info.processId = processId;
+    return true;
+}
+
+// Источник данных на основе WinAPI и SetWinEventHook
+class WinWindowSystemBackend : public WindowSystemBackend
+{
+public:
+    ~WinWindowSystemBackend() override { removeHooks(); }
+
+    QList<quintptr> enumerateWindows() const override
+    {
+        QList<quintptr> windows;
+        EnumWindows(enumWindowsProc, reinterpret_cast<LPARAM>(&windows));
+        return windows;
+    }
+
+    QString windowTitle(quintptr window) const override
+    {
+        wchar_t windowTitle[256];
+        int titleLength = GetWindowTextW(reinterpret_cast<HWND>(window), windowTitle, 255);
+        return QString::fromWCharArray(windowTitle, titleLength);
+    }
+
+    bool queryWindow(quintptr window, TaskWindowInfo& info) const override
+    {
+        HWND hwnd = reinterpret_cast<HWND>(window);
+        if (!IsWindow(hwnd) || GetAncestor(hwnd, GA_ROOT) != hwnd) {
+            return false;
+        }
+        return ReadTaskWindowInfo(hwnd, info);
+    }
+
+    quint32 untitledWindowProcess(quintptr window) const override
+    {
+        HWND hwnd = reinterpret_cast<HWND>(window);
+        if (!IsWindow(hwnd) || GetAncestor(hwnd, GA_ROOT) != hwnd || !IsWindowVisible(hwnd) ||
+            GetWindowTextLengthW(hwnd) > 0 ||
+            (GetWindowLongPtr(hwnd, GWL_EXSTYLE) & WS_EX_TOOLWINDOW)) {
+            return 0;
+        }
+
+        DWORD processId = 0;
+        GetWindowThreadProcessId(hwnd, &processId);
+        return processId;
+    }
+
+    bool installHooks(WindowTaskModel* model) override
+    {
+        s_model = model;
+
+        // Активация окна - для порядка окон
+        m_foregroundHook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
+                                           nullptr, winEventProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+        // Уничтожение, показ и скрытие окна
+        m_objectHook = SetWinEventHook(EVENT_OBJECT_DESTROY, EVENT_OBJECT_HIDE,
+                                       nullptr, winEventProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+        // Изменения заголовков - через setTitleWatch для отдельных процессов
+
+        if (!m_foregroundHook || !m_objectHook) {
+            qDebug() << "WindowTaskModel: failed to install WinEvent hooks";
+            removeHooks();
+            return false;
+        }
+        return true;
+    }
+
+    void removeHooks() override
+    {
+        if (m_foregroundHook) {
+            UnhookWinEvent(m_foregroundHook);
+            m_foregroundHook = nullptr;
+        }
+        if (m_objectHook) {
+            UnhookWinEvent(m_objectHook);
+            m_objectHook = nullptr;
+        }
+        for (HWINEVENTHOOK hook : std::as_const(m_nameHooks)) {
+            UnhookWinEvent(hook);
+        }
+        m_nameHooks.clear();
+        s_model = nullptr;
+    }
+
+    void setTitleWatch(quint32 processId, bool watch) override
+    {
+        if (!watch) {
+            HWINEVENTHOOK hook = m_nameHooks.take(processId);
+            if (hook) {
+                UnhookWinEvent(hook);
+            }
+            return;
+        }
+
+        if (!s_model || m_nameHooks.contains(processId)) {
+            return;
+        }
+
+        HWINEVENTHOOK hook = SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE,
+                                             nullptr, winEventProc, processId, 0, WINEVENT_OUTOFCONTEXT);
+        if (hook) {
+            m_nameHooks.insert(processId, hook);
+        } else {
+            qDebug() << "WindowTaskModel: failed to watch titles of process" << processId;
+        }
+    }
+
+private:
+    static BOOL CALLBACK enumWindowsProc(HWND hwnd, LPARAM lParam)
+    {
+        reinterpret_cast<QList<quintptr>*>(lParam)->append(reinterpret_cast<quintptr>(hwnd));
+        return TRUE;
+    }
+
+    static void CALLBACK winEventProc(HWINEVENTHOOK, DWORD event, HWND hwnd,
+                                      LONG idObject, LONG idChild, DWORD, DWORD)
+    {
+        // Интересуют только события самих окон, а не их дочерних объектов
+        if (!s_model || !hwnd || idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+            return;
+        }
+
+        quintptr id = reinterpret_cast<quintptr>(hwnd);
+        switch (event) {
+        case EVENT_SYSTEM_FOREGROUND:
+            s_model->notifyWindowActivated(id);
+            break;
+        case EVENT_OBJECT_SHOW:
+            s_model->notifyWindowShown(id);
+            break;
+        case EVENT_OBJECT_HIDE:
+            s_model->notifyWindowHidden(id);
+            break;
+        case EVENT_OBJECT_DESTROY:
+            s_model->notifyWindowDestroyed(id);
+            break;
+        case EVENT_OBJECT_NAMECHANGE:
+            s_model->notifyTitleChanged(id);
+            break;
+        default:
+            break;
+        }
+    }
+
+    HWINEVENTHOOK m_foregroundHook = nullptr;
+    HWINEVENTHOOK m_objectHook = nullptr;
+    QHash<quint32, HWINEVENTHOOK> m_nameHooks;
+
+    static WindowTaskModel* s_model;
+};
+
+WindowTaskModel* WinWindowSystemBackend::s_model = nullptr;
+#endif
+
+WindowTaskModel& WindowTaskModel::instance()
+{
+    static WindowTaskModel model;
+    return model;
+}
+
+WindowTaskModel::WindowTaskModel()
+    : QObject(nullptr)
+    , m_backend(nullptr)
+    , m_live(false)
+    , m_zCounter(0)
+{
+#ifdef Q_OS_WIN
+    setBackend(new WinWindowSystemBackend());
+#endif
+}
+
+WindowTaskModel::~WindowTaskModel()
+{
+    if (m_backend) {
+        m_backend->removeHooks();
+        delete m_backend;
+        m_backend = nullptr;
+    }
+}
+
+void WindowTaskModel::setBackend(WindowSystemBackend* backend)
+{
+    if (m_backend) {
+        m_backend->removeHooks();
+        delete m_backend;
+    }
+
+    m_backend = backend;
+    m_live = m_backend ? m_backend->installHooks(this) : false;
+    resync();
+}
+
+void WindowTaskModel::resync()
+{
+    if (m_backend) {
+        for (auto it = m_processWindowCounts.constBegin(); it != m_processWindowCounts.constEnd(); ++it) {
+            m_backend->setTitleWatch(it.key(), false);
+        }
+    }
+
+    m_windows.clear();
+    m_windowsByProcess.clear();
+    m_untitledWindows.clear();
+    m_processWindowCounts.clear();
+    m_zCounter = 0;
+
+    if (!m_backend) {
+        return;
+    }
+
+    // Перечисление идет сверху вниз, поэтому порядок назначаем с конца
+    QList<quintptr> windows = m_backend->enumerateWindows();
+    for (int i = windows.size() - 1; i >= 0; --i) {
+        TaskWindowInfo info;
+        if (m_backend->queryWindow(windows[i], info)) {
+            insertWindow(info);
+        }
+    }
+
+    qDebug() << "WindowTaskModel resynced, windows:" << m_windows.size() << "live:" << m_live;
+}
+
+const TaskWindowInfo* WindowTaskModel::window(quintptr id) const
+{
+    auto it = m_windows.constFind(id);
+    return it != m_windows.constEnd() ? &it.value() : nullptr;
+}
+
+bool WindowTaskModel::hasWindowsForProcess(const QString& processName) const
+{
+    auto it = m_windowsByProcess.constFind(processName.toLower());
+    return it != m_windowsByProcess.constEnd() && !it.value().isEmpty();
+}
+
+QList<TaskWindowInfo> WindowTaskModel::windowsForProcess(const QString& processName) const
+{
+    QList<TaskWindowInfo> result;
+
+    auto it = m_windowsByProcess.constFind(processName.toLower());
+    if (it == m_windowsByProcess.constEnd()) {
+        return result;
+    }
+
+    result.reserve(it.value().size());
+    for (quintptr id : it.value()) {
+        auto windowIt = m_windows.constFind(id);
+        if (windowIt != m_windows.constEnd()) {
+            result.append(windowIt.value());
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const TaskWindowInfo& a, const TaskWindowInfo& b) {
+        return a.zOrder > b.zOrder;
+    });
+    return result;
+}
+
+void WindowTaskModel::insertWindow(const TaskWindowInfo& info)
+{
+    TaskWindowInfo stored = info;
+    stored.zOrder = ++m_zCounter;
+
+    m_windows.insert(stored.id, stored);
+    m_windowsByProcess[stored.processName].insert(stored.id);
+    retainProcess(stored.processId);
+    // После retainProcess, чтобы подписка на заголовки процесса не снималась
+    forgetUntitledWindow(stored.id);
+    emit windowAdded(stored.id);
+}
+
+void WindowTaskModel::removeWindow(quintptr id)
+{
+    auto it = m_windows.find(id);
+    if (it == m_windows.end()) {
+        return;
+    }
+
+    auto processIt = m_windowsByProcess.find(it.value().processName);
+    if (processIt != m_windowsByProcess.end()) {
+        processIt.value().remove(id);
+        if (processIt.value().isEmpty()) {
+            m_windowsByProcess.erase(processIt);
+        }
+    }
+
+    const quint32 processId = it.value().processId;
+    m_windows.erase(it);
+    releaseProcess(processId);
+    emit windowRemoved(id);
+}
+
+void WindowTaskModel::trackUntitledWindow(quintptr id)
+{
+    if (!m_backend || m_untitledWindows.contains(id)) {
+        return;
+    }
+
+    const quint32 processId = m_backend->untitledWindowProcess(id);
+    if (processId == 0) {
+        return;
+    }
+
+    m_untitledWindows.insert(id, processId);
+    retainProcess(processId);
+}
+
+void WindowTaskModel::forgetUntitledWindow(quintptr id)
+{
+    auto it = m_untitledWindows.find(id);
+    if (it == m_untitledWindows.end()) {
+        return;
+    }
+
+    const quint32 processId = it.value();
+    m_untitledWindows.erase(it);
+    releaseProcess(processId);
+}
+
+void WindowTaskModel::retainProcess(quint32 processId)
+{
+    if (++m_processWindowCounts[processId] == 1 && m_backend) {
+        m_backend->setTitleWatch(processId, true);
+    }
+}
+
+void WindowTaskModel::releaseProcess(quint32 processId)
+{
+    auto it = m_processWindowCounts.find(processId);
+    if (it == m_processWindowCounts.end()) {
+        return;
+    }
+
+    if (--it.value() == 0) {
+        m_processWindowCounts.erase(it);
+        if (m_backend) {
+            m_backend->setTitleWatch(processId, false);
+        }
+    }
+}
+
+void WindowTaskModel::updateWindow(quintptr id)
+{
+    if (!m_backend) {
+        return;
+    }
+
+    TaskWindowInfo info;
+    bool eligible = m_backend->queryWindow(id, info);
+
+    auto it = m_windows.find(id);
+    if (it == m_windows.end()) {
+        // Окно могло стать подходящим (например, получило заголовок)
+        if (eligible) {
+            insertWindow(info);
+        } else {
+            trackUntitledWindow(id);
+        }
+        return;
+    }
+
+    if (!eligible) {
+        removeWindow(id);
+        return;
+    }
+
+    if (it.value().title != info.title) {
+        it.value().title = info.title;
+        emit windowChanged(id);
+    }
+}
+
+void WindowTaskModel::notifyWindowShown(quintptr id)
+{
+    updateWindow(id);
+}
+
+void WindowTaskModel::notifyWindowHidden(quintptr id)
+{
+    forgetUntitledWindow(id);
+    removeWindow(id);
+}
+
+void WindowTaskModel::notifyWindowDestroyed(quintptr id)
+{
+    forgetUntitledWindow(id);
+    removeWindow(id);
+}
+
+void WindowTaskModel::notifyTitleChanged(quintptr id)
+{
+    if (!m_backend) {
+        return;
+    }
+
+    // Окно, показанное без заголовка, проверяется целиком, когда заголовок
+    // появился. Заголовки остальных чужих окон не читаются
+    auto it = m_windows.find(id);
+    if (it == m_windows.end()) {
+        if (m_untitledWindows.contains(id) && !m_backend->windowTitle(id).isEmpty()) {
+            updateWindow(id);
+        }
+        return;
+    }
+
+    // Для известного окна достаточно перечитать заголовок, без запроса процесса
+    QString title = m_backend->windowTitle(id);
+    if (title.isEmpty()) {
+        // Окно может снова получить заголовок
+        trackUntitledWindow(id);
+        removeWindow(id);
+        return;
+    }
+
+    if (it.value().title != title) {
+        it.value().title = title;
+        emit windowChanged(id);
+    }
+}
+
+void WindowTaskModel::notifyWindowActivated(quintptr id)
+{
+    auto it = m_windows.find(id);
+    if (it == m_windows.end()) {
+        // Активированное окно могло еще не попасть в модель
+        updateWindow(id);
+    } else {
+        it.value().zOrder = ++m_zCounter;
+    }
+
+    emit windowActivated(id);
+}
@@ -0,0 +1,131 @@
+#ifndef WINDOWTASKMODEL_H
+#define WINDOWTASKMODEL_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+
+#ifdef Q_OS_WIN
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+class WindowTaskModel;
+
+// Данные об окне приложения. id - стабильный идентификатор (HWND) на все время жизни окна
+struct TaskWindowInfo {
+    quintptr id = 0;
+    QString title;
+    QString processName;   // Имя исполняемого файла в нижнем регистре
+    quint32 processId = 0;
+    quint64 zOrder = 0;    // Порядок активации: больше - выше
+};
+
+// Источник данных об окнах. Позволяет подменить WinAPI (например, заглушкой)
+class WindowSystemBackend
+{
+public:
+    virtual ~WindowSystemBackend() = default;
+
+    // Полное перечисление окон верхнего уровня, сверху вниз по z-order.
+    // Используется только при первичной загрузке и ресинхронизации
+    virtual QList<quintptr> enumerateWindows() const = 0;
+
+    // Читает данные окна. false - окно не должно отображаться в доке
+    virtual bool queryWindow(quintptr window, TaskWindowInfo& info) const = 0;
+
+    // Только заголовок окна (без запроса процесса)
+    virtual QString windowTitle(quintptr window) const = 0;
+
+    // ID процесса видимого окна верхнего уровня, которое пока не попало
+    // в модель только из-за пустого заголовка; 0 - окно не ждет заголовка
+    virtual quint32 untitledWindowProcess(quintptr window) const
+    {
+        Q_UNUSED(window);
+        return 0;
+    }
+
+    // Подписка на уведомления об окнах. false - уведомлений не будет
+    virtual bool installHooks(WindowTaskModel* model) = 0;
+    virtual void removeHooks() = 0;
+
+    // Изменения заголовков нужны только для процессов с окнами в модели:
+    // глобальная подписка будила бы док при смене любой подписи в системе
+    virtual void setTitleWatch(quint32 processId, bool watch)
+    {
+        Q_UNUSED(processId);
+        Q_UNUSED(watch);
+    }
+};
+
+// Модель окон для дока. Хранит окна по стабильному идентификатору
+// с индексом по имени процесса и обновляется инкрементально по событиям,
+// поэтому выбор окна и превью не перечисляют все окна системы.
+class WindowTaskModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    static WindowTaskModel& instance();
+
+    // Заменяет источник данных (модель становится его владельцем) и перечитывает окна
+    void setBackend(WindowSystemBackend* backend);
+
+    // true - модель получает уведомления и ее данные актуальны
+    bool isLive() const { return m_live; }
+
+    const TaskWindowInfo* window(quintptr id) const;
+    bool hasWindowsForProcess(const QString& processName) const;
+    // Окна процесса, отсортированные сверху вниз
+    QList<TaskWindowInfo> windowsForProcess(const QString& processName) const;
+    int windowCount() const { return m_windows.size(); }
+
+    // Полная ресинхронизация с системой
+    void resync();
+
+    // Вызываются источником данных при изменениях
+    void notifyWindowShown(quintptr id);
+    void notifyWindowHidden(quintptr id);
+    void notifyWindowDestroyed(quintptr id);
+    void notifyTitleChanged(quintptr id);
+    void notifyWindowActivated(quintptr id);
+
+signals:
+    void windowAdded(quintptr id);
+    void windowRemoved(quintptr id);
+    void windowChanged(quintptr id);
+    // Окно стало активным (на переднем плане)
+    void windowActivated(quintptr id);
+
+private:
+    WindowTaskModel();
+    ~WindowTaskModel();
+
+    void insertWindow(const TaskWindowInfo& info);
+    void removeWindow(quintptr id);
+    void trackUntitledWindow(quintptr id);
+    void forgetUntitledWindow(quintptr id);
+    void updateWindow(quintptr id);
+    void retainProcess(quint32 processId);
+    void releaseProcess(quint32 processId);
+
+    WindowSystemBackend* m_backend;
+    bool m_live;
+    quint64 m_zCounter;
+    QHash<quintptr, TaskWindowInfo> m_windows;
+    QHash<QString, QSet<quintptr>> m_windowsByProcess;
+    // Показанные окна без заголовка (ID окна -> ID процесса): заголовок
+    // часто задается после EVENT_OBJECT_SHOW, окно попадет в модель по нему
+    QHash<quintptr, quint32> m_untitledWindows;
+    // Число окон модели и окон без заголовка по ID процесса - для подписки на заголовки
+    QHash<quint32, int> m_processWindowCounts;
+};
+
+#ifdef Q_OS_WIN
+// Проверяет, является ли окно окном приложения для дока, и заполняет его данные
+bool ReadTaskWindowInfo(HWND hwnd, TaskWindowInfo& info);
+#endif
+
+#endif // WINDOWTASKMODEL_H
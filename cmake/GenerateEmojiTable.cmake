@@ -0,0 +1,232 @@
+# Генерация constexpr-таблицы эмодзи из emoji_data.json.
+# Вызов: cmake -DEMOJI_DATA=<emoji_data.json> -DOUTPUT=<EmojiTable.h> -P GenerateEmojiTable.cmake
+#
+# Формат входного файла - по одной записи в строке:
+#   // Категория
+#   {"😀", {"ключевое", "слово"}, {"english", "keywords"}},
+#   {"👍", {"палец", "вверх"}, {"thumbs", "up"}, skin},
+# Вторая группа ключевых слов (английские) необязательна, метка skin
+# добавляет после записи пять вариантов с модификаторами оттенка кожи.
+# Повтор эмодзи добавляет ключевые слова к первой записи,
+# повтор заголовка категории продолжает существующую категорию.
+
+cmake_minimum_required(VERSION 3.20)
+
+if(NOT EMOJI_DATA OR NOT OUTPUT)
+    message(FATAL_ERROR "EMOJI_DATA and OUTPUT must be set")
+endif()
+
+file(STRINGS "${EMOJI_DATA}" DATA_LINES ENCODING UTF-8)
+
+set(CATEGORY_COUNT 0)
+set(EMOJI_COUNT 0)
+set(KEYWORD_COUNT 0)
+set(DUPLICATE_COUNT 0)
+set(CURRENT_CATEGORY -1)
+set(LINE_NUMBER 0)
+
+# Модификаторы оттенка кожи U+1F3FB..U+1F3FF
+set(SKIN_TONES "🏻" "🏼" "🏽" "🏾" "🏿")
+
+foreach(DATA_LINE IN LISTS DATA_LINES)
+    math(EXPR LINE_NUMBER "${LINE_NUMBER} + 1")
+    string(STRIP "${DATA_LINE}" DATA_LINE)
+
+    if(DATA_LINE STREQUAL "")
+        continue()
+    endif()
+
+    # Заголовок категории
+    if(DATA_LINE MATCHES "^//[ \t]*(.+)$")
+        set(CATEGORY_NAME "${CMAKE_MATCH_1}")
+        string(MD5 CATEGORY_KEY "${CATEGORY_NAME}")
+        if(DEFINED CATEGORY_ID_${CATEGORY_KEY})
+            set(CURRENT_CATEGORY ${CATEGORY_ID_${CATEGORY_KEY}})
+        else()
+            set(CURRENT_CATEGORY ${CATEGORY_COUNT})
+            set(CATEGORY_ID_${CATEGORY_KEY} ${CATEGORY_COUNT})
+            set(CATEGORY_NAME_${CATEGORY_COUNT} "${CATEGORY_NAME}")
+            math(EXPR CATEGORY_COUNT "${CATEGORY_COUNT} + 1")
+        endif()
+        continue()
+    endif()
+
+    if(NOT DATA_LINE MATCHES "^{\"([^\"]+)\", {([^}]*)}(, {([^}]*)})?(, skin)?},?$")
+        message(FATAL_ERROR "${EMOJI_DATA}:${LINE_NUMBER}: unexpected line: ${DATA_LINE}")
+    endif()
+    if(CURRENT_CATEGORY LESS 0)
+        message(FATAL_ERROR "${EMOJI_DATA}:${LINE_NUMBER}: emoji before the first category")
+    endif()
+
+    set(EMOJI "${CMAKE_MATCH_1}")
+    set(HAS_SKIN_TONES OFF)
+    if(CMAKE_MATCH_5)
+        set(HAS_SKIN_TONES ON)
+    endif()
+    string(REGEX MATCHALL "\"[^\"]+\"" QUOTED_KEYWORDS "${CMAKE_MATCH_2};${CMAKE_MATCH_4}")
+
+    string(MD5 EMOJI_KEY "${EMOJI}")
+    if(DEFINED EMOJI_ROW_${EMOJI_KEY})
+        set(ROW ${EMOJI_ROW_${EMOJI_KEY}})
+        math(EXPR DUPLICATE_COUNT "${DUPLICATE_COUNT} + 1")
+    else()
+        set(ROW ${EMOJI_COUNT})
+        set(EMOJI_ROW_${EMOJI_KEY} ${ROW})
+        set(EMOJI_TEXT_${ROW} "${EMOJI}")
+        set(EMOJI_CATEGORY_${ROW} ${CURRENT_CATEGORY})
+        set(EMOJI_KEYWORDS_${ROW} "")
+        set(EMOJI_SKIN_${ROW} OFF)
+        math(EXPR EMOJI_COUNT "${EMOJI_COUNT} + 1")
+    endif()
+    if(HAS_SKIN_TONES)
+        set(EMOJI_SKIN_${ROW} ON)
+    endif()
+
+    # Ключевые слова хранятся один раз, записи ссылаются на них по номеру
+    foreach(QUOTED_KEYWORD IN LISTS QUOTED_KEYWORDS)
+        string(REGEX REPLACE "^\"(.*)\"$" "\\1" KEYWORD "${QUOTED_KEYWORD}")
+        string(MD5 KEYWORD_KEY "${KEYWORD}")
+        if(NOT DEFINED KEYWORD_ID_${KEYWORD_KEY})
+            set(KEYWORD_ID_${KEYWORD_KEY} ${KEYWORD_COUNT})
+            set(KEYWORD_TEXT_${KEYWORD_COUNT} "${KEYWORD}")
+            math(EXPR KEYWORD_COUNT "${KEYWORD_COUNT} + 1")
+        endif()
+
+        set(KEYWORD_ID ${KEYWORD_ID_${KEYWORD_KEY}})
+        if(NOT KEYWORD_ID IN_LIST EMOJI_KEYWORDS_${ROW})
+            list(APPEND EMOJI_KEYWORDS_${ROW} ${KEYWORD_ID})
+        endif()
+    endforeach()
+endforeach()
+
+if(EMOJI_COUNT EQUAL 0)
+    message(FATAL_ERROR "${EMOJI_DATA}: no emoji found")
+endif()
+
+set(STRING_BYTES 0)
+
+set(CATEGORY_LINES "")
+math(EXPR LAST_CATEGORY "${CATEGORY_COUNT} - 1")
+foreach(CATEGORY RANGE ${LAST_CATEGORY})
+    string(LENGTH "${CATEGORY_NAME_${CATEGORY}}" BYTES)
+    math(EXPR STRING_BYTES "${STRING_BYTES} + ${BYTES}")
+    string(APPEND CATEGORY_LINES "    \"${CATEGORY_NAME_${CATEGORY}}\",\n")
+endforeach()
+
+set(KEYWORD_LINES "")
+math(EXPR LAST_KEYWORD "${KEYWORD_COUNT} - 1")
+foreach(KEYWORD RANGE ${LAST_KEYWORD})
+    string(LENGTH "${KEYWORD_TEXT_${KEYWORD}}" BYTES)
+    math(EXPR STRING_BYTES "${STRING_BYTES} + ${BYTES}")
+    string(APPEND KEYWORD_LINES "    \"${KEYWORD_TEXT_${KEYWORD}}\",\n")
+endforeach()
+
+# Вариант с оттенком кожи: модификатор ставится после первого символа,
+# селектор варианта U+FE0F после него отбрасывается
+function(make_skin_variant EMOJI TONE RESULT)
+    string(HEX "${EMOJI}" EMOJI_HEX)
+    string(SUBSTRING "${EMOJI_HEX}" 0 2 FIRST_BYTE)
+    if(FIRST_BYTE MATCHES "^f")
+        set(FIRST_LENGTH 4)
+    elseif(FIRST_BYTE MATCHES "^e")
+        set(FIRST_LENGTH 3)
+    elseif(FIRST_BYTE MATCHES "^[cd]")
+        set(FIRST_LENGTH 2)
+    else()
+        set(FIRST_LENGTH 1)
+    endif()
+
+    string(SUBSTRING "${EMOJI}" 0 ${FIRST_LENGTH} HEAD)
+    string(SUBSTRING "${EMOJI}" ${FIRST_LENGTH} -1 TAIL)
+    math(EXPR TAIL_HEX_START "${FIRST_LENGTH} * 2")
+    string(SUBSTRING "${EMOJI_HEX}" ${TAIL_HEX_START} 6 TAIL_PREFIX)
+    if(TAIL_PREFIX STREQUAL "efb88f")
+        string(SUBSTRING "${TAIL}" 3 -1 TAIL)
+    endif()
+
+    set(${RESULT} "${HEAD}${TONE}${TAIL}" PARENT_SCOPE)
+endfunction()
+
+set(EMOJI_LINES "")
+set(REF_LINES "")
+set(REF_COUNT 0)
+set(RECORD_COUNT 0)
+math(EXPR LAST_ROW "${EMOJI_COUNT} - 1")
+foreach(ROW RANGE ${LAST_ROW})
+    list(LENGTH EMOJI_KEYWORDS_${ROW} ROW_KEYWORD_COUNT)
+    if(ROW_KEYWORD_COUNT GREATER 255)
+        message(FATAL_ERROR "${EMOJI_TEXT_${ROW}}: too many keywords")
+    endif()
+
+    string(LENGTH "${EMOJI_TEXT_${ROW}}" BYTES)
+    math(EXPR STRING_BYTES "${STRING_BYTES} + ${BYTES}")
+    if(EMOJI_SKIN_${ROW})
+        string(APPEND EMOJI_LINES "    {\"${EMOJI_TEXT_${ROW}}\", ${REF_COUNT}, ${ROW_KEYWORD_COUNT}, ${EMOJI_CATEGORY_${ROW}}, 0, true},\n")
+    else()
+        string(APPEND EMOJI_LINES "    {\"${EMOJI_TEXT_${ROW}}\", ${REF_COUNT}, ${ROW_KEYWORD_COUNT}, ${EMOJI_CATEGORY_${ROW}}, 0, false},\n")
+    endif()
+    math(EXPR RECORD_COUNT "${RECORD_COUNT} + 1")
+
+    # Варианты идут сразу за основной записью и ссылаются на ее ключевые слова
+    if(EMOJI_SKIN_${ROW})
+        set(TONE_NUMBER 0)
+        foreach(TONE IN LISTS SKIN_TONES)
+            math(EXPR TONE_NUMBER "${TONE_NUMBER} + 1")
+            make_skin_variant("${EMOJI_TEXT_${ROW}}" "${TONE}" VARIANT)
+            string(LENGTH "${VARIANT}" BYTES)
+            math(EXPR STRING_BYTES "${STRING_BYTES} + ${BYTES}")
+            string(APPEND EMOJI_LINES "    {\"${VARIANT}\", ${REF_COUNT}, ${ROW_KEYWORD_COUNT}, ${EMOJI_CATEGORY_${ROW}}, ${TONE_NUMBER}, false},\n")
+            math(EXPR RECORD_COUNT "${RECORD_COUNT} + 1")
+        endforeach()
+    endif()
+
+    if(ROW_KEYWORD_COUNT GREATER 0)
+        string(REPLACE ";" ", " ROW_REFS "${EMOJI_KEYWORDS_${ROW}}")
+        string(APPEND REF_LINES "    ${ROW_REFS},\n")
+        math(EXPR REF_COUNT "${REF_COUNT} + ${ROW_KEYWORD_COUNT}")
+    endif()
+endforeach()
+
+if(REF_COUNT GREATER 65535 OR KEYWORD_COUNT GREATER 65535 OR CATEGORY_COUNT GREATER 255)
+    message(FATAL_ERROR "${EMOJI_DATA}: table does not fit into 16-bit offsets")
+endif()
+
+get_filename_component(DATA_NAME "${EMOJI_DATA}" NAME)
+set(TABLE_CONTENT "// Сгенерировано cmake/GenerateEmojiTable.cmake из ${DATA_NAME} - не редактировать.
+// Включается только из EmojiList.cpp (после EmojiList.h)
+
+namespace EmojiTable {
+
+inline constexpr std::string_view categories[] = {
+${CATEGORY_LINES}};
+
+inline constexpr std::string_view keywords[] = {
+${KEYWORD_LINES}};
+
+// Номера ключевых слов записей подряд, EmojiRecord::firstKeyword - смещение в массиве
+inline constexpr quint16 keywordRefs[] = {
+${REF_LINES}};
+
+inline constexpr EmojiRecord emojis[] = {
+${EMOJI_LINES}};
+
+// Объем строковых данных таблицы, байт
+inline constexpr std::size_t stringBytes = ${STRING_BYTES};
+
+} // namespace EmojiTable
+")
+
+# Файл перезаписывается только при изменении, чтобы не пересобирать зависимые файлы.
+# Время изменения все равно обновляется: иначе выход остается старше входов,
+# и генераторы без restat (Make, Visual Studio) запускают команду при каждой сборке
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" OLD_CONTENT)
+    if(OLD_CONTENT STREQUAL TABLE_CONTENT)
+        file(TOUCH "${OUTPUT}")
+        return()
+    endif()
+endif()
+
+file(WRITE "${OUTPUT}" "${TABLE_CONTENT}")
+message(STATUS "Emoji table: ${EMOJI_COUNT} emoji, ${RECORD_COUNT} records with skin tones (${DUPLICATE_COUNT} duplicates merged), "
+               "${KEYWORD_COUNT} keywords, ${CATEGORY_COUNT} categories, ${STRING_BYTES} bytes of strings")
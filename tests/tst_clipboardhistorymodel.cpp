@@ -0,0 +1,225 @@
+#include "Extensions/ClipboardHistoryModel.h"
+#include "Extensions/ClipboardHistoryStore.h"
+#include "Extensions/ClipboardPreviewLoader.h"
+
+#include <QStandardPaths>
+#include <QStyleOptionViewItem>
+#include <QTemporaryDir>
+#include <QtTest>
+
+namespace {
+
+const int kBenchmarkEntries = 10000;
+// Размер истории по умолчанию - столько строк в модели при обновлении
+const int kModelRows = 1000;
+
+QString snippet(int i)
+{
+    return QString("clipboard snippet #%1").arg(i);
+}
+
+} // namespace
+
+class ClipboardHistoryModelTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void sizeHintDoesNotLoadEntries();
+    void loadedImagePathRelayoutsRows();
+    void rowsFollowStoreChanges();
+
+    void benchmarkSizeHintAllRows();
+    void benchmarkUpdate1000Rows_data();
+    void benchmarkUpdate1000Rows();
+
+private:
+    // Журнал из count записей, прочитанный заново - старые записи не загружены
+    ClipboardHistoryStore* createReloadedStore(int count, const QString& oldestText);
+    QStyleOptionViewItem viewOption() const;
+    static QList<QByteArray> modelHashes(const ClipboardHistoryModel& model);
+
+    QTemporaryDir* m_dir = nullptr;
+};
+
+void ClipboardHistoryModelTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void ClipboardHistoryModelTest::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+}
+
+void ClipboardHistoryModelTest::cleanup()
+{
+    delete m_dir;
+    m_dir = nullptr;
+}
+
+ClipboardHistoryStore* ClipboardHistoryModelTest::createReloadedStore(int count, const QString& oldestText)
+{
+    const QString logPath = m_dir->filePath("history.log");
+    {
+        ClipboardHistoryStore store(logPath);
+        store.setRetention(count, 0, 0);
+        store.load();
+        store.addText(oldestText);
+        for (int i = 1; i < count; ++i) {
+            store.addText(snippet(i));
+        }
+    }
+
+    ClipboardHistoryStore* store = new ClipboardHistoryStore(logPath, this);
+    store->load();
+    return store;
+}
+
+QStyleOptionViewItem ClipboardHistoryModelTest::viewOption() const
+{
+    QStyleOptionViewItem option;
+    option.rect = QRect(0, 0, 400, 40);
+    return option;
+}
+
+QList<QByteArray> ClipboardHistoryModelTest::modelHashes(const ClipboardHistoryModel& model)
+{
+    QList<QByteArray> hashes;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        hashes.append(model.index(row).data(ClipboardHistoryModel::HashRole).toByteArray());
+    }
+    return hashes;
+}
+
+void ClipboardHistoryModelTest::sizeHintDoesNotLoadEntries()
+{
+    const int count = ClipboardHistoryStore::PRELOAD_COUNT * 3;
+    QScopedPointer<ClipboardHistoryStore> store(createReloadedStore(count, "oldest"));
+    ClipboardPreviewLoader previewLoader;
+    ClipboardHistoryModel model(store.data(), &previewLoader);
+    ClipboardHistoryDelegate delegate;
+
+    QCOMPARE(model.rowCount(), count);
+    const QStyleOptionViewItem option = viewOption();
+    for (int row = 0; row < model.rowCount(); ++row) {
+        QVERIFY(delegate.sizeHint(option, model.index(row)).height() > 0);
+    }
+
+    const QByteArray oldest = model.index(count - 1).data(ClipboardHistoryModel::HashRole).toByteArray();
+    QVERIFY(!store->cachedEntry(oldest)->loaded);
+}
+
+void ClipboardHistoryModelTest::loadedImagePathRelayoutsRows()
+{
+    const int count = ClipboardHistoryStore::PRELOAD_COUNT * 2;
+    QScopedPointer<ClipboardHistoryStore> store(createReloadedStore(count, "file:///tmp/picture.png"));
+    ClipboardPreviewLoader previewLoader;
+    ClipboardHistoryModel model(store.data(), &previewLoader);
+    ClipboardHistoryDelegate delegate;
+    QSignalSpy relayout(&model, &ClipboardHistoryModel::rowHeightsChanged);
+
+    // До загрузки строка оценивается как текстовая
+    const QModelIndex oldest = model.index(count - 1);
+    const QStyleOptionViewItem option = viewOption();
+    const int textHeight = delegate.sizeHint(option, oldest).height();
+    QVERIFY(!oldest.data(ClipboardHistoryModel::ImageRowHintRole).toBool());
+
+    // Отрисовка загружает запись - раскладка пересчитывается один раз
+    oldest.data(Qt::DisplayRole);
+    oldest.data(Qt::ToolTipRole);
+    QVERIFY(relayout.wait());
+    QCOMPARE(relayout.count(), 1);
+
+    QVERIFY(oldest.data(ClipboardHistoryModel::ImageRowHintRole).toBool());
+    QVERIFY(delegate.sizeHint(option, oldest).height() > textHeight);
+}
+
+void ClipboardHistoryModelTest::rowsFollowStoreChanges()
+{
+    QScopedPointer<ClipboardHistoryStore> store(createReloadedStore(50, snippet(0)));
+    store->setRetention(50, 0, 0);
+    ClipboardPreviewLoader previewLoader;
+    ClipboardHistoryModel model(store.data(), &previewLoader);
+    QSignalSpy moved(&model, &QAbstractItemModel::rowsMoved);
+
+    // Перемещение, удаление из середины и вставка с вытеснением старых записей
+    const QList<QByteArray> initial = store->hashes();
+    store->moveToFront(initial.at(10));
+    store->moveToFront(initial.at(49));
+    store->remove(initial.at(25));
+    store->moveToFront(initial.at(30));
+    for (int i = 0; i < 5; ++i) {
+        store->addText(QString("new entry #%1").arg(i));
+    }
+    store->moveToFront(initial.at(10));
+
+    QCOMPARE(moved.count(), 4);
+    QCOMPARE(modelHashes(model), store->hashes());
+
+    // Повторное перемещение первой строки ничего не двигает
+    store->moveToFront(store->hashes().first());
+    QCOMPARE(moved.count(), 4);
+}
+
+void ClipboardHistoryModelTest::benchmarkSizeHintAllRows()
+{
+    QScopedPointer<ClipboardHistoryStore> store(createReloadedStore(kBenchmarkEntries, snippet(0)));
+    ClipboardPreviewLoader previewLoader;
+    ClipboardHistoryModel model(store.data(), &previewLoader);
+    ClipboardHistoryDelegate delegate;
+    const QStyleOptionViewItem option = viewOption();
+
+    // Раскладка списка запрашивает высоту каждой строки
+    QBENCHMARK {
+        int height = 0;
+        for (int row = 0; row < model.rowCount(); ++row) {
+            height += delegate.sizeHint(option, model.index(row)).height();
+        }
+        QVERIFY(height > 0);
+    }
+
+    QVERIFY(!store->cachedEntry(store->hashes().last())->loaded);
+}
+
+void ClipboardHistoryModelTest::benchmarkUpdate1000Rows_data()
+{
+    QTest::addColumn<int>("movedRow");
+
+    // -1 - новая запись в начало (самая старая вытесняется)
+    QTest::newRow("insert") << -1;
+    QTest::newRow("move recent") << 10;
+    QTest::newRow("move oldest") << kModelRows - 1;
+}
+
+void ClipboardHistoryModelTest::benchmarkUpdate1000Rows()
+{
+    QFETCH(int, movedRow);
+
+    QScopedPointer<ClipboardHistoryStore> store(createReloadedStore(kModelRows, snippet(0)));
+    store->setRetention(kModelRows, 0, 0);
+    ClipboardPreviewLoader previewLoader;
+    ClipboardHistoryModel model(store.data(), &previewLoader);
+    QCOMPARE(model.rowCount(), kModelRows);
+
+    // Копирование в буфер: хранилище и модель обновляются вместе
+    int next = kModelRows;
+    QBENCHMARK {
+        if (movedRow < 0) {
+            store->addText(snippet(next++));
+        } else {
+            store->moveToFront(model.index(movedRow).data(ClipboardHistoryModel::HashRole).toByteArray());
+        }
+    }
+
+    QCOMPARE(model.rowCount(), kModelRows);
+    QCOMPARE(modelHashes(model), store->hashes());
+}
+
+QTEST_MAIN(ClipboardHistoryModelTest)
+#include "tst_clipboardhistorymodel.moc"
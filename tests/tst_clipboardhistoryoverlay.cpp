@@ -0,0 +1,112 @@
+#include "Extensions/ClipboardHistoryOverlay.h"
+#include "Extensions/EmojiGlyphAtlas.h"
+#include "Extensions/EmojiGridView.h"
+#include "Extensions/EmojiUsageTracker.h"
+
+#include <QElapsedTimer>
+#include <QStandardPaths>
+#include <QTabWidget>
+#include <QtTest>
+
+class ClipboardHistoryOverlayTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void creationDoesNotBuildEmojiTab();
+    void firstShowTime();
+    void emojiTabFirstShowTime();
+    void prewarmRasterizesFirstScreenOnly();
+
+    void benchmarkCreate();
+
+private:
+    static EmojiGridView* emojiGrid(const ClipboardHistoryOverlay& overlay);
+};
+
+void ClipboardHistoryOverlayTest::initTestCase()
+{
+    // История и настройки теста не смешиваются с пользовательскими
+    QStandardPaths::setTestModeEnabled(true);
+    EmojiUsageTracker::instance().clear();
+}
+
+EmojiGridView* ClipboardHistoryOverlayTest::emojiGrid(const ClipboardHistoryOverlay& overlay)
+{
+    return overlay.findChild<EmojiGridView*>();
+}
+
+void ClipboardHistoryOverlayTest::creationDoesNotBuildEmojiTab()
+{
+    QElapsedTimer timer;
+    timer.start();
+    ClipboardHistoryOverlay overlay;
+    qDebug() << "create:" << timer.nsecsElapsed() / 1000 << "us";
+
+    // Вкладка эмодзи строится при первом переключении или прогреве
+    QVERIFY(!emojiGrid(overlay));
+}
+
+void ClipboardHistoryOverlayTest::firstShowTime()
+{
+    ClipboardHistoryOverlay overlay;
+
+    // Путь горячей клавиши: от вызова до окна на экране
+    QElapsedTimer timer;
+    timer.start();
+    overlay.toggleVisibility();
+    const qint64 showUs = timer.nsecsElapsed() / 1000;
+    QVERIFY(QTest::qWaitForWindowExposed(&overlay));
+    qDebug() << "first show:" << showUs << "us, exposed after" << timer.nsecsElapsed() / 1000 << "us";
+
+    QVERIFY(!emojiGrid(overlay));
+}
+
+void ClipboardHistoryOverlayTest::emojiTabFirstShowTime()
+{
+    ClipboardHistoryOverlay overlay;
+    overlay.toggleVisibility();
+    QVERIFY(QTest::qWaitForWindowExposed(&overlay));
+
+    // Переключение на вкладку строит ее; глифы первого экрана готовятся в фоне
+    QElapsedTimer timer;
+    timer.start();
+    overlay.findChild<QTabWidget*>()->setCurrentIndex(1);
+    const qint64 switchUs = timer.nsecsElapsed() / 1000;
+
+    EmojiGridView* grid = emojiGrid(overlay);
+    QVERIFY(grid);
+    grid->viewport()->repaint();
+    QTRY_VERIFY(grid->glyphAtlas()->glyphCount() > 0 && !grid->glyphAtlas()->isBusy());
+    qDebug() << "emoji tab: switch" << switchUs << "us, glyphs ready after" << timer.nsecsElapsed() / 1000 << "us,"
+             << grid->glyphAtlas()->glyphCount() << "glyphs";
+}
+
+void ClipboardHistoryOverlayTest::prewarmRasterizesFirstScreenOnly()
+{
+    ClipboardHistoryOverlay overlay;
+
+    // Прогрев строит вкладку, не показывая оверлей
+    QTRY_VERIFY_WITH_TIMEOUT(emojiGrid(overlay), ClipboardHistoryOverlay::EMOJI_PREWARM_DELAY * 2);
+    EmojiGridView* grid = emojiGrid(overlay);
+    QTRY_VERIFY(!grid->glyphAtlas()->isBusy());
+
+    const int columns = ClipboardHistoryOverlay::TAB_WIDTH / EmojiGridView::CELL_SIZE.width();
+    const int rows = ClipboardHistoryOverlay::EMOJI_TAB_HEIGHT / EmojiGridView::CELL_SIZE.height() + 1;
+    QVERIFY(grid->glyphAtlas()->glyphCount() > 0);
+    QVERIFY(grid->glyphAtlas()->glyphCount() <= columns * rows);
+    qDebug() << "prewarm:" << grid->glyphAtlas()->glyphCount() << "glyphs,"
+             << grid->glyphAtlas()->memoryBytes() / 1024 << "KB";
+}
+
+void ClipboardHistoryOverlayTest::benchmarkCreate()
+{
+    QBENCHMARK {
+        ClipboardHistoryOverlay overlay;
+    }
+}
+
+QTEST_MAIN(ClipboardHistoryOverlayTest)
+#include "tst_clipboardhistoryoverlay.moc"
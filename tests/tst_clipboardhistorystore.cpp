@@ -0,0 +1,339 @@
+#include "Extensions/ClipboardHistoryStore.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QMimeData>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <QtTest>
+
+namespace {
+
+const int kBenchmarkEntries = 100000;
+
+QString windowsFormat(const char* name)
+{
+    return QString("application/x-qt-windows-mime;value=\"%1\"").arg(name);
+}
+
+QByteArray dword(quint32 value)
+{
+    QByteArray data(sizeof(value), '\0');
+    qToLittleEndian(value, data.data());
+    return data;
+}
+
+QImage testImage(QRgb color)
+{
+    QImage image(320, 200, QImage::Format_ARGB32);
+    image.fill(color);
+    return image;
+}
+
+QString snippet(int i)
+{
+    return QString("clipboard snippet #%1 with some typical text around it").arg(i);
+}
+
+} // namespace
+
+class ClipboardHistoryStoreTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void addTextDeduplicatesAndMovesToFront();
+    void historySurvivesReload();
+    void retentionEvictsOldestText();
+    void lazyLoadingReadsOldTextsOnDemand();
+    void sensitiveContentIsExcluded();
+    void imageThumbnailSurvivesReload();
+    void imageFileSurvivesRemovalDuringIngest();
+    void imageFileKeepsOriginalBytes();
+    void thumbnailMemoryStaysSmall_data();
+    void thumbnailMemoryStaysSmall();
+
+    void benchmarkInsert100k();
+    void benchmarkDedup100k();
+
+private:
+    ClipboardHistoryStore* createStore();
+
+    QTemporaryDir* m_dir = nullptr;
+};
+
+void ClipboardHistoryStoreTest::initTestCase()
+{
+    // Настройки теста не смешиваются с настройками пользователя
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void ClipboardHistoryStoreTest::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+}
+
+void ClipboardHistoryStoreTest::cleanup()
+{
+    delete m_dir;
+    m_dir = nullptr;
+}
+
+ClipboardHistoryStore* ClipboardHistoryStoreTest::createStore()
+{
+    ClipboardHistoryStore* store = new ClipboardHistoryStore(m_dir->filePath("history.log"), this);
+    store->setRetention(ClipboardHistoryStore::DEFAULT_MAX_COUNT, ClipboardHistoryStore::DEFAULT_MAX_BYTES, 0);
+    store->load();
+    return store;
+}
+
+void ClipboardHistoryStoreTest::addTextDeduplicatesAndMovesToFront()
+{
+    QScopedPointer<ClipboardHistoryStore> store(createStore());
+
+    const QByteArray first = store->addText("first");
+    store->addText("second");
+    QCOMPARE(store->hashes().first(), ClipboardHistoryStore::hashText("second"));
+
+    QCOMPARE(store->addText("first"), first);
+    QCOMPARE(store->count(), 2);
+    QCOMPARE(store->hashes().first(), first);
+}
+
+void ClipboardHistoryStoreTest::historySurvivesReload()
+{
+    {
+        QScopedPointer<ClipboardHistoryStore> store(createStore());
+        store->addText("one");
+        store->addText("two");
+        store->addText("one");
+        store->remove(ClipboardHistoryStore::hashText("two"));
+        store->addText("three");
+    }
+
+    QScopedPointer<ClipboardHistoryStore> store(createStore());
+    QCOMPARE(store->count(), 2);
+    QCOMPARE(store->text(store->hashes().at(0)), QString("three"));
+    QCOMPARE(store->text(store->hashes().at(1)), QString("one"));
+}
+
+void ClipboardHistoryStoreTest::retentionEvictsOldestText()
+{
+    QScopedPointer<ClipboardHistoryStore> store(createStore());
+    store->setRetention(3, 0, 0);
+
+    for (int i = 0; i < 5; ++i) {
+        store->addText(snippet(i));
+    }
+
+    QCOMPARE(store->count(), 3);
+    QVERIFY(!store->contains(ClipboardHistoryStore::hashText(snippet(0))));
+    QVERIFY(store->contains(ClipboardHistoryStore::hashText(snippet(4))));
+}
+
+void ClipboardHistoryStoreTest::lazyLoadingReadsOldTextsOnDemand()
+{
+    const int count = ClipboardHistoryStore::PRELOAD_COUNT * 3;
+    {
+        QScopedPointer<ClipboardHistoryStore> store(createStore());
+        for (int i = 0; i < count; ++i) {
+            store->addText(snippet(i));
+        }
+    }
+
+    QScopedPointer<ClipboardHistoryStore> store(createStore());
+    QCOMPARE(store->count(), count);
+
+    // Самая старая запись не загружена, пока к ней не обратились
+    const QByteArray oldest = store->hashes().last();
+    QVERIFY(!store->cachedEntry(oldest)->loaded);
+    QCOMPARE(store->text(oldest), snippet(0));
+    QVERIFY(store->cachedEntry(oldest)->loaded);
+}
+
+void ClipboardHistoryStoreTest::sensitiveContentIsExcluded()
+{
+    QMimeData plain;
+    plain.setText("hello");
+    QVERIFY(!ClipboardHistoryStore::isExcludedFromHistory(&plain));
+    QVERIFY(!ClipboardHistoryStore::isExcludedFromHistory(nullptr));
+
+    QMimeData excluded;
+    excluded.setText("password");
+    excluded.setData(windowsFormat("ExcludeClipboardContentFromMonitorProcessing"), QByteArray());
+    QVERIFY(ClipboardHistoryStore::isExcludedFromHistory(&excluded));
+
+    QMimeData notInHistory;
+    notInHistory.setText("password");
+    notInHistory.setData(windowsFormat("CanIncludeInClipboardHistory"), dword(0));
+    QVERIFY(ClipboardHistoryStore::isExcludedFromHistory(&notInHistory));
+
+    QMimeData allowed;
+    allowed.setText("text");
+    allowed.setData(windowsFormat("CanIncludeInClipboardHistory"), dword(1));
+    QVERIFY(!ClipboardHistoryStore::isExcludedFromHistory(&allowed));
+}
+
+void ClipboardHistoryStoreTest::imageThumbnailSurvivesReload()
+{
+    QByteArray hash;
+    {
+        QScopedPointer<ClipboardHistoryStore> store(createStore());
+        QSignalSpy added(store.data(), &ClipboardHistoryStore::imageAdded);
+        store->addImage(testImage(qRgb(200, 40, 40)));
+        QVERIFY(added.wait());
+        hash = added.first().first().toByteArray();
+    }
+
+    QScopedPointer<ClipboardHistoryStore> store(createStore());
+    const ClipboardEntry* entry = store->entry(hash);
+    QVERIFY(entry);
+    QCOMPARE(entry->type, ClipboardEntry::Image);
+    QVERIFY(!entry->thumbnail.isNull());
+    QVERIFY(QFileInfo::exists(store->imagePath(hash)));
+}
+
+void ClipboardHistoryStoreTest::imageFileSurvivesRemovalDuringIngest()
+{
+    QScopedPointer<ClipboardHistoryStore> store(createStore());
+    const QImage image = testImage(qRgb(40, 200, 40));
+
+    QSignalSpy added(store.data(), &ClipboardHistoryStore::imageAdded);
+    store->addImage(image);
+    QVERIFY(added.wait());
+    const QByteArray hash = added.first().first().toByteArray();
+
+    // Повторное копирование того же изображения, а запись удаляется до того,
+    // как результат фоновой обработки вернется в GUI-поток
+    store->addImage(image);
+    store->remove(hash);
+
+    QTRY_VERIFY(store->contains(hash));
+    QVERIFY(QFileInfo::exists(store->imagePath(hash)));
+    QVERIFY(!store->loadImage(hash).isNull());
+}
+
+void ClipboardHistoryStoreTest::imageFileKeepsOriginalBytes()
+{
+    QScopedPointer<ClipboardHistoryStore> store(createStore());
+
+    // Скопированный файл JPEG сохраняется байт в байт, без пересжатия в PNG
+    const QString source = m_dir->filePath("photo.jpg");
+    QVERIFY(testImage(qRgb(40, 40, 200)).save(source, "JPEG", 90));
+    QFile sourceFile(source);
+    QVERIFY(sourceFile.open(QIODevice::ReadOnly));
+    const QByteArray sourceBytes = sourceFile.readAll();
+
+    QSignalSpy added(store.data(), &ClipboardHistoryStore::imageAdded);
+    store->addImageFile(source);
+    QVERIFY(added.wait());
+    const QByteArray hash = added.first().first().toByteArray();
+
+    QFile stored(store->imagePath(hash));
+    QVERIFY(stored.open(QIODevice::ReadOnly));
+    QCOMPARE(stored.readAll(), sourceBytes);
+
+    const QImage image = store->loadImage(hash);
+    QCOMPARE(image.size(), QSize(320, 200));
+    QVERIFY(!store->entry(hash)->thumbnail.isNull());
+}
+
+void ClipboardHistoryStoreTest::thumbnailMemoryStaysSmall_data()
+{
+    QTest::addColumn<int>("imageCount");
+
+    QTest::newRow("15 images") << 15;
+    QTest::newRow("500 images") << 500;
+}
+
+void ClipboardHistoryStoreTest::thumbnailMemoryStaysSmall()
+{
+    QFETCH(int, imageCount);
+
+    QScopedPointer<ClipboardHistoryStore> store(createStore());
+    store->setMaxImageCount(imageCount);
+
+    QSignalSpy added(store.data(), &ClipboardHistoryStore::imageAdded);
+    qint64 originalBytes = 0;
+    for (int i = 0; i < imageCount; ++i) {
+        const QImage image = testImage(qRgb(i % 256, (i / 256) * 64, 128));
+        originalBytes += image.sizeInBytes();
+        store->addImage(image);
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(added.count(), imageCount, 60000);
+    QCOMPARE(store->count(), imageCount);
+
+    // В памяти только миниатюры: не больше THUMBNAIL_SIZE x THUMBNAIL_SIZE в 32 битах
+    const qint64 residentBytes = store->thumbnailMemoryBytes();
+    const qint64 thumbnailLimit = qint64(ClipboardHistoryStore::THUMBNAIL_SIZE)
+                                  * ClipboardHistoryStore::THUMBNAIL_SIZE * 4;
+    qDebug() << imageCount << "images: thumbnails" << residentBytes / 1024 << "KB in memory,"
+             << "originals" << originalBytes / 1024 << "KB";
+    QVERIFY(residentBytes > 0);
+    QVERIFY2(residentBytes <= imageCount * thumbnailLimit,
+             qPrintable(QString("%1 bytes for %2 images").arg(residentBytes).arg(imageCount)));
+    QVERIFY(residentBytes * 10 < originalBytes);
+}
+
+void ClipboardHistoryStoreTest::benchmarkInsert100k()
+{
+    // Уникальные записи с записью в журнал
+    QStringList texts;
+    texts.reserve(kBenchmarkEntries);
+    for (int i = 0; i < kBenchmarkEntries; ++i) {
+        texts.append(snippet(i));
+    }
+
+    QBENCHMARK_ONCE {
+        QScopedPointer<ClipboardHistoryStore> store(createStore());
+        store->setRetention(kBenchmarkEntries, 0, 0);
+
+        QElapsedTimer timer;
+        timer.start();
+        for (const QString& text : std::as_const(texts)) {
+            store->addText(text);
+        }
+        const qint64 elapsedMs = qMax<qint64>(timer.elapsed(), 1);
+
+        QCOMPARE(store->count(), kBenchmarkEntries);
+        qDebug() << "insert:" << kBenchmarkEntries * 1000 / elapsedMs << "entries/s,"
+                 << "log size:" << store->logSize() / 1024 << "KB";
+    }
+}
+
+void ClipboardHistoryStoreTest::benchmarkDedup100k()
+{
+    QScopedPointer<ClipboardHistoryStore> store(createStore());
+    store->setRetention(kBenchmarkEntries, 0, 0);
+
+    QStringList texts;
+    texts.reserve(kBenchmarkEntries);
+    for (int i = 0; i < kBenchmarkEntries; ++i) {
+        texts.append(snippet(i));
+        store->addText(texts.last());
+    }
+
+    // Повторное копирование существующих записей - поиск по хешу и перемещение в начало
+    QBENCHMARK_ONCE {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < kBenchmarkEntries; ++i) {
+            store->addText(texts.at((i * 7919) % kBenchmarkEntries));
+        }
+        const qint64 elapsedMs = qMax<qint64>(timer.elapsed(), 1);
+
+        QCOMPARE(store->count(), kBenchmarkEntries);
+        qDebug() << "dedup:" << kBenchmarkEntries * 1000 / elapsedMs << "entries/s";
+    }
+}
+
+QTEST_GUILESS_MAIN(ClipboardHistoryStoreTest)
+#include "tst_clipboardhistorystore.moc"
@@ -0,0 +1,176 @@
+#include "Extensions/ClipboardPreviewLoader.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <QScopeGuard>
+#include <QSemaphore>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QtTest>
+
+namespace {
+
+const int kFileCount = 200;
+// Интервал таймера, имитирующего кадры интерфейса
+const int kFrameIntervalMs = 16;
+// Сколько кадров GUI-поток должен отрисовать, пока декодирование задержано
+const int kFramesWhileDecoding = 5;
+
+QImage photoLikeImage(const QSize& size)
+{
+    QImage image(size, QImage::Format_RGB32);
+    QPainter painter(&image);
+    QLinearGradient gradient(0, 0, size.width(), size.height());
+    gradient.setColorAt(0, Qt::darkBlue);
+    gradient.setColorAt(0.5, Qt::yellow);
+    gradient.setColorAt(1, Qt::darkGreen);
+    painter.fillRect(image.rect(), gradient);
+    painter.setPen(Qt::white);
+    for (int x = 0; x < size.width(); x += 37) {
+        painter.drawLine(x, 0, size.width() - x, size.height());
+    }
+    return image;
+}
+
+} // namespace
+
+class ClipboardPreviewLoaderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void previewIsCachedAfterDecode();
+    void brokenFileIsMarkedFailed();
+    void cancelledRequestsDoNotReport();
+    void guiStaysResponsiveWhileDecoding();
+
+private:
+    QString filePath(int index) const;
+
+    QTemporaryDir m_dir;
+};
+
+void ClipboardPreviewLoaderTest::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    // Одна большая фотография, скопированная под разными именами
+    const QString source = m_dir.filePath("source.jpg");
+    QVERIFY(photoLikeImage(QSize(4000, 3000)).save(source, "JPEG", 90));
+    for (int i = 0; i < kFileCount; ++i) {
+        QVERIFY(QFile::copy(source, filePath(i)));
+    }
+
+    QFile broken(m_dir.filePath("broken.png"));
+    QVERIFY(broken.open(QIODevice::WriteOnly));
+    broken.write("not an image");
+}
+
+QString ClipboardPreviewLoaderTest::filePath(int index) const
+{
+    return m_dir.filePath(QString("photo_%1.jpg").arg(index, 3, 10, QChar('0')));
+}
+
+void ClipboardPreviewLoaderTest::previewIsCachedAfterDecode()
+{
+    ClipboardPreviewLoader loader;
+    QSignalSpy ready(&loader, &ClipboardPreviewLoader::previewReady);
+
+    QVERIFY(loader.preview(filePath(0)).isNull());
+    QCOMPARE(loader.pendingCount(), 1);
+    QVERIFY(ready.wait());
+
+    const QImage preview = ready.first().at(1).value<QImage>();
+    QVERIFY(!preview.isNull());
+    QVERIFY(preview.width() <= ClipboardPreviewLoader::PREVIEW_SIZE);
+    QVERIFY(preview.height() <= ClipboardPreviewLoader::PREVIEW_SIZE);
+
+    QCOMPARE(loader.preview(filePath(0)), preview);
+    QCOMPARE(loader.pendingCount(), 0);
+}
+
+void ClipboardPreviewLoaderTest::brokenFileIsMarkedFailed()
+{
+    ClipboardPreviewLoader loader;
+    QSignalSpy ready(&loader, &ClipboardPreviewLoader::previewReady);
+
+    const QString path = m_dir.filePath("broken.png");
+    loader.preview(path);
+    QVERIFY(ready.wait());
+    QVERIFY(loader.hasFailed(path));
+
+    // Повторно не декодируется
+    QVERIFY(loader.preview(path).isNull());
+    QCOMPARE(loader.pendingCount(), 0);
+}
+
+void ClipboardPreviewLoaderTest::cancelledRequestsDoNotReport()
+{
+    ClipboardPreviewLoader loader;
+    QSignalSpy ready(&loader, &ClipboardPreviewLoader::previewReady);
+
+    for (int i = 0; i < kFileCount; ++i) {
+        loader.preview(filePath(i));
+    }
+    loader.cancelPending();
+    QCOMPARE(loader.pendingCount(), 0);
+
+    QTest::qWait(500);
+    QCOMPARE(ready.count(), 0);
+}
+
+void ClipboardPreviewLoaderTest::guiStaysResponsiveWhileDecoding()
+{
+    ClipboardPreviewLoader loader;
+    QSignalSpy ready(&loader, &ClipboardPreviewLoader::previewReady);
+
+    // Потоки декодирования заняты, пока тест их не отпустит, - проверка
+    // не зависит от скорости машины
+    QSemaphore gate;
+    for (int i = 0; i < ClipboardPreviewLoader::MAX_THREADS; ++i) {
+        loader.threadPool()->start([&gate]() { gate.acquire(); });
+    }
+    auto releaseGate = qScopeGuard([&gate]() { gate.release(ClipboardPreviewLoader::MAX_THREADS); });
+
+    // Открытие окна истории с 200 файлами: preview() только ставит файлы в очередь
+    for (int i = 0; i < kFileCount; ++i) {
+        QVERIFY(loader.preview(filePath(i)).isNull());
+    }
+    QCOMPARE(loader.pendingCount(), kFileCount);
+    QCOMPARE(ready.count(), 0);
+
+    // GUI-поток продолжает рисовать "кадры", пока ни один файл не декодирован
+    int frames = 0;
+    QTimer frameTick;
+    frameTick.setInterval(kFrameIntervalMs);
+    connect(&frameTick, &QTimer::timeout, this, [&frames]() { ++frames; });
+    frameTick.start();
+
+    QTRY_VERIFY(frames >= kFramesWhileDecoding);
+    QCOMPARE(ready.count(), 0);
+    QCOMPARE(loader.pendingCount(), kFileCount);
+
+    // Декодирование в фоне: все миниатюры приходят через previewReady
+    const int framesBeforeDecode = frames;
+    QElapsedTimer decodeTimer;
+    decodeTimer.start();
+    releaseGate.dismiss();
+    gate.release(ClipboardPreviewLoader::MAX_THREADS);
+    QTRY_COMPARE_WITH_TIMEOUT(ready.count(), kFileCount, 60000);
+    frameTick.stop();
+
+    qDebug() << "decode:" << decodeTimer.elapsed() << "ms, frames while decoding:"
+             << frames - framesBeforeDecode;
+    QCOMPARE(loader.pendingCount(), 0);
+
+    for (const QList<QVariant>& arguments : std::as_const(ready)) {
+        QVERIFY(!arguments.at(1).value<QImage>().isNull());
+    }
+}
+
+QTEST_MAIN(ClipboardPreviewLoaderTest)
+#include "tst_clipboardpreviewloader.moc"
@@ -0,0 +1,218 @@
+#include "Extensions/ClipboardHistoryStore.h"
+#include "Extensions/ClipboardSearchIndex.h"
+
+#include <QRandomGenerator>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <iterator>
+
+namespace {
+
+const int kBenchmarkEntries = 20000;
+
+const char* const kWords[] = {
+    "invoice", "meeting", "password", "deploy", "release", "kernel", "https",
+    "github", "report", "budget", "schedule", "docker", "commit", "review",
+    "привет", "отчет", "встреча", "задача", "Straße", "café"
+};
+
+// Текст из случайных слов - похож на типичное содержимое буфера
+QString randomText(QRandomGenerator& random)
+{
+    QStringList words;
+    const int count = 3 + random.bounded(20);
+    for (int i = 0; i < count; ++i) {
+        words.append(QString::fromUtf8(kWords[random.bounded(int(std::size(kWords)))]));
+    }
+    words.append(QString::number(random.generate()));
+    return words.join(' ');
+}
+
+} // namespace
+
+class ClipboardSearchIndexTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void searchMatchesFullScan_data();
+    void searchMatchesFullScan();
+    void buildDoesNotKeepTextsLoaded();
+    void followsStoreChanges();
+    void shortQueriesFindShortTexts();
+
+    void benchmarkBuild();
+    void benchmarkSearch_data();
+    void benchmarkSearch();
+
+private:
+    // Журнал из count случайных текстов, прочитанный заново
+    ClipboardHistoryStore* createReloadedStore(int count);
+
+    QTemporaryDir* m_dir = nullptr;
+};
+
+void ClipboardSearchIndexTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void ClipboardSearchIndexTest::init()
+{
+    m_dir = new QTemporaryDir();
+    QVERIFY(m_dir->isValid());
+}
+
+void ClipboardSearchIndexTest::cleanup()
+{
+    delete m_dir;
+    m_dir = nullptr;
+}
+
+ClipboardHistoryStore* ClipboardSearchIndexTest::createReloadedStore(int count)
+{
+    const QString logPath = m_dir->filePath("history.log");
+    {
+        ClipboardHistoryStore store(logPath);
+        store.setRetention(count, 0, 0);
+        store.load();
+        QRandomGenerator random(42);
+        for (int i = 0; i < count; ++i) {
+            store.addText(randomText(random));
+        }
+    }
+
+    ClipboardHistoryStore* store = new ClipboardHistoryStore(logPath, this);
+    store->load();
+    return store;
+}
+
+void ClipboardSearchIndexTest::searchMatchesFullScan_data()
+{
+    QTest::addColumn<QString>("query");
+
+    QTest::newRow("single char") << "e";
+    QTest::newRow("single digit") << "7";
+    QTest::newRow("two chars") << "Ew";
+    QTest::newRow("two chars across words") << "t m";
+    QTest::newRow("two cyrillic chars") << "ЧЕ";
+    QTest::newRow("trigram") << "dep";
+    QTest::newRow("word") << "Meeting";
+    QTest::newRow("two words") << "budget schedule";
+    QTest::newRow("cyrillic") << "ОТЧЕТ";
+    QTest::newRow("case folding") << "CAFÉ";
+    QTest::newRow("no match") << "nonexistent";
+}
+
+void ClipboardSearchIndexTest::searchMatchesFullScan()
+{
+    QFETCH(QString, query);
+
+    QScopedPointer<ClipboardHistoryStore> store(createReloadedStore(2000));
+    ClipboardSearchIndex index(store.data());
+
+    QSet<QByteArray> expected;
+    for (const QByteArray& hash : store->hashes()) {
+        if (store->peekText(hash).contains(query, Qt::CaseInsensitive)) {
+            expected.insert(hash);
+        }
+    }
+
+    QCOMPARE(index.search(query), expected);
+}
+
+void ClipboardSearchIndexTest::buildDoesNotKeepTextsLoaded()
+{
+    const int count = ClipboardHistoryStore::PRELOAD_COUNT * 5;
+    QScopedPointer<ClipboardHistoryStore> store(createReloadedStore(count));
+    ClipboardSearchIndex index(store.data());
+
+    index.search("invoice");
+    QVERIFY(index.isBuilt());
+    QCOMPARE(index.entryCount(), count);
+
+    int loaded = 0;
+    for (const QByteArray& hash : store->hashes()) {
+        loaded += store->cachedEntry(hash)->loaded ? 1 : 0;
+    }
+    QCOMPARE(loaded, ClipboardHistoryStore::PRELOAD_COUNT);
+}
+
+void ClipboardSearchIndexTest::followsStoreChanges()
+{
+    QScopedPointer<ClipboardHistoryStore> store(createReloadedStore(100));
+    ClipboardSearchIndex index(store.data());
+    index.ensureBuilt();
+
+    const quint32 sequence = index.sequence();
+    const QByteArray hash = store->addText("unique clipboard needle");
+    QVERIFY(index.indexedAfter(hash, sequence));
+    QCOMPARE(index.search("needle"), QSet<QByteArray>({hash}));
+
+    store->remove(hash);
+    QVERIFY(index.search("needle").isEmpty());
+    QVERIFY(!index.matches(hash, "needle"));
+}
+
+void ClipboardSearchIndexTest::shortQueriesFindShortTexts()
+{
+    QScopedPointer<ClipboardHistoryStore> store(createReloadedStore(100));
+    ClipboardSearchIndex index(store.data());
+    index.ensureBuilt();
+
+    // У текстов короче трех символов нет триграмм
+    const QByteArray ok = store->addText("OK");
+    const QByteArray x = store->addText("x");
+    QVERIFY(index.search("o").contains(ok));
+    QVERIFY(index.search("Ok").contains(ok));
+    QVERIFY(!index.search("ko").contains(ok));
+    QCOMPARE(index.search("X").contains(x), true);
+
+    store->remove(ok);
+    QVERIFY(!index.search("ok").contains(ok));
+}
+
+void ClipboardSearchIndexTest::benchmarkBuild()
+{
+    QScopedPointer<ClipboardHistoryStore> store(createReloadedStore(kBenchmarkEntries));
+
+    // Первый поиск после запуска: все тексты читаются из журнала
+    QBENCHMARK {
+        ClipboardSearchIndex index(store.data());
+        index.ensureBuilt();
+        QCOMPARE(index.entryCount(), kBenchmarkEntries);
+    }
+}
+
+void ClipboardSearchIndexTest::benchmarkSearch_data()
+{
+    QTest::addColumn<QString>("query");
+
+    QTest::newRow("single char") << "a";
+    QTest::newRow("two chars") << "re";
+    QTest::newRow("frequent word") << "report";
+    QTest::newRow("rare pair") << "café kernel";
+    QTest::newRow("no match") << "nonexistent";
+}
+
+void ClipboardSearchIndexTest::benchmarkSearch()
+{
+    QFETCH(QString, query);
+
+    QScopedPointer<ClipboardHistoryStore> store(createReloadedStore(kBenchmarkEntries));
+    ClipboardSearchIndex index(store.data());
+    index.ensureBuilt();
+
+    // Каждая буква в строке поиска - новый запрос
+    QBENCHMARK {
+        index.search(query);
+    }
+}
+
+QTEST_GUILESS_MAIN(ClipboardSearchIndexTest)
+#include "tst_clipboardsearchindex.moc"
@@ -0,0 +1,222 @@
+#include "DockLayoutBatch.h"
+
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPointer>
+#include <QtTest>
+
+namespace {
+
+// Одновременный запуск приложений: столько иконок добавляется за один пакет
+constexpr int BURST_SIZE = 20;
+
+// Получатель контейнера, считающий свои события, - проверка того, что
+// пакет не удаляет из очереди чужие события
+class EventCounter : public QObject
+{
+public:
+    int layoutRequests = 0;
+    int userEvents = 0;
+
+protected:
+    bool eventFilter(QObject*, QEvent* event) override
+    {
+        if (event->type() == QEvent::LayoutRequest) {
+            ++layoutRequests;
+        } else if (event->type() == QEvent::User) {
+            ++userEvents;
+        }
+        return false;
+    }
+};
+
+// Контейнер как в доке: внешний layout с вложенным layout иконок
+struct DockContainer
+{
+    QWidget widget;
+    QHBoxLayout* iconLayout = nullptr;
+
+    DockContainer()
+    {
+        auto* mainLayout = new QHBoxLayout(&widget);
+        iconLayout = new QHBoxLayout();
+        mainLayout->addLayout(iconLayout);
+        widget.resize(800, 64);
+        widget.show();
+        QCoreApplication::processEvents();
+    }
+
+    QWidget* addIcon()
+    {
+        auto* icon = new QLabel(&widget);
+        icon->setFixedSize(48, 48);
+        iconLayout->addWidget(icon);
+        // Явный показ сразу, а не отложенный из addWidget: иначе отложенный
+        // показ после commit() сам запросит еще один проход layout
+        icon->show();
+        return icon;
+    }
+};
+
+} // namespace
+
+class DockLayoutBatchTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void burstUsesSingleLayoutPass();
+    void unbatchedBurstCountsEveryPass();
+    void nestedBatchCommitsOnce();
+    void commitWithoutBeginIsIgnored();
+    void keepsUnrelatedPostedEvents();
+    void benchmarkBurst_data();
+    void benchmarkBurst();
+};
+
+void DockLayoutBatchTest::burstUsesSingleLayoutPass()
+{
+    DockContainer container;
+    DockLayoutBatch batch;
+    batch.setContainer(&container.widget);
+
+    QVERIFY(batch.begin());
+    QList<QWidget*> icons;
+    for (int i = 0; i < BURST_SIZE; ++i) {
+        icons.append(container.addIcon());
+        batch.addMutation();
+    }
+    QCOMPARE(batch.pendingMutations(), BURST_SIZE);
+    QVERIFY(batch.commit());
+    QVERIFY(!batch.isActive());
+
+    // Геометрия готова сразу после commit(), до обработки очереди
+    QVERIFY(icons.last()->geometry().right() > icons.first()->geometry().right());
+    QCOMPARE(batch.layoutPassCount(), 1);
+
+    // Отложенный запрос layout не считается вторым проходом
+    QCoreApplication::processEvents();
+    QCoreApplication::processEvents();
+    QCOMPARE(batch.layoutPassCount(), 1);
+}
+
+void DockLayoutBatchTest::unbatchedBurstCountsEveryPass()
+{
+    DockContainer container;
+    DockLayoutBatch batch;
+    batch.setContainer(&container.widget);
+
+    // Без пакета каждая иконка, добавленная после обработки событий,
+    // вызывает свой проход layout
+    for (int i = 0; i < BURST_SIZE; ++i) {
+        container.addIcon();
+        QCoreApplication::processEvents();
+    }
+    QVERIFY(batch.layoutPassCount() >= BURST_SIZE);
+}
+
+void DockLayoutBatchTest::nestedBatchCommitsOnce()
+{
+    DockContainer container;
+    DockLayoutBatch batch;
+    batch.setContainer(&container.widget);
+
+    QVERIFY(batch.begin());
+    QVERIFY(!batch.begin());
+    container.addIcon();
+    batch.addMutation();
+    QVERIFY(!batch.commit());
+    QVERIFY(batch.isActive());
+    QCOMPARE(batch.layoutPassCount(), 0);
+
+    container.addIcon();
+    batch.addMutation();
+    QVERIFY(batch.commit());
+    QCOMPARE(batch.layoutPassCount(), 1);
+    QCOMPARE(batch.pendingMutations(), 0);
+
+    QCoreApplication::processEvents();
+    QCOMPARE(batch.layoutPassCount(), 1);
+}
+
+void DockLayoutBatchTest::commitWithoutBeginIsIgnored()
+{
+    DockContainer container;
+    DockLayoutBatch batch;
+    batch.setContainer(&container.widget);
+
+    QVERIFY(!batch.commit());
+    QVERIFY(!batch.isActive());
+
+    // Пустой пакет не пересчитывает layout
+    QVERIFY(batch.begin());
+    QVERIFY(batch.commit());
+    QCOMPARE(batch.layoutPassCount(), 0);
+}
+
+void DockLayoutBatchTest::keepsUnrelatedPostedEvents()
+{
+    DockContainer container;
+    DockLayoutBatch batch;
+    batch.setContainer(&container.widget);
+
+    EventCounter counter;
+    container.widget.installEventFilter(&counter);
+
+    QVERIFY(batch.begin());
+    QCoreApplication::postEvent(&container.widget, new QEvent(QEvent::User));
+    for (int i = 0; i < BURST_SIZE; ++i) {
+        container.addIcon();
+        batch.addMutation();
+    }
+    QVERIFY(batch.commit());
+
+    // Событие, посланное контейнеру во время пакета, доставляется
+    QCoreApplication::processEvents();
+    QCOMPARE(counter.userEvents, 1);
+
+    // Изменение после пакета вызывает обычный проход layout
+    const int requestsBefore = counter.layoutRequests;
+    container.addIcon();
+    QCoreApplication::processEvents();
+    QCOMPARE(counter.layoutRequests, requestsBefore + 1);
+    QCOMPARE(batch.layoutPassCount(), 2);
+}
+
+void DockLayoutBatchTest::benchmarkBurst_data()
+{
+    QTest::addColumn<bool>("batched");
+
+    QTest::newRow("batched") << true;
+    QTest::newRow("unbatched") << false;
+}
+
+void DockLayoutBatchTest::benchmarkBurst()
+{
+    QFETCH(bool, batched);
+
+    QBENCHMARK {
+        DockContainer container;
+        DockLayoutBatch batch;
+        batch.setContainer(&container.widget);
+
+        if (batched) {
+            batch.begin();
+        }
+        for (int i = 0; i < BURST_SIZE; ++i) {
+            container.addIcon();
+            if (batched) {
+                batch.addMutation();
+            } else {
+                QCoreApplication::processEvents();
+            }
+        }
+        if (batched) {
+            batch.commit();
+        }
+        QCoreApplication::processEvents();
+    }
+}
+
+QTEST_MAIN(DockLayoutBatchTest)
+#include "tst_docklayoutbatch.moc"
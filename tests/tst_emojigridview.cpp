@@ -0,0 +1,154 @@
+#include "EmojiList.h"
+#include "Extensions/EmojiGlyphAtlas.h"
+#include "Extensions/EmojiGridView.h"
+#include "Extensions/EmojiListModel.h"
+
+#include <QElapsedTimer>
+#include <QScrollBar>
+#include <QStandardPaths>
+#include <QtMath>
+#include <QtTest>
+
+namespace {
+
+// Размер сетки во вкладке эмодзи
+const QSize kViewSize(460, 420);
+
+int visibleCells(const EmojiGridView& view)
+{
+    const int columns = qMax(1, view.viewport()->width() / EmojiGridView::CELL_SIZE.width());
+    const int rows = view.viewport()->height() / EmojiGridView::CELL_SIZE.height() + 2;
+    return columns * rows;
+}
+
+// Отрисовка и ожидание глифов, запрошенных ею
+void paintAndWait(EmojiGridView& view)
+{
+    view.viewport()->repaint();
+    QTRY_VERIFY(!view.glyphAtlas()->isBusy());
+    view.viewport()->repaint();
+}
+
+} // namespace
+
+class EmojiGridViewTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void rasterizesOnlyVisibleGlyphs();
+    void scrollingKeepsMemoryBounded();
+    void releaseGlyphsFreesMemory();
+
+    void benchmarkScrollFrame();
+
+private:
+    EmojiListModel* m_model = nullptr;
+};
+
+void EmojiGridViewTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    m_model = new EmojiListModel(this);
+}
+
+void EmojiGridViewTest::rasterizesOnlyVisibleGlyphs()
+{
+    EmojiGridView view;
+    view.resize(kViewSize);
+    view.setModel(m_model);
+    view.setGlyphFont(EmojiGlyphAtlas::emojiFont(view.font()));
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    paintAndWait(view);
+
+    // Видимый экран и следующий, а не весь каталог
+    EmojiGlyphAtlas* atlas = view.glyphAtlas();
+    QVERIFY(atlas->glyphCount() > 0);
+    QVERIFY2(atlas->glyphCount() <= 2 * visibleCells(view),
+             qPrintable(QString("%1 glyphs for %2 visible cells").arg(atlas->glyphCount()).arg(visibleCells(view))));
+    qDebug() << "first screen:" << atlas->glyphCount() << "glyphs," << atlas->memoryBytes() / 1024 << "KB;"
+             << "catalog:" << EmojiCatalog::count() << "records";
+}
+
+void EmojiGridViewTest::scrollingKeepsMemoryBounded()
+{
+    EmojiGridView view;
+    view.resize(kViewSize);
+    view.setModel(m_model);
+    view.setGlyphFont(EmojiGlyphAtlas::emojiFont(view.font()));
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    // Прокрутка всего каталога по экранам
+    QScrollBar* scrollBar = view.verticalScrollBar();
+    qint64 peakBytes = 0;
+    for (int value = 0; value <= scrollBar->maximum(); value += scrollBar->pageStep()) {
+        scrollBar->setValue(value);
+        paintAndWait(view);
+        peakBytes = qMax(peakBytes, view.glyphAtlas()->memoryBytes());
+    }
+
+    // Тот же предел, что у кэша атласа
+    const int cellPixels = qCeil(EmojiGridView::GLYPH_SIZE * view.glyphAtlas()->devicePixelRatio());
+    const qint64 limit = qMax<qint64>(EmojiGlyphAtlas::CACHE_MAX_BYTES,
+                                      qint64(EmojiGlyphAtlas::MIN_CACHED_GLYPHS) * cellPixels * cellPixels * 4);
+    qDebug() << "full scroll: peak" << peakBytes / 1024 << "KB, glyphs kept:" << view.glyphAtlas()->glyphCount();
+    QVERIFY(peakBytes <= limit);
+    QVERIFY(view.glyphAtlas()->glyphCount() < EmojiCatalog::count());
+}
+
+void EmojiGridViewTest::releaseGlyphsFreesMemory()
+{
+    EmojiGridView view;
+    view.resize(kViewSize);
+    view.setModel(m_model);
+    view.setGlyphFont(EmojiGlyphAtlas::emojiFont(view.font()));
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+    paintAndWait(view);
+    QVERIFY(view.glyphAtlas()->glyphCount() > 0);
+
+    view.hide();
+    view.releaseGlyphs();
+    QCOMPARE(view.glyphAtlas()->glyphCount(), 0);
+    QCOMPARE(view.glyphAtlas()->memoryBytes(), 0);
+
+    // Задание, начатое до освобождения, не возвращает глифы в кэш
+    view.show();
+    view.prefetchGlyphs();
+    view.releaseGlyphs();
+    QTRY_VERIFY(!view.glyphAtlas()->isBusy());
+    QCOMPARE(view.glyphAtlas()->glyphCount(), 0);
+}
+
+void EmojiGridViewTest::benchmarkScrollFrame()
+{
+    EmojiGridView view;
+    view.resize(kViewSize);
+    view.setModel(m_model);
+    view.setGlyphFont(EmojiGlyphAtlas::emojiFont(view.font()));
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+    paintAndWait(view);
+
+    // Кадр прокрутки на половину ячейки: отрисовка видимых ячеек в GUI-потоке.
+    // Глифы, которых еще нет, растеризуются в фоне и в кадр не входят
+    QScrollBar* scrollBar = view.verticalScrollBar();
+    qint64 worstFrameUs = 0;
+    QBENCHMARK {
+        QElapsedTimer frameTimer;
+        frameTimer.start();
+        const int next = scrollBar->value() + scrollBar->singleStep();
+        scrollBar->setValue(next > scrollBar->maximum() ? 0 : next);
+        view.viewport()->repaint();
+        worstFrameUs = qMax(worstFrameUs, frameTimer.nsecsElapsed() / 1000);
+    }
+    qDebug() << "worst scroll frame:" << worstFrameUs << "us";
+}
+
+QTEST_MAIN(EmojiGridViewTest)
+#include "tst_emojigridview.moc"
@@ -0,0 +1,364 @@
+#include "EmojiList.h"
+#include "Extensions/EmojiListModel.h"
+#include "Extensions/EmojiSearchIndex.h"
+#include "Extensions/EmojiUsageTracker.h"
+
+#include <QStandardPaths>
+#include <QtTest>
+
+namespace {
+
+// Проверка без индекса: перебор ключевых слов всех основных записей
+QBitArray bruteForceMatch(const QString& query)
+{
+    QBitArray result(EmojiCatalog::count(), query.isEmpty());
+    if (query.isEmpty()) {
+        return result;
+    }
+
+    const QString lower = query.toLower();
+    const bool prefixOnly = lower.size() < 3;
+    for (int row = 0; row < EmojiCatalog::count(); ++row) {
+        if (EmojiCatalog::record(row).skinTone != 0) {
+            continue;
+        }
+        for (const QString& keyword : EmojiCatalog::keywords(row)) {
+            const QString text = keyword.toLower();
+            if (prefixOnly ? text.startsWith(lower) : text.contains(lower)) {
+                result.setBit(row);
+                break;
+            }
+        }
+    }
+
+    const bool wordQuery = std::all_of(query.constBegin(), query.constEnd(), [](QChar ch) {
+        return ch.isLetterOrNumber() || ch.isSpace();
+    });
+    if (!wordQuery) {
+        for (int row = 0; row < EmojiCatalog::count(); ++row) {
+            if (EmojiCatalog::emoji(row).contains(query)) {
+                result.setBit(EmojiCatalog::baseRow(row));
+            }
+        }
+    }
+    return result;
+}
+
+bool matchesEmoji(const QBitArray& result, const char* emoji)
+{
+    const int row = EmojiCatalog::findRow(emoji);
+    return row >= 0 && result.testBit(row);
+}
+
+} // namespace
+
+class EmojiSearchIndexTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void catalogCoversRgiSet();
+    void skinToneVariantsFollowBase();
+    void matchesBruteForce_data();
+    void matchesBruteForce();
+    void findsKnownEmoji();
+    void variantsAreNotMatchedDirectly();
+    void filterModelShowsIndexMatches_data();
+    void filterModelShowsIndexMatches();
+    void filterModelHidesFrequentWhileSearching();
+    void filterModelReordersAfterUse();
+    void findRowFindsEveryRecord();
+
+    void benchmarkCatalogStrings();
+    void benchmarkMatch_data();
+    void benchmarkMatch();
+    void benchmarkBruteForce();
+    void benchmarkFilterQuery();
+    void benchmarkFindRow();
+
+private:
+    const QStringList m_queries = {
+        "a", "с", "fa", "ул", "smile", "улыб", "heart", "сердце", "flag", "technologist",
+        "family", "inning", "HAND", "❤", "👍", "🏳", "zzzz", "кот", "cat face"
+    };
+};
+
+void EmojiSearchIndexTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void EmojiSearchIndexTest::catalogCoversRgiSet()
+{
+    int baseCount = 0;
+    int zwjCount = 0;
+    for (int row = 0; row < EmojiCatalog::count(); ++row) {
+        if (EmojiCatalog::record(row).skinTone != 0) {
+            continue;
+        }
+        ++baseCount;
+        if (EmojiCatalog::emoji(row).contains(QChar(0x200D))) {
+            ++zwjCount;
+        }
+        QVERIFY2(EmojiCatalog::record(row).keywordCount > 0, qPrintable(EmojiCatalog::emoji(row)));
+    }
+
+    qDebug() << "catalog:" << EmojiCatalog::count() << "records," << baseCount << "emoji,"
+             << zwjCount << "ZWJ sequences," << EmojiCatalog::keywordCount() << "keywords";
+
+    // Полный набор RGI Emoji 15.1 без сочетаний разных оттенков кожи
+    QVERIFY(baseCount >= 1850);
+    QVERIFY(EmojiCatalog::count() >= 3400);
+    QVERIFY(zwjCount >= 200);
+}
+
+void EmojiSearchIndexTest::skinToneVariantsFollowBase()
+{
+    for (int row = 0; row < EmojiCatalog::count(); ++row) {
+        const EmojiRecord& record = EmojiCatalog::record(row);
+        if (!record.hasSkinTones) {
+            continue;
+        }
+        for (int tone = 1; tone <= EmojiCatalog::SKIN_TONE_COUNT; ++tone) {
+            const int variant = EmojiCatalog::variantRow(row, tone);
+            QCOMPARE(variant, row + tone);
+            QCOMPARE(int(EmojiCatalog::record(variant).skinTone), tone);
+            QCOMPARE(EmojiCatalog::baseRow(variant), row);
+            // Модификатор U+1F3FB..U+1F3FF во втором символе последовательности
+            const QList<uint> codePoints = EmojiCatalog::emoji(variant).toUcs4();
+            QVERIFY(codePoints.size() >= 2);
+            QCOMPARE(codePoints.at(1), uint(0x1F3FA + tone));
+        }
+    }
+
+    // ZWJ-последовательность с оттенком кожи
+    const int technologist = EmojiCatalog::findRow("🧑‍💻");
+    QVERIFY(technologist >= 0);
+    QVERIFY(EmojiCatalog::record(technologist).hasSkinTones);
+    QCOMPARE(EmojiCatalog::emoji(EmojiCatalog::variantRow(technologist, 1)), QString("🧑🏻‍💻"));
+}
+
+void EmojiSearchIndexTest::matchesBruteForce_data()
+{
+    QTest::addColumn<QString>("query");
+    for (const QString& query : m_queries) {
+        QTest::newRow(qPrintable(query)) << query;
+    }
+}
+
+void EmojiSearchIndexTest::matchesBruteForce()
+{
+    QFETCH(QString, query);
+    QCOMPARE(EmojiSearchIndex::instance().match(query), bruteForceMatch(query));
+}
+
+void EmojiSearchIndexTest::findsKnownEmoji()
+{
+    const EmojiSearchIndex& index = EmojiSearchIndex::instance();
+
+    QVERIFY(matchesEmoji(index.match("улыбка"), "😊"));
+    QVERIFY(matchesEmoji(index.match("grinning"), "😀"));
+    QVERIFY(matchesEmoji(index.match("GRINNING"), "😀"));
+    QVERIFY(matchesEmoji(index.match("technologist"), "🧑‍💻"));
+    QVERIFY(matchesEmoji(index.match("rainbow"), "🏳️‍🌈"));
+    QVERIFY(matchesEmoji(index.match("germany"), "🇩🇪"));
+    QVERIFY(matchesEmoji(index.match("👍"), "👍"));
+    QVERIFY(index.match("nonexistentword").count(true) == 0);
+    QCOMPARE(index.match(QString()).count(true), EmojiCatalog::count());
+}
+
+void EmojiSearchIndexTest::variantsAreNotMatchedDirectly()
+{
+    // Вариант с оттенком кожи находится через основную запись
+    const QBitArray result = EmojiSearchIndex::instance().match("👍🏽");
+    QVERIFY(matchesEmoji(result, "👍"));
+    QVERIFY(!matchesEmoji(result, "👍🏽"));
+
+    const QBitArray words = EmojiSearchIndex::instance().match("hand");
+    for (int row = 0; row < words.size(); ++row) {
+        if (words.testBit(row)) {
+            QCOMPARE(int(EmojiCatalog::record(row).skinTone), 0);
+        }
+    }
+}
+
+void EmojiSearchIndexTest::filterModelShowsIndexMatches_data()
+{
+    QTest::addColumn<QString>("query");
+    for (const QString& query : m_queries) {
+        QTest::newRow(qPrintable(query)) << query;
+    }
+}
+
+void EmojiSearchIndexTest::filterModelShowsIndexMatches()
+{
+    QFETCH(QString, query);
+
+    EmojiUsageTracker::instance().clear();
+    EmojiListModel model;
+    EmojiFilterModel filter;
+    filter.setSourceModel(&model);
+
+    // Видимые строки фильтра - ровно основные записи из маски индекса
+    const QBitArray expected = EmojiSearchIndex::instance().match(query);
+    filter.setQuery(query);
+    QCOMPARE(filter.rowCount(), int(expected.count(true)));
+    for (int row = 0; row < filter.rowCount(); ++row) {
+        const int baseRow = filter.index(row, 0).data(EmojiListModel::BaseRowRole).toInt();
+        QVERIFY(expected.testBit(baseRow));
+    }
+
+    filter.setQuery(QString());
+    QCOMPARE(filter.rowCount(), model.rowCount());
+}
+
+void EmojiSearchIndexTest::filterModelHidesFrequentWhileSearching()
+{
+    EmojiUsageTracker& tracker = EmojiUsageTracker::instance();
+    tracker.clear();
+    tracker.recordUse("🐱");
+    tracker.recordUse("🐱");
+    tracker.recordUse("😺");
+
+    EmojiListModel model;
+    EmojiFilterModel filter;
+    filter.setSourceModel(&model);
+    QCOMPARE(model.frequentCount(), 2);
+
+    // Без запроса раздел часто используемых идет первым
+    QVERIFY(filter.index(0, 0).data(EmojiListModel::FrequentRole).toBool());
+    QCOMPARE(filter.index(0, 0).data().toString(), QString("🐱"));
+
+    // С запросом раздел скрыт, а найденные упорядочены по частоте
+    filter.setQuery("cat");
+    QVERIFY(filter.rowCount() > 2);
+    for (int row = 0; row < filter.rowCount(); ++row) {
+        QVERIFY(!filter.index(row, 0).data(EmojiListModel::FrequentRole).toBool());
+    }
+    QCOMPARE(filter.index(0, 0).data().toString(), QString("🐱"));
+    QCOMPARE(filter.index(1, 0).data().toString(), QString("😺"));
+
+    tracker.clear();
+}
+
+void EmojiSearchIndexTest::filterModelReordersAfterUse()
+{
+    EmojiUsageTracker& tracker = EmojiUsageTracker::instance();
+    tracker.clear();
+    tracker.recordUse("🐱");
+
+    EmojiListModel model;
+    EmojiFilterModel filter;
+    filter.setSourceModel(&model);
+
+    filter.setQuery("ca");
+    filter.setQuery("cat");
+    QCOMPARE(filter.index(0, 0).data().toString(), QString("🐱"));
+
+    // Использование во время поиска учитывается следующим запросом
+    tracker.recordUse("😺");
+    tracker.recordUse("😺");
+    filter.setQuery("cat ");
+    filter.setQuery("cat");
+    QCOMPARE(filter.index(0, 0).data().toString(), QString("😺"));
+    QCOMPARE(filter.index(1, 0).data().toString(), QString("🐱"));
+
+    tracker.clear();
+}
+
+void EmojiSearchIndexTest::findRowFindsEveryRecord()
+{
+    for (int row = 0; row < EmojiCatalog::count(); ++row) {
+        QCOMPARE(EmojiCatalog::findRow(EmojiCatalog::record(row).emoji), row);
+    }
+    QCOMPARE(EmojiCatalog::findRow("not an emoji"), -1);
+    QCOMPARE(EmojiCatalog::findRow(std::string_view()), -1);
+}
+
+void EmojiSearchIndexTest::benchmarkCatalogStrings()
+{
+    // Каталог constexpr, QString создаются только по запросу. Здесь создаются
+    // строки всех записей - столько работы раньше выполнялось при старте
+    QBENCHMARK {
+        qsizetype length = 0;
+        for (int row = 0; row < EmojiCatalog::count(); ++row) {
+            length += EmojiCatalog::emoji(row).size();
+            for (const QString& keyword : EmojiCatalog::keywords(row)) {
+                length += keyword.size();
+            }
+        }
+        QVERIFY(length > 0);
+    }
+}
+
+void EmojiSearchIndexTest::benchmarkMatch_data()
+{
+    QTest::addColumn<QString>("query");
+    QTest::newRow("one letter") << "s";
+    QTest::newRow("two letters") << "ул";
+    QTest::newRow("word") << "smiling";
+    QTest::newRow("substring") << "inning";
+    QTest::newRow("no match") << "nonexistent";
+    QTest::newRow("emoji") << "❤";
+}
+
+void EmojiSearchIndexTest::benchmarkMatch()
+{
+    QFETCH(QString, query);
+    const EmojiSearchIndex& index = EmojiSearchIndex::instance();
+
+    // Каждое нажатие клавиши в строке поиска - один запрос
+    QBENCHMARK {
+        index.match(query);
+    }
+}
+
+void EmojiSearchIndexTest::benchmarkBruteForce()
+{
+    // Для сравнения: перебор ключевых слов всех эмодзи на каждый запрос
+    QBENCHMARK {
+        bruteForceMatch("smiling");
+    }
+}
+
+void EmojiSearchIndexTest::benchmarkFilterQuery()
+{
+    // Трекер заполнен: у каждого запроса есть счета для сортировки
+    EmojiUsageTracker& tracker = EmojiUsageTracker::instance();
+    tracker.clear();
+    for (int row = 0, used = 0; row < EmojiCatalog::count() && used < EmojiUsageTracker::MAX_ENTRIES; ++row) {
+        if (EmojiCatalog::record(row).skinTone == 0) {
+            tracker.recordUse(EmojiCatalog::emoji(row));
+            ++used;
+        }
+    }
+
+    EmojiListModel model;
+    EmojiFilterModel filter;
+    filter.setSourceModel(&model);
+
+    // Ввод слова по буквам: каждый запрос пересчитывает видимые строки фильтра
+    const QString word = QStringLiteral("smiling");
+    QBENCHMARK {
+        for (int length = 1; length <= word.size(); ++length) {
+            filter.setQuery(word.left(length));
+        }
+        filter.setQuery(QString());
+    }
+
+    tracker.clear();
+}
+
+void EmojiSearchIndexTest::benchmarkFindRow()
+{
+    // Поиск последней записи: худший случай для перебора таблицы
+    const std::string_view last = EmojiCatalog::record(EmojiCatalog::count() - 1).emoji;
+    QBENCHMARK {
+        QCOMPARE(EmojiCatalog::findRow(last), EmojiCatalog::count() - 1);
+    }
+}
+
+QTEST_GUILESS_MAIN(EmojiSearchIndexTest)
+#include "tst_emojisearchindex.moc"
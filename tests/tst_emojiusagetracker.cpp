@@ -0,0 +1,122 @@
+#include "Extensions/EmojiUsageTracker.h"
+
+#include <QSettings>
+#include <QStandardPaths>
+#include <QtTest>
+
+class EmojiUsageTrackerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void repeatedUseRaisesScore();
+    void newEmojiSurvivesEvictionWhenFull();
+    void weakestEmojiIsEvicted();
+    void savesAreBatched();
+
+    void benchmarkRecordUseWhenFull();
+
+private:
+    static QString emojiAt(int index);
+};
+
+void EmojiUsageTrackerTest::initTestCase()
+{
+    // Настройки теста не смешиваются с настройками пользователя
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void EmojiUsageTrackerTest::init()
+{
+    EmojiUsageTracker::instance().clear();
+}
+
+QString EmojiUsageTrackerTest::emojiAt(int index)
+{
+    // Различные ключи; настоящие эмодзи для трекера не обязательны
+    return QString("emoji-%1").arg(index);
+}
+
+void EmojiUsageTrackerTest::repeatedUseRaisesScore()
+{
+    EmojiUsageTracker& tracker = EmojiUsageTracker::instance();
+    tracker.recordUse("😀");
+    tracker.recordUse("😀");
+    tracker.recordUse("👍");
+
+    QVERIFY(tracker.score("😀") > tracker.score("👍"));
+    QCOMPARE(tracker.frequent(2), QStringList({"😀", "👍"}));
+}
+
+void EmojiUsageTrackerTest::newEmojiSurvivesEvictionWhenFull()
+{
+    EmojiUsageTracker& tracker = EmojiUsageTracker::instance();
+
+    // Заполняем трекер эмодзи, использованными дважды (счет около 2)
+    for (int i = 0; i < EmojiUsageTracker::MAX_ENTRIES; ++i) {
+        tracker.recordUse(emojiAt(i));
+        tracker.recordUse(emojiAt(i));
+    }
+    QCOMPARE(tracker.scores().size(), EmojiUsageTracker::MAX_ENTRIES);
+
+    // У нового эмодзи наименьший счет, но вытесняется другой
+    tracker.recordUse("🆕");
+    QCOMPARE(tracker.scores().size(), EmojiUsageTracker::MAX_ENTRIES);
+    QVERIFY(tracker.score("🆕") > 0);
+}
+
+void EmojiUsageTrackerTest::weakestEmojiIsEvicted()
+{
+    EmojiUsageTracker& tracker = EmojiUsageTracker::instance();
+
+    tracker.recordUse(emojiAt(0));
+    for (int i = 1; i < EmojiUsageTracker::MAX_ENTRIES; ++i) {
+        tracker.recordUse(emojiAt(i));
+        tracker.recordUse(emojiAt(i));
+    }
+
+    tracker.recordUse("🆕");
+    QCOMPARE(tracker.score(emojiAt(0)), 0.0);
+    QVERIFY(tracker.score("🆕") > 0);
+}
+
+void EmojiUsageTrackerTest::savesAreBatched()
+{
+    EmojiUsageTracker& tracker = EmojiUsageTracker::instance();
+    tracker.flush();
+
+    // Серия использований не пишет настройки сразу
+    for (int i = 0; i < 20; ++i) {
+        tracker.recordUse(emojiAt(i));
+    }
+    QVERIFY(!QSettings("MyCompany", "DockApp").value("Emoji/Usage").toMap().contains(emojiAt(0)));
+
+    // Запись - одна, после паузы
+    QTRY_VERIFY_WITH_TIMEOUT(QSettings("MyCompany", "DockApp").value("Emoji/Usage").toMap().size() == 20,
+                             EmojiUsageTracker::SAVE_DELAY_MS * 3);
+
+    // flush записывает отложенные изменения сразу
+    tracker.recordUse("🆕");
+    tracker.flush();
+    QVERIFY(QSettings("MyCompany", "DockApp").value("Emoji/Usage").toMap().contains("🆕"));
+}
+
+void EmojiUsageTrackerTest::benchmarkRecordUseWhenFull()
+{
+    EmojiUsageTracker& tracker = EmojiUsageTracker::instance();
+    for (int i = 0; i < EmojiUsageTracker::MAX_ENTRIES; ++i) {
+        tracker.recordUse(emojiAt(i));
+    }
+
+    // Каждое использование нового эмодзи перебирает счета; настройки пишутся позже
+    int next = EmojiUsageTracker::MAX_ENTRIES;
+    QBENCHMARK {
+        tracker.recordUse(emojiAt(next++));
+    }
+}
+
+QTEST_GUILESS_MAIN(EmojiUsageTrackerTest)
+#include "tst_emojiusagetracker.moc"
@@ -0,0 +1,230 @@
+#include "ForegroundWindowTracker.h"
+
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QtTest>
+
+namespace {
+
+// Заглушка WinAPI: считает запросы и имитирует их работу
+class MockForegroundBackend : public ForegroundWindowBackend
+{
+public:
+    explicit MockForegroundBackend(bool hooks)
+        : m_hooks(hooks)
+    {
+    }
+
+    quintptr foregroundWindow() const override { return window; }
+
+    void queryIdentity(quintptr, ForegroundWindowState& state) const override
+    {
+        ++identityCalls;
+        // Как в WinAPI-версии: имя класса и имя файла из полного пути процесса
+        state.className = className;
+        state.executableName = QFileInfo(QString("C:/Program Files/Game/") + executable).fileName().toLower();
+    }
+
+    void queryGeometry(quintptr, ForegroundWindowState& state) const override
+    {
+        ++geometryCalls;
+        state.visible = true;
+        state.minimized = false;
+        state.borderless = true;
+        state.geometry = geometry;
+    }
+
+    bool installHooks(ForegroundWindowTracker*) override { return m_hooks; }
+    void removeHooks() override {}
+
+    quintptr window = 1;
+    QString className = "GameWindowClass";
+    QString executable = "Game.exe";
+    QRect geometry = QRect(0, 0, 1920, 1080);
+
+    mutable int identityCalls = 0;
+    mutable int geometryCalls = 0;
+
+private:
+    bool m_hooks;
+};
+
+const QRect kScreen(0, 0, 1920, 1080);
+
+} // namespace
+
+class ForegroundWindowTrackerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanupTestCase();
+
+    void detectsFullScreenWindow();
+    void cachedChecksDoNotQueryBackend();
+    void foregroundChangeRequeriesIdentity();
+    void geometryChangeRequeriesGeometryOnly();
+    void otherWindowChangesAreIgnored();
+    void exceptionsAreCaseInsensitive();
+    void systemClassesAreExcluded();
+    void withoutHooksEveryCheckQueries();
+
+    void benchmarkCachedCheck();
+    void benchmarkUncachedCheck();
+
+private:
+    MockForegroundBackend* installBackend(bool hooks);
+
+    ForegroundWindowTracker& tracker() { return ForegroundWindowTracker::instance(); }
+    MockForegroundBackend* m_backend = nullptr;
+};
+
+void ForegroundWindowTrackerTest::initTestCase()
+{
+    // Настройки и данные теста не смешиваются с настройками пользователя
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void ForegroundWindowTrackerTest::init()
+{
+    tracker().setExceptions({});
+    m_backend = installBackend(true);
+}
+
+void ForegroundWindowTrackerTest::cleanupTestCase()
+{
+    tracker().setBackend(nullptr);
+    m_backend = nullptr;
+}
+
+MockForegroundBackend* ForegroundWindowTrackerTest::installBackend(bool hooks)
+{
+    // Трекер становится владельцем источника данных
+    MockForegroundBackend* backend = new MockForegroundBackend(hooks);
+    tracker().setBackend(backend);
+    return backend;
+}
+
+void ForegroundWindowTrackerTest::detectsFullScreenWindow()
+{
+    QVERIFY(tracker().isFullScreenOn(kScreen));
+
+    m_backend->geometry = QRect(100, 100, 800, 600);
+    tracker().notifyWindowChanged(m_backend->window);
+    QVERIFY(!tracker().isFullScreenOn(kScreen));
+}
+
+void ForegroundWindowTrackerTest::cachedChecksDoNotQueryBackend()
+{
+    for (int i = 0; i < 1000; ++i) {
+        tracker().isFullScreenOn(kScreen);
+    }
+
+    QCOMPARE(m_backend->identityCalls, 1);
+    QCOMPARE(m_backend->geometryCalls, 1);
+}
+
+void ForegroundWindowTrackerTest::foregroundChangeRequeriesIdentity()
+{
+    QSignalSpy spy(&tracker(), &ForegroundWindowTracker::foregroundChanged);
+    tracker().isFullScreenOn(kScreen);
+
+    m_backend->window = 2;
+    m_backend->executable = "Editor.exe";
+    tracker().notifyForegroundChanged();
+
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(tracker().state().executableName, QString("editor.exe"));
+    QCOMPARE(m_backend->identityCalls, 2);
+    QCOMPARE(m_backend->geometryCalls, 2);
+}
+
+void ForegroundWindowTrackerTest::geometryChangeRequeriesGeometryOnly()
+{
+    QSignalSpy spy(&tracker(), &ForegroundWindowTracker::foregroundGeometryChanged);
+    tracker().isFullScreenOn(kScreen);
+
+    tracker().notifyWindowChanged(m_backend->window);
+    tracker().isFullScreenOn(kScreen);
+
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(m_backend->identityCalls, 1);
+    QCOMPARE(m_backend->geometryCalls, 2);
+}
+
+void ForegroundWindowTrackerTest::otherWindowChangesAreIgnored()
+{
+    QSignalSpy spy(&tracker(), &ForegroundWindowTracker::foregroundGeometryChanged);
+    tracker().isFullScreenOn(kScreen);
+
+    tracker().notifyWindowChanged(m_backend->window + 1);
+    tracker().isFullScreenOn(kScreen);
+
+    QCOMPARE(spy.count(), 0);
+    QCOMPARE(m_backend->geometryCalls, 1);
+}
+
+void ForegroundWindowTrackerTest::exceptionsAreCaseInsensitive()
+{
+    tracker().setExceptions({" GAME.exe "});
+    QVERIFY(!tracker().isFullScreenOn(kScreen));
+
+    tracker().setExceptions({});
+    QVERIFY(tracker().isFullScreenOn(kScreen));
+}
+
+void ForegroundWindowTrackerTest::systemClassesAreExcluded()
+{
+    // Рабочий стол развернут на весь экран, но док над ним не скрывается
+    m_backend->className = "WorkerW";
+    m_backend->window = 3;
+    tracker().notifyForegroundChanged();
+    QVERIFY(!tracker().isFullScreenOn(kScreen));
+}
+
+void ForegroundWindowTrackerTest::withoutHooksEveryCheckQueries()
+{
+    m_backend = installBackend(false);
+
+    for (int i = 0; i < 10; ++i) {
+        tracker().isFullScreenOn(kScreen);
+    }
+
+    QCOMPARE(m_backend->identityCalls, 10);
+    QCOMPARE(m_backend->geometryCalls, 10);
+}
+
+void ForegroundWindowTrackerTest::benchmarkCachedCheck()
+{
+    // С уведомлениями проверка - чтение кэша без обращений к источнику
+    tracker().isFullScreenOn(kScreen);
+    const int identityBefore = m_backend->identityCalls;
+
+    bool fullScreen = false;
+    QBENCHMARK {
+        fullScreen = tracker().isFullScreenOn(kScreen);
+    }
+
+    QVERIFY(fullScreen);
+    QCOMPARE(m_backend->identityCalls, identityBefore);
+}
+
+void ForegroundWindowTrackerTest::benchmarkUncachedCheck()
+{
+    // Для сравнения: без уведомлений каждая проверка заново читает окно
+    m_backend = installBackend(false);
+
+    bool fullScreen = false;
+    QBENCHMARK {
+        fullScreen = tracker().isFullScreenOn(kScreen);
+    }
+
+    QVERIFY(fullScreen);
+    QVERIFY(m_backend->identityCalls > 0);
+}
+
+QTEST_GUILESS_MAIN(ForegroundWindowTrackerTest)
+#include "tst_foregroundwindowtracker.moc"
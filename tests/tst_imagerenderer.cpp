@@ -0,0 +1,300 @@
+#include "Wallpaper/ImageRenderer.h"
+#include "DockTelemetry.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QPainter>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QWidget>
+#include <QtTest>
+
+namespace {
+
+// Экран Full HD - типичный размер кадра смены слайда
+const QSize kScreenSize(1920, 1080);
+// Интервал кадра при 60 Гц
+const int kFrameIntervalMs = 16;
+// Корзины телеметрии - степени двойки в мкс. Интервал между кадрами смены
+// слайда от 2^15 мкс (32.8 мс) - пропущен хотя бы один кадр 60 Гц
+const int kDroppedFrameBucket = 15;
+const int kMaxDroppedFrames = 2;
+const int kLoadTimeoutMs = 10000;
+// Экран 4K и фотография 5K для замера отрисовки в режиме fill
+const QSize k4KScreenSize(3840, 2160);
+const QSize k5KImageSize(5120, 2880);
+
+// Фотография с преобладающим цветом color
+QImage wallpaperImage(const QColor& color, const QSize& size = QSize(3840, 2160))
+{
+    QImage image(size, QImage::Format_RGB32);
+    QPainter painter(&image);
+    QLinearGradient gradient(0, 0, image.width(), image.height());
+    gradient.setColorAt(0, color);
+    gradient.setColorAt(1, color.darker(200));
+    painter.fillRect(image.rect(), gradient);
+    painter.setPen(QPen(Qt::white, 2));
+    for (int x = 0; x < image.width(); x += 97) {
+        painter.drawLine(x, 0, image.width() - x, image.height());
+    }
+    painter.end();
+    return image;
+}
+
+// Виджет рабочего стола: фон рисует ImageRenderer
+class RendererHost : public QWidget
+{
+public:
+    explicit RendererHost(const QSize& size = kScreenSize)
+        : renderer(new ImageRenderer(this))
+    {
+        resize(size);
+    }
+
+    ImageRenderer* renderer;
+
+protected:
+    void paintEvent(QPaintEvent*) override
+    {
+        QPainter painter(this);
+        painter.fillRect(rect(), Qt::black);
+        renderer->paint(&painter, rect());
+    }
+};
+
+// Гистограмма телеметрии по имени; пустой объект - записей не было
+QJsonObject telemetryTiming(const char* name)
+{
+    return DockTelemetry::instance().toJson().value("timings").toObject().value(name).toObject();
+}
+
+// Отрисовка фона до кеширования кадра: каждое событие отрисовки
+// масштабирует изображение под экран и копирует обрезанную середину
+class UncachedBackground : public QWidget
+{
+public:
+    UncachedBackground(const QPixmap& pixmap, const QSize& size)
+        : background(pixmap)
+    {
+        resize(size);
+    }
+
+protected:
+    void paintEvent(QPaintEvent*) override
+    {
+        QPainter painter(this);
+        painter.fillRect(rect(), Qt::black);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        const QPixmap scaled = background.scaled(size(), Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+        const QPoint offset((scaled.width() - width()) / 2, (scaled.height() - height()) / 2);
+        painter.drawPixmap(rect(), scaled, QRect(offset, size()));
+    }
+
+private:
+    QPixmap background;
+};
+
+// Преобладающий канал показанного кадра: Qt::red, Qt::green, Qt::blue
+// или Qt::black, пока ничего не показано
+Qt::GlobalColor shownColor(RendererHost& host)
+{
+    const QRgb average = host.grab().toImage()
+        .scaled(1, 1, Qt::IgnoreAspectRatio, Qt::SmoothTransformation).pixel(0, 0);
+    const int red = qRed(average), green = qGreen(average), blue = qBlue(average);
+    if (qMax(red, qMax(green, blue)) < 40) {
+        return Qt::black;
+    }
+    if (red >= green && red >= blue) {
+        return Qt::red;
+    }
+    return green >= blue ? Qt::green : Qt::blue;
+}
+
+} // namespace
+
+class ImageRendererTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void crossfadeDoesNotDropFrames();
+    void unreadableImageIsSkipped();
+
+    void benchmarkPaint4K_data();
+    void benchmarkPaint4K();
+
+private:
+    // Копия подготовленного изображения source в каталоге слайд-шоу под именем name
+    void addImage(const QString& name, const QString& source);
+    void startSlideshow(RendererHost& host);
+    void advance(RendererHost& host);
+
+    QTemporaryDir m_sourceDir;
+    QScopedPointer<QTemporaryDir> m_slideshowDir;
+};
+
+void ImageRendererTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_sourceDir.isValid());
+
+    // Интервалы между кадрами смены слайда записывает сам ImageRenderer
+    DockTelemetry::instance().setEnabled(true, false);
+
+    QVERIFY(wallpaperImage(QColor(220, 40, 30)).save(m_sourceDir.filePath("red.jpg"), "JPEG", 90));
+    QVERIFY(wallpaperImage(QColor(30, 200, 40)).save(m_sourceDir.filePath("green.jpg"), "JPEG", 90));
+    QVERIFY(wallpaperImage(QColor(30, 50, 220)).save(m_sourceDir.filePath("blue.jpg"), "JPEG", 90));
+    QVERIFY(wallpaperImage(QColor(200, 120, 40), k5KImageSize).save(m_sourceDir.filePath("5k.jpg"), "JPEG", 90));
+
+    QFile broken(m_sourceDir.filePath("broken.jpg"));
+    QVERIFY(broken.open(QIODevice::WriteOnly));
+    broken.write("not an image");
+}
+
+void ImageRendererTest::init()
+{
+    // Свой каталог на каждый тест - загрузчик не отдаст изображения из кеша прошлого теста
+    m_slideshowDir.reset(new QTemporaryDir);
+    QVERIFY(m_slideshowDir->isValid());
+}
+
+void ImageRendererTest::cleanup()
+{
+    m_slideshowDir.reset();
+}
+
+void ImageRendererTest::addImage(const QString& name, const QString& source)
+{
+    QVERIFY(QFile::copy(m_sourceDir.filePath(source), m_slideshowDir->filePath(name)));
+}
+
+void ImageRendererTest::startSlideshow(RendererHost& host)
+{
+    host.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&host));
+
+    ScreenSettings settings;
+    settings.scaling = "fill";
+    settings.slideshowDirectory = m_slideshowDir->path();
+    host.renderer->setSettings(settings);
+
+    // Первое изображение каталога; следующее после этого готовится в фоне
+    QTRY_COMPARE_WITH_TIMEOUT(shownColor(host), Qt::red, kLoadTimeoutMs);
+
+    // Смена слайдов - только по вызову advance(), а не по таймеру слайд-шоу
+    host.renderer->hide();
+}
+
+void ImageRendererTest::advance(RendererHost& host)
+{
+    QVERIFY(QMetaObject::invokeMethod(host.renderer, "onSlideshowTimeout"));
+}
+
+void ImageRendererTest::crossfadeDoesNotDropFrames()
+{
+    addImage("1.jpg", "red.jpg");
+    addImage("2.jpg", "green.jpg");
+    addImage("3.jpg", "blue.jpg");
+
+    // Текущее и следующее изображения запрашиваются вместе при сканировании каталога
+    QSignalSpy readySpy(&WallpaperImageLoader::instance(), &WallpaperImageLoader::imageReady);
+    RendererHost host;
+    startSlideshow(host);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    // Следующее изображение готово - переход не ждет декодирования
+    auto readyKeys = [&readySpy]() {
+        QSet<QString> keys;
+        for (const QList<QVariant>& arguments : std::as_const(readySpy)) {
+            keys.insert(arguments.at(0).toString());
+        }
+        return keys.size();
+    };
+    QTRY_VERIFY_WITH_TIMEOUT(readyKeys() >= 2, kLoadTimeoutMs);
+
+    DockTelemetry::instance().reset();
+    advance(host);
+    // Анимация идет фиксированное время; кадры считает телеметрия
+    QTest::qWait(DesktopBackgroundSettings::SLIDESHOW_CROSSFADE_MS + 300);
+    QCOMPARE(shownColor(host), Qt::green);
+
+    const QJsonObject intervals = telemetryTiming("ImageRenderer::crossfadeFrameInterval");
+    const QJsonArray buckets = intervals.value("log2Buckets").toArray();
+    const int frames = intervals.value("count").toInt() + 1;
+    int dropped = 0;
+    for (int bucket = kDroppedFrameBucket; bucket < buckets.size(); ++bucket) {
+        dropped += buckets.at(bucket).toInt();
+    }
+
+    qDebug() << "transition start:" << telemetryTiming("ImageRenderer::startTransition").value("maxUs").toDouble() << "us,"
+             << "frames:" << frames << ", dropped:" << dropped
+             << ", max frame interval:" << intervals.value("maxUs").toDouble() / 1000.0 << "ms";
+
+    QVERIFY2(frames >= DesktopBackgroundSettings::SLIDESHOW_CROSSFADE_MS / kFrameIntervalMs / 2,
+             qPrintable(QString("Only %1 frames painted during the crossfade").arg(frames)));
+    QVERIFY2(dropped <= kMaxDroppedFrames, qPrintable(QString("%1 frames dropped").arg(dropped)));
+}
+
+void ImageRendererTest::unreadableImageIsSkipped()
+{
+    addImage("1.jpg", "red.jpg");
+    addImage("2.jpg", "broken.jpg");
+    addImage("3.jpg", "blue.jpg");
+
+    RendererHost host;
+    startSlideshow(host);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    advance(host);
+    QTRY_COMPARE_WITH_TIMEOUT(shownColor(host), Qt::blue, kLoadTimeoutMs);
+}
+
+void ImageRendererTest::benchmarkPaint4K_data()
+{
+    QTest::addColumn<bool>("frameCache");
+    QTest::newRow("rescale per paint") << false;
+    QTest::newRow("frame cache") << true;
+}
+
+void ImageRendererTest::benchmarkPaint4K()
+{
+    QFETCH(bool, frameCache);
+
+    // Полная перерисовка фона экрана 4K в режиме fill, как в DesktopBackground::paintEvent.
+    // Без кеша каждая отрисовка масштабирует фотографию 5K; с кешем - копирует готовый кадр
+    QScopedPointer<QWidget> background;
+    if (frameCache) {
+        addImage("1.jpg", "5k.jpg");
+        RendererHost* host = new RendererHost(k4KScreenSize);
+        background.reset(host);
+        host->show();
+        QVERIFY(QTest::qWaitForWindowExposed(host));
+
+        ScreenSettings settings;
+        settings.scaling = "fill";
+        settings.backgroundImage = m_slideshowDir->filePath("1.jpg");
+        host->renderer->setSettings(settings);
+        QTRY_VERIFY_WITH_TIMEOUT(shownColor(*host) == Qt::red, kLoadTimeoutMs);
+    } else {
+        const QPixmap source(m_sourceDir.filePath("5k.jpg"));
+        QVERIFY(!source.isNull());
+        background.reset(new UncachedBackground(source, k4KScreenSize));
+        background->show();
+        QVERIFY(QTest::qWaitForWindowExposed(background.data()));
+    }
+
+    QBENCHMARK {
+        background->repaint();
+    }
+}
+
+QTEST_MAIN(ImageRendererTest)
+#include "tst_imagerenderer.moc"
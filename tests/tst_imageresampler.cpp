@@ -0,0 +1,389 @@
+#include "ImageResampler.h"
+
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QtTest>
+#include <cmath>
+#include <vector>
+
+Q_DECLARE_METATYPE(ImageResampler::Filter)
+Q_DECLARE_METATYPE(ImageResampler::Implementation)
+
+namespace {
+
+// Допустимое отличие канала от эталона: два прохода с округлением до 8 бит
+// и веса в фиксированной точке
+const int kMaxChannelError = 2;
+const double kMaxMeanChannelError = 0.5;
+
+// Эталон в двойной точности по тем же формулам окна, что и ресемплер,
+// без промежуточного округления
+double sinc(double x)
+{
+    if (x == 0.0) {
+        return 1.0;
+    }
+    x *= M_PI;
+    return std::sin(x) / x;
+}
+
+double kernel(double x, ImageResampler::Filter filter)
+{
+    if (filter == ImageResampler::Area) {
+        return (x > -0.5 && x <= 0.5) ? 1.0 : 0.0;
+    }
+    return (x > -3.0 && x < 3.0) ? sinc(x) * sinc(x / 3.0) : 0.0;
+}
+
+struct ReferenceWeights {
+    int first = 0;
+    std::vector<double> weights;
+};
+
+std::vector<ReferenceWeights> referenceWeights(int inSize, int outSize, ImageResampler::Filter filter)
+{
+    const double support = filter == ImageResampler::Lanczos3 ? 3.0 : 0.5;
+    const double scale = double(inSize) / outSize;
+    const double filterScale = qMax(scale, 1.0);
+    const double scaledSupport = support * filterScale;
+
+    std::vector<ReferenceWeights> result(outSize);
+    for (int out = 0; out < outSize; ++out) {
+        const double center = (out + 0.5) * scale;
+        const int first = qMax(int(center - scaledSupport + 0.5), 0);
+        const int last = qMin(int(center + scaledSupport + 0.5), inSize);
+
+        ReferenceWeights& entry = result[out];
+        entry.first = first;
+        double total = 0.0;
+        for (int i = first; i < last; ++i) {
+            entry.weights.push_back(kernel((i - center + 0.5) / filterScale, filter));
+            total += entry.weights.back();
+        }
+        for (double& weight : entry.weights) {
+            weight = total != 0.0 ? weight / total : 0.0;
+        }
+    }
+    return result;
+}
+
+// Каналы b, g, r, a в порядке байтов пикселя
+using Plane = std::vector<double>;
+
+// Значения вне 0..255 и цвета больше альфы обрезаются после каждого прохода, как в ресемплере
+void clampPixel(double* pixel)
+{
+    pixel[3] = qBound(0.0, pixel[3], 255.0);
+    for (int channel = 0; channel < 3; ++channel) {
+        pixel[channel] = qBound(0.0, pixel[channel], pixel[3]);
+    }
+}
+
+QImage referenceResize(const QImage& image, const QSize& size, ImageResampler::Filter filter)
+{
+    const int inWidth = image.width();
+    const int inHeight = image.height();
+
+    Plane source(size_t(inWidth) * inHeight * 4);
+    for (int y = 0; y < inHeight; ++y) {
+        const uchar* line = image.constScanLine(y);
+        for (int x = 0; x < inWidth * 4; ++x) {
+            source[size_t(y) * inWidth * 4 + x] = line[x];
+        }
+    }
+
+    Plane horizontal = source;
+    if (inWidth != size.width()) {
+        const std::vector<ReferenceWeights> weights = referenceWeights(inWidth, size.width(), filter);
+        horizontal.assign(size_t(size.width()) * inHeight * 4, 0.0);
+        for (int y = 0; y < inHeight; ++y) {
+            for (int x = 0; x < size.width(); ++x) {
+                double* pixel = &horizontal[(size_t(y) * size.width() + x) * 4];
+                for (size_t i = 0; i < weights[x].weights.size(); ++i) {
+                    const double* in = &source[(size_t(y) * inWidth + weights[x].first + i) * 4];
+                    for (int channel = 0; channel < 4; ++channel) {
+                        pixel[channel] += in[channel] * weights[x].weights[i];
+                    }
+                }
+                clampPixel(pixel);
+            }
+        }
+    }
+
+    Plane vertical = horizontal;
+    if (inHeight != size.height()) {
+        const std::vector<ReferenceWeights> weights = referenceWeights(inHeight, size.height(), filter);
+        vertical.assign(size_t(size.width()) * size.height() * 4, 0.0);
+        for (int y = 0; y < size.height(); ++y) {
+            for (int x = 0; x < size.width(); ++x) {
+                double* pixel = &vertical[(size_t(y) * size.width() + x) * 4];
+                for (size_t i = 0; i < weights[y].weights.size(); ++i) {
+                    const double* in = &horizontal[((weights[y].first + i) * size.width() + x) * 4];
+                    for (int channel = 0; channel < 4; ++channel) {
+                        pixel[channel] += in[channel] * weights[y].weights[i];
+                    }
+                }
+                clampPixel(pixel);
+            }
+        }
+    }
+
+    QImage result(size, image.format());
+    for (int y = 0; y < size.height(); ++y) {
+        uchar* line = result.scanLine(y);
+        for (int x = 0; x < size.width() * 4; ++x) {
+            line[x] = uchar(std::lround(vertical[size_t(y) * size.width() * 4 + x]));
+        }
+    }
+    return result;
+}
+
+// Шум с прозрачностью - худший случай для отрицательных лепестков Ланцоша
+QImage noiseImage(const QSize& size, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < size.height(); ++y) {
+        quint32* line = reinterpret_cast<quint32*>(image.scanLine(y));
+        for (int x = 0; x < size.width(); ++x) {
+            const int alpha = random.bounded(256);
+            line[x] = qPremultiply(qRgba(random.bounded(256), random.bounded(256), random.bounded(256), alpha));
+        }
+    }
+    return image;
+}
+
+// Похожее на фотографию изображение: градиенты и резкие границы
+QImage photoImage(const QSize& size)
+{
+    QImage image(size, QImage::Format_RGB32);
+    QPainter painter(&image);
+    QLinearGradient gradient(0, 0, size.width(), size.height());
+    gradient.setColorAt(0, QColor(20, 40, 120));
+    gradient.setColorAt(0.5, QColor(240, 200, 80));
+    gradient.setColorAt(1, QColor(30, 120, 40));
+    painter.fillRect(image.rect(), gradient);
+    painter.setPen(QPen(Qt::white, qMax(1, size.width() / 400)));
+    for (int x = 0; x < size.width(); x += qMax(3, size.width() / 50)) {
+        painter.drawLine(x, 0, size.width() - x, size.height());
+    }
+    painter.end();
+    return image;
+}
+
+struct Difference {
+    int maxError = 0;
+    double meanError = 0.0;
+};
+
+Difference compare(const QImage& actual, const QImage& expected)
+{
+    Difference result;
+    qint64 total = 0;
+    for (int y = 0; y < expected.height(); ++y) {
+        const uchar* a = actual.constScanLine(y);
+        const uchar* e = expected.constScanLine(y);
+        for (int x = 0; x < expected.width() * 4; ++x) {
+            const int error = qAbs(int(a[x]) - int(e[x]));
+            result.maxError = qMax(result.maxError, error);
+            total += error;
+        }
+    }
+    result.meanError = double(total) / (qint64(expected.width()) * expected.height() * 4);
+    return result;
+}
+
+QList<QPair<const char*, ImageResampler::Implementation>> implementations()
+{
+    return {
+        {"scalar", ImageResampler::Scalar},
+        {"sse2", ImageResampler::Sse2},
+        {"avx2", ImageResampler::Avx2}
+    };
+}
+
+void addImplementationRows(const char* prefix)
+{
+    for (const auto& implementation : implementations()) {
+        QTest::newRow(qPrintable(QString("%1 %2").arg(prefix, implementation.first))) << implementation.second;
+    }
+}
+
+// Замеры ресемплера и, для сравнения, QImage::scaled с Qt::SmoothTransformation
+void addBenchmarkRows(const char* prefix)
+{
+    QTest::addColumn<ImageResampler::Implementation>("implementation");
+    QTest::addColumn<bool>("qtSmooth");
+    QTest::newRow("QImage::scaled smooth") << ImageResampler::Auto << true;
+    for (const auto& implementation : implementations()) {
+        QTest::newRow(qPrintable(QString("%1 %2").arg(prefix, implementation.first))) << implementation.second << false;
+    }
+}
+
+} // namespace
+
+class ImageResamplerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+
+    void matchesReference_data();
+    void matchesReference();
+    void implementationsAreIdentical_data();
+    void implementationsAreIdentical();
+    void keepsFormatAndSize();
+
+    void benchmark8KTo4K_data();
+    void benchmark8KTo4K();
+    void benchmark4KToThumbnail_data();
+    void benchmark4KToThumbnail();
+
+private:
+    void selectImplementation(ImageResampler::Implementation implementation);
+};
+
+void ImageResamplerTest::cleanup()
+{
+    ImageResampler::setImplementation(ImageResampler::Auto);
+}
+
+void ImageResamplerTest::selectImplementation(ImageResampler::Implementation implementation)
+{
+    if (!ImageResampler::setImplementation(implementation)) {
+        QSKIP("Implementation is not supported by this CPU or compiler");
+    }
+}
+
+void ImageResamplerTest::matchesReference_data()
+{
+    QTest::addColumn<ImageResampler::Implementation>("implementation");
+    QTest::addColumn<QImage>("source");
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<ImageResampler::Filter>("filter");
+
+    // Нечетные ширины проверяют хвосты векторных циклов
+    const QImage noise = noiseImage(QSize(301, 203), 7);
+    const QImage photo = photoImage(QSize(1003, 707));
+    for (const auto& implementation : implementations()) {
+        const QString name = implementation.first;
+        QTest::newRow(qPrintable(name + " noise down")) << implementation.second << noise << QSize(157, 97) << ImageResampler::Lanczos3;
+        QTest::newRow(qPrintable(name + " noise up")) << implementation.second << noise << QSize(613, 411) << ImageResampler::Lanczos3;
+        QTest::newRow(qPrintable(name + " noise width only")) << implementation.second << noise << QSize(99, 203) << ImageResampler::Lanczos3;
+        QTest::newRow(qPrintable(name + " noise height only")) << implementation.second << noise << QSize(301, 61) << ImageResampler::Lanczos3;
+        QTest::newRow(qPrintable(name + " noise area")) << implementation.second << noise << QSize(37, 23) << ImageResampler::Area;
+        QTest::newRow(qPrintable(name + " photo down")) << implementation.second << photo << QSize(517, 311) << ImageResampler::Lanczos3;
+        QTest::newRow(qPrintable(name + " photo thumbnail")) << implementation.second << photo << QSize(64, 45) << ImageResampler::Area;
+        QTest::newRow(qPrintable(name + " tiny source")) << implementation.second << noiseImage(QSize(3, 2), 11)
+                                                         << QSize(17, 9) << ImageResampler::Lanczos3;
+    }
+}
+
+void ImageResamplerTest::matchesReference()
+{
+    QFETCH(ImageResampler::Implementation, implementation);
+    QFETCH(QImage, source);
+    QFETCH(QSize, size);
+    QFETCH(ImageResampler::Filter, filter);
+
+    selectImplementation(implementation);
+
+    const QImage actual = ImageResampler::resize(source, size, filter);
+    const QImage expected = referenceResize(source, size, filter);
+    QCOMPARE(actual.size(), size);
+
+    const Difference difference = compare(actual, expected);
+    QVERIFY2(difference.maxError <= kMaxChannelError,
+             qPrintable(QString("max channel error %1").arg(difference.maxError)));
+    QVERIFY2(difference.meanError <= kMaxMeanChannelError,
+             qPrintable(QString("mean channel error %1").arg(difference.meanError)));
+}
+
+void ImageResamplerTest::implementationsAreIdentical_data()
+{
+    QTest::addColumn<ImageResampler::Implementation>("implementation");
+    addImplementationRows("vs scalar");
+}
+
+void ImageResamplerTest::implementationsAreIdentical()
+{
+    QFETCH(ImageResampler::Implementation, implementation);
+
+    // Целочисленная арифметика одинакова - результаты совпадают побитно
+    const QImage source = noiseImage(QSize(1021, 769), 3);
+    const QSize size(509, 383);
+
+    QVERIFY(ImageResampler::setImplementation(ImageResampler::Scalar));
+    const QImage expected = ImageResampler::resize(source, size);
+
+    selectImplementation(implementation);
+    QCOMPARE(ImageResampler::resize(source, size), expected);
+}
+
+void ImageResamplerTest::keepsFormatAndSize()
+{
+    const QImage rgb = photoImage(QSize(200, 100));
+    QCOMPARE(ImageResampler::resize(rgb, QSize(50, 25)).format(), QImage::Format_RGB32);
+
+    const QImage indexed = rgb.convertToFormat(QImage::Format_Indexed8);
+    QCOMPARE(ImageResampler::resize(indexed, QSize(50, 25)).format(), QImage::Format_RGB32);
+
+    const QImage alpha = noiseImage(QSize(200, 100), 5).convertToFormat(QImage::Format_ARGB32);
+    QCOMPARE(ImageResampler::resize(alpha, QSize(50, 25)).format(), QImage::Format_ARGB32_Premultiplied);
+
+    QCOMPARE(ImageResampler::scaled(rgb, QSize(64, 64)).size(), QSize(64, 32));
+    QCOMPARE(ImageResampler::scaled(rgb, QSize(64, 64), Qt::KeepAspectRatioByExpanding).size(), QSize(128, 64));
+    QVERIFY(ImageResampler::resize(QImage(), QSize(10, 10)).isNull());
+}
+
+void ImageResamplerTest::benchmark8KTo4K_data()
+{
+    addBenchmarkRows("lanczos3");
+}
+
+void ImageResamplerTest::benchmark8KTo4K()
+{
+    QFETCH(ImageResampler::Implementation, implementation);
+    QFETCH(bool, qtSmooth);
+    selectImplementation(implementation);
+
+    // Обои 8K на экране 4K
+    const QImage source = photoImage(QSize(7680, 4320));
+    if (qtSmooth) {
+        QBENCHMARK {
+            source.scaled(QSize(3840, 2160), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+        return;
+    }
+    QBENCHMARK {
+        ImageResampler::resize(source, QSize(3840, 2160));
+    }
+}
+
+void ImageResamplerTest::benchmark4KToThumbnail_data()
+{
+    addBenchmarkRows("area");
+}
+
+void ImageResamplerTest::benchmark4KToThumbnail()
+{
+    QFETCH(ImageResampler::Implementation, implementation);
+    QFETCH(bool, qtSmooth);
+    selectImplementation(implementation);
+
+    // Миниатюра скриншота для истории буфера обмена
+    const QImage source = photoImage(QSize(3840, 2160));
+    if (qtSmooth) {
+        QBENCHMARK {
+            source.scaled(QSize(64, 64), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+        return;
+    }
+    QBENCHMARK {
+        ImageResampler::scaled(source, QSize(64, 64), Qt::KeepAspectRatio, ImageResampler::Area);
+    }
+}
+
+QTEST_MAIN(ImageResamplerTest)
+#include "tst_imageresampler.moc"
@@ -0,0 +1,272 @@
+#include "Wallpaper/SharedVideoPlayer.h"
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QImage>
+#include <QTemporaryDir>
+#include <QVideoFrame>
+#include <QVideoFrameFormat>
+#include <QVideoSink>
+#include <QtTest>
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_WIN
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Бенчмарк нагрузки на процессор при показе одного видео на нескольких экранах.
+// Видео передается аргументом:
+//   tst_sharedvideoplayer -video <файл> [аргументы Qt Test]
+// Без аргумента раздача кадров измеряется на синтетических кадрах,
+// которые подаются в приемник плеера вместо декодера.
+
+namespace {
+
+const QSize kScreenSize(1920, 1080);
+const int kFirstFrameTimeoutMs = 10000;
+const int kMeasureMs = 5000;
+
+// Процессорное время всех потоков процесса, включая декодирование
+qint64 processCpuTimeUs()
+{
+#ifdef Q_OS_WIN
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    const quint64 kernel = (quint64(kernelTime.dwHighDateTime) << 32) | kernelTime.dwLowDateTime;
+    const quint64 user = (quint64(userTime.dwHighDateTime) << 32) | userTime.dwLowDateTime;
+    return qint64((kernel + user) / 10);
+#else
+    rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+    return qint64(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000
+           + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+// Кадр в формате декодера (NV12), содержимое для замеров не важно
+QVideoFrame syntheticFrame()
+{
+    return QVideoFrame(QVideoFrameFormat(kScreenSize, QVideoFrameFormat::Format_NV12));
+}
+
+// Экран: приемник кадров, каждый кадр переводится в RGB и масштабируется
+// под экран, как при программной отрисовке видео виджета
+struct Screen {
+    QObject client;
+    QVideoSink sink;
+    int frames = 0;
+
+    Screen()
+    {
+        QObject::connect(&sink, &QVideoSink::videoFrameChanged, &client, [this](const QVideoFrame& frame) {
+            ++frames;
+            const QImage image = frame.toImage();
+            if (!image.isNull()) {
+                const QImage scaled = image.scaled(kScreenSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+                Q_UNUSED(scaled);
+            }
+        });
+    }
+};
+
+} // namespace
+
+class SharedVideoPlayerTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SharedVideoPlayerTest(const QString& videoPath)
+        : m_videoPath(videoPath)
+    {
+    }
+
+private slots:
+    void cleanup();
+
+    void framesGoOnlyToPlayingScreens();
+
+    void fanOutPerScreen_data();
+    void fanOutPerScreen();
+
+    void cpuPerScreen_data();
+    void cpuPerScreen();
+
+private:
+    QString m_videoPath;
+};
+
+void SharedVideoPlayerTest::cleanup()
+{
+    // release удаляет плеер через deleteLater
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+void SharedVideoPlayerTest::framesGoOnlyToPlayingScreens()
+{
+    // Раздача кадров не зависит от того, открылся ли файл
+    QTemporaryDir dir;
+    SharedVideoPlayer* player = SharedVideoPlayer::acquire(dir.filePath("missing.mp4"));
+    Screen first, second;
+
+    player->addSink(&first.client, &first.sink);
+    player->addSink(&second.client, &second.sink);
+    QCOMPARE(player->sinkCount(), 2);
+    QCOMPARE(player->activeSinkCount(), 0);
+
+    player->setPlaying(&first.client, true);
+    player->setPlaying(&second.client, true);
+    QCOMPARE(player->activeSinkCount(), 2);
+
+    // Закрытый экран перестает получать кадры, но остается подключенным
+    player->setPlaying(&second.client, false);
+    QCOMPARE(player->sinkCount(), 2);
+    QCOMPARE(player->activeSinkCount(), 1);
+
+    player->setPlaying(&second.client, true);
+    QCOMPARE(player->activeSinkCount(), 2);
+
+    player->removeSink(&first.client);
+    QCOMPARE(player->sinkCount(), 1);
+    QCOMPARE(player->activeSinkCount(), 1);
+
+    // Повторное подключение того же приемника ничего не меняет
+    player->addSink(&second.client, &second.sink);
+    QCOMPARE(player->sinkCount(), 1);
+    QCOMPARE(player->activeSinkCount(), 1);
+
+    player->removeSink(&second.client);
+    player->setPlaying(&first.client, false);
+    player->setPlaying(&second.client, false);
+    SharedVideoPlayer::release(player);
+}
+
+void SharedVideoPlayerTest::fanOutPerScreen_data()
+{
+    cpuPerScreen_data();
+}
+
+void SharedVideoPlayerTest::fanOutPerScreen()
+{
+    QFETCH(int, screens);
+    QFETCH(int, covered);
+
+    // Файл не нужен: кадры подаются в приемник плеера напрямую, как от декодера
+    QTemporaryDir dir;
+    SharedVideoPlayer* player = SharedVideoPlayer::acquire(dir.filePath("missing.mp4"));
+    QVideoSink* decoderSink = player->findChild<QVideoSink*>(QString(), Qt::FindDirectChildrenOnly);
+    QVERIFY(decoderSink);
+
+    std::vector<std::unique_ptr<Screen>> screenList;
+    for (int i = 0; i < screens; ++i) {
+        screenList.push_back(std::make_unique<Screen>());
+        player->addSink(&screenList.back()->client, &screenList.back()->sink);
+        player->setPlaying(&screenList.back()->client, i >= covered);
+    }
+
+    // Время одного кадра: раздача и перевод в RGB с масштабированием на каждом
+    // открытом экране. Закрытые экраны не должны добавлять к нему ничего
+    int pushed = 0;
+    QBENCHMARK {
+        decoderSink->setVideoFrame(syntheticFrame());
+        ++pushed;
+    }
+
+    for (int i = 0; i < screens; ++i) {
+        QCOMPARE(screenList[i]->frames, i < covered ? 0 : pushed);
+    }
+
+    for (const auto& screen : screenList) {
+        player->removeSink(&screen->client);
+        player->setPlaying(&screen->client, false);
+    }
+    SharedVideoPlayer::release(player);
+}
+
+void SharedVideoPlayerTest::cpuPerScreen_data()
+{
+    QTest::addColumn<int>("screens");
+    QTest::addColumn<int>("covered");
+
+    QTest::newRow("1 screen") << 1 << 0;
+    QTest::newRow("2 screens") << 2 << 0;
+    QTest::newRow("3 screens") << 3 << 0;
+    QTest::newRow("3 screens, 2 covered") << 3 << 2;
+}
+
+void SharedVideoPlayerTest::cpuPerScreen()
+{
+    QFETCH(int, screens);
+    QFETCH(int, covered);
+
+    if (m_videoPath.isEmpty()) {
+        QSKIP("No video given: run with -video <file>");
+    }
+    QVERIFY2(QFileInfo::exists(m_videoPath), qPrintable(m_videoPath));
+
+    SharedVideoPlayer* player = SharedVideoPlayer::acquire(m_videoPath);
+    std::vector<std::unique_ptr<Screen>> screenList;
+    for (int i = 0; i < screens; ++i) {
+        screenList.push_back(std::make_unique<Screen>());
+        player->addSink(&screenList.back()->client, &screenList.back()->sink);
+        player->setPlaying(&screenList.back()->client, i >= covered);
+    }
+
+    // Последний экран в списке всегда воспроизводит видео
+    Screen& playing = *screenList.back();
+    QTRY_VERIFY_WITH_TIMEOUT(playing.frames > 0, kFirstFrameTimeoutMs);
+
+    for (const auto& screen : screenList) {
+        screen->frames = 0;
+    }
+    const qint64 cpuStartUs = processCpuTimeUs();
+    QElapsedTimer wallTimer;
+    wallTimer.start();
+    QTest::qWait(kMeasureMs);
+    const qint64 cpuUs = processCpuTimeUs() - cpuStartUs;
+    const qint64 wallUs = wallTimer.nsecsElapsed() / 1000;
+
+    const double cpuPercent = 100.0 * cpuUs / wallUs;
+    const double fps = playing.frames * 1000000.0 / wallUs;
+    qDebug() << "screens:" << screens << "covered:" << covered
+             << "CPU:" << QString::number(cpuPercent, 'f', 1) + "% of one core"
+             << "fps:" << QString::number(fps, 'f', 1);
+
+    // Закрытые экраны не получают кадров
+    for (int i = 0; i < covered; ++i) {
+        QCOMPARE(screenList[i]->frames, 0);
+    }
+    QVERIFY(playing.frames > 0);
+
+    for (const auto& screen : screenList) {
+        player->removeSink(&screen->client);
+        player->setPlaying(&screen->client, false);
+    }
+    SharedVideoPlayer::release(player);
+}
+
+int main(int argc, char* argv[])
+{
+    QGuiApplication app(argc, argv);
+
+    // Путь к видео - собственный аргумент, остальные передаются Qt Test
+    QStringList arguments = app.arguments();
+    QString videoPath;
+    const int index = arguments.indexOf("-video");
+    if (index > 0 && index + 1 < arguments.size()) {
+        videoPath = arguments.at(index + 1);
+        arguments.remove(index, 2);
+    }
+
+    SharedVideoPlayerTest test(videoPath);
+    return QTest::qExec(&test, arguments);
+}
+
+#include "tst_sharedvideoplayer.moc"
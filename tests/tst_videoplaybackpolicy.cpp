@@ -0,0 +1,217 @@
+#include "Wallpaper/VideoPlaybackPolicy.h"
+
+#include <QSignalSpy>
+#include <QWidget>
+#include <QtTest>
+
+Q_DECLARE_METATYPE(VideoPlaybackPolicy::Mode)
+
+class VideoPlaybackPolicyTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void decide_data();
+    void decide();
+    void highLoadNeedsConsecutiveSamples();
+    void highLoadHysteresis();
+    void unknownLoadKeepsState();
+
+    void coveredWindowPauses();
+    void batteryShowsPoster();
+    void sustainedLoadShowsPoster();
+    void hiddenWindowIsNotCovered();
+
+private:
+    // Окружение принадлежит политике; указатель остается действительным до следующего init()
+    ManualPlaybackEnvironment* m_environment = nullptr;
+    QWidget* m_window = nullptr;
+};
+
+void VideoPlaybackPolicyTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    qRegisterMetaType<VideoPlaybackPolicy::Mode>();
+}
+
+void VideoPlaybackPolicyTest::init()
+{
+    VideoPlaybackPolicy& policy = VideoPlaybackPolicy::instance();
+    m_environment = new ManualPlaybackEnvironment();
+    policy.setEnvironment(m_environment);
+    policy.setPosterOnBattery(true);
+    policy.setPosterOnHighLoad(true);
+
+    m_window = new QWidget();
+    m_window->resize(320, 240);
+    m_window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_window));
+    policy.attach(m_window);
+}
+
+void VideoPlaybackPolicyTest::cleanup()
+{
+    VideoPlaybackPolicy::instance().detach(m_window);
+    delete m_window;
+    m_window = nullptr;
+}
+
+void VideoPlaybackPolicyTest::decide_data()
+{
+    QTest::addColumn<bool>("covered");
+    QTest::addColumn<bool>("onBattery");
+    QTest::addColumn<bool>("highLoad");
+    QTest::addColumn<bool>("posterOnBattery");
+    QTest::addColumn<bool>("posterOnHighLoad");
+    QTest::addColumn<VideoPlaybackPolicy::Mode>("mode");
+
+    QTest::newRow("idle") << false << false << false << true << true << VideoPlaybackPolicy::Playing;
+    QTest::newRow("covered") << true << false << false << true << true << VideoPlaybackPolicy::Paused;
+    QTest::newRow("covered on battery") << true << true << true << true << true << VideoPlaybackPolicy::Paused;
+    QTest::newRow("battery") << false << true << false << true << true << VideoPlaybackPolicy::Poster;
+    QTest::newRow("battery, poster off") << false << true << false << false << true << VideoPlaybackPolicy::Playing;
+    QTest::newRow("high load") << false << false << true << true << true << VideoPlaybackPolicy::Poster;
+    QTest::newRow("high load, poster off") << false << false << true << true << false << VideoPlaybackPolicy::Playing;
+    QTest::newRow("battery and load, load off") << false << true << true << true << false << VideoPlaybackPolicy::Poster;
+}
+
+void VideoPlaybackPolicyTest::decide()
+{
+    QFETCH(bool, covered);
+    QFETCH(bool, onBattery);
+    QFETCH(bool, highLoad);
+    QFETCH(bool, posterOnBattery);
+    QFETCH(bool, posterOnHighLoad);
+    QFETCH(VideoPlaybackPolicy::Mode, mode);
+
+    QCOMPARE(VideoPlaybackPolicy::decide(covered, onBattery, highLoad, posterOnBattery, posterOnHighLoad), mode);
+}
+
+void VideoPlaybackPolicyTest::highLoadNeedsConsecutiveSamples()
+{
+    const int high = VideoPlaybackPolicy::HIGH_LOAD_PERCENT;
+    int samples = 0;
+    bool highLoad = false;
+
+    for (int i = 1; i < VideoPlaybackPolicy::HIGH_LOAD_SAMPLES; ++i) {
+        highLoad = VideoPlaybackPolicy::updateHighLoad(highLoad, high, samples);
+        QVERIFY(!highLoad);
+    }
+
+    // Кратковременный пик прерывается - счет начинается заново
+    highLoad = VideoPlaybackPolicy::updateHighLoad(highLoad, 10, samples);
+    QVERIFY(!highLoad);
+    QCOMPARE(samples, 0);
+
+    for (int i = 0; i < VideoPlaybackPolicy::HIGH_LOAD_SAMPLES; ++i) {
+        QVERIFY(!highLoad);
+        highLoad = VideoPlaybackPolicy::updateHighLoad(highLoad, 100, samples);
+    }
+    QVERIFY(highLoad);
+}
+
+void VideoPlaybackPolicyTest::highLoadHysteresis()
+{
+    int samples = VideoPlaybackPolicy::HIGH_LOAD_SAMPLES;
+    bool highLoad = true;
+
+    // Между порогами состояние сохраняется
+    highLoad = VideoPlaybackPolicy::updateHighLoad(highLoad, VideoPlaybackPolicy::NORMAL_LOAD_PERCENT, samples);
+    QVERIFY(highLoad);
+    highLoad = VideoPlaybackPolicy::updateHighLoad(highLoad, VideoPlaybackPolicy::HIGH_LOAD_PERCENT - 1, samples);
+    QVERIFY(highLoad);
+
+    highLoad = VideoPlaybackPolicy::updateHighLoad(highLoad, VideoPlaybackPolicy::NORMAL_LOAD_PERCENT - 1, samples);
+    QVERIFY(!highLoad);
+
+    // Загрузка между порогами не включает режим заново
+    highLoad = VideoPlaybackPolicy::updateHighLoad(highLoad, VideoPlaybackPolicy::HIGH_LOAD_PERCENT - 1, samples);
+    QVERIFY(!highLoad);
+}
+
+void VideoPlaybackPolicyTest::unknownLoadKeepsState()
+{
+    int samples = 1;
+    QVERIFY(VideoPlaybackPolicy::updateHighLoad(true, -1, samples));
+    QVERIFY(!VideoPlaybackPolicy::updateHighLoad(false, -1, samples));
+    QCOMPARE(samples, 1);
+}
+
+void VideoPlaybackPolicyTest::coveredWindowPauses()
+{
+    VideoPlaybackPolicy& policy = VideoPlaybackPolicy::instance();
+    QSignalSpy modeChanged(&policy, &VideoPlaybackPolicy::modeChanged);
+
+    m_environment->setWindowCovered(quintptr(m_window->winId()), true);
+    policy.evaluate();
+    QCOMPARE(policy.mode(m_window), VideoPlaybackPolicy::Paused);
+    QCOMPARE(modeChanged.count(), 1);
+    QCOMPARE(modeChanged.first().at(1).value<VideoPlaybackPolicy::Mode>(), VideoPlaybackPolicy::Paused);
+
+    // Без изменений сигнал не повторяется
+    policy.evaluate();
+    QCOMPARE(modeChanged.count(), 1);
+
+    m_environment->setWindowCovered(quintptr(m_window->winId()), false);
+    policy.evaluate();
+    QCOMPARE(policy.mode(m_window), VideoPlaybackPolicy::Playing);
+    QCOMPARE(modeChanged.count(), 2);
+}
+
+void VideoPlaybackPolicyTest::batteryShowsPoster()
+{
+    VideoPlaybackPolicy& policy = VideoPlaybackPolicy::instance();
+
+    m_environment->setOnBattery(true);
+    policy.evaluate();
+    QCOMPARE(policy.mode(m_window), VideoPlaybackPolicy::Poster);
+
+    // Настройка пересчитывает режим сразу
+    policy.setPosterOnBattery(false);
+    QCOMPARE(policy.mode(m_window), VideoPlaybackPolicy::Playing);
+
+    policy.setPosterOnBattery(true);
+    QCOMPARE(policy.mode(m_window), VideoPlaybackPolicy::Poster);
+
+    m_environment->setOnBattery(false);
+    policy.evaluate();
+    QCOMPARE(policy.mode(m_window), VideoPlaybackPolicy::Playing);
+}
+
+void VideoPlaybackPolicyTest::sustainedLoadShowsPoster()
+{
+    VideoPlaybackPolicy& policy = VideoPlaybackPolicy::instance();
+
+    m_environment->setCpuLoad(95);
+    for (int i = 1; i < VideoPlaybackPolicy::HIGH_LOAD_SAMPLES; ++i) {
+        policy.evaluate();
+        QCOMPARE(policy.mode(m_window), VideoPlaybackPolicy::Playing);
+    }
+    policy.evaluate();
+    QCOMPARE(policy.mode(m_window), VideoPlaybackPolicy::Poster);
+
+    m_environment->setCpuLoad(70);
+    policy.evaluate();
+    QCOMPARE(policy.mode(m_window), VideoPlaybackPolicy::Poster);
+
+    m_environment->setCpuLoad(20);
+    policy.evaluate();
+    QCOMPARE(policy.mode(m_window), VideoPlaybackPolicy::Playing);
+}
+
+void VideoPlaybackPolicyTest::hiddenWindowIsNotCovered()
+{
+    VideoPlaybackPolicy& policy = VideoPlaybackPolicy::instance();
+
+    m_environment->setWindowCovered(quintptr(m_window->winId()), true);
+    m_window->hide();
+    policy.evaluate();
+    QCOMPARE(policy.mode(m_window), VideoPlaybackPolicy::Playing);
+}
+
+QTEST_MAIN(VideoPlaybackPolicyTest)
+#include "tst_videoplaybackpolicy.moc"
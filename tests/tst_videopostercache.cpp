@@ -0,0 +1,267 @@
+#include "Wallpaper/VideoPosterCache.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest>
+
+namespace {
+
+const int kWriteTimeoutMs = 10000;
+const QSize kCanvasSize(320, 180);
+const QRect kTargetRect(40, 0, 240, 180);
+
+QImage solidFrame(const QColor& color)
+{
+    QImage frame(kTargetRect.size(), QImage::Format_RGB32);
+    frame.fill(color);
+    return frame;
+}
+
+// JPEG сжимает с потерями - цвета сравниваются с допуском
+bool isClose(QRgb actual, const QColor& expected)
+{
+    const int tolerance = 16;
+    return qAbs(qRed(actual) - expected.red()) <= tolerance
+           && qAbs(qGreen(actual) - expected.green()) <= tolerance
+           && qAbs(qBlue(actual) - expected.blue()) <= tolerance;
+}
+
+} // namespace
+
+class VideoPosterCacheTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void keyIsStable();
+    void keyChangesWithInputs();
+    void storeThenLoad();
+    void missingPosterLoadsEmpty();
+    void keepsNewestPosters();
+    void overwriteIsAtomic();
+
+private:
+    // Видео с уникальным именем - у каждого теста свои ключи кеша
+    QString createVideo(const QString& name);
+    QString key(const QString& videoPath) const;
+    QString posterPath(const QString& key) const;
+    QStringList posterFiles() const;
+    // Ждет, пока фоновая запись создаст файл кадра
+    bool waitForPoster(const QString& key) const;
+
+    QTemporaryDir m_dir;
+};
+
+void VideoPosterCacheTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_dir.isValid());
+
+    QSettings settings("MyCompany", "DockApp");
+    settings.setValue("Video/PosterCache", true);
+    settings.sync();
+
+    // Каталог кеша берется из AppDataLocation при первом instance()
+    VideoPosterCache& cache = VideoPosterCache::instance();
+    QVERIFY(cache.isEnabled());
+    QCOMPARE(cache.posterDirectory(),
+             QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/video_posters");
+    QVERIFY(QFileInfo(cache.posterDirectory()).isDir());
+    cleanup();
+}
+
+void VideoPosterCacheTest::cleanup()
+{
+    QDir dir(VideoPosterCache::instance().posterDirectory());
+    for (const QString& name : dir.entryList(QDir::Files)) {
+        dir.remove(name);
+    }
+}
+
+QString VideoPosterCacheTest::createVideo(const QString& name)
+{
+    const QString path = m_dir.filePath(name);
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(name.toUtf8());
+    }
+    return path;
+}
+
+QString VideoPosterCacheTest::key(const QString& videoPath) const
+{
+    return VideoPosterCache::posterKey(videoPath, QSize(1920, 1080), "fill", "center", 1.0);
+}
+
+QString VideoPosterCacheTest::posterPath(const QString& key) const
+{
+    return VideoPosterCache::instance().posterDirectory() + '/' + key + ".jpg";
+}
+
+QStringList VideoPosterCacheTest::posterFiles() const
+{
+    return QDir(VideoPosterCache::instance().posterDirectory()).entryList(QDir::Files, QDir::Name);
+}
+
+bool VideoPosterCacheTest::waitForPoster(const QString& key) const
+{
+    const QString path = posterPath(key);
+    return QTest::qWaitFor([&path]() { return QFile::exists(path); }, kWriteTimeoutMs);
+}
+
+void VideoPosterCacheTest::keyIsStable()
+{
+    const QString video = createVideo("stable.mp4");
+    const QString first = key(video);
+
+    // Ключ - имя файла: SHA-1 в hex
+    QCOMPARE(first.size(), 40);
+    QVERIFY(QRegularExpression("^[0-9a-f]+$").match(first).hasMatch());
+
+    // Тот же файл по относительному пути и при повторном вызове дает тот же ключ
+    QCOMPARE(key(video), first);
+    QCOMPARE(key(QDir::current().relativeFilePath(video)), first);
+
+    // Без файла или размера экрана кадр не кешируется
+    QVERIFY(key(m_dir.filePath("missing.mp4")).isEmpty());
+    QVERIFY(key(QString()).isEmpty());
+    QVERIFY(VideoPosterCache::posterKey(video, QSize(), "fill", "center", 1.0).isEmpty());
+}
+
+void VideoPosterCacheTest::keyChangesWithInputs()
+{
+    const QString video = createVideo("inputs.mp4");
+    const QString base = key(video);
+
+    QVERIFY(key(createVideo("other.mp4")) != base);
+    QVERIFY(VideoPosterCache::posterKey(video, QSize(2560, 1440), "fill", "center", 1.0) != base);
+    QVERIFY(VideoPosterCache::posterKey(video, QSize(1920, 1080), "fit", "center", 1.0) != base);
+    QVERIFY(VideoPosterCache::posterKey(video, QSize(1920, 1080), "fill", "top", 1.0) != base);
+    QVERIFY(VideoPosterCache::posterKey(video, QSize(1920, 1080), "fill", "center", 1.5) != base);
+
+    // Замененный файл с тем же именем дает другой ключ
+    QFile file(video);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(QDateTime::currentDateTime().addSecs(-3600), QFileDevice::FileModificationTime));
+    file.close();
+    QVERIFY(key(video) != base);
+}
+
+void VideoPosterCacheTest::storeThenLoad()
+{
+    VideoPosterCache& cache = VideoPosterCache::instance();
+    const QString posterKey = key(createVideo("roundtrip.mp4"));
+
+    cache.store(posterKey, solidFrame(Qt::red), kCanvasSize, kTargetRect);
+    QVERIFY(waitForPoster(posterKey));
+
+    QSignalSpy loaded(&cache, &VideoPosterCache::posterLoaded);
+    cache.load(posterKey);
+    QVERIFY(loaded.wait(kWriteTimeoutMs));
+    QCOMPARE(loaded.first().at(0).toString(), posterKey);
+
+    // Кадр разложен на холсте экрана: поля черные, область видео - кадр
+    const QImage image = loaded.first().at(1).value<QImage>();
+    QCOMPARE(image.size(), kCanvasSize);
+    QCOMPARE(image.format(), QImage::Format_RGB32);
+    QVERIFY(isClose(image.pixel(kTargetRect.center()), Qt::red));
+    QVERIFY(isClose(image.pixel(5, kCanvasSize.height() / 2), Qt::black));
+    QVERIFY(isClose(image.pixel(kCanvasSize.width() - 5, kCanvasSize.height() / 2), Qt::black));
+}
+
+void VideoPosterCacheTest::missingPosterLoadsEmpty()
+{
+    VideoPosterCache& cache = VideoPosterCache::instance();
+    const QString posterKey = key(createVideo("missing-poster.mp4"));
+
+    QSignalSpy loaded(&cache, &VideoPosterCache::posterLoaded);
+    cache.load(posterKey);
+    QVERIFY(loaded.wait(kWriteTimeoutMs));
+    QCOMPARE(loaded.first().at(0).toString(), posterKey);
+    QVERIFY(loaded.first().at(1).value<QImage>().isNull());
+}
+
+void VideoPosterCacheTest::keepsNewestPosters()
+{
+    VideoPosterCache& cache = VideoPosterCache::instance();
+    const int total = VideoPosterCache::MAX_POSTERS + 1;
+
+    QStringList keys;
+    for (int i = 0; i < VideoPosterCache::MAX_POSTERS; ++i) {
+        keys.append(key(createVideo(QString("evict-%1.mp4").arg(i))));
+        cache.store(keys.last(), solidFrame(Qt::blue), kCanvasSize, kTargetRect);
+    }
+    for (const QString& posterKey : keys) {
+        QVERIFY(waitForPoster(posterKey));
+    }
+    QCOMPARE(posterFiles().size(), VideoPosterCache::MAX_POSTERS);
+
+    // Время изменения файлов на диске грубое - задаем порядок явно,
+    // первый кадр самый старый
+    const QDateTime now = QDateTime::currentDateTime();
+    for (int i = 0; i < keys.size(); ++i) {
+        QFile file(posterPath(keys[i]));
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(now.addSecs(i - total), QFileDevice::FileModificationTime));
+    }
+
+    keys.append(key(createVideo(QString("evict-%1.mp4").arg(total - 1))));
+    cache.store(keys.last(), solidFrame(Qt::blue), kCanvasSize, kTargetRect);
+    QVERIFY(waitForPoster(keys.last()));
+
+    // Лишний кадр удаляется после записи нового - удален самый старый
+    QTRY_VERIFY_WITH_TIMEOUT(!QFile::exists(posterPath(keys.first())), kWriteTimeoutMs);
+    QCOMPARE(posterFiles().size(), VideoPosterCache::MAX_POSTERS);
+    for (int i = 1; i < keys.size(); ++i) {
+        QVERIFY2(QFile::exists(posterPath(keys[i])), qPrintable(keys[i]));
+    }
+}
+
+void VideoPosterCacheTest::overwriteIsAtomic()
+{
+    VideoPosterCache& cache = VideoPosterCache::instance();
+    const QString posterKey = key(createVideo("atomic.mp4"));
+    const QString path = posterPath(posterKey);
+
+    cache.store(posterKey, solidFrame(Qt::red), kCanvasSize, kTargetRect);
+    QVERIFY(waitForPoster(posterKey));
+    QTRY_COMPARE_WITH_TIMEOUT(posterFiles(), QStringList{posterKey + ".jpg"}, kWriteTimeoutMs);
+
+    // Пока пишется новый кадр, на месте файла всегда целый старый или новый кадр:
+    // QSaveFile пишет во временный файл и подменяет его одним переименованием
+    cache.store(posterKey, solidFrame(Qt::green), kCanvasSize, kTargetRect);
+
+    bool replaced = false;
+    QElapsedTimer timer;
+    timer.start();
+    while (!replaced && timer.elapsed() < kWriteTimeoutMs) {
+        QImageReader reader(path);
+        const QImage image = reader.read();
+        QVERIFY2(!image.isNull(), qPrintable(reader.errorString()));
+        QCOMPARE(image.size(), kCanvasSize);
+
+        const QRgb center = image.pixel(kTargetRect.center());
+        replaced = isClose(center, Qt::green);
+        QVERIFY(replaced || isClose(center, Qt::red));
+        QCoreApplication::processEvents();
+    }
+    QVERIFY(replaced);
+
+    // Временных файлов записи не остается
+    QTRY_COMPARE_WITH_TIMEOUT(posterFiles(), QStringList{posterKey + ".jpg"}, kWriteTimeoutMs);
+}
+
+QTEST_MAIN(VideoPosterCacheTest)
+
+#include "tst_videopostercache.moc"
@@ -0,0 +1,161 @@
+#include "Wallpaper/VideoTranscodeCache.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QtTest>
+
+namespace {
+
+const int kFinishTimeoutMs = 10000;
+
+// Заглушка ffmpeg: последний аргумент - выходной файл. Видео с "slow" в имени
+// "кодируется" дольше любого теста, остальные - за доли секунды
+const char* kStubEncoder =
+    "#!/bin/sh\n"
+    "input=\n"
+    "previous=\n"
+    "for argument; do\n"
+    "    if [ \"$previous\" = \"-i\" ]; then input=$argument; fi\n"
+    "    previous=$argument\n"
+    "done\n"
+    "case \"$input\" in\n"
+    "    *slow*) exec sleep 60 ;;\n"
+    "esac\n"
+    "sleep 0.2\n"
+    "printf 'webm' > \"$previous\"\n";
+
+} // namespace
+
+class VideoTranscodeCacheTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void convertsAndCaches();
+    void abortingRunningJobStartsNextOne();
+    void abortedJobLeavesNoOutput();
+
+private:
+    // Видео с уникальным содержимым - у каждого теста свои ключи кеша
+    QString createVideo(const QString& name);
+    VideoTranscodeRequest request(const QString& path) const;
+
+    QTemporaryDir m_dir;
+};
+
+void VideoTranscodeCacheTest::initTestCase()
+{
+#ifdef Q_OS_WIN
+    QSKIP("The stub encoder is a POSIX shell script");
+#endif
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_dir.isValid());
+
+    // Кеш создается во временном каталоге системы - подменяем его до первого instance()
+    QVERIFY(QDir().mkpath(m_dir.filePath("tmp")));
+    qputenv("TMPDIR", QFile::encodeName(m_dir.filePath("tmp")));
+
+    const QString encoder = m_dir.filePath("ffmpeg-stub.sh");
+    QFile script(encoder);
+    QVERIFY(script.open(QIODevice::WriteOnly));
+    script.write(kStubEncoder);
+    script.close();
+    QVERIFY(script.setPermissions(script.permissions() | QFileDevice::ExeOwner));
+
+    QSettings settings("MyCompany", "DockApp");
+    settings.setValue("Video/EncoderPath", encoder);
+    settings.sync();
+
+    QCOMPARE(VideoTranscodeCache::instance().cacheDirectory(), m_dir.filePath("tmp") + "/VideoWallpaperCache");
+}
+
+QString VideoTranscodeCacheTest::createVideo(const QString& name)
+{
+    const QString path = m_dir.filePath(name);
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(name.toUtf8());
+    }
+    return path;
+}
+
+VideoTranscodeRequest VideoTranscodeCacheTest::request(const QString& path) const
+{
+    VideoTranscodeRequest request;
+    request.inputPath = path;
+    request.videoSize = QSize(1920, 1080);
+    return request;
+}
+
+void VideoTranscodeCacheTest::convertsAndCaches()
+{
+    VideoTranscodeCache& cache = VideoTranscodeCache::instance();
+    QSignalSpy finished(&cache, &VideoTranscodeCache::finished);
+
+    QString readyPath;
+    const QString key = cache.acquire(request(createVideo("cached.mp4")), &readyPath);
+    QVERIFY(!key.isEmpty());
+    QVERIFY(readyPath.isEmpty());
+
+    QVERIFY(finished.wait(kFinishTimeoutMs));
+    QCOMPARE(finished.first().at(0).toString(), key);
+    const QString outputPath = finished.first().at(1).toString();
+    QVERIFY(QFileInfo(outputPath).size() > 0);
+    QVERIFY(!QFile::exists(outputPath + ".part"));
+
+    // Второй экран с тем же видео получает файл сразу
+    QCOMPARE(cache.acquire(request(m_dir.filePath("cached.mp4")), &readyPath), key);
+    QCOMPARE(readyPath, outputPath);
+
+    cache.release(key);
+    cache.release(key);
+}
+
+void VideoTranscodeCacheTest::abortingRunningJobStartsNextOne()
+{
+    VideoTranscodeCache& cache = VideoTranscodeCache::instance();
+    QSignalSpy finished(&cache, &VideoTranscodeCache::finished);
+
+    QString readyPath;
+    const QString slowKey = cache.acquire(request(createVideo("slow-running.mp4")), &readyPath);
+    const QString nextKey = cache.acquire(request(createVideo("queued.mp4")), &readyPath);
+    QVERIFY(!slowKey.isEmpty());
+    QVERIFY(!nextKey.isEmpty());
+
+    // Отмена идущей конвертации запускает следующую из очереди, и та доходит до конца
+    cache.release(slowKey);
+
+    QVERIFY(finished.wait(kFinishTimeoutMs));
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(finished.first().at(0).toString(), nextKey);
+    QVERIFY(QFileInfo(finished.first().at(1).toString()).size() > 0);
+
+    cache.release(nextKey);
+}
+
+void VideoTranscodeCacheTest::abortedJobLeavesNoOutput()
+{
+    VideoTranscodeCache& cache = VideoTranscodeCache::instance();
+    QSignalSpy finished(&cache, &VideoTranscodeCache::finished);
+
+    QString readyPath;
+    const QString key = cache.acquire(request(createVideo("slow-aborted.mp4")), &readyPath);
+    QVERIFY(!key.isEmpty());
+    QTest::qWait(200);
+
+    cache.release(key);
+
+    // Отмененная конвертация не сообщает о завершении и не оставляет файлов
+    QTest::qWait(500);
+    QCOMPARE(finished.count(), 0);
+    const QString outputPath = cache.cacheDirectory() + "/" + key + ".webm";
+    QVERIFY(!QFile::exists(outputPath));
+    QVERIFY(!QFile::exists(outputPath + ".part"));
+}
+
+QTEST_GUILESS_MAIN(VideoTranscodeCacheTest)
+#include "tst_videotranscodecache.moc"
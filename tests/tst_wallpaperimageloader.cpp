@@ -0,0 +1,185 @@
+#include "Wallpaper/WallpaperImageLoader.h"
+
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest>
+
+namespace {
+
+// Фотография 6000x4000 (24 Мп): в полном разрешении около 92 МБ
+const QSize kPhotoSize(6000, 4000);
+const int kLoadTimeoutMs = 20000;
+
+// Экраны в физических пикселях, включая повернутый
+const QList<QSize> kScreens = {
+    QSize(3840, 2160),
+    QSize(2560, 1440),
+    QSize(1920, 1080),
+    QSize(1080, 1920)
+};
+
+QImage photo()
+{
+    QImage image(kPhotoSize, QImage::Format_RGB32);
+    QPainter painter(&image);
+    QLinearGradient gradient(0, 0, image.width(), image.height());
+    gradient.setColorAt(0, QColor(200, 90, 40));
+    gradient.setColorAt(1, QColor(20, 60, 160));
+    painter.fillRect(image.rect(), gradient);
+    painter.setPen(QPen(Qt::white, 3));
+    for (int x = 0; x < image.width(); x += 101) {
+        painter.drawLine(x, 0, image.width() - x, image.height());
+    }
+    return image;
+}
+
+qint64 imageBytes(const QSize& size)
+{
+    return qint64(size.width()) * size.height() * 4;
+}
+
+} // namespace
+
+class WallpaperImageLoaderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void loadScreens_data();
+    void loadScreens();
+    void sameScreensShareOneImage();
+
+private:
+    // Захватывает изображения экранов и ждет все; время загрузки - в loadMs
+    QStringList acquireAll(const QList<WallpaperImageRequest>& requests, qint64* loadMs);
+    WallpaperImageRequest request(const QSize& screen, const QString& scaling) const;
+
+    QTemporaryDir m_dir;
+    QString m_photoPath;
+};
+
+void WallpaperImageLoaderTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_dir.isValid());
+    m_photoPath = m_dir.filePath("photo.jpg");
+    QVERIFY(photo().save(m_photoPath, "JPEG", 90));
+}
+
+void WallpaperImageLoaderTest::cleanup()
+{
+    // Все изображения освобождены - в памяти ничего не остается
+    QCOMPARE(WallpaperImageLoader::instance().memoryBytes(), 0);
+}
+
+WallpaperImageRequest WallpaperImageLoaderTest::request(const QSize& screen, const QString& scaling) const
+{
+    WallpaperImageRequest result;
+    result.path = m_photoPath;
+    result.targetSize = screen;
+    result.scaling = scaling;
+    result.alignment = "center";
+    return result;
+}
+
+QStringList WallpaperImageLoaderTest::acquireAll(const QList<WallpaperImageRequest>& requests, qint64* loadMs)
+{
+    WallpaperImageLoader& loader = WallpaperImageLoader::instance();
+    QSignalSpy readySpy(&loader, &WallpaperImageLoader::imageReady);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QStringList keys;
+    QSet<QString> pending;
+    for (const WallpaperImageRequest& screenRequest : requests) {
+        QImage readyImage;
+        const QString key = loader.acquire(screenRequest, &readyImage);
+        keys.append(key);
+        if (readyImage.isNull()) {
+            pending.insert(key);
+        }
+    }
+
+    auto collectReady = [&]() {
+        for (const QList<QVariant>& arguments : std::as_const(readySpy)) {
+            pending.remove(arguments.at(0).toString());
+        }
+        return pending.isEmpty();
+    };
+    const bool allReady = QTest::qWaitFor(collectReady, kLoadTimeoutMs);
+    *loadMs = timer.elapsed();
+    if (!allReady) {
+        qWarning() << "Images not loaded:" << pending;
+    }
+    return keys;
+}
+
+void WallpaperImageLoaderTest::loadScreens_data()
+{
+    QTest::addColumn<QString>("scaling");
+    QTest::addColumn<int>("screenCount");
+
+    for (const QString& scaling : {QString("fill"), QString("fit")}) {
+        for (int count = 1; count <= kScreens.size(); ++count) {
+            QTest::addRow("%s, %d screens", qPrintable(scaling), count) << scaling << count;
+        }
+    }
+}
+
+void WallpaperImageLoaderTest::loadScreens()
+{
+    QFETCH(QString, scaling);
+    QFETCH(int, screenCount);
+
+    WallpaperImageLoader& loader = WallpaperImageLoader::instance();
+
+    QList<WallpaperImageRequest> requests;
+    qint64 screenBytes = 0;
+    for (int i = 0; i < screenCount; ++i) {
+        requests.append(request(kScreens.at(i), scaling));
+        screenBytes += imageBytes(kScreens.at(i));
+    }
+
+    qint64 loadMs = 0;
+    const QStringList keys = acquireAll(requests, &loadMs);
+    const qint64 memory = loader.memoryBytes();
+    qDebug() << scaling << screenCount << "screens: loaded in" << loadMs << "ms," << memory / (1024 * 1024)
+             << "MB (photo in full resolution:" << imageBytes(kPhotoSize) / (1024 * 1024) << "MB)";
+
+    // После загрузки в памяти только изображения экранов: исходник
+    // в полном разрешении не задерживается
+    QVERIFY2(memory <= screenBytes,
+             qPrintable(QString("%1 bytes kept for %2 bytes of screens").arg(memory).arg(screenBytes)));
+
+    for (const QString& key : keys) {
+        loader.release(key);
+    }
+}
+
+void WallpaperImageLoaderTest::sameScreensShareOneImage()
+{
+    WallpaperImageLoader& loader = WallpaperImageLoader::instance();
+    const WallpaperImageRequest screenRequest = request(kScreens.first(), "fill");
+
+    qint64 loadMs = 0;
+    const QStringList keys = acquireAll({screenRequest, screenRequest, screenRequest}, &loadMs);
+    QCOMPARE(keys.at(0), keys.at(1));
+    QCOMPARE(keys.at(0), keys.at(2));
+    QCOMPARE(loader.memoryBytes(), imageBytes(kScreens.first()));
+
+    // Изображение остается, пока его использует хотя бы один экран
+    loader.release(keys.at(0));
+    loader.release(keys.at(1));
+    QCOMPARE(loader.memoryBytes(), imageBytes(kScreens.first()));
+    loader.release(keys.at(2));
+}
+
+QTEST_MAIN(WallpaperImageLoaderTest)
+#include "tst_wallpaperimageloader.moc"
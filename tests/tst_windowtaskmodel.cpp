@@ -0,0 +1,286 @@
+#include "WindowTaskModel.h"
+
+#include <QElapsedTimer>
+#include <QSet>
+#include <QSignalSpy>
+#include <QtTest>
+#include <algorithm>
+
+namespace {
+
+// Заглушка оконной системы: окна хранятся в памяти, события посылает тест
+class MockWindowSystemBackend : public WindowSystemBackend
+{
+public:
+    QList<quintptr> enumerateWindows() const override
+    {
+        // Сверху вниз, как EnumWindows
+        QList<quintptr> result = order;
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+    bool queryWindow(quintptr window, TaskWindowInfo& info) const override
+    {
+        ++queryCalls;
+        auto it = windows.constFind(window);
+        if (it == windows.constEnd() || it.value().title.isEmpty()) {
+            return false;
+        }
+        info = it.value();
+        return true;
+    }
+
+    QString windowTitle(quintptr window) const override
+    {
+        ++titleCalls;
+        return windows.value(window).title;
+    }
+
+    quint32 untitledWindowProcess(quintptr window) const override
+    {
+        auto it = windows.constFind(window);
+        if (it == windows.constEnd() || !it.value().title.isEmpty()) {
+            return 0;
+        }
+        return it.value().processId;
+    }
+
+    bool installHooks(WindowTaskModel*) override { return true; }
+    void removeHooks() override { watchedProcesses.clear(); }
+
+    void setTitleWatch(quint32 processId, bool watch) override
+    {
+        if (watch) {
+            watchedProcesses.insert(processId);
+        } else {
+            watchedProcesses.remove(processId);
+        }
+    }
+
+    quintptr create(quint32 processId, const QString& title)
+    {
+        TaskWindowInfo info;
+        info.id = ++lastId;
+        info.title = title;
+        info.processId = processId;
+        info.processName = QString("app%1.exe").arg(processId);
+        windows.insert(info.id, info);
+        order.append(info.id);
+        return info.id;
+    }
+
+    void destroy(quintptr id)
+    {
+        windows.remove(id);
+        order.removeOne(id);
+    }
+
+    QHash<quintptr, TaskWindowInfo> windows;
+    QList<quintptr> order;   // Снизу вверх
+    QSet<quint32> watchedProcesses;
+    quintptr lastId = 0;
+
+    mutable int queryCalls = 0;
+    mutable int titleCalls = 0;
+};
+
+} // namespace
+
+class WindowTaskModelTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanupTestCase();
+
+    void resyncLoadsExistingWindows();
+    void showAndDestroyUpdateIncrementally();
+    void activationOrdersWindows();
+    void titleChangeOfTrackedWindowReadsTitleOnly();
+    void titleChangeOfUnknownWindowIsIgnored();
+    void windowTitledAfterShowIsAdded();
+    void titlesAreWatchedOnlyForTrackedProcesses();
+
+    void benchmarkWindowChurn();
+
+private:
+    WindowTaskModel& model() { return WindowTaskModel::instance(); }
+    MockWindowSystemBackend* m_backend = nullptr;
+};
+
+void WindowTaskModelTest::init()
+{
+    // Модель становится владельцем источника данных
+    m_backend = new MockWindowSystemBackend();
+    model().setBackend(m_backend);
+}
+
+void WindowTaskModelTest::cleanupTestCase()
+{
+    model().setBackend(nullptr);
+    m_backend = nullptr;
+}
+
+void WindowTaskModelTest::resyncLoadsExistingWindows()
+{
+    m_backend->create(1, "Editor");
+    m_backend->create(1, "Editor 2");
+    m_backend->create(2, "Browser");
+    m_backend->create(3, QString());   // Без заголовка - не для дока
+
+    model().resync();
+
+    QCOMPARE(model().windowCount(), 3);
+    QVERIFY(model().hasWindowsForProcess("APP1.exe"));
+    QCOMPARE(model().windowsForProcess("app1.exe").size(), 2);
+    QVERIFY(!model().hasWindowsForProcess("app3.exe"));
+}
+
+void WindowTaskModelTest::showAndDestroyUpdateIncrementally()
+{
+    QSignalSpy added(&model(), &WindowTaskModel::windowAdded);
+    QSignalSpy removed(&model(), &WindowTaskModel::windowRemoved);
+
+    quintptr id = m_backend->create(1, "Editor");
+    model().notifyWindowShown(id);
+    QCOMPARE(added.count(), 1);
+    QVERIFY(model().window(id));
+
+    m_backend->destroy(id);
+    model().notifyWindowDestroyed(id);
+    QCOMPARE(removed.count(), 1);
+    QVERIFY(!model().window(id));
+    QVERIFY(!model().hasWindowsForProcess("app1.exe"));
+}
+
+void WindowTaskModelTest::activationOrdersWindows()
+{
+    quintptr first = m_backend->create(1, "First");
+    quintptr second = m_backend->create(1, "Second");
+    model().notifyWindowShown(first);
+    model().notifyWindowShown(second);
+
+    QCOMPARE(model().windowsForProcess("app1.exe").first().id, second);
+
+    model().notifyWindowActivated(first);
+    QCOMPARE(model().windowsForProcess("app1.exe").first().id, first);
+}
+
+void WindowTaskModelTest::titleChangeOfTrackedWindowReadsTitleOnly()
+{
+    quintptr id = m_backend->create(1, "Document 1");
+    model().notifyWindowShown(id);
+    const int queriesBefore = m_backend->queryCalls;
+
+    QSignalSpy changed(&model(), &WindowTaskModel::windowChanged);
+    m_backend->windows[id].title = "Document 2";
+    model().notifyTitleChanged(id);
+
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(model().window(id)->title, QString("Document 2"));
+    QCOMPARE(m_backend->queryCalls, queriesBefore);
+    QCOMPARE(m_backend->titleCalls, 1);
+}
+
+void WindowTaskModelTest::titleChangeOfUnknownWindowIsIgnored()
+{
+    quintptr id = m_backend->create(5, "Not shown yet");
+    model().notifyTitleChanged(id);
+
+    QCOMPARE(m_backend->queryCalls, 0);
+    QCOMPARE(m_backend->titleCalls, 0);
+    QVERIFY(!model().window(id));
+
+    // Окно попадает в модель при активации
+    model().notifyWindowActivated(id);
+    QVERIFY(model().window(id));
+}
+
+void WindowTaskModelTest::windowTitledAfterShowIsAdded()
+{
+    QSignalSpy added(&model(), &WindowTaskModel::windowAdded);
+
+    // Окно показано до того, как приложение задало заголовок
+    quintptr id = m_backend->create(7, QString());
+    model().notifyWindowShown(id);
+    QVERIFY(!model().window(id));
+    QCOMPARE(added.count(), 0);
+    QCOMPARE(m_backend->watchedProcesses, QSet<quint32>({7}));
+
+    m_backend->windows[id].title = "Loaded document";
+    model().notifyTitleChanged(id);
+    QVERIFY(model().window(id));
+    QCOMPARE(model().window(id)->title, QString("Loaded document"));
+    QCOMPARE(added.count(), 1);
+    QCOMPARE(m_backend->watchedProcesses, QSet<quint32>({7}));
+
+    // Окно без заголовка, скрытое до его появления, не держит подписку
+    quintptr hidden = m_backend->create(8, QString());
+    model().notifyWindowShown(hidden);
+    QVERIFY(m_backend->watchedProcesses.contains(8));
+    model().notifyWindowHidden(hidden);
+    QVERIFY(!m_backend->watchedProcesses.contains(8));
+
+    model().notifyWindowDestroyed(id);
+    QVERIFY(m_backend->watchedProcesses.isEmpty());
+}
+
+void WindowTaskModelTest::titlesAreWatchedOnlyForTrackedProcesses()
+{
+    quintptr a1 = m_backend->create(1, "A1");
+    quintptr a2 = m_backend->create(1, "A2");
+    quintptr b1 = m_backend->create(2, "B1");
+    model().notifyWindowShown(a1);
+    model().notifyWindowShown(a2);
+    model().notifyWindowShown(b1);
+    QCOMPARE(m_backend->watchedProcesses, QSet<quint32>({1, 2}));
+
+    model().notifyWindowHidden(a1);
+    QCOMPARE(m_backend->watchedProcesses, QSet<quint32>({1, 2}));
+
+    model().notifyWindowDestroyed(a2);
+    model().notifyWindowDestroyed(b1);
+    QVERIFY(m_backend->watchedProcesses.isEmpty());
+}
+
+void WindowTaskModelTest::benchmarkWindowChurn()
+{
+    // Фон: 200 окон 50 процессов, затем 1000 событий создания/уничтожения
+    for (int i = 0; i < 200; ++i) {
+        model().notifyWindowShown(m_backend->create(i % 50, QString("Window %1").arg(i)));
+    }
+
+    const int eventCount = 1000;
+    QList<quintptr> churn;
+    churn.reserve(eventCount / 2);
+
+    qint64 elapsedNs = 0;
+    QBENCHMARK {
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int i = 0; i < eventCount / 2; ++i) {
+            quintptr id = m_backend->create(i % 50, QString("Transient %1").arg(i));
+            churn.append(id);
+            model().notifyWindowShown(id);
+            model().windowsForProcess(QString("app%1.exe").arg(i % 50));
+        }
+        for (quintptr id : std::as_const(churn)) {
+            m_backend->destroy(id);
+            model().notifyWindowDestroyed(id);
+        }
+        churn.clear();
+
+        elapsedNs = timer.nsecsElapsed();
+    }
+
+    QCOMPARE(model().windowCount(), 200);
+    // 1000 событий в секунду должны обрабатываться с большим запасом
+    QVERIFY2(elapsedNs < 100 * 1000 * 1000,
+             qPrintable(QString("1000 events took %1 ms").arg(elapsedNs / 1e6)));
+}
+
+QTEST_GUILESS_MAIN(WindowTaskModelTest)
+#include "tst_windowtaskmodel.moc"